@@ -0,0 +1,824 @@
+#pragma once
+#include "ActionSymbols.h"
+#include "ActionTree.h"
+#include "Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+/**
+ * @file ActionBTree.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the ActionBTree class, a B+-tree of moves for catalogs of
+ * tens of thousands of skills, items and scripted actions, where a binary tree pays a cache
+ * miss at every one of its twenty odd levels. Each node fills CacheLines cache lines and holds
+ * as many moves, or routing keys, as fit in them, so a lookup touches a handful of nodes and
+ * searches each with a binary search over one array.
+ *
+ * Unlike ActionTree, which orders moves by symbol, the tree is ordered by action name, so
+ * moves that share a prefix sit side by side. Every key carries the first 8 characters of its
+ * name packed into an integer, most significant first, so most comparisons are one integer
+ * comparison; only names that agree on those 8 characters are compared in full, through
+ * ActionSymbols::Global().
+ *
+ * The moves are kept in the leaves only, and the leaves are linked left to right, so walking
+ * in order, or along a range such as every move starting with "Up", runs from leaf to leaf
+ * without climbing back into the tree. Inner nodes only route: separator i is the first key
+ * of child i + 1 when it was split off. A full node is split in half on the way back up from
+ * an insertion. Deleting takes the move out of its leaf and leaves the leaf where it is,
+ * however empty, the way many database B-trees do, since separators stay valid bounds;
+ * BulkLoad() packs the tree again.
+ *
+ * Leaves and inner nodes live in two Arenas and link to each other by index. Inserting can
+ * move the moves of a leaf into a new one, so iterators are only valid until the next insert
+ * or delete.
+ *
+ * Properties:
+ * -----------
+ * > _leaves: Arena<Leaf> - The leaves, holding the moves.
+ * > _inners: Arena<Inner> - The inner nodes, holding separators and children.
+ * > _root: uint32_t - The root, a leaf while _height is 0.
+ * > _first: uint32_t - The leftmost leaf, where walks start.
+ * > _height: int - The number of levels of inner nodes above the leaves.
+ * > _size: int - The number of moves.
+ * > _damage: long long - The damage of every move added up.
+ *
+ * Methods:
+ * --------
+ * > InsertNode(action or symbol, damage): Iterator - Inserts a move.
+ * > Delete(position): Iterator - Deletes a move.
+ * > BulkLoad(moves) - Replaces the moves with a catalog, packed into full leaves.
+ * > Find(action): Iterator - The first move holding an action.
+ * > LowerBound(action): Iterator - The first move not ordered before an action.
+ * > begin(), end(): Iterator - Walk the moves in order of name.
+ * > Visit(visit), VisitRange(low, high, visit), VisitPrefix(prefix, visit) - Call a function on moves in order.
+ * > SetDamage(position, damage) - Changes the damage of a move.
+ * > GetSize(), GetHeight(), GetDamage(), GetMemoryBytes() - Getters.
+ */
+template <int CacheLines = 4>
+class ActionBTree
+{
+public:
+	static const int ACTION_CACHE_LINE = 64;
+	static const int ACTION_NODE_BYTES = CacheLines * ACTION_CACHE_LINE;
+	// a leaf move takes a key head, a symbol and a damage, an inner key a head, a symbol and a child
+	static const int ACTION_LEAF_CAPACITY = (ACTION_NODE_BYTES - 8) / 14;
+	static const int ACTION_INNER_CAPACITY = (ACTION_NODE_BYTES - 12) / 16;
+	static const int ACTION_BTREE_MAX_HEIGHT = 32;
+	static const uint32_t ACTION_BTREE_NONE = Arena<int>::ARENA_NO_INDEX;
+
+private:
+	static_assert(ACTION_INNER_CAPACITY >= 3, "An ActionBTree node needs room for at least three keys");
+
+	/**
+	 * @brief A leaf, its moves in order of name, and the next leaf to the right.
+	*/
+	struct Leaf
+	{
+		uint64_t heads[ACTION_LEAF_CAPACITY];
+		uint32_t symbols[ACTION_LEAF_CAPACITY];
+		uint32_t next;
+		uint16_t damage[ACTION_LEAF_CAPACITY];
+		uint16_t count;
+	};
+
+	/**
+	 * @brief An inner node, count separators and count + 1 children.
+	*/
+	struct Inner
+	{
+		uint64_t heads[ACTION_INNER_CAPACITY];
+		uint32_t symbols[ACTION_INNER_CAPACITY];
+		uint32_t children[ACTION_INNER_CAPACITY + 1];
+		uint16_t count;
+	};
+
+	/**
+	 * @brief A name being searched for, its symbol ACTION_SYMBOL_NONE if it was never interned.
+	*/
+	struct Key
+	{
+		uint64_t head;
+		uint32_t symbol;
+		const char* data;
+		uint32_t length;
+	};
+
+	static_assert(sizeof(Leaf) <= ACTION_NODE_BYTES && sizeof(Inner) <= ACTION_NODE_BYTES, "An ActionBTree node must fit its cache lines");
+
+	Arena<Leaf> _leaves;
+	Arena<Inner> _inners;
+	uint32_t _root;
+	uint32_t _first;
+	int _height;
+	int _size;
+	long long _damage;
+
+	/**
+	 * @brief Packs the first 8 characters of a name into an integer that orders like they do.
+	*/
+	static uint64_t Head(const char* data, size_t length)
+	{
+		uint64_t head = 0;
+		for (size_t i = 0; i < 8; i++)
+		{
+			head = (head << 8) | ((i < length) ? static_cast<unsigned char>(data[i]) : 0);
+		}
+		return head;
+	}
+
+	/**
+	 * @brief Makes the key of a name.
+	*/
+	static Key KeyOf(const std::string& action)
+	{
+		const uint32_t length = static_cast<uint32_t>(action.size());
+		return Key{ Head(action.data(), length), ActionSymbols::Global().Find(action), action.data(), length };
+	}
+
+	/**
+	 * @brief Makes the key of an interned action.
+	*/
+	static Key KeyOf(uint32_t symbol)
+	{
+		const ActionSymbols& symbols = ActionSymbols::Global();
+		const uint32_t length = symbols.GetLength(symbol);
+		return Key{ Head(symbols.GetData(symbol), length), symbol, symbols.GetData(symbol), length };
+	}
+
+	/**
+	 * @brief Orders a key against a stored key, as their names compare.
+	*/
+	static int Compare(const Key& key, uint64_t head, uint32_t symbol)
+	{
+		if (key.head != head)
+		{
+			return (key.head < head) ? -1 : 1;
+		}
+		if (key.symbol == symbol)
+		{
+			return 0;
+		}
+		// the first 8 characters agree, the rest of the names decide
+		const ActionSymbols& symbols = ActionSymbols::Global();
+		const uint32_t length = symbols.GetLength(symbol);
+		const uint32_t shorter = std::min(key.length, length);
+		const uint32_t known = std::min<uint32_t>(8, shorter);
+		const int order = std::memcmp(key.data + known, symbols.GetData(symbol) + known, shorter - known);
+		if (order != 0)
+		{
+			return order;
+		}
+		return (key.length < length) ? -1 : (key.length > length) ? 1 : 0;
+	}
+
+	/**
+	 * @brief Binary searches the keys of a node for the first one after a key, or, with
+	 * after false, the first one not before it. Names are only read when key heads tie.
+	*/
+	static uint32_t Search(const Key& key, const uint64_t* heads, const uint32_t* symbols, uint32_t count, bool after)
+	{
+		uint32_t low = 0;
+		while (count > 0)
+		{
+			const uint32_t half = count / 2;
+			const int order = Compare(key, heads[low + half], symbols[low + half]);
+			if (order > 0 || (after && order == 0))
+			{
+				low += half + 1;
+				count -= half + 1;
+			}
+			else
+			{
+				count = half;
+			}
+		}
+		return low;
+	}
+
+	/**
+	 * @brief Finds the leaf and slot of the first move not ordered before a key.
+	*/
+	void Lower(const Key& key, uint32_t& leaf, uint32_t& slot) const
+	{
+		uint32_t node = _root;
+		for (int level = _height; level > 0; level--)
+		{
+			const Inner& inner = _inners.At(node);
+			node = inner.children[Search(key, inner.heads, inner.symbols, inner.count, false)];
+		}
+		const Leaf& at = _leaves.At(node);
+		slot = Search(key, at.heads, at.symbols, at.count, false);
+		leaf = node;
+		Settle(leaf, slot);
+	}
+
+	/**
+	 * @brief Moves a position off the end of its leaf onto the next move, past empty leaves.
+	*/
+	void Settle(uint32_t& leaf, uint32_t& slot) const
+	{
+		while (leaf != ACTION_BTREE_NONE && slot >= _leaves.At(leaf).count)
+		{
+			leaf = _leaves.At(leaf).next;
+			slot = 0;
+		}
+	}
+
+	/**
+	 * @brief Adds a separator and the child to its right to the inner nodes along a path,
+	 * splitting full ones up to the root.
+	*/
+	void Grow(const uint32_t* path, const uint32_t* taken, int depth, uint64_t head, uint32_t symbol, uint32_t child)
+	{
+		for (int level = depth - 1; level >= 0; level--)
+		{
+			Inner& inner = _inners.At(path[level]);
+			const uint32_t at = taken[level];
+			if (inner.count < ACTION_INNER_CAPACITY)
+			{
+				for (uint32_t i = inner.count; i > at; i--)
+				{
+					inner.heads[i] = inner.heads[i - 1];
+					inner.symbols[i] = inner.symbols[i - 1];
+					inner.children[i + 1] = inner.children[i];
+				}
+				inner.heads[at] = head;
+				inner.symbols[at] = symbol;
+				inner.children[at + 1] = child;
+				inner.count++;
+				return;
+			}
+
+			// the full node and the new separator are laid out together, then cut around the middle
+			uint64_t heads[ACTION_INNER_CAPACITY + 1];
+			uint32_t symbols[ACTION_INNER_CAPACITY + 1];
+			uint32_t children[ACTION_INNER_CAPACITY + 2];
+			for (uint32_t i = 0, from = 0; i <= ACTION_INNER_CAPACITY; i++)
+			{
+				if (i == at)
+				{
+					heads[i] = head;
+					symbols[i] = symbol;
+				}
+				else
+				{
+					heads[i] = inner.heads[from];
+					symbols[i] = inner.symbols[from];
+					from++;
+				}
+			}
+			for (uint32_t i = 0, from = 0; i <= ACTION_INNER_CAPACITY + 1; i++)
+			{
+				children[i] = (i == at + 1) ? child : inner.children[from++];
+			}
+
+			const uint32_t middle = (ACTION_INNER_CAPACITY + 1) / 2;
+			const uint32_t right = _inners.Allocate();
+			Inner& left = _inners.At(path[level]);
+			Inner& split = _inners.At(right);
+			left.count = static_cast<uint16_t>(middle);
+			for (uint32_t i = 0; i < middle; i++)
+			{
+				left.heads[i] = heads[i];
+				left.symbols[i] = symbols[i];
+				left.children[i] = children[i];
+			}
+			left.children[middle] = children[middle];
+			split.count = static_cast<uint16_t>(ACTION_INNER_CAPACITY - middle);
+			for (uint32_t i = 0; i < split.count; i++)
+			{
+				split.heads[i] = heads[middle + 1 + i];
+				split.symbols[i] = symbols[middle + 1 + i];
+				split.children[i] = children[middle + 1 + i];
+			}
+			split.children[split.count] = children[ACTION_INNER_CAPACITY + 1];
+
+			// the middle separator moves up a level instead of staying in either half
+			head = heads[middle];
+			symbol = symbols[middle];
+			child = right;
+		}
+
+		const uint32_t root = _inners.Allocate();
+		Inner& top = _inners.At(root);
+		top.count = 1;
+		top.heads[0] = head;
+		top.symbols[0] = symbol;
+		top.children[0] = _root;
+		top.children[1] = child;
+		_root = root;
+		_height++;
+	}
+
+public:
+	/**
+	 * @brief A forward iterator over the moves in order of name. It holds the tree, a leaf and
+	 * a slot in it, and is invalidated by inserting or deleting.
+	*/
+	class Iterator
+	{
+	private:
+		friend class ActionBTree;
+		const ActionBTree* _tree;
+		uint32_t _leaf;
+		uint32_t _slot;
+
+	public:
+		/**
+		 * @brief Creates an iterator on a slot of a leaf
+		 * @param tree - the tree to walk
+		 * @param leaf - the leaf, ACTION_BTREE_NONE for the end
+		 * @param slot - the slot in the leaf
+		*/
+		Iterator(const ActionBTree* tree, uint32_t leaf, uint32_t slot)
+		{
+			_tree = tree;
+			_leaf = leaf;
+			_slot = slot;
+		}
+
+		/**
+		 * @brief Gets the move the iterator is on
+		 * @return the symbol and damage of the move
+		*/
+		ActionTree::Move operator*() const
+		{
+			const Leaf& leaf = _tree->_leaves.At(_leaf);
+			return ActionTree::Move{ leaf.symbols[_slot], leaf.damage[_slot] };
+		}
+
+		/**
+		 * @brief Getter for the symbol of the move
+		 * @return the symbol of the action in ActionSymbols::Global()
+		*/
+		uint32_t GetSymbol() const
+		{
+			return _tree->_leaves.At(_leaf).symbols[_slot];
+		}
+
+		/**
+		 * @brief Getter for the action of the move
+		 * @return a string representing the action
+		*/
+		std::string GetAction() const
+		{
+			return ActionSymbols::Global().GetName(GetSymbol());
+		}
+
+		/**
+		 * @brief Getter for the damage of the move
+		 * @return an integer representing the damage dealt by the action
+		*/
+		int GetDamage() const
+		{
+			return _tree->_leaves.At(_leaf).damage[_slot];
+		}
+
+		/**
+		 * @brief Moves on to the next move, along the leaf links
+		 * @return the iterator
+		*/
+		Iterator& operator++()
+		{
+			_slot++;
+			_tree->Settle(_leaf, _slot);
+			return *this;
+		}
+
+		/**
+		 * @brief Checks whether two iterators are on the same move
+		*/
+		bool operator==(const Iterator& other) const
+		{
+			return _leaf == other._leaf && (_leaf == ACTION_BTREE_NONE || _slot == other._slot) && _tree == other._tree;
+		}
+
+		/**
+		 * @brief Checks whether two iterators are on different moves
+		*/
+		bool operator!=(const Iterator& other) const
+		{
+			return !(*this == other);
+		}
+	};
+
+	/**
+	 * @brief Creates an empty tree, a single empty leaf.
+	*/
+	ActionBTree()
+	{
+		_root = _leaves.Allocate();
+		_first = _root;
+		_leaves.At(_root).next = ACTION_BTREE_NONE;
+		_height = 0;
+		_size = 0;
+		_damage = 0;
+	}
+
+	ActionBTree(const ActionBTree& other) = default;
+	ActionBTree& operator=(const ActionBTree&) = delete;
+
+	/**
+	 * @brief Interns an action and inserts a move holding it.
+	 * @param action - the action of the move
+	 * @param damage - the damage dealt by the action, from 0 to 65535
+	 * @return an iterator on the new move
+	*/
+	Iterator InsertNode(const std::string& action, int damage = ActionTree::ACTION_DEFAULT_DAMAGE)
+	{
+		return InsertNode(ActionSymbols::Global().Intern(action), damage);
+	}
+
+	/**
+	 * @brief Inserts a move holding an interned action after any equal ones, splitting the
+	 * nodes that fill up on the way.
+	 * @param symbol - the symbol of the action in ActionSymbols::Global()
+	 * @param damage - the damage dealt by the action, from 0 to 65535
+	 * @return an iterator on the new move
+	*/
+	Iterator InsertNode(uint32_t symbol, int damage = ActionTree::ACTION_DEFAULT_DAMAGE)
+	{
+		if (damage < 0 || damage > UINT16_MAX)
+		{
+			throw std::out_of_range("Action damage must be from 0 to 65535");
+		}
+		const Key key = KeyOf(symbol);
+
+		// equal names go right, so the path follows every separator not after the key
+		uint32_t path[ACTION_BTREE_MAX_HEIGHT];
+		uint32_t taken[ACTION_BTREE_MAX_HEIGHT];
+		uint32_t node = _root;
+		for (int level = 0; level < _height; level++)
+		{
+			const Inner& inner = _inners.At(node);
+			const uint32_t child = Search(key, inner.heads, inner.symbols, inner.count, true);
+			path[level] = node;
+			taken[level] = child;
+			node = inner.children[child];
+		}
+		uint32_t slot = Search(key, _leaves.At(node).heads, _leaves.At(node).symbols, _leaves.At(node).count, true);
+
+		if (_leaves.At(node).count == ACTION_LEAF_CAPACITY)
+		{
+			if (_height == ACTION_BTREE_MAX_HEIGHT)
+			{
+				throw std::out_of_range("ActionBTree is too tall to grow");
+			}
+			// the upper half moves to a new leaf linked in after this one
+			const uint32_t middle = ACTION_LEAF_CAPACITY / 2;
+			const uint32_t right = _leaves.Allocate();
+			Leaf& left = _leaves.At(node);
+			Leaf& split = _leaves.At(right);
+			split.count = static_cast<uint16_t>(ACTION_LEAF_CAPACITY - middle);
+			std::copy(left.heads + middle, left.heads + ACTION_LEAF_CAPACITY, split.heads);
+			std::copy(left.symbols + middle, left.symbols + ACTION_LEAF_CAPACITY, split.symbols);
+			std::copy(left.damage + middle, left.damage + ACTION_LEAF_CAPACITY, split.damage);
+			left.count = static_cast<uint16_t>(middle);
+			split.next = left.next;
+			left.next = right;
+			Grow(path, taken, _height, split.heads[0], split.symbols[0], right);
+			if (slot > middle)
+			{
+				node = right;
+				slot -= middle;
+			}
+		}
+
+		Leaf& leaf = _leaves.At(node);
+		for (uint32_t i = leaf.count; i > slot; i--)
+		{
+			leaf.heads[i] = leaf.heads[i - 1];
+			leaf.symbols[i] = leaf.symbols[i - 1];
+			leaf.damage[i] = leaf.damage[i - 1];
+		}
+		leaf.heads[slot] = key.head;
+		leaf.symbols[slot] = symbol;
+		leaf.damage[slot] = static_cast<uint16_t>(damage);
+		leaf.count++;
+		_size++;
+		_damage += damage;
+		return Iterator(this, node, slot);
+	}
+
+	/**
+	 * @brief Deletes a move from its leaf. The leaf stays, however few moves are left in it.
+	 * @param position - an iterator on the move
+	 * @return an iterator on the move after it
+	*/
+	Iterator Delete(Iterator position)
+	{
+		Leaf& leaf = _leaves.At(position._leaf);
+		_damage -= leaf.damage[position._slot];
+		for (uint32_t i = position._slot + 1; i < leaf.count; i++)
+		{
+			leaf.heads[i - 1] = leaf.heads[i];
+			leaf.symbols[i - 1] = leaf.symbols[i];
+			leaf.damage[i - 1] = leaf.damage[i];
+		}
+		leaf.count--;
+		_size--;
+		Settle(position._leaf, position._slot);
+		return position;
+	}
+
+	/**
+	 * @brief Replaces every move with a catalog, sorted by name, then packed into full leaves
+	 * and the levels above them built from the bottom up in O(n). Equal actions keep their
+	 * order in the catalog.
+	 * @param moves - the catalog, each damage from 0 to 65535
+	*/
+	void BulkLoad(const std::vector<ActionTree::Move>& moves)
+	{
+		struct Entry
+		{
+			uint64_t head;
+			uint32_t symbol;
+			uint16_t damage;
+		};
+		std::vector<Entry> entries;
+		entries.reserve(moves.size());
+		long long damage = 0;
+		for (const ActionTree::Move& move : moves)
+		{
+			if (move.damage < 0 || move.damage > UINT16_MAX)
+			{
+				throw std::out_of_range("Action damage must be from 0 to 65535");
+			}
+			entries.push_back(Entry{ KeyOf(move.symbol).head, move.symbol, static_cast<uint16_t>(move.damage) });
+			damage += move.damage;
+		}
+		std::stable_sort(entries.begin(), entries.end(), [](const Entry& one, const Entry& other)
+		{
+			if (one.head != other.head)
+			{
+				return one.head < other.head;
+			}
+			return Compare(KeyOf(one.symbol), other.head, other.symbol) < 0;
+		});
+
+		_leaves.Clear();
+		_inners.Clear();
+		std::vector<uint32_t> level;
+		std::vector<uint64_t> heads;
+		std::vector<uint32_t> symbols;
+		for (size_t start = 0; start < entries.size() || level.empty(); start += ACTION_LEAF_CAPACITY)
+		{
+			const uint32_t index = _leaves.Allocate();
+			Leaf& leaf = _leaves.At(index);
+			leaf.count = static_cast<uint16_t>(std::min<size_t>(ACTION_LEAF_CAPACITY, entries.size() - start));
+			for (uint32_t i = 0; i < leaf.count; i++)
+			{
+				leaf.heads[i] = entries[start + i].head;
+				leaf.symbols[i] = entries[start + i].symbol;
+				leaf.damage[i] = entries[start + i].damage;
+			}
+			leaf.next = ACTION_BTREE_NONE;
+			if (!level.empty())
+			{
+				_leaves.At(level.back()).next = index;
+			}
+			level.push_back(index);
+			heads.push_back(leaf.heads[0]);
+			symbols.push_back(leaf.symbols[0]);
+		}
+		_first = level.front();
+
+		// each level takes the first key of every node below but the first as its separators
+		_height = 0;
+		while (level.size() > 1)
+		{
+			std::vector<uint32_t> above;
+			std::vector<uint64_t> aboveHeads;
+			std::vector<uint32_t> aboveSymbols;
+			for (size_t start = 0; start < level.size(); start += ACTION_INNER_CAPACITY + 1)
+			{
+				const uint32_t index = _inners.Allocate();
+				Inner& inner = _inners.At(index);
+				const size_t children = std::min<size_t>(ACTION_INNER_CAPACITY + 1, level.size() - start);
+				inner.count = static_cast<uint16_t>(children - 1);
+				for (size_t i = 0; i < children; i++)
+				{
+					inner.children[i] = level[start + i];
+					if (i > 0)
+					{
+						inner.heads[i - 1] = heads[start + i];
+						inner.symbols[i - 1] = symbols[start + i];
+					}
+				}
+				above.push_back(index);
+				aboveHeads.push_back(heads[start]);
+				aboveSymbols.push_back(symbols[start]);
+			}
+			level.swap(above);
+			heads.swap(aboveHeads);
+			symbols.swap(aboveSymbols);
+			_height++;
+		}
+		_root = level.front();
+		_size = static_cast<int>(entries.size());
+		_damage = damage;
+	}
+
+	/**
+	 * @brief Looks up the first move holding an action
+	 * @param action - the action to look for
+	 * @return an iterator on the move, end() if there is none
+	*/
+	Iterator Find(const std::string& action) const
+	{
+		const Key key = KeyOf(action);
+		if (key.symbol == ActionSymbols::ACTION_SYMBOL_NONE)
+		{
+			return end();
+		}
+		uint32_t leaf;
+		uint32_t slot;
+		Lower(key, leaf, slot);
+		return (leaf != ACTION_BTREE_NONE && _leaves.At(leaf).symbols[slot] == key.symbol) ? Iterator(this, leaf, slot) : end();
+	}
+
+	/**
+	 * @brief Looks up the first move whose action is not ordered before a name
+	 * @param action - the name, interned or not
+	 * @return an iterator on the move, end() if every move comes before it
+	*/
+	Iterator LowerBound(const std::string& action) const
+	{
+		uint32_t leaf;
+		uint32_t slot;
+		Lower(KeyOf(action), leaf, slot);
+		return Iterator(this, leaf, slot);
+	}
+
+	/**
+	 * @brief Getter for an iterator on the first move
+	 * @return an iterator over the moves in order of name
+	*/
+	Iterator begin() const
+	{
+		uint32_t leaf = _first;
+		uint32_t slot = 0;
+		Settle(leaf, slot);
+		return Iterator(this, leaf, slot);
+	}
+
+	/**
+	 * @brief Getter for the iterator past the last move
+	 * @return the end iterator
+	*/
+	Iterator end() const
+	{
+		return Iterator(this, ACTION_BTREE_NONE, 0);
+	}
+
+	/**
+	 * @brief Calls a function on every move in order of name, leaf after leaf
+	 * @param visit - the function to call, with an ActionTree::Move
+	*/
+	template <typename Visitor>
+	void Visit(Visitor visit) const
+	{
+		for (uint32_t leaf = _first; leaf != ACTION_BTREE_NONE; leaf = _leaves.At(leaf).next)
+		{
+			const Leaf& at = _leaves.At(leaf);
+			for (uint32_t slot = 0; slot < at.count; slot++)
+			{
+				visit(ActionTree::Move{ at.symbols[slot], at.damage[slot] });
+			}
+		}
+	}
+
+	/**
+	 * @brief Calls a function on every move from one name up to another, in order
+	 * @param low - the first name of the range, included
+	 * @param high - the name the range stops at, left out
+	 * @param visit - the function to call, with an ActionTree::Move
+	*/
+	template <typename Visitor>
+	void VisitRange(const std::string& low, const std::string& high, Visitor visit) const
+	{
+		const Key stop = KeyOf(high);
+		uint32_t leaf;
+		uint32_t slot;
+		Lower(KeyOf(low), leaf, slot);
+		while (leaf != ACTION_BTREE_NONE)
+		{
+			const Leaf& at = _leaves.At(leaf);
+			for (; slot < at.count; slot++)
+			{
+				if (Compare(stop, at.heads[slot], at.symbols[slot]) <= 0)
+				{
+					return;
+				}
+				visit(ActionTree::Move{ at.symbols[slot], at.damage[slot] });
+			}
+			leaf = at.next;
+			slot = 0;
+		}
+	}
+
+	/**
+	 * @brief Calls a function on every move whose action starts with a prefix, in order.
+	 * Prefixes of up to 8 characters are matched on the key heads alone.
+	 * @param prefix - the start of the actions, "Up" for Uppercut Punch and Upward Slash
+	 * @param visit - the function to call, with an ActionTree::Move
+	*/
+	template <typename Visitor>
+	void VisitPrefix(const std::string& prefix, Visitor visit) const
+	{
+		const bool byHead = prefix.size() <= 8 && std::memchr(prefix.data(), '\0', prefix.size()) == nullptr;
+		const uint64_t mask = (byHead && !prefix.empty()) ? ~static_cast<uint64_t>(0) << (64 - 8 * prefix.size()) : 0;
+		const uint64_t head = Head(prefix.data(), prefix.size());
+		const ActionSymbols& names = ActionSymbols::Global();
+		uint32_t leaf;
+		uint32_t slot;
+		Lower(KeyOf(prefix), leaf, slot);
+		while (leaf != ACTION_BTREE_NONE)
+		{
+			const Leaf& at = _leaves.At(leaf);
+			for (; slot < at.count; slot++)
+			{
+				const bool starts = byHead ? (at.heads[slot] & mask) == head
+					: names.GetLength(at.symbols[slot]) >= prefix.size()
+						&& std::memcmp(names.GetData(at.symbols[slot]), prefix.data(), prefix.size()) == 0;
+				if (!starts)
+				{
+					return;
+				}
+				visit(ActionTree::Move{ at.symbols[slot], at.damage[slot] });
+			}
+			leaf = at.next;
+			slot = 0;
+		}
+	}
+
+	/**
+	 * @brief Setter for the damage of one move
+	 * @param position - an iterator on the move
+	 * @param damage - the desired damage value, from 0 to 65535
+	*/
+	void SetDamage(Iterator position, int damage)
+	{
+		if (damage < 0 || damage > UINT16_MAX)
+		{
+			throw std::out_of_range("Action damage must be from 0 to 65535");
+		}
+		uint16_t& stored = _leaves.At(position._leaf).damage[position._slot];
+		_damage += damage - stored;
+		stored = static_cast<uint16_t>(damage);
+	}
+
+	/**
+	 * @brief Getter for the size of the tree
+	 * @return an integer representing the number of moves
+	*/
+	int GetSize() const
+	{
+		return _size;
+	}
+
+	/**
+	 * @brief Getter for the height of the tree
+	 * @return an integer representing the number of nodes on every path from the root, leaves included
+	*/
+	int GetHeight() const
+	{
+		return _height + 1;
+	}
+
+	/**
+	 * @brief Getter for the damage
+	 * @return the damage of every move added up, 64 bits wide like ActionTree::GetDamage()
+	*/
+	long long GetDamage() const
+	{
+		return _damage;
+	}
+
+	/**
+	 * @brief Getter for the memory the tree holds
+	 * @return the number of bytes in the arenas of leaves and inner nodes
+	*/
+	size_t GetMemoryBytes() const
+	{
+		return _leaves.GetMemoryBytes() + _inners.GetMemoryBytes();
+	}
+};
+
+template <int CacheLines>
+const int ActionBTree<CacheLines>::ACTION_CACHE_LINE;
+template <int CacheLines>
+const int ActionBTree<CacheLines>::ACTION_NODE_BYTES;
+template <int CacheLines>
+const int ActionBTree<CacheLines>::ACTION_LEAF_CAPACITY;
+template <int CacheLines>
+const int ActionBTree<CacheLines>::ACTION_INNER_CAPACITY;
+template <int CacheLines>
+const int ActionBTree<CacheLines>::ACTION_BTREE_MAX_HEIGHT;
+template <int CacheLines>
+const uint32_t ActionBTree<CacheLines>::ACTION_BTREE_NONE;
@@ -0,0 +1,216 @@
+#include "ActionSymbols.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+const uint32_t ActionSymbols::ACTION_SYMBOL_NONE;
+const uint32_t ActionSymbols::ACTION_SYMBOL_BLOCK;
+const uint32_t ActionSymbols::ACTION_SYMBOL_BLOCKS;
+const uint32_t ActionSymbols::ACTION_TABLE_MIN_SIZE;
+const size_t ActionSymbols::ACTION_CHAR_BLOCK;
+const uint32_t ActionSymbols::ACTION_DEFAULT_COUNT;
+const char* const ActionSymbols::ACTION_DEFAULT_NAMES[ACTION_DEFAULT_COUNT] = {
+	"Hammer Swing", "Head Butt", "Jab Punch", "Uppercut Punch"
+};
+
+ActionSymbols::ActionSymbols()
+{
+	for (atomic<Entry*>& block : _entries)
+	{
+		block.store(nullptr, memory_order_relaxed);
+	}
+	_size.store(0, memory_order_relaxed);
+	_charNext = nullptr;
+	_charFree = 0;
+	_table.store(Build(ACTION_TABLE_MIN_SIZE), memory_order_release);
+}
+
+ActionSymbols::ActionSymbols(const char* const* names, uint32_t count)
+	: ActionSymbols()
+{
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Intern(names[i]);
+	}
+}
+
+ActionSymbols::~ActionSymbols()
+{
+	for (Table* table : _tables)
+	{
+		delete[] table->slots;
+		delete table;
+	}
+	for (atomic<Entry*>& block : _entries)
+	{
+		delete[] block.load(memory_order_relaxed);
+	}
+	for (char* block : _chars)
+	{
+		delete[] block;
+	}
+}
+
+ActionSymbols& ActionSymbols::Global()
+{
+	// the defaults are interned by the same initialization that makes the table, so nothing
+	// can intern one of them first, whatever order static objects are initialized in
+	static ActionSymbols symbols(ACTION_DEFAULT_NAMES, ACTION_DEFAULT_COUNT);
+	return symbols;
+}
+
+uint32_t ActionSymbols::Hash(const char* name, size_t length)
+{
+	uint64_t hash = 14695981039346656037ull;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash = (hash ^ static_cast<unsigned char>(name[i])) * 1099511628211ull;
+	}
+	return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+const ActionSymbols::Entry& ActionSymbols::EntryOf(uint32_t symbol) const
+{
+	return _entries[symbol / ACTION_SYMBOL_BLOCK].load(memory_order_acquire)[symbol % ACTION_SYMBOL_BLOCK];
+}
+
+uint32_t ActionSymbols::Probe(const char* name, size_t length, uint32_t hash) const
+{
+	const Table* table = _table.load(memory_order_acquire);
+	for (uint32_t slot = hash & table->mask; ; slot = (slot + 1) & table->mask)
+	{
+		// a slot is written once, after its entry, so a symbol read here has its entry in place
+		const uint32_t stored = table->slots[slot].load(memory_order_acquire);
+		if (stored == 0)
+		{
+			return ACTION_SYMBOL_NONE;
+		}
+		const Entry& entry = EntryOf(stored - 1);
+		if (entry.hash == hash && entry.length == length && memcmp(entry.name, name, length) == 0)
+		{
+			return stored - 1;
+		}
+	}
+}
+
+ActionSymbols::Table* ActionSymbols::Build(uint32_t size)
+{
+	Table* table = new Table;
+	table->mask = size - 1;
+	table->slots = new atomic<uint32_t>[size];
+	for (uint32_t i = 0; i < size; i++)
+	{
+		table->slots[i].store(0, memory_order_relaxed);
+	}
+
+	const uint32_t count = _size.load(memory_order_relaxed);
+	for (uint32_t symbol = 0; symbol < count; symbol++)
+	{
+		uint32_t slot = EntryOf(symbol).hash & table->mask;
+		while (table->slots[slot].load(memory_order_relaxed) != 0)
+		{
+			slot = (slot + 1) & table->mask;
+		}
+		table->slots[slot].store(symbol + 1, memory_order_relaxed);
+	}
+	_tables.push_back(table);
+	return table;
+}
+
+uint32_t ActionSymbols::Intern(const string& name)
+{
+	const uint32_t hash = Hash(name.data(), name.size());
+	uint32_t symbol = Probe(name.data(), name.size(), hash);
+	if (symbol != ACTION_SYMBOL_NONE)
+	{
+		return symbol;
+	}
+
+	lock_guard<mutex> guard(_lock);
+	// another thread may have interned the name while this one waited
+	symbol = Probe(name.data(), name.size(), hash);
+	if (symbol != ACTION_SYMBOL_NONE)
+	{
+		return symbol;
+	}
+
+	symbol = _size.load(memory_order_relaxed);
+	if (symbol == ACTION_SYMBOL_BLOCK * ACTION_SYMBOL_BLOCKS)
+	{
+		throw out_of_range("The action symbol table is full");
+	}
+
+	// the characters and the entry are in place before any table can hand out the symbol
+	if (_charNext == nullptr || name.size() > _charFree)
+	{
+		const size_t size = max(name.size(), ACTION_CHAR_BLOCK);
+		_chars.push_back(new char[size]);
+		_charNext = _chars.back();
+		_charFree = size;
+	}
+	memcpy(_charNext, name.data(), name.size());
+
+	if (symbol % ACTION_SYMBOL_BLOCK == 0)
+	{
+		_entries[symbol / ACTION_SYMBOL_BLOCK].store(new Entry[ACTION_SYMBOL_BLOCK], memory_order_release);
+	}
+	Entry& entry = _entries[symbol / ACTION_SYMBOL_BLOCK].load(memory_order_relaxed)[symbol % ACTION_SYMBOL_BLOCK];
+	entry.name = _charNext;
+	entry.length = static_cast<uint32_t>(name.size());
+	entry.hash = hash;
+	_charNext += name.size();
+	_charFree -= name.size();
+	_size.store(symbol + 1, memory_order_release);
+
+	// tables stay at most half full, a full one is replaced rather than changed under readers
+	Table* table = _table.load(memory_order_relaxed);
+	if ((symbol + 1) * 2 > table->mask + 1)
+	{
+		_table.store(Build((table->mask + 1) * 2), memory_order_release);
+	}
+	else
+	{
+		uint32_t slot = hash & table->mask;
+		while (table->slots[slot].load(memory_order_relaxed) != 0)
+		{
+			slot = (slot + 1) & table->mask;
+		}
+		table->slots[slot].store(symbol + 1, memory_order_release);
+	}
+	return symbol;
+}
+
+uint32_t ActionSymbols::Find(const string& name) const
+{
+	return Probe(name.data(), name.size(), Hash(name.data(), name.size()));
+}
+
+string ActionSymbols::GetName(uint32_t symbol) const
+{
+	const Entry& entry = EntryOf(symbol);
+	return string(entry.name, entry.length);
+}
+
+const char* ActionSymbols::GetData(uint32_t symbol) const
+{
+	return EntryOf(symbol).name;
+}
+
+uint32_t ActionSymbols::GetLength(uint32_t symbol) const
+{
+	return EntryOf(symbol).length;
+}
+
+void ActionSymbols::Print(ostream& out, uint32_t symbol) const
+{
+	const Entry& entry = EntryOf(symbol);
+	out.write(entry.name, entry.length);
+}
+
+uint32_t ActionSymbols::Size() const
+{
+	return _size.load(memory_order_acquire);
+}
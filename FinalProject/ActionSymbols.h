@@ -0,0 +1,183 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+/**
+ * @file ActionSymbols.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the ActionSymbols class, the table that
+ * turns action names into symbols: dense integers handed out from 0 in the order names are
+ * first interned. ActionTrees hold and compare symbols instead of strings, and a name is only
+ * looked at again when it is printed.
+ *
+ * Names are interned once, when moves are loaded, behind a mutex. Looking a name up, and
+ * turning a symbol back into its name, take no lock at all, so any number of threads can read
+ * while another interns. The names sit in an open addressing hash table of symbols that is
+ * never changed in place: a slot goes from empty to its symbol once, and a table that gets
+ * too full is replaced by a larger copy, the old one kept alive for readers still probing it
+ * until the symbol table itself goes away. Entries and name characters live in blocks that
+ * never move, so a symbol read from a slot always finds its entry whole.
+ *
+ * The global table is made with the default moves of every ActionTree already interned, in
+ * alphabetical order, as symbols 0 to ACTION_DEFAULT_COUNT - 1, so their symbols sort the
+ * way their names do whatever else is interned before the first tree is built.
+ *
+ * Properties:
+ * -----------
+ * > _table: atomic<Table*> - The hash table readers probe.
+ * > _tables: vector<Table*> - Every table made so far, the current one last.
+ * > _entries: atomic<Entry*>[] - The blocks of entries, ACTION_SYMBOL_BLOCK symbols each.
+ * > _size: atomic<uint32_t> - The number of symbols.
+ * > _chars: vector<char*> - The blocks of name characters.
+ * > _charNext, _charFree: Where the next name goes in the last block, and the room left there.
+ * > _lock: mutex - Taken by Intern() when a name is new.
+ *
+ * Methods:
+ * --------
+ * > Global(): ActionSymbols& - The table shared by every ActionTree.
+ * > Intern(name): uint32_t - The symbol of a name, made if the name is new.
+ * > Find(name): uint32_t - The symbol of a name, ACTION_SYMBOL_NONE if it was never interned.
+ * > GetName(symbol): string - The name of a symbol.
+ * > GetData(symbol), GetLength(symbol) - The characters of the name of a symbol, without copying them.
+ * > Print(out, symbol) - Writes the name of a symbol.
+ * > Size(): uint32_t - The number of symbols.
+ */
+class ActionSymbols
+{
+public:
+	static const uint32_t ACTION_SYMBOL_NONE = 0xFFFFFFFFu;
+	static const uint32_t ACTION_SYMBOL_BLOCK = 4096;
+	static const uint32_t ACTION_SYMBOL_BLOCKS = 1024;
+	static const uint32_t ACTION_TABLE_MIN_SIZE = 64;
+	static const size_t ACTION_CHAR_BLOCK = 65536;
+	static const uint32_t ACTION_DEFAULT_COUNT = 4;
+	static const char* const ACTION_DEFAULT_NAMES[ACTION_DEFAULT_COUNT];
+
+private:
+	/**
+	 * @brief The name of a symbol and its hash.
+	*/
+	struct Entry
+	{
+		const char* name;
+		uint32_t length;
+		uint32_t hash;
+	};
+
+	/**
+	 * @brief A hash table of symbols, plus one, 0 marking an empty slot.
+	*/
+	struct Table
+	{
+		uint32_t mask;
+		std::atomic<uint32_t>* slots;
+	};
+
+	std::atomic<Table*> _table;
+	std::vector<Table*> _tables;
+	std::atomic<Entry*> _entries[ACTION_SYMBOL_BLOCKS];
+	std::atomic<uint32_t> _size;
+	std::vector<char*> _chars;
+	char* _charNext;
+	size_t _charFree;
+	std::mutex _lock;
+
+	/**
+	 * @brief Hashes a name, FNV-1a folded to 32 bits.
+	*/
+	static uint32_t Hash(const char* name, size_t length);
+
+	/**
+	 * @brief Gets the entry of a symbol.
+	*/
+	const Entry& EntryOf(uint32_t symbol) const;
+
+	/**
+	 * @brief Probes the current table for a name, without locking.
+	*/
+	uint32_t Probe(const char* name, size_t length, uint32_t hash) const;
+
+	/**
+	 * @brief Makes a table of a size and puts every symbol in it.
+	*/
+	Table* Build(uint32_t size);
+
+	/**
+	 * @brief Creates a symbol table with some names interned in order.
+	*/
+	ActionSymbols(const char* const* names, uint32_t count);
+
+public:
+	/**
+	 * @brief Creates an empty symbol table.
+	*/
+	ActionSymbols();
+
+	ActionSymbols(const ActionSymbols&) = delete;
+	ActionSymbols& operator=(const ActionSymbols&) = delete;
+
+	/**
+	 * @brief Frees the tables, entries and names.
+	*/
+	~ActionSymbols();
+
+	/**
+	 * @brief Getter for the symbol table shared by every ActionTree, made on first use with
+	 * the default moves interned first.
+	 * @return a reference to the table.
+	*/
+	static ActionSymbols& Global();
+
+	/**
+	 * @brief Gets the symbol of a name, giving the name the next symbol if it is new. Only new
+	 * names take the lock.
+	 * @param name - the action name.
+	 * @return the symbol of the name.
+	*/
+	uint32_t Intern(const std::string& name);
+
+	/**
+	 * @brief Looks up the symbol of a name without locking.
+	 * @param name - the action name.
+	 * @return the symbol of the name, ACTION_SYMBOL_NONE if it was never interned.
+	*/
+	uint32_t Find(const std::string& name) const;
+
+	/**
+	 * @brief Turns a symbol back into its name.
+	 * @param symbol - a symbol handed out by this table.
+	 * @return a copy of the name.
+	*/
+	std::string GetName(uint32_t symbol) const;
+
+	/**
+	 * @brief Getter for the characters of the name of a symbol, which never move.
+	 * @param symbol - a symbol handed out by this table.
+	 * @return a pointer to the characters, not terminated, GetLength(symbol) of them.
+	*/
+	const char* GetData(uint32_t symbol) const;
+
+	/**
+	 * @brief Getter for the length of the name of a symbol.
+	 * @param symbol - a symbol handed out by this table.
+	 * @return the number of characters in the name.
+	*/
+	uint32_t GetLength(uint32_t symbol) const;
+
+	/**
+	 * @brief Writes the name of a symbol without copying it.
+	 * @param out - the stream to write to.
+	 * @param symbol - a symbol handed out by this table.
+	*/
+	void Print(std::ostream& out, uint32_t symbol) const;
+
+	/**
+	 * @brief Getter for the number of symbols.
+	 * @return the number of names interned so far.
+	*/
+	uint32_t Size() const;
+};
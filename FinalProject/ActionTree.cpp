@@ -1,238 +1,881 @@
 #include "ActionTree.h"
+#include <algorithm>
+#include <stdexcept>
 #include <iostream>
+#include <thread>
 
 using namespace std;
+
+namespace
+{
+	/**
+	 * @brief Looks up the default moves on first use. The global symbol table interns them
+	 * before anything else, in alphabetical order, so their symbols sort the way their names do.
+	*/
+	const uint32_t* DefaultMoves()
+	{
+		static const uint32_t moves[ActionSymbols::ACTION_DEFAULT_COUNT] = {
+			ActionSymbols::Global().Find(ActionSymbols::ACTION_DEFAULT_NAMES[0]),
+			ActionSymbols::Global().Find(ActionSymbols::ACTION_DEFAULT_NAMES[1]),
+			ActionSymbols::Global().Find(ActionSymbols::ACTION_DEFAULT_NAMES[2]),
+			ActionSymbols::Global().Find(ActionSymbols::ACTION_DEFAULT_NAMES[3])
+		};
+		return moves;
+	}
+
+	bool BySymbol(const ActionTree::Move& one, const ActionTree::Move& other)
+	{
+		return one.symbol < other.symbol;
+	}
+
+	/**
+	 * @brief Sorts a catalog by symbol, keeping equal actions in order. Large catalogs are cut
+	 * into one slice per thread, and the sorted slices merged in pairs, each pair on its own thread.
+	*/
+	void SortMoves(vector<ActionTree::Move>& moves)
+	{
+		if (is_sorted(moves.begin(), moves.end(), BySymbol))
+		{
+			return;
+		}
+		const size_t hardware = max(1u, thread::hardware_concurrency());
+		const size_t workers = max<size_t>(1, min(hardware, moves.size() / ActionTree::ACTION_PARALLEL_MOVES));
+		if (workers == 1)
+		{
+			stable_sort(moves.begin(), moves.end(), BySymbol);
+			return;
+		}
+
+		vector<vector<ActionTree::Move>::iterator> bounds;
+		for (size_t w = 0; w <= workers; w++)
+		{
+			bounds.push_back(moves.begin() + moves.size() * w / workers);
+		}
+		vector<thread> threads;
+		for (size_t w = 0; w < workers; w++)
+		{
+			threads.emplace_back([&bounds, w]() { stable_sort(bounds[w], bounds[w + 1], BySymbol); });
+		}
+		for (auto& worker : threads)
+		{
+			worker.join();
+		}
+
+		for (size_t width = 1; width < workers; width *= 2)
+		{
+			threads.clear();
+			for (size_t w = 0; w + width < workers; w += 2 * width)
+			{
+				const size_t end = min(w + 2 * width, workers);
+				threads.emplace_back([&bounds, w, width, end]() { inplace_merge(bounds[w], bounds[w + width], bounds[end], BySymbol); });
+			}
+			for (auto& worker : threads)
+			{
+				worker.join();
+			}
+		}
+	}
+}
+
+const uint32_t ActionTree::ACTION_TREE_NONE;
+const int ActionTree::ACTION_DEFAULT_DAMAGE;
+const size_t ActionTree::ACTION_PARALLEL_MOVES;
+
 ActionTree::ActionTree()
 {
-	string action0 = "Hammer Swing";
-	string action1 = "Head Butt";
-	string action2 = "Jab Punch";
-	string action3 = "Uppercut Punch";
-	Node* root = new Node(action0);
-	Node* left = new Node(action1);
-	Node* right = new Node(action2);
-	Node* right2 = new Node(action3);
-
-	root->SetParent(nullptr);
-	root->SetLeft(left);
-	root->SetRight(right);
-	root->GetLeft()->SetParent(root);
-	root->GetRight()->SetParent(root);
-	root->GetRight()->SetRight(right2);
-
-	_root = root;
-	_current = root;
-	_current->SetParent(nullptr);
-	_size = 1;
+	_root = ACTION_TREE_NONE;
+	_current = ACTION_TREE_NONE;
+	_size = 0;
 	_maxSize = 20;
 	_isFull = false;
-	_damage = 14;
+	_balanced = true;
+	_statistics = false;
+	_version = 0;
+	_combo.total = 0;
+	_combo.version = 0;
+
+	// the default moves add up to 14 damage an attack
+	const uint32_t* moves = DefaultMoves();
+	InsertNode(moves[0], 4);
+	InsertNode(moves[1], 3);
+	InsertNode(moves[2], 3);
+	InsertNode(moves[3], 4);
+	_current = _root;
+}
+
+ActionTree::ActionTree(ActionTreeBalance balance)
+{
+	_root = ACTION_TREE_NONE;
+	_current = ACTION_TREE_NONE;
+	_size = 0;
+	_maxSize = 20;
+	_isFull = false;
+	_balanced = balance == ACTION_TREE_RED_BLACK;
+	_statistics = false;
+	_version = 0;
+	_combo.total = 0;
+	_combo.version = 0;
+}
+
+ActionTree::ActionTree(const ActionTree& other)
+	: _nodes(other._nodes), _subtrees(other._subtrees)
+{
+	_root = other._root;
+	_current = other._current;
+	_size = other._size;
+	_maxSize = other._maxSize;
+	_isFull = other._isFull;
+	_balanced = other._balanced;
+	_statistics = other._statistics;
+	_version = other._version;
+	_combo = other._combo;
 }
 
 ActionTree::~ActionTree()
 {
-	delete _root;
-}
-
-void ActionTree::InsertNode(Node* node)
-{
-    if (_root == nullptr)
-    {
-        _root = node;
-        _current = node;
-        _size++;
-        return;
-    }
-    
-    Node* current = _root;
-    while (true)
-    {
-        if (node->GetAction() < current->GetAction())
-        {
-            if (current->GetLeft() == nullptr)
-            {
-                current->SetLeft(node);
-                node->SetParent(current);
-                _size++;
-                return;
-            }
-            else
-            {
-                current = current->GetLeft();
-            }
-        }
-        else
-        {
-            if (current->GetRight() == nullptr)
-            {
-                current->SetRight(node);
-                node->SetParent(current);
-                _size++;
-                return;
-            }
-            else
-            {
-                current = current->GetRight();
-            }
-        }
-    }
-}
-
-void ActionTree::Delete(Node* node)
-{
-    if (node == nullptr)
-    {
-        return;
-    }
-    
-    Node* parent = node->GetParent();
-    Node* leftChild = node->GetLeft();
-    Node* rightChild = node->GetRight();
-    
-    // If Node has no children
-    if (leftChild == nullptr && rightChild == nullptr)
-    {
-        if (parent == nullptr)
-        {
-            _root = nullptr;
-        }
-        else if (parent->GetLeft() == node)
-        {
-            parent->SetLeft(nullptr);
-        }
-        else
-        {
-            parent->SetRight(nullptr);
-        }
-        
-        delete node;
-        _size--;
-    }
-    
-    // If Node has one child
-    else if (leftChild == nullptr || rightChild == nullptr)
-    {
-        Node* child = (leftChild != nullptr) ? leftChild : rightChild;
-        
-        if (parent == nullptr)
-        {
-            _root = child;
-            child->SetParent(nullptr);
-        }
-        else if (parent->GetLeft() == node)
-        {
-            parent->SetLeft(child);
-            child->SetParent(parent);
-        }
-        else
-        {
-            parent->SetRight(child);
-            child->SetParent(parent);
-        }
-        
-        delete node;
-        _size--;
-    }
-    
-    // If Node has two children
-    else
-    {
-        Node* successor = GetSuccessor(node);
-        Node* successorParent = successor->GetParent();
-        Node* successorRightChild = successor->GetRight();
-        
-        if (successorParent->GetLeft() == successor)
-        {
-            successorParent->SetLeft(successorRightChild);
-        }
-        else
-        {
-            successorParent->SetRight(successorRightChild);
-        }
-        
-        if (successorRightChild != nullptr)
-        {
-            successorRightChild->SetParent(successorParent);
-        }
-        
-        node->SetAction(successor->GetAction());
-        
-        delete successor;
-        _size--;
-    }
+	// the arena frees the nodes with its blocks
+}
+
+Node& ActionTree::At(uint32_t index)
+{
+	return _nodes.At(index);
+}
+
+const Node& ActionTree::At(uint32_t index) const
+{
+	return _nodes.At(index);
+}
+
+Node* ActionTree::ToNode(uint32_t index) const
+{
+	return (index == ACTION_TREE_NONE) ? nullptr : const_cast<Node*>(&_nodes.At(index));
+}
+
+uint32_t ActionTree::IndexOf(const Node* node) const
+{
+	if (node->_parent == ACTION_TREE_NONE)
+	{
+		return _root;
+	}
+	const Node& parent = At(node->_parent);
+	return (parent._left != ACTION_TREE_NONE && &At(parent._left) == node) ? parent._left : parent._right;
+}
+
+uint32_t ActionTree::CountOf(uint32_t node) const
+{
+	return (node == ACTION_TREE_NONE) ? 0 : _subtrees[node].count;
+}
+
+uint64_t ActionTree::WeightOf(uint32_t node) const
+{
+	return (node == ACTION_TREE_NONE) ? 0 : _subtrees[node].weight;
+}
+
+void ActionTree::Pull(uint32_t node)
+{
+	const Node& at = At(node);
+	_subtrees[node].count = CountOf(at._left) + CountOf(at._right) + 1;
+	_subtrees[node].weight = WeightOf(at._left) + WeightOf(at._right) + at._damage;
+}
+
+void ActionTree::RequireStatistics() const
+{
+	if (!_statistics)
+	{
+		throw runtime_error("Order statistics are off for this ActionTree");
+	}
+}
+
+bool ActionTree::IsRed(uint32_t node) const
+{
+	return node != ACTION_TREE_NONE && At(node)._red;
+}
+
+void ActionTree::RotateLeft(uint32_t node)
+{
+	const uint32_t child = At(node)._right;
+	const uint32_t inner = At(child)._left;
+	At(node)._right = inner;
+	if (inner != ACTION_TREE_NONE)
+	{
+		At(inner)._parent = node;
+	}
+	Transplant(node, child);
+	At(child)._left = node;
+	At(node)._parent = child;
+
+	// the child now heads what the node headed, the node is recounted under it
+	if (_statistics)
+	{
+		_subtrees[child] = _subtrees[node];
+		Pull(node);
+	}
+}
+
+void ActionTree::RotateRight(uint32_t node)
+{
+	const uint32_t child = At(node)._left;
+	const uint32_t inner = At(child)._right;
+	At(node)._left = inner;
+	if (inner != ACTION_TREE_NONE)
+	{
+		At(inner)._parent = node;
+	}
+	Transplant(node, child);
+	At(child)._right = node;
+	At(node)._parent = child;
+
+	if (_statistics)
+	{
+		_subtrees[child] = _subtrees[node];
+		Pull(node);
+	}
+}
+
+void ActionTree::Transplant(uint32_t node, uint32_t replacement)
+{
+	const uint32_t parent = At(node)._parent;
+	if (parent == ACTION_TREE_NONE)
+	{
+		_root = replacement;
+	}
+	else if (At(parent)._left == node)
+	{
+		At(parent)._left = replacement;
+	}
+	else
+	{
+		At(parent)._right = replacement;
+	}
+	if (replacement != ACTION_TREE_NONE)
+	{
+		At(replacement)._parent = parent;
+	}
+}
+
+Node* ActionTree::InsertNode(const string& action, int damage)
+{
+	return InsertNode(ActionSymbols::Global().Intern(action), damage);
+}
+
+Node* ActionTree::InsertNode(uint32_t symbol, int damage)
+{
+	if (damage < 0 || damage > UINT16_MAX)
+	{
+		throw out_of_range("Action damage must be from 0 to 65535");
+	}
+
+	const uint32_t index = _nodes.Allocate();
+	Node& node = At(index);
+	node._symbol = symbol;
+	node._damage = static_cast<uint16_t>(damage);
+	node._left = ACTION_TREE_NONE;
+	node._right = ACTION_TREE_NONE;
+	node._parent = ACTION_TREE_NONE;
+	node._red = _balanced;
+	_size++;
+	_version++;
+	if (_statistics)
+	{
+		if (index >= _subtrees.size())
+		{
+			_subtrees.resize(index + 1);
+		}
+		_subtrees[index].count = 1;
+		_subtrees[index].weight = node._damage;
+	}
+
+	if (_root == ACTION_TREE_NONE)
+	{
+		_root = index;
+		_current = index;
+		node._red = false;
+		return &node;
+	}
+
+	uint32_t current = _root;
+	bool left;
+	while (true)
+	{
+		left = symbol < At(current)._symbol;
+		const uint32_t next = left ? At(current)._left : At(current)._right;
+		if (next == ACTION_TREE_NONE)
+		{
+			break;
+		}
+		current = next;
+	}
+
+	node._parent = current;
+	if (left)
+	{
+		At(current)._left = index;
+	}
+	else
+	{
+		At(current)._right = index;
+	}
+	if (_statistics)
+	{
+		for (uint32_t above = current; above != ACTION_TREE_NONE; above = At(above)._parent)
+		{
+			_subtrees[above].count++;
+			_subtrees[above].weight += node._damage;
+		}
+	}
+
+	if (_balanced)
+	{
+		InsertFixup(index);
+	}
+	return &node;
+}
+
+void ActionTree::InsertFixup(uint32_t node)
+{
+	while (IsRed(At(node)._parent))
+	{
+		uint32_t parent = At(node)._parent;
+		const uint32_t grandparent = At(parent)._parent;
+		const bool leftSide = parent == At(grandparent)._left;
+		const uint32_t uncle = leftSide ? At(grandparent)._right : At(grandparent)._left;
+
+		// a red uncle only needs recolouring, and the problem moves two levels up
+		if (IsRed(uncle))
+		{
+			At(parent)._red = false;
+			At(uncle)._red = false;
+			At(grandparent)._red = true;
+			node = grandparent;
+			continue;
+		}
+
+		// a black uncle takes one or two rotations and ends the walk
+		if (leftSide)
+		{
+			if (node == At(parent)._right)
+			{
+				node = parent;
+				RotateLeft(node);
+				parent = At(node)._parent;
+			}
+			At(parent)._red = false;
+			At(grandparent)._red = true;
+			RotateRight(grandparent);
+		}
+		else
+		{
+			if (node == At(parent)._left)
+			{
+				node = parent;
+				RotateRight(node);
+				parent = At(node)._parent;
+			}
+			At(parent)._red = false;
+			At(grandparent)._red = true;
+			RotateLeft(grandparent);
+		}
+	}
+	At(_root)._red = false;
+}
+
+void ActionTree::Delete(Node* target)
+{
+	if (target == nullptr)
+	{
+		return;
+	}
+
+	// the node is unlinked rather than overwritten, so pointers to other nodes stay valid
+	const uint32_t node = IndexOf(target);
+	bool removedRed = At(node)._red;
+	uint32_t replacement;
+	uint32_t replacementParent;
+	if (At(node)._left == ACTION_TREE_NONE)
+	{
+		replacement = At(node)._right;
+		replacementParent = At(node)._parent;
+		Transplant(node, replacement);
+	}
+	else if (At(node)._right == ACTION_TREE_NONE)
+	{
+		replacement = At(node)._left;
+		replacementParent = At(node)._parent;
+		Transplant(node, replacement);
+	}
+	else
+	{
+		// the successor takes the place and colour of the node, its own place is what shrinks
+		const uint32_t successor = Successor(node);
+		removedRed = At(successor)._red;
+		replacement = At(successor)._right;
+		if (At(successor)._parent == node)
+		{
+			replacementParent = successor;
+		}
+		else
+		{
+			replacementParent = At(successor)._parent;
+			Transplant(successor, replacement);
+			At(successor)._right = At(node)._right;
+			At(At(successor)._right)._parent = successor;
+		}
+		Transplant(node, successor);
+		At(successor)._left = At(node)._left;
+		At(At(successor)._left)._parent = successor;
+		At(successor)._red = At(node)._red;
+	}
+
+	if (_current == node)
+	{
+		_current = _root;
+	}
+	_nodes.Release(node);
+	_size--;
+	_version++;
+
+	// everything that changed shape hangs above the place that shrank
+	if (_statistics)
+	{
+		for (uint32_t above = replacementParent; above != ACTION_TREE_NONE; above = At(above)._parent)
+		{
+			Pull(above);
+		}
+	}
+
+	if (_balanced && !removedRed)
+	{
+		DeleteFixup(replacement, replacementParent);
+	}
+}
+
+void ActionTree::BulkLoad(vector<Move> moves)
+{
+	for (const Move& move : moves)
+	{
+		if (move.damage < 0 || move.damage > UINT16_MAX)
+		{
+			throw out_of_range("Action damage must be from 0 to 65535");
+		}
+	}
+	if (moves.size() >= ACTION_TREE_NONE)
+	{
+		throw out_of_range("An ActionTree holds fewer than 4294967295 moves");
+	}
+	SortMoves(moves);
+
+	const uint32_t count = static_cast<uint32_t>(moves.size());
+	_nodes.Clear();
+	for (uint32_t i = 0; i < count; i++)
+	{
+		_nodes.Allocate();
+	}
+	vector<uint64_t> before;
+	if (_statistics)
+	{
+		_subtrees.assign(count, Subtree());
+		before.assign(count + 1, 0);
+		for (uint32_t i = 0; i < count; i++)
+		{
+			before[i + 1] = before[i] + moves[i].damage;
+		}
+	}
+
+	// every level above the last is full, so only the nodes on the last level have to be red
+	uint32_t fullLevels = 0;
+	while ((static_cast<uint64_t>(1) << (fullLevels + 1)) <= static_cast<uint64_t>(count) + 1)
+	{
+		fullLevels++;
+	}
+
+	// the middle move of each span heads it, the spans either side of it become its subtrees
+	struct Span
+	{
+		uint32_t low;
+		uint32_t high;
+		uint32_t parent;
+		uint32_t depth;
+	};
+	vector<Span> spans;
+	if (count > 0)
+	{
+		spans.push_back(Span{ 0, count, ACTION_TREE_NONE, 0 });
+	}
+	_root = ACTION_TREE_NONE;
+	while (!spans.empty())
+	{
+		const Span span = spans.back();
+		spans.pop_back();
+		const uint32_t middle = span.low + (span.high - span.low) / 2;
+		Node& node = At(middle);
+		node._symbol = moves[middle].symbol;
+		node._damage = static_cast<uint16_t>(moves[middle].damage);
+		node._parent = span.parent;
+		node._left = ACTION_TREE_NONE;
+		node._right = ACTION_TREE_NONE;
+		node._red = _balanced && span.depth >= fullLevels;
+		if (span.parent == ACTION_TREE_NONE)
+		{
+			_root = middle;
+		}
+		else if (middle < span.parent)
+		{
+			At(span.parent)._left = middle;
+		}
+		else
+		{
+			At(span.parent)._right = middle;
+		}
+		if (_statistics)
+		{
+			_subtrees[middle].count = span.high - span.low;
+			_subtrees[middle].weight = before[span.high] - before[span.low];
+		}
+
+		if (span.low < middle)
+		{
+			spans.push_back(Span{ span.low, middle, middle, span.depth + 1 });
+		}
+		if (middle + 1 < span.high)
+		{
+			spans.push_back(Span{ middle + 1, span.high, middle, span.depth + 1 });
+		}
+	}
+
+	_current = _root;
+	_size = static_cast<int>(count);
+	_version++;
+}
+
+void ActionTree::DeleteFixup(uint32_t node, uint32_t parent)
+{
+	// the path through node is one black short, fixed by recolouring upwards or rotating
+	while (node != _root && !IsRed(node))
+	{
+		if (node == At(parent)._left)
+		{
+			uint32_t sibling = At(parent)._right;
+			if (IsRed(sibling))
+			{
+				At(sibling)._red = false;
+				At(parent)._red = true;
+				RotateLeft(parent);
+				sibling = At(parent)._right;
+			}
+			if (!IsRed(At(sibling)._left) && !IsRed(At(sibling)._right))
+			{
+				At(sibling)._red = true;
+				node = parent;
+				parent = At(node)._parent;
+				continue;
+			}
+			if (!IsRed(At(sibling)._right))
+			{
+				At(At(sibling)._left)._red = false;
+				At(sibling)._red = true;
+				RotateRight(sibling);
+				sibling = At(parent)._right;
+			}
+			At(sibling)._red = At(parent)._red;
+			At(parent)._red = false;
+			At(At(sibling)._right)._red = false;
+			RotateLeft(parent);
+		}
+		else
+		{
+			uint32_t sibling = At(parent)._left;
+			if (IsRed(sibling))
+			{
+				At(sibling)._red = false;
+				At(parent)._red = true;
+				RotateRight(parent);
+				sibling = At(parent)._left;
+			}
+			if (!IsRed(At(sibling)._left) && !IsRed(At(sibling)._right))
+			{
+				At(sibling)._red = true;
+				node = parent;
+				parent = At(node)._parent;
+				continue;
+			}
+			if (!IsRed(At(sibling)._left))
+			{
+				At(At(sibling)._right)._red = false;
+				At(sibling)._red = true;
+				RotateLeft(sibling);
+				sibling = At(parent)._left;
+			}
+			At(sibling)._red = At(parent)._red;
+			At(parent)._red = false;
+			At(At(sibling)._left)._red = false;
+			RotateRight(parent);
+		}
+		node = _root;
+	}
+	if (node != ACTION_TREE_NONE)
+	{
+		At(node)._red = false;
+	}
+}
+
+uint32_t ActionTree::Successor(uint32_t node) const
+{
+	if (At(node)._right != ACTION_TREE_NONE)
+	{
+		uint32_t current = At(node)._right;
+		while (At(current)._left != ACTION_TREE_NONE)
+		{
+			current = At(current)._left;
+		}
+		return current;
+	}
+
+	// without a right subtree the successor is the first ancestor reached from the left
+	uint32_t current = node;
+	while (At(current)._parent != ACTION_TREE_NONE && At(At(current)._parent)._right == current)
+	{
+		current = At(current)._parent;
+	}
+	return At(current)._parent;
 }
 
 Node* ActionTree::GetSuccessor(Node* node)
 {
-    Node* current = node->GetRight();
-    
-    while (current->GetLeft() != nullptr)
-    {
-        current = current->GetLeft();
-    }
-    
-    return current;
+	return ToNode(Successor(IndexOf(node)));
+}
+
+Node* ActionTree::Find(const string& action) const
+{
+	// a name that was never interned is in no tree
+	const uint32_t symbol = ActionSymbols::Global().Find(action);
+	return (symbol == ActionSymbols::ACTION_SYMBOL_NONE) ? nullptr : Find(symbol);
+}
+
+Node* ActionTree::Find(uint32_t symbol) const
+{
+	uint32_t found = ACTION_TREE_NONE;
+	uint32_t current = _root;
+	while (current != ACTION_TREE_NONE)
+	{
+		if (symbol > At(current)._symbol)
+		{
+			current = At(current)._right;
+		}
+		else
+		{
+			// equal actions may sit further left, keep going for the first in order
+			if (symbol == At(current)._symbol)
+			{
+				found = current;
+			}
+			current = At(current)._left;
+		}
+	}
+	return ToNode(found);
+}
+
+int ActionTree::GetHeight() const
+{
+	int height = 0;
+	vector<uint32_t> level, next;
+	if (_root != ACTION_TREE_NONE)
+	{
+		level.push_back(_root);
+	}
+	while (!level.empty())
+	{
+		height++;
+		next.clear();
+		for (uint32_t node : level)
+		{
+			if (At(node)._left != ACTION_TREE_NONE)
+			{
+				next.push_back(At(node)._left);
+			}
+			if (At(node)._right != ACTION_TREE_NONE)
+			{
+				next.push_back(At(node)._right);
+			}
+		}
+		level.swap(next);
+	}
+	return height;
+}
+
+bool ActionTree::IsBalanced() const
+{
+	return _balanced;
+}
+
+uint32_t ActionTree::First(ActionTraversal order, uint32_t top) const
+{
+	if (top == ACTION_TREE_NONE || order == ACTION_PRE_ORDER)
+	{
+		return top;
+	}
+
+	// in order starts at the leftmost node, post order at the first leaf reached leaning left
+	uint32_t node = top;
+	while (true)
+	{
+		if (At(node)._left != ACTION_TREE_NONE)
+		{
+			node = At(node)._left;
+		}
+		else if (order == ACTION_POST_ORDER && At(node)._right != ACTION_TREE_NONE)
+		{
+			node = At(node)._right;
+		}
+		else
+		{
+			return node;
+		}
+	}
+}
+
+uint32_t ActionTree::Next(ActionTraversal order, uint32_t node, uint32_t top) const
+{
+	if (order == ACTION_IN_ORDER)
+	{
+		if (At(node)._right != ACTION_TREE_NONE)
+		{
+			return First(ACTION_IN_ORDER, At(node)._right);
+		}
+		while (node != top && At(At(node)._parent)._right == node)
+		{
+			node = At(node)._parent;
+		}
+		return (node == top) ? ACTION_TREE_NONE : At(node)._parent;
+	}
+
+	if (order == ACTION_PRE_ORDER)
+	{
+		if (At(node)._left != ACTION_TREE_NONE)
+		{
+			return At(node)._left;
+		}
+		if (At(node)._right != ACTION_TREE_NONE)
+		{
+			return At(node)._right;
+		}
+		// climb to the nearest ancestor entered from the left that has a right subtree
+		while (node != top)
+		{
+			const uint32_t parent = At(node)._parent;
+			if (At(parent)._left == node && At(parent)._right != ACTION_TREE_NONE)
+			{
+				return At(parent)._right;
+			}
+			node = parent;
+		}
+		return ACTION_TREE_NONE;
+	}
+
+	// post order: a left child is followed by its sibling's subtree, anything else by its parent
+	if (node == top)
+	{
+		return ACTION_TREE_NONE;
+	}
+	const uint32_t parent = At(node)._parent;
+	if (At(parent)._left == node && At(parent)._right != ACTION_TREE_NONE)
+	{
+		return First(ACTION_POST_ORDER, At(parent)._right);
+	}
+	return parent;
+}
+
+ActionTree::Iterator ActionTree::begin() const
+{
+	return Begin(ACTION_IN_ORDER);
+}
+
+ActionTree::Iterator ActionTree::end() const
+{
+	return Iterator(this, ACTION_TREE_NONE, ACTION_IN_ORDER);
+}
+
+ActionTree::Iterator ActionTree::Begin(ActionTraversal order) const
+{
+	return Iterator(this, First(order, _root), order);
 }
 
 void ActionTree::InOrder(Node* node) const
 {
 	if (node != nullptr)
 	{
-		InOrder(node->GetLeft());
-		cout << "Attacking with: " << endl;
-		node->Print();
-		InOrder(node->GetRight());
+		Visit(ACTION_IN_ORDER, [](const Node& visited)
+		{
+			cout << "Attacking with: \n";
+			visited.Print();
+		}, node);
 	}
 }
 
 void ActionTree::InOrderTraverse() const
 {
-	InOrder(_root);
-    cout << "Damage Dealt: " << _damage << endl;
+	InOrder(GetRoot());
+    cout << "Damage Dealt: " << GetDamage() << '\n';
 }
 
 void ActionTree::PreOrder(Node* node) const
 {
-    if (node != nullptr)
-    {
-        cout << "Attacking with: " << endl;
-        node->Print();
-        PreOrder(node->GetLeft());
-        PreOrder(node->GetRight());
-    }
+	if (node != nullptr)
+	{
+		Visit(ACTION_PRE_ORDER, [](const Node& visited)
+		{
+			cout << "Attacking with: \n";
+			visited.Print();
+		}, node);
+	}
 }
 
 void ActionTree::PreOrderTraverse() const
 {
-	PreOrder(_root);
-    cout << "Damage Dealt: " << _damage << endl;
+	PreOrder(GetRoot());
+    cout << "Damage Dealt: " << GetDamage() << '\n';
 }
 
 void ActionTree::PostOrder(Node* node) const
 {
 	if (node != nullptr)
 	{
-		PostOrder(node->GetLeft());
-		PostOrder(node->GetRight());
-		cout << "Attacking with: " << endl;
-		node->Print();
+		Visit(ACTION_POST_ORDER, [](const Node& visited)
+		{
+			cout << "Attacking with: \n";
+			visited.Print();
+		}, node);
 	}
 }
 
 void ActionTree::PostOrderTraverse() const
 {
-	PostOrder(_root);
-    cout << "Damage Dealt: " << _damage << endl;
+	PostOrder(GetRoot());
+    cout << "Damage Dealt: " << GetDamage() << '\n';
 }
 
 Node* ActionTree::GetRoot() const
 {
-	return _root;
+	return ToNode(_root);
 }
 
 Node* ActionTree::GetCurrent() const
 {
-	return _current;
+	return ToNode(_current);
+}
+
+Node* ActionTree::GetLeft(const Node* node) const
+{
+	return ToNode(node->_left);
+}
+
+Node* ActionTree::GetRight(const Node* node) const
+{
+	return ToNode(node->_right);
+}
+
+Node* ActionTree::GetParent(const Node* node) const
+{
+	return ToNode(node->_parent);
 }
 
 int ActionTree::GetSize() const
@@ -240,84 +883,214 @@ int ActionTree::GetSize() const
 	return _size;
 }
 
- int ActionTree::GetDamage() const
+size_t ActionTree::GetMemoryBytes() const
 {
-	return _damage;
+	return _nodes.GetMemoryBytes() + _subtrees.capacity() * sizeof(Subtree);
 }
 
-void ActionTree::SetDamage(int damage)
+const ActionTree::Combo& ActionTree::GetCombo() const
 {
-	_damage = damage;
+	if (_combo.version != _version)
+	{
+		_combo.moves.clear();
+		_combo.damage.clear();
+		_combo.total = 0;
+		for (uint32_t node = First(ACTION_IN_ORDER, _root); node != ACTION_TREE_NONE; node = Next(ACTION_IN_ORDER, node, _root))
+		{
+			_combo.moves.push_back(At(node)._symbol);
+			_combo.damage.push_back(At(node)._damage);
+			_combo.total += At(node)._damage;
+		}
+		_combo.version = _version;
+	}
+	return _combo;
+}
+
+uint32_t ActionTree::GetVersion() const
+{
+	return _version;
+}
+
+long long ActionTree::GetDamage() const
+{
+	return GetCombo().total;
+}
+
+void ActionTree::SetDamage(Node* node, int damage)
+{
+	if (damage < 0 || damage > UINT16_MAX)
+	{
+		throw out_of_range("Action damage must be from 0 to 65535");
+	}
+	if (_statistics)
+	{
+		const uint64_t old = node->_damage;
+		for (uint32_t above = IndexOf(node); above != ACTION_TREE_NONE; above = At(above)._parent)
+		{
+			_subtrees[above].weight = _subtrees[above].weight - old + damage;
+		}
+	}
+	node->_damage = static_cast<uint16_t>(damage);
+	_version++;
+}
+
+void ActionTree::SetOrderStatistics(bool enabled)
+{
+	_statistics = enabled;
+	if (!enabled)
+	{
+		vector<Subtree>().swap(_subtrees);
+		return;
+	}
+
+	// children come before their parents in post order, so each node is counted from theirs
+	for (uint32_t node = First(ACTION_POST_ORDER, _root); node != ACTION_TREE_NONE; node = Next(ACTION_POST_ORDER, node, _root))
+	{
+		if (node >= _subtrees.size())
+		{
+			_subtrees.resize(node + 1);
+		}
+		Pull(node);
+	}
+}
+
+bool ActionTree::HasOrderStatistics() const
+{
+	return _statistics;
+}
+
+Node* ActionTree::Select(uint32_t k) const
+{
+	RequireStatistics();
+	uint32_t node = _root;
+	while (node != ACTION_TREE_NONE)
+	{
+		const uint32_t before = CountOf(At(node)._left);
+		if (k < before)
+		{
+			node = At(node)._left;
+		}
+		else if (k == before)
+		{
+			break;
+		}
+		else
+		{
+			k -= before + 1;
+			node = At(node)._right;
+		}
+	}
+	return ToNode(node);
+}
+
+uint32_t ActionTree::Rank(const Node* node) const
+{
+	RequireStatistics();
+	uint32_t current = IndexOf(node);
+	uint32_t rank = CountOf(At(current)._left);
+	// every climb from a right child passes the parent and its left subtree
+	while (At(current)._parent != ACTION_TREE_NONE)
+	{
+		const uint32_t parent = At(current)._parent;
+		if (At(parent)._right == current)
+		{
+			rank += CountOf(At(parent)._left) + 1;
+		}
+		current = parent;
+	}
+	return rank;
+}
+
+uint32_t ActionTree::Pick(uint64_t point) const
+{
+	uint32_t node = _root;
+	while (true)
+	{
+		const uint64_t before = WeightOf(At(node)._left);
+		if (point < before)
+		{
+			node = At(node)._left;
+		}
+		else if (point < before + At(node)._damage)
+		{
+			return node;
+		}
+		else
+		{
+			point -= before + At(node)._damage;
+			node = At(node)._right;
+		}
+	}
 }
 
 void ActionTree::SetCurrent(Node* current)
 {
-	_current = current;
+	_current = (current == nullptr) ? ACTION_TREE_NONE : IndexOf(current);
 }
 
-Node::Node()
+ActionTree::Iterator::Iterator(const ActionTree* tree, uint32_t node, ActionTraversal order)
 {
-	_left = nullptr;
-	_right = nullptr;
-	_parent = nullptr;
-	_action = "Wrestle Attack";
+	_tree = tree;
+	_node = node;
+	_order = order;
 }
 
-Node::Node(string& action)
+const Node& ActionTree::Iterator::operator*() const
 {
-	_left = nullptr;
-	_right = nullptr;
-	_parent = nullptr;
-	_action = action;
+	return _tree->At(_node);
 }
 
-Node::~Node()
+const Node* ActionTree::Iterator::operator->() const
 {
-	delete _left;
-	delete _right;
+	return &_tree->At(_node);
 }
 
-string& Node::GetAction()
+ActionTree::Iterator& ActionTree::Iterator::operator++()
 {
-	return _action;
+	_node = _tree->Next(_order, _node, _tree->_root);
+	return *this;
 }
 
-Node* Node::GetLeft() const
+ActionTree::Iterator ActionTree::Iterator::operator++(int)
 {
-	return _left;
+	Iterator before = *this;
+	++*this;
+	return before;
 }
 
-Node* Node::GetRight() const
+bool ActionTree::Iterator::operator==(const Iterator& other) const
 {
-	return _right;
+	return _node == other._node && _tree == other._tree;
 }
 
-Node* Node::GetParent() const
+bool ActionTree::Iterator::operator!=(const Iterator& other) const
 {
-	return _parent;
+	return !(*this == other);
 }
 
-void Node::SetAction(string& action)
+string Node::GetAction() const
 {
-	_action = action;
+	return ActionSymbols::Global().GetName(_symbol);
 }
 
-void Node::SetLeft(Node* left)
+uint32_t Node::GetSymbol() const
 {
-	_left = left;
+	return _symbol;
 }
 
-void Node::SetRight(Node* right)
+int Node::GetDamage() const
 {
-	_right = right;
+	return _damage;
 }
 
-void Node::SetParent(Node* parent)
+bool Node::IsRed() const
 {
-	_parent = parent;
+	return _red;
 }
 
 void Node::Print() const
 {
-	cout << "\t> " << _action << endl;
-}
\ No newline at end of file
+	cout << "\t> ";
+	ActionSymbols::Global().Print(cout, _symbol);
+	cout << '\n';
+}
@@ -1,6 +1,89 @@
 #pragma once
+#include "ActionSymbols.h"
+#include "Arena.h"
+
+#include <cstdint>
+#include <random>
 #include <string>
-class Node;
+#include <vector>
+class ActionTree;
+enum ActionTreeBalance : unsigned char;
+enum ActionTraversal : unsigned char;
+/**
+ * @file ActionTree.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This class represents a node in the ActionTree. It holds the action
+ * and the damage it deals along with the indices of the left, right and parent nodes
+ * in the arena of its tree,
+ * which follows them for it. Nodes are only made by a tree, and stay where they are
+ * until they are deleted from it.
+ *
+ * The action is held as its symbol in ActionSymbols::Global(), so a node is 20 bytes
+ * and comparing against it is comparing two integers. The name is only looked up again
+ * when it is asked for or printed.
+ *
+ * Properties:
+ * -----------
+ * > _left: The index of the left node of the current node
+ * > _right: The index of the right node of the current node
+ * > _parent: The index of the parent node of the current node
+ * > _symbol: The symbol of the action that is to be performed by the character
+ * > _damage: The damage dealt by the action
+ * > _red: The colour of the node in a red-black tree
+ *
+ * Methods:
+ * --------
+ * > GetAction(): std::string - Returns the action
+ * > GetSymbol(): uint32_t - Returns the symbol of the action
+ * > GetDamage(): int - Returns the damage dealt by the action
+ * > IsRed(): bool - Returns the colour of the node
+ * > Print(): void - Prints the action
+ *
+ */
+class Node
+{
+	friend class ActionTree;
+
+private:
+	uint32_t _left;
+	uint32_t _right;
+	uint32_t _parent;
+	uint32_t _symbol;
+	uint16_t _damage;
+	bool _red;
+
+public:
+	/**
+	 * @brief Getter for the action
+	 * @return a string representing the action
+	*/
+	std::string GetAction() const;
+
+	/**
+	 * @brief Getter for the symbol of the action
+	 * @return the symbol of the action in ActionSymbols::Global()
+	*/
+	uint32_t GetSymbol() const;
+
+	/**
+	 * @brief Getter for the damage
+	 * @return an integer representing the damage dealt by the action
+	*/
+	int GetDamage() const;
+
+	/**
+	 * @brief Getter for the colour
+	 * @return a boolean value indicating whether the node is red
+	*/
+	bool IsRed() const;
+
+	/**
+	 * @brief This method is used to print the action
+	*/
+	void Print() const;
+};
+
 /**
  * @file ActionTree.h
  * @author Billy Ndegwah Micah
@@ -9,63 +92,402 @@ class Node;
  * which is a tree structure that holds the actions that are to be performed
  * by the character.
  *
+ * The tree is a binary search tree ordered by action symbol, that is by the order in
+ * which ActionSymbols first saw each name, so every comparison on the way down is an
+ * integer comparison. Names are interned once, when moves are loaded: InsertNode() and
+ * Find() also take symbols, and their string forms intern or look up the name first.
+ * The global symbol table interns the default moves before any other name, in alphabetical
+ * order, so a default tree walks them in the order of their names.
+ *
+ * By default the tree is kept balanced as a red-black tree: every node is red or black,
+ * a red node never has a red child, and every path from a node down to a missing child
+ * crosses the same number of black nodes. InsertNode() and Delete() restore these rules
+ * with at most three rotations and a walk up the recolouring path, so the longest path
+ * is never more than twice the shortest and depth stays O(log n) even when a move
+ * catalog is inserted in sorted order. A plain, unbalanced tree can still be asked for,
+ * to compare against.
+ *
+ * The nodes live in an Arena owned by the tree and link to each other with 32 bit
+ * indices into it, which packs a node and its action into 20 bytes, three to a cache
+ * line, and keeps the nodes of a tree side by side in memory instead of scattered
+ * over the heap. Nothing in a node needs destroying: the tree goes away by freeing
+ * its blocks, without walking its nodes.
+ *
+ * The nodes can be walked in order, pre order or post order without recursion and
+ * without printing, with an Iterator or by handing Visit() a function to call on each
+ * node. Both climb back up along the parent links instead of keeping a stack, so a
+ * walk takes no memory however deep the tree, and leaves the tree untouched.
+ *
+ * An attack runs through every move in order. GetCombo() compiles that walk once into
+ * flat arrays of move ids and damage values and keeps them until InsertNode(), Delete()
+ * or SetDamage() bump the version of the tree, so attacking scans an array instead of
+ * walking the nodes. A move id is the symbol of its action, which ActionSymbols turns
+ * back into the name.
+ *
+ * A whole catalog is better loaded with BulkLoad(), which sorts the moves, across threads
+ * when there are many, and then lays the sorted moves out as a perfectly balanced tree in
+ * O(n): node i of the arena holds the i-th move in order, so the arena is filled front to
+ * back and an in order walk reads it in sequence, and only the bottom, incomplete level is
+ * coloured red. Moves already in order skip the sort.
+ *
+ * A tree can also keep order statistics: the number of nodes and the total damage under
+ * every node, kept in a vector beside the arena so trees without them stay as small.
+ * InsertNode() and SetDamage() add along the path to the root, Delete() recounts the path
+ * it changed and rotations recount the two nodes they swap, all O(log n). With them,
+ * Select() finds the move at a place in order, Rank() the place of a move, and Sample()
+ * draws a move with a chance in proportion to its damage, each in O(log n) instead of a
+ * walk over every node.
+ *
  * Properties:
  * -----------
- * > _root: The root node of the tree
- * > _current: The current node of the tree
+ * > _nodes: The arena the nodes live in
+ * > _subtrees: The node count and damage of the subtree under each node, by node index
+ * > _statistics: Whether the order statistics are kept
+ * > _root: The index of the root node of the tree
+ * > _current: The index of the current node of the tree
  * > _size: The number of nodes in the tree
  * > _maxSize: The maximum number of nodes in the tree
  * > _isFull: A boolean value that indicates whether the tree is full or not
+ * > _balanced: Whether the tree is kept balanced as a red-black tree
+ * > _version: The number of changes made to the moves, bumped by every change
+ * > _combo: The compiled combo, rebuilt when the version moves on
  *
  * Methods:
  * --------
  * > ActionTree(): Constructor
+ * > ActionTree(balance): Creates an empty tree, balanced or plain
+ * > ActionTree(other): Copy constructor
  * > ~ActionTree(): Destructor
- * > Insert(): void - Inserts a new node into the tree
+ * > InsertNode(action or symbol, damage): Node* - Inserts a new node into the tree
  * > Delete(): void - Deletes a node from the tree
- * > Traverse(): void - Traverses the tree
+ * > BulkLoad(moves): void - Replaces the moves with a perfectly balanced tree built from a catalog
+ * > Traverse(): void - Traverses the tree, printing every action
+ * > Visit(order, visit, top): void - Calls a function on every node of a subtree in an order
+ * > begin(), end(), Begin(order): Iterator - Walks the nodes in order, or in another order
  * > GetRoot(): Node* - Returns the root node of the tree
  * > GetCurrent(): Node* - Returns the current node of the tree
  * > SetCurrent(): void - Sets the current node of the tree
+ * > GetLeft(node), GetRight(node), GetParent(node): Node* - Follow the links of a node
  * > GetSize(): int - Returns the number of nodes in the tree
+ * > GetCombo(): const Combo& - Returns the moves of an attack compiled into flat arrays
+ * > GetVersion(): uint32_t - Returns the number of changes made to the moves
+ * > GetDamage(): long long, SetDamage(node, damage) - The damage of an attack and of one move
+ * > Find(action or symbol): Node* - Returns the node holding an action
+ * > GetHeight(): int - Returns the number of nodes on the longest path from the root
+ * > IsBalanced(): bool - Returns whether the tree is kept balanced
+ * > GetMemoryBytes(): size_t - Returns the memory held by the nodes and their statistics
+ * > SetOrderStatistics(enabled), HasOrderStatistics() - Turn the order statistics on or off
+ * > Select(k): Node* - Returns the node at a place in order
+ * > Rank(node): uint32_t - Returns the place of a node in order
+ * > Sample(random): Node* - Returns a node drawn in proportion to its damage
  * 
  */
 class ActionTree
 {
+public:
+	static const uint32_t ACTION_TREE_NONE = Arena<Node>::ARENA_NO_INDEX;
+	static const int ACTION_DEFAULT_DAMAGE = 3;
+	static const size_t ACTION_PARALLEL_MOVES = 65536;
+
+	/**
+	 * @brief The moves of an attack in order, as parallel arrays, and the damage they add up to.
+	*/
+	struct Combo
+	{
+		std::vector<uint32_t> moves;
+		std::vector<int> damage;
+		long long total;
+		uint32_t version;
+	};
+
+	/**
+	 * @brief An interned action and its damage, as BulkLoad() takes them.
+	*/
+	struct Move
+	{
+		uint32_t symbol;
+		int damage;
+	};
+
 private:
-	Node* _root;
-	Node* _current;
+	/**
+	 * @brief The number of nodes under a node, itself included, and the damage they add up to.
+	*/
+	struct Subtree
+	{
+		uint32_t count;
+		uint64_t weight;
+	};
+
+	Arena<Node> _nodes;
+	std::vector<Subtree> _subtrees;
+	bool _statistics;
+	uint32_t _root;
+	uint32_t _current;
 	int _size;
 	int _maxSize;
 	bool _isFull;
-	int _damage;
-	
+	bool _balanced;
+	uint32_t _version;
+	mutable Combo _combo;
+
+	/**
+	 * @brief Gets the node at an index of the arena
+	*/
+	Node& At(uint32_t index);
+
+	/**
+	 * @brief Gets the node at an index of the arena
+	*/
+	const Node& At(uint32_t index) const;
+
+	/**
+	 * @brief Turns an index into a pointer, nullptr for ACTION_TREE_NONE
+	*/
+	Node* ToNode(uint32_t index) const;
+
+	/**
+	 * @brief Finds the index of a node from the link its parent, or the root, holds to it
+	*/
+	uint32_t IndexOf(const Node* node) const;
+
+	/**
+	 * @brief Gets the number of nodes under a node, 0 for a missing one
+	*/
+	uint32_t CountOf(uint32_t node) const;
+
+	/**
+	 * @brief Gets the damage of the nodes under a node, 0 for a missing one
+	*/
+	uint64_t WeightOf(uint32_t node) const;
+
+	/**
+	 * @brief Recounts the subtree of a node from its children
+	*/
+	void Pull(uint32_t node);
+
+	/**
+	 * @brief Throws when the order statistics are off
+	*/
+	void RequireStatistics() const;
+
+	/**
+	 * @brief Finds the node a point of the total damage falls in, counting along the nodes in order
+	*/
+	uint32_t Pick(uint64_t point) const;
+
+	/**
+	 * @brief Checks whether a node is red, missing children count as black
+	*/
+	bool IsRed(uint32_t node) const;
+
+	/**
+	 * @brief Rotates a node down to the left, its right child taking its place
+	*/
+	void RotateLeft(uint32_t node);
+
+	/**
+	 * @brief Rotates a node down to the right, its left child taking its place
+	*/
+	void RotateRight(uint32_t node);
+
+	/**
+	 * @brief Restores the red-black rules after a red node was inserted
+	*/
+	void InsertFixup(uint32_t node);
+
+	/**
+	 * @brief Puts one subtree in the place of another under the other's parent
+	*/
+	void Transplant(uint32_t node, uint32_t replacement);
+
+	/**
+	 * @brief Restores the red-black rules after a black node was taken out
+	 * @param node - the node that took its place, possibly missing
+	 * @param parent - the parent of that place
+	*/
+	void DeleteFixup(uint32_t node, uint32_t parent);
+
+	/**
+	 * @brief Finds the next node in order, ACTION_TREE_NONE after the last
+	*/
+	uint32_t Successor(uint32_t node) const;
+
+	/**
+	 * @brief Finds the first node of a subtree in a traversal order
+	*/
+	uint32_t First(ActionTraversal order, uint32_t top) const;
+
+	/**
+	 * @brief Finds the node after another in a traversal order, ACTION_TREE_NONE once the walk
+	 * would climb out of the subtree under top
+	*/
+	uint32_t Next(ActionTraversal order, uint32_t node, uint32_t top) const;
 
 public:
 	/**
-	 * @brief This is the default constructor
+	 * @brief A forward iterator over the nodes of the tree in one traversal order. It holds
+	 * the tree, the order and a node, so it costs nothing to copy, and moves by following
+	 * links. Deleting the node it is on leaves it dangling, other changes to the tree
+	 * reorder the walk.
+	*/
+	class Iterator
+	{
+	private:
+		const ActionTree* _tree;
+		uint32_t _node;
+		ActionTraversal _order;
+
+	public:
+		/**
+		 * @brief Creates an iterator on a node of a tree
+		 * @param tree - the tree to walk
+		 * @param node - the index of the node, ACTION_TREE_NONE for the end
+		 * @param order - the traversal order
+		*/
+		Iterator(const ActionTree* tree, uint32_t node, ActionTraversal order);
+
+		/**
+		 * @brief Gets the node the iterator is on
+		 * @return a reference to the node
+		*/
+		const Node& operator*() const;
+
+		/**
+		 * @brief Gets the node the iterator is on
+		 * @return a pointer to the node
+		*/
+		const Node* operator->() const;
+
+		/**
+		 * @brief Moves on to the next node in the order
+		 * @return the iterator
+		*/
+		Iterator& operator++();
+
+		/**
+		 * @brief Moves on to the next node in the order
+		 * @return a copy of the iterator before it moved
+		*/
+		Iterator operator++(int);
+
+		/**
+		 * @brief Checks whether two iterators are on the same node
+		*/
+		bool operator==(const Iterator& other) const;
+
+		/**
+		 * @brief Checks whether two iterators are on different nodes
+		*/
+		bool operator!=(const Iterator& other) const;
+	};
+
+	/**
+	 * @brief This is the default constructor, it fills the tree with the default attack moves
 	*/
 	ActionTree();
 
 	/**
-	 * @brief This is the destructor
+	 * @brief Creates an empty tree
+	 * @param balance - whether the tree is kept balanced
+	*/
+	explicit ActionTree(ActionTreeBalance balance);
+
+	/**
+	 * @brief Copies a tree node for node. Every move keeps its place, so the compiled combo of
+	 * the tree carries over as it is.
+	 * @param other - the tree to copy
+	*/
+	ActionTree(const ActionTree& other);
+
+	ActionTree& operator=(const ActionTree&) = delete;
+
+	/**
+	 * @brief This is the destructor, it frees the arena without visiting the nodes
 	*/
 	~ActionTree();
 
 	/**
-	 * @brief This method inserts a new node into the tree
-	 * @param node - the node to be inserted
+	 * @brief This method interns an action and inserts a new node holding it into the tree.
+	 * @param action - the action of the new node
+	 * @param damage - the damage dealt by the action, from 0 to 65535
+	 * @return pointer to the new node, valid until it is deleted
+	*/
+	Node* InsertNode(const std::string& action, int damage = ACTION_DEFAULT_DAMAGE);
+
+	/**
+	 * @brief This method inserts a new node holding an interned action into the tree.
+	 * Equal actions go to the right of each other.
+	 * @param symbol - the symbol of the action in ActionSymbols::Global()
+	 * @param damage - the damage dealt by the action, from 0 to 65535
+	 * @return pointer to the new node, valid until it is deleted
 	*/
-	void InsertNode(Node* node);
+	Node* InsertNode(uint32_t symbol, int damage = ACTION_DEFAULT_DAMAGE);
 
 	/**
-	 * @brief This method deletes a node from the tree
+	 * @brief This method deletes a node from the tree. Other nodes keep their actions and
+	 * pointers to them stay valid.
 	 * @param node - node to be deleted
 	*/
 	void Delete(Node* node);
 
 	/**
-	 * @brief This method performs recurring InOrder traversal of the tree
+	 * @brief Replaces every move of the tree with a catalog, sorting it by symbol with one
+	 * thread per ACTION_PARALLEL_MOVES moves unless it is already sorted, then building a
+	 * perfectly balanced tree from it in O(n), its nodes side by side in the arena in order.
+	 * Equal actions keep their order in the catalog. Nodes of the old tree are freed.
+	 * @param moves - the catalog, each damage from 0 to 65535
+	*/
+	void BulkLoad(std::vector<Move> moves);
+
+	/**
+	 * @brief Replaces every move of the tree with a catalog, see BulkLoad(moves)
+	 * @param first, last - a range of moves, or of anything a Move can be made from
+	*/
+	template <typename MoveIterator>
+	void BulkLoad(MoveIterator first, MoveIterator last)
+	{
+		BulkLoad(std::vector<Move>(first, last));
+	}
+
+	/**
+	 * @brief Calls a function on every node of a subtree, in a traversal order, without
+	 * recursion, without a stack and without any output
+	 * @param order - the traversal order
+	 * @param visit - the function to call, with a const Node&
+	 * @param top - the root of the subtree, nullptr for the whole tree
+	*/
+	template <typename Visitor>
+	void Visit(ActionTraversal order, Visitor visit, const Node* top = nullptr) const
+	{
+		const uint32_t root = (top == nullptr) ? _root : IndexOf(top);
+		for (uint32_t node = First(order, root); node != ACTION_TREE_NONE; node = Next(order, node, root))
+		{
+			visit(At(node));
+		}
+	}
+
+	/**
+	 * @brief Getter for an iterator on the first node in order
+	 * @return an iterator over the nodes in order of action
+	*/
+	Iterator begin() const;
+
+	/**
+	 * @brief Getter for the iterator past the last node, in any order
+	 * @return the end iterator
+	*/
+	Iterator end() const;
+
+	/**
+	 * @brief Getter for an iterator on the first node in a traversal order
+	 * @param order - the traversal order
+	 * @return an iterator over the nodes in that order, ending at end()
+	*/
+	Iterator Begin(ActionTraversal order) const;
+
+	/**
+	 * @brief This method performs InOrder traversal of the tree, printing every action
 	 * @param node - the node to start traversing from
 	*/
 	void InOrder(Node* node) const;
@@ -76,7 +498,7 @@ public:
 	void InOrderTraverse() const;
 
 	/**
-	 * @brief This method performs recurring PreOrder traversal of the tree
+	 * @brief This method performs PreOrder traversal of the tree, printing every action
 	 * @param node - the node to start traversing from
 	*/
 	void PreOrder(Node* node) const;
@@ -87,7 +509,7 @@ public:
 	void PreOrderTraverse() const;
 
 	/**
-	 * @brief This method performs recurring PostOrder traversal of the tree
+	 * @brief This method performs PostOrder traversal of the tree, printing every action
 	 * @param node - the node to start traversing from
 	*/
 	void PostOrder(Node* node) const;
@@ -110,138 +532,179 @@ public:
 	Node* GetCurrent() const;
 
 	/**
-	 * @brief Getter for the successor node
-	 * @param node - the node from which to retrieve the successor node
-	 * @return pointer to the successor node
+	 * @brief Getter for the left child of a node
+	 * @param node - a node of this tree
+	 * @return pointer to the left node, nullptr if there is none
 	*/
-	Node* GetSuccessor(Node* node);
+	Node* GetLeft(const Node* node) const;
 
 	/**
-	 * @brief Getter for the size of the tree
-	 * @return an integer representing the size of the tree
+	 * @brief Getter for the right child of a node
+	 * @param node - a node of this tree
+	 * @return pointer to the right node, nullptr if there is none
 	*/
-	int GetSize() const;
+	Node* GetRight(const Node* node) const;
 
 	/**
-	 * @brief Getter for the damage
-	 * @return an integer representing the damage from attacks
+	 * @brief Getter for the parent of a node
+	 * @param node - a node of this tree
+	 * @return pointer to the parent node, nullptr for the root
 	*/
-	int GetDamage() const;
+	Node* GetParent(const Node* node) const;
 
 	/**
-	 * @brief Setter for the damage value
-	 * @param damage - the desired damage value
+	 * @brief Getter for the successor node
+	 * @param node - the node from which to retrieve the successor node
+	 * @return pointer to the successor node, nullptr for the last node
 	*/
-	void SetDamage(int damage);
+	Node* GetSuccessor(Node* node);
 
 	/**
-	 * @brief Setter for the current node
-	 * @param current - the desired current node
+	 * @brief Looks up the node holding an action, by its symbol if it was ever interned
+	 * @param action - the action to look for
+	 * @return pointer to the first node in order holding the action, nullptr if there is none
 	*/
-	void SetCurrent(Node* current);
-};
+	Node* Find(const std::string& action) const;
 
+	/**
+	 * @brief Looks up the node holding an interned action
+	 * @param symbol - the symbol of the action to look for
+	 * @return pointer to the first node in order holding the action, nullptr if there is none
+	*/
+	Node* Find(uint32_t symbol) const;
 
-/**
- * @file ActionTree.h
- * @author Billy Ndegwah Micah
- *
- * Description: This class represents a node in the ActionTree. It holds the action
- * along with the left, right and parent nodes which are all of type Node (or attack actions).
- *
- * Properties:
- * -----------
- * > _action: The action that is to be performed by the character
- * > _left: The left node of the current node
- * > _right: The right node of the current node
- * > _parent: The parent node of the current node
- * > None: A sentinel node that is used to indicate that a node is null
- *
- * Methods:
- * --------
- * > Node(): Default Constructor
- * > Node(std::string& action): Overloaded Constructor
- * > ~Node(): Destructor
- * > Getters and Setters for all the properties
- * > Print(): void - Prints the action
- *
- */
-class Node
-{
+	/**
+	 * @brief Getter for the height of the tree, measured without recursion
+	 * @return an integer representing the number of nodes on the longest path from the root
+	*/
+	int GetHeight() const;
 
-private:
-	std::string _action;
-	Node* _left = nullptr;
-	Node* _right = nullptr;
-	Node* _parent = nullptr;
+	/**
+	 * @brief Getter for the balancing mode
+	 * @return a boolean value indicating whether the tree is kept balanced as a red-black tree
+	*/
+	bool IsBalanced() const;
 
-public:
 	/**
-	 * @brief This is the default constructor
+	 * @brief Getter for the size of the tree
+	 * @return an integer representing the size of the tree
 	*/
-	Node();
+	int GetSize() const;
 
 	/**
-	 * @brief This is the overloaded constructor
-	 * @param action - the action to be performed
+	 * @brief Getter for the memory the tree holds
+	 * @return the number of bytes in the arena and the order statistics
 	*/
-	Node(std::string& action);
+	size_t GetMemoryBytes() const;
 
 	/**
-	 * @brief This is the destructor
+	 * @brief Turns the order statistics on, counting every subtree once in O(n), or off,
+	 * dropping them
+	 * @param enabled - whether the statistics are kept from now on
 	*/
-	~Node();
+	void SetOrderStatistics(bool enabled);
 
 	/**
-	 * @brief Getter for the action
-	 * @return a string representing the action
+	 * @brief Getter for whether the order statistics are kept
+	 * @return a boolean value indicating whether Select(), Rank() and Sample() can be used
 	*/
-	std::string& GetAction();
+	bool HasOrderStatistics() const;
 
 	/**
-	 * @brief Getter for the left node
-	 * @return a pointer to the left node
+	 * @brief Finds the node at a place in order, in O(log n). Throws std::runtime_error
+	 * when the order statistics are off.
+	 * @param k - the place, counting from 0
+	 * @return pointer to the node, nullptr if the tree has k nodes or fewer
 	*/
-	Node* GetLeft() const;
+	Node* Select(uint32_t k) const;
 
 	/**
-	 * @brief Getter for the right node
-	 * @return a pointer to the right node
+	 * @brief Finds the place of a node in order, in O(log n). Throws std::runtime_error
+	 * when the order statistics are off.
+	 * @param node - a node of this tree
+	 * @return the number of nodes before it in order
 	*/
-	Node* GetRight() const;
+	uint32_t Rank(const Node* node) const;
 
 	/**
-	 * @brief Getter for the parent node
-	 * @return a pointer to the parent node
+	 * @brief Draws a node at random, each with a chance in proportion to its damage, in
+	 * O(log n). Throws std::runtime_error when the order statistics are off.
+	 * @param random - a random number engine, such as std::mt19937
+	 * @return pointer to the node, nullptr if no move deals damage
 	*/
-	Node* GetParent() const;
+	template <typename Random>
+	Node* Sample(Random& random) const
+	{
+		RequireStatistics();
+		const uint64_t total = WeightOf(_root);
+		if (total == 0)
+		{
+			return nullptr;
+		}
+		return ToNode(Pick(std::uniform_int_distribution<uint64_t>(0, total - 1)(random)));
+	}
 
 	/**
-	 * @brief Setter for the action
-	 * @param action - the action to be performed
+	 * @brief Getter for the compiled combo, rebuilt first if the moves changed since
+	 * @return the move ids and damage values of an attack, in order
 	*/
-	void SetAction(std::string& action);
+	const Combo& GetCombo() const;
 
 	/**
-	 * @brief Setter for the left node
-	 * @param left - the left node
+	 * @brief Getter for the version
+	 * @return the number of changes made to the moves of the tree
 	*/
-	void SetLeft(Node* left);
+	uint32_t GetVersion() const;
 
 	/**
-	 * @brief Setter for the right node
-	 * @param right - the right node
+	 * @brief Getter for the damage
+	 * @return the damage from attacks, the total of every move, 64 bits wide so a large
+	 * catalog of moves at up to 65535 damage each cannot overflow it
 	*/
-	void SetRight(Node* right);
+	long long GetDamage() const;
 
 	/**
-	 * @brief Setter for the parent node
-	 * @param parent - the parent node
+	 * @brief Setter for the damage of one move
+	 * @param node - a node of this tree
+	 * @param damage - the desired damage value, from 0 to 65535
 	*/
-	void SetParent(Node* parent);
+	void SetDamage(Node* node, int damage);
 
 	/**
-	 * @brief This method is used to print the action
+	 * @brief Setter for the current node
+	 * @param current - the desired current node
 	*/
-	void Print() const;
+	void SetCurrent(Node* current);
+};
+
+/**
+ * ActionTreeBalance enum
+ *
+ * @brief How an ActionTree keeps its shape.
+ *
+ * Values:
+ * ACTION_TREE_PLAIN - A plain binary search tree, its shape follows the order of insertion.
+ * ACTION_TREE_RED_BLACK - A red-black tree, its depth stays O(log n).
+*/
+enum ActionTreeBalance : unsigned char
+{
+	ACTION_TREE_PLAIN = 0,
+	ACTION_TREE_RED_BLACK = 1
+};
+
+/**
+ * ActionTraversal enum
+ *
+ * @brief The order in which an ActionTree walks its nodes.
+ *
+ * Values:
+ * ACTION_IN_ORDER - Left subtree, node, right subtree: the actions in order of symbol.
+ * ACTION_PRE_ORDER - Node, left subtree, right subtree: every node before its children.
+ * ACTION_POST_ORDER - Left subtree, right subtree, node: every node after its children.
+*/
+enum ActionTraversal : unsigned char
+{
+	ACTION_IN_ORDER = 0,
+	ACTION_PRE_ORDER = 1,
+	ACTION_POST_ORDER = 2
 };
@@ -0,0 +1,202 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+/**
+ * @file Arena.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the Arena class, a pool of objects of one type that are
+ * addressed by 32 bit indices instead of pointers. Objects are carved out of blocks of
+ * ARENA_BLOCK_SIZE slots, so neighbours in the pool are neighbours in memory, an index takes
+ * half the space of a pointer, and a slot never moves once handed out, which keeps pointers
+ * to it valid as the arena grows. Released slots go on a free list and are handed out again.
+ * The first block only has ARENA_FIRST_BLOCK_SIZE slots, so the many small pools a game
+ * makes cost a few hundred bytes rather than a whole block each.
+ *
+ * Only trivially destructible types are allowed, so nothing has to run when objects go away:
+ * emptying the arena frees its few blocks in one go, whatever the number of objects. Copying
+ * an arena copies its blocks byte for byte, every object keeping its index.
+ *
+ * Properties:
+ * -----------
+ * > _blocks: vector<T*> - The blocks of slots.
+ * > _count: uint32_t - The number of slots handed out at least once.
+ * > _free: vector<uint32_t> - The released slots, reused first.
+ *
+ * Methods:
+ * --------
+ * > Arena(other) - Copies every block of another arena.
+ * > Allocate(): uint32_t - Hands out a slot holding a default constructed object.
+ * > Release(index) - Returns a slot to the arena.
+ * > At(index): T& - The object in a slot.
+ * > Clear() - Frees every block.
+ * > Size(): uint32_t - The number of live objects.
+ * > GetMemoryBytes(): size_t - The memory held by the blocks.
+ */
+template <typename T>
+class Arena
+{
+	static_assert(std::is_trivially_destructible<T>::value, "Arena objects are dropped without running destructors");
+
+public:
+	static const uint32_t ARENA_NO_INDEX = 0xFFFFFFFFu;
+	static const int ARENA_BLOCK_SHIFT = 10;
+	static const uint32_t ARENA_BLOCK_SIZE = 1u << ARENA_BLOCK_SHIFT;
+	static const uint32_t ARENA_FIRST_BLOCK_SIZE = 16;
+
+private:
+	std::vector<T*> _blocks;
+	uint32_t _count = 0;
+	std::vector<uint32_t> _free;
+
+	/**
+	 * @brief Gets the number of slots in a block.
+	*/
+	static uint32_t BlockSize(size_t block)
+	{
+		return (block == 0) ? ARENA_FIRST_BLOCK_SIZE : ARENA_BLOCK_SIZE;
+	}
+
+	/**
+	 * @brief Gets the number of slots in every block together.
+	*/
+	size_t Capacity() const
+	{
+		return _blocks.empty() ? 0 : ARENA_FIRST_BLOCK_SIZE + (_blocks.size() - 1) * ARENA_BLOCK_SIZE;
+	}
+
+public:
+	Arena() = default;
+	Arena& operator=(const Arena&) = delete;
+
+	/**
+	 * @brief Copies another arena, slot for slot, so every object keeps its index.
+	 * @param other - the arena to copy.
+	*/
+	Arena(const Arena& other)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Arena objects are copied byte for byte");
+		size_t start = 0;
+		for (size_t block = 0; block < other._blocks.size(); block++)
+		{
+			const size_t used = std::min<size_t>(BlockSize(block), other._count - start);
+			_blocks.push_back(static_cast<T*>(::operator new(sizeof(T) * BlockSize(block))));
+			std::memcpy(static_cast<void*>(_blocks.back()), other._blocks[block], sizeof(T) * used);
+			start += BlockSize(block);
+		}
+		_count = other._count;
+		_free = other._free;
+	}
+
+	/**
+	 * @brief Frees every block.
+	*/
+	~Arena()
+	{
+		Clear();
+	}
+
+	/**
+	 * @brief Hands out a slot, reusing a released one when there is any.
+	 * @return the index of the slot, which holds a default constructed object.
+	*/
+	uint32_t Allocate()
+	{
+		uint32_t index;
+		if (!_free.empty())
+		{
+			index = _free.back();
+			_free.pop_back();
+		}
+		else
+		{
+			if (_count == ARENA_NO_INDEX)
+			{
+				throw std::out_of_range("Arena is out of indices");
+			}
+			if (_count == Capacity())
+			{
+				_blocks.push_back(static_cast<T*>(::operator new(sizeof(T) * BlockSize(_blocks.size()))));
+			}
+			index = _count++;
+		}
+		new (&At(index)) T();
+		return index;
+	}
+
+	/**
+	 * @brief Returns a slot to the arena. The object is simply forgotten.
+	 * @param index - the index of the slot.
+	*/
+	void Release(uint32_t index)
+	{
+		_free.push_back(index);
+	}
+
+	/**
+	 * @brief Getter for the object in a slot.
+	 * @param index - the index of the slot.
+	 * @return a reference to the object, valid until the arena is cleared.
+	*/
+	T& At(uint32_t index)
+	{
+		if (index < ARENA_FIRST_BLOCK_SIZE)
+		{
+			return _blocks[0][index];
+		}
+		index -= ARENA_FIRST_BLOCK_SIZE;
+		return _blocks[1 + (index >> ARENA_BLOCK_SHIFT)][index & (ARENA_BLOCK_SIZE - 1)];
+	}
+
+	/**
+	 * @brief Getter for the object in a slot.
+	 * @param index - the index of the slot.
+	 * @return a reference to the object, valid until the arena is cleared.
+	*/
+	const T& At(uint32_t index) const
+	{
+		if (index < ARENA_FIRST_BLOCK_SIZE)
+		{
+			return _blocks[0][index];
+		}
+		index -= ARENA_FIRST_BLOCK_SIZE;
+		return _blocks[1 + (index >> ARENA_BLOCK_SHIFT)][index & (ARENA_BLOCK_SIZE - 1)];
+	}
+
+	/**
+	 * @brief Frees every block at once, no object is visited.
+	*/
+	void Clear()
+	{
+		for (T* block : _blocks)
+		{
+			::operator delete(block);
+		}
+		_blocks.clear();
+		_free.clear();
+		_count = 0;
+	}
+
+	/**
+	 * @brief Getter for the number of live objects.
+	 * @return the number of slots handed out and not released.
+	*/
+	uint32_t Size() const
+	{
+		return _count - static_cast<uint32_t>(_free.size());
+	}
+
+	/**
+	 * @brief Getter for the memory held by the blocks.
+	 * @return the number of bytes of slots.
+	*/
+	size_t GetMemoryBytes() const
+	{
+		return Capacity() * sizeof(T);
+	}
+};
@@ -104,11 +104,11 @@ bool Backpack::SearchItem(Item* item) const
 	{
 		if (&_itemBag.GetArray()[i] == item)
 		{
-			std::cout << "Item found!" << std::endl;
+			std::cout << "Item found!\n";
 			return true;
 		}
 	}
-	std::cout << "Item not found!" << std::endl;
+	std::cout << "Item not found!\n";
 	return false;
 }
 
@@ -118,29 +118,29 @@ bool Backpack::SearchWeapon(Weapon* weapon) const
 	{
 		if (&_weaponBag.GetArray()[i] == weapon)
 		{
-			std::cout << "Weapon found!" << std::endl;
+			std::cout << "Weapon found!\n";
 			return true;
 		}
 	}
-	std::cout << "Weapon not found!" << std::endl;
+	std::cout << "Weapon not found!\n";
 	return false;
 }
 
 void Backpack::DisplayItems() const
 {
-	std::cout << "Items in the Backpack:" << std::endl;
+	std::cout << "Items in the Backpack:\n";
 	for (int i = 0; i < _itemBag.GetSize(); ++i)
 	{
-		std::cout << _itemBag[i].GetName() << std::endl;
+		std::cout << _itemBag[i].GetName() << '\n';
 	}
 }
 
 void Backpack::DisplayWeapons() const
 {
-	std::cout << "Weapons in the Backpack:" << std::endl;
+	std::cout << "Weapons in the Backpack:\n";
 	for (int i = 0; i < _weaponBag.GetSize(); ++i)
 	{
-		std::cout << _weaponBag.GetArray()[i].GetName() << std::endl;
+		std::cout << _weaponBag.GetArray()[i].GetName() << '\n';
 	}
 }
 
@@ -0,0 +1,2177 @@
+#include "Benchmark.h"
+#include "TileSpace.h"
+#include "Pathfinder.h"
+#include "FlowField.h"
+#include "HierarchicalPathfinder.h"
+#include "CooperativePlanner.h"
+#include "Enemy.h"
+#include "SpatialHash.h"
+#include "KdTree.h"
+#include "FieldOfView.h"
+#include "TileBitboards.h"
+#include "MapGenerator.h"
+#include "Connectivity.h"
+#include "PaletteLayer.h"
+#include "FrameRenderer.h"
+#include "MapView.h"
+#include "ActionTree.h"
+#include "ActionBTree.h"
+#include "ComboDetector.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+namespace
+{
+	const char* const RANDOM_SPACE_PATH = "bench_space.jtm";
+
+	/**
+	 * @brief Counts the agents ending a move on an occupied tile or swapping with another agent.
+	*/
+	int CountCollisions(const vector<Location>& before, const vector<Location>& after, int cols)
+	{
+		unordered_map<int, int> holder;
+		int collisions = 0;
+		for (size_t i = 0; i < after.size(); i++)
+		{
+			if (!holder.emplace(after[i].x * cols + after[i].y, static_cast<int>(i)).second)
+			{
+				++collisions;
+			}
+		}
+		for (size_t i = 0; i < after.size(); i++)
+		{
+			auto other = holder.find(before[i].x * cols + before[i].y);
+			if (other != holder.end() && other->second != static_cast<int>(i)
+				&& before[other->second].x == after[i].x && before[other->second].y == after[i].y)
+			{
+				++collisions;
+			}
+		}
+		return collisions;
+	}
+
+	/**
+	 * @brief Loads a copy of a binary map with one layer descriptor rewritten and reads every
+	 * tile of it, for Benchmark::MapLoad().
+	 * @return "rejected" when the copy fails to load, otherwise a sum of every tile read.
+	*/
+	string LoadCrafted(vector<char> bytes, const string& path, uint32_t id, uint32_t bytesPerTile, uint64_t size)
+	{
+		MapFileHeader header;
+		memcpy(&header, bytes.data(), sizeof(header));
+		for (uint32_t i = 0; i < header.layerCount; i++)
+		{
+			MapFileLayer layer;
+			char* at = bytes.data() + header.layerTableOffset + i * sizeof(MapFileLayer);
+			memcpy(&layer, at, sizeof(layer));
+			if (layer.id == id)
+			{
+				layer.bytesPerTile = bytesPerTile;
+				layer.size = size;
+				memcpy(at, &layer, sizeof(layer));
+			}
+		}
+		{
+			ofstream out(path, ios::binary);
+			out.write(bytes.data(), static_cast<streamsize>(bytes.size()));
+		}
+
+		string result;
+		try
+		{
+			TileSpace<Tile*> space(path);
+			long sum = 0;
+			for (int i = 0; i < space.GetRows(); i++)
+			{
+				for (int j = 0; j < space.GetCols(); j++)
+				{
+					sum += space.GetFlags(i, j) + space.GetTerrain(i, j);
+				}
+			}
+			result = "loaded, tile sum " + to_string(sum);
+		}
+		catch (const runtime_error&)
+		{
+			result = "rejected";
+		}
+		remove(path.c_str());
+		return result;
+	}
+
+	/**
+	 * @brief Times one ActionBTree node size on a catalog, for Benchmark::MoveCatalogs().
+	*/
+	template <int CacheLines>
+	void TimeMoveCatalog(const vector<uint32_t>& catalog, const vector<string>& lookups, double (*elapsedMs)(chrono::steady_clock::time_point))
+	{
+		ActionBTree<CacheLines> tree;
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		for (uint32_t symbol : catalog)
+		{
+			tree.InsertNode(symbol, symbol % 100);
+		}
+		const double insertMs = elapsedMs(start);
+
+		int found = 0;
+		start = chrono::steady_clock::now();
+		for (const string& action : lookups)
+		{
+			found += (tree.Find(action) != tree.end()) ? 1 : 0;
+		}
+		const double findMs = elapsedMs(start);
+
+		long long damage = 0;
+		start = chrono::steady_clock::now();
+		tree.Visit([&damage](ActionTree::Move move) { damage += move.damage; });
+		const double walkMs = elapsedMs(start);
+
+		int prefixed = 0;
+		start = chrono::steady_clock::now();
+		tree.VisitPrefix("Up", [&prefixed](ActionTree::Move) { ++prefixed; });
+		const double prefixMs = elapsedMs(start);
+
+		const double moves = static_cast<double>(catalog.size());
+		cout << "ActionBTree<" << CacheLines << "> (" << ActionBTree<CacheLines>::ACTION_LEAF_CAPACITY << " moves a leaf): insert "
+			<< insertMs * 1e6 / moves << " ns, find " << findMs * 1e6 / lookups.size() << " ns (" << found << " found), walk "
+			<< walkMs * 1e6 / moves << " ns a move (" << damage << " damage), \"Up\" prefix " << prefixMs * 1000 << " us ("
+			<< prefixed << " moves), height " << tree.GetHeight() << ", " << tree.GetMemoryBytes() / moves << " bytes a move" << '\n';
+	}
+}
+
+double Benchmark::ElapsedMs(Clock::time_point start)
+{
+	return chrono::duration<double, milli>(Clock::now() - start).count();
+}
+
+TileSpace<Tile*>* Benchmark::RandomSpace(int rows, int cols, int wallPercent, unsigned int seed)
+{
+	mt19937 random(seed);
+	uniform_int_distribution<int> percent(0, 99);
+	uniform_int_distribution<int> length(2, 24);
+	uniform_int_distribution<int> perMyriad(0, 9999);
+	vector<unsigned char> flags(static_cast<size_t>(rows) * cols, TILE_WALKABLE);
+	vector<unsigned char> terrain(static_cast<size_t>(rows) * cols, 0);
+
+	for (size_t i = 0; i < flags.size(); i++)
+	{
+		// half of the walls grow into segments averaging 13 tiles, so walls are seeded at a
+		// seventh of the requested density
+		if (perMyriad(random) < wallPercent * 100 / 7)
+		{
+			const int row = static_cast<int>(i / cols);
+			const int col = static_cast<int>(i % cols);
+			const int segment = (percent(random) < 50) ? length(random) : 1;
+			const bool vertical = percent(random) < 50;
+			for (int k = 0; k < segment; k++)
+			{
+				const int r = vertical ? row + k : row;
+				const int c = vertical ? col : col + k;
+				if (r < rows && c < cols)
+				{
+					flags[static_cast<size_t>(r) * cols + c] = TILE_OPAQUE;
+				}
+			}
+		}
+		terrain[i] = static_cast<unsigned char>(percent(random) % 8);
+	}
+
+	MapFilePoint entry = { 0, 0 };
+	MapFilePoint exits[MAP_FILE_EXITS] = { { 0, cols - 1 }, { rows - 1, 0 }, { rows - 1, cols - 1 } };
+	flags[0] = TILE_WALKABLE;
+	for (const auto& exit : exits)
+	{
+		flags[static_cast<size_t>(exit.x) * cols + exit.y] = TILE_WALKABLE;
+	}
+
+	PaletteLayer<unsigned char> packed(terrain.size(), 0);
+	packed.Assign(terrain.data());
+	MapFile::Save(RANDOM_SPACE_PATH, rows, cols, flags.data(), packed, entry, exits);
+	return new TileSpace<Tile*>(string(RANDOM_SPACE_PATH));
+}
+
+void Benchmark::ReleaseSpace(TileSpace<Tile*>* space)
+{
+	delete space;
+	remove(RANDOM_SPACE_PATH);
+}
+
+void Benchmark::Run(const string& name)
+{
+	if (name == "mapload")
+	{
+		MapLoad(2048, 2048);
+	}
+	else if (name == "pathfind")
+	{
+		Pathfinding(1024, 200);
+	}
+	else if (name == "flowfield")
+	{
+		FlowFields(1024, 500);
+	}
+	else if (name == "hpa")
+	{
+		Hierarchical(1024, 200);
+	}
+	else if (name == "coop")
+	{
+		Cooperative(256, 2000, 50);
+	}
+	else if (name == "spatial")
+	{
+		SpatialIndex(100000, 10000);
+	}
+	else if (name == "kdtree")
+	{
+		NearestNeighbours(100000, 10000);
+	}
+	else if (name == "fov")
+	{
+		FieldsOfView(1024, 5000);
+	}
+	else if (name == "bitboard")
+	{
+		Bitboards(1024, 10000000);
+	}
+	else if (name == "mapgen")
+	{
+		MapGeneration(2048, 2048);
+	}
+	else if (name == "regions")
+	{
+		Regions(1024, 2000);
+	}
+	else if (name == "sat")
+	{
+		AreaSums(2048, 1000000);
+	}
+	else if (name == "palette")
+	{
+		EnvironLayers(16384, 10000000);
+	}
+	else if (name == "render")
+	{
+		Rendering(60, 200, 2000);
+	}
+	else if (name == "viewport")
+	{
+		Viewport(4096, 5000);
+	}
+	else if (name == "actiontree")
+	{
+		ActionTrees(1000000);
+	}
+	else if (name == "attack")
+	{
+		Attacks(1000000);
+	}
+	else if (name == "spawn")
+	{
+		Spawning(100000, 10);
+	}
+	else if (name == "select")
+	{
+		MoveSelection(100000, 100000);
+	}
+	else if (name == "bulkload")
+	{
+		BulkLoading(1000000);
+	}
+	else if (name == "combo")
+	{
+		ComboDetection(10000, 10000000);
+	}
+	else if (name == "btree")
+	{
+		MoveCatalogs(50000);
+	}
+	else
+	{
+		cout << "Unknown benchmark '" << name << "'" << '\n';
+		List();
+	}
+}
+
+void Benchmark::List()
+{
+	cout << "Benchmarks: " << '\n';
+	cout << "\tmapload - \t\tParsed versus memory mapped map startup" << '\n';
+	cout << "\tpathfind - \t\tA* versus Jump Point Search on a 1K x 1K map" << '\n';
+	cout << "\tflowfield - \t\tShared flow field versus a search per enemy" << '\n';
+	cout << "\thpa - \t\t\tHierarchical pathfinding versus Jump Point Search" << '\n';
+	cout << "\tcoop - \t\t\tCooperative crowd movement with a reservation table" << '\n';
+	cout << "\tspatial - \t\tSpatial hash range queries over 100K characters" << '\n';
+	cout << "\tkdtree - \t\tk-d tree nearest queries over a clustered crowd" << '\n';
+	cout << "\tfov - \t\t\tShadowcasting field of view for 5000 viewers" << '\n';
+	cout << "\tbitboard - \t\tBitboard flood fill and move masks on a 1K x 1K map" << '\n';
+	cout << "\tmapgen - \t\tSeeded procedural generation of a 2K x 2K map" << '\n';
+	cout << "\tregions - \t\tUnion-find region labels and exit reachability" << '\n';
+	cout << "\tsat - \t\t\tSummed-area table damage and healing totals" << '\n';
+	cout << "\tpalette - \t\tPalette packed Environ layer of a 16K x 16K world" << '\n';
+	cout << "\trender - \t\tDiffed frame rendering versus a flush per line" << '\n';
+	cout << "\tviewport - \t\tScrolling viewport over a 4K x 4K map" << '\n';
+	cout << "\tactiontree - \t\tRed-black ActionTree inserts, lookups, walks and teardown of 1M moves" << '\n';
+	cout << "\tattack - \t\tCompiled combo attacks versus walking and printing the tree" << '\n';
+	cout << "\tspawn - \t\tSpawning a wave of 100K enemies sharing their attack moves" << '\n';
+	cout << "\tselect - \t\tRank, select and damage weighted moves in a 100K move ActionTree" << '\n';
+	cout << "\tbulkload - \t\tBulk loading a 1M move catalog versus inserting every move" << '\n';
+	cout << "\tcombo - \t\tAho-Corasick combo detection over 10K characters' moves" << '\n';
+	cout << "\tbtree - \t\tCache line B+-tree versus red-black ActionTree on a 50K move catalog" << '\n';
+}
+
+void Benchmark::MapLoad(int rows, int cols)
+{
+	const string textPath = "bench_map.txt";
+	const string mapPath = "bench_map.jtm";
+
+	{
+		ofstream text(textPath);
+		for (int i = 0; i < rows; i++)
+		{
+			string line(cols, '_');
+			for (int j = 0; j < cols; j++)
+			{
+				if ((i % 16 == 7 && j % 64 != 3) || (j % 32 == 31 && i % 8 != 0))
+				{
+					line[j] = '#';
+				}
+				else if ((i * 31 + j * 17) % 97 == 0)
+				{
+					line[j] = static_cast<char>('0' + (i + j) % 8);
+				}
+			}
+			if (i == 0)
+			{
+				line[0] = 'E';
+			}
+			if (i == rows - 1)
+			{
+				line[0] = 'X';
+				line[cols - 1] = 'X';
+			}
+			text << line << '\n';
+		}
+		text.close();
+	}
+
+	Clock::time_point start = Clock::now();
+	MapFile::ConvertAscii(textPath, mapPath);
+	const double parseMs = ElapsedMs(start);
+
+	start = Clock::now();
+	TileSpace<Tile*>* mapped = new TileSpace<Tile*>(mapPath);
+	const double openMs = ElapsedMs(start);
+
+	start = Clock::now();
+	long walkable = 0;
+	const unsigned char* flags = mapped->GetFlagsLayer();
+	const long tiles = static_cast<long>(mapped->GetRows()) * mapped->GetCols();
+	for (long i = 0; i < tiles; i++)
+	{
+		walkable += flags[i] & TILE_WALKABLE;
+	}
+	const double scanMs = ElapsedMs(start);
+
+	cout << "Map load benchmark (" << rows << " x " << cols << " tiles)" << '\n';
+	cout << "==============================================" << '\n';
+	cout << "Parse ASCII map and write binary: " << parseMs << " ms" << '\n';
+	cout << "Open mapped binary map: " << openMs << " ms" << '\n';
+	cout << "First full scan of mapped layer: " << scanMs << " ms (" << walkable << " walkable tiles)" << '\n';
+	delete mapped;
+
+	// a map file is untrusted input, broken descriptors must fail to load or read in bounds
+	ifstream saved(mapPath, ios::binary);
+	const vector<char> bytes((istreambuf_iterator<char>(saved)), istreambuf_iterator<char>());
+	saved.close();
+	const string craftedPath = "bench_crafted.jtm";
+	cout << "Crafted file, empty flags layer: " << LoadCrafted(bytes, craftedPath, MAP_LAYER_FLAGS, 0, 0) << '\n';
+	cout << "Crafted file, one entry terrain palette: " << LoadCrafted(bytes, craftedPath, MAP_LAYER_TERRAIN_PALETTE, 0, 1) << '\n';
+
+	remove(textPath.c_str());
+	remove(mapPath.c_str());
+}
+
+void Benchmark::Pathfinding(int size, int queries)
+{
+	TileSpace<Tile*>* space = RandomSpace(size, size, 20, 27);
+	Pathfinder pathfinder(space);
+	mt19937 random(1027);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+
+	vector<Location> starts, goals;
+	while (static_cast<int>(starts.size()) < queries)
+	{
+		Location from(coordinate(random), coordinate(random));
+		Location to(coordinate(random), coordinate(random));
+		if (space->IsWalkable(from.x, from.y) && space->IsWalkable(to.x, to.y))
+		{
+			starts.push_back(from);
+			goals.push_back(to);
+		}
+	}
+
+	cout << "Pathfinding benchmark (" << size << " x " << size << " tiles, " << queries << " queries)" << '\n';
+	cout << "==============================================" << '\n';
+
+	vector<Location> path;
+	path.reserve(static_cast<size_t>(size) * 4);
+	const char* names[] = { "A*", "Jump Point Search" };
+	long long costs[2] = { 0, 0 };
+	for (int mode = 0; mode < 2; mode++)
+	{
+		long long expanded = 0;
+		int found = 0;
+		Clock::time_point start = Clock::now();
+		for (int i = 0; i < queries; i++)
+		{
+			if (pathfinder.FindPath(starts[i], goals[i], path, mode == 1))
+			{
+				++found;
+				costs[mode] += pathfinder.GetLastCost();
+			}
+			expanded += pathfinder.GetExpanded();
+		}
+		const double totalMs = ElapsedMs(start);
+
+		cout << names[mode] << ": " << totalMs / queries << " ms/query, "
+			<< expanded / queries << " nodes expanded/query, "
+			<< found << " routes found" << '\n';
+	}
+	cout << "Route costs " << ((costs[0] == costs[1]) ? "match" : "DIFFER") << " between both searches" << '\n';
+
+	ReleaseSpace(space);
+}
+
+void Benchmark::FlowFields(int size, int enemies)
+{
+	TileSpace<Tile*>* space = RandomSpace(size, size, 20, 28);
+	mt19937 random(1028);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+
+	vector<Location> crowd;
+	Location target(size / 2, size / 2);
+	space->SetFlags(target.x, target.y, TILE_WALKABLE);
+	while (static_cast<int>(crowd.size()) < enemies)
+	{
+		Location enemy(coordinate(random), coordinate(random));
+		if (space->IsWalkable(enemy.x, enemy.y))
+		{
+			crowd.push_back(enemy);
+		}
+	}
+
+	cout << "Flow field benchmark (" << size << " x " << size << " tiles, " << enemies << " enemies)" << '\n';
+	cout << "==============================================" << '\n';
+
+	FlowField flowField(space, 1);
+	vector<Location> targets(1, target);
+	Clock::time_point start = Clock::now();
+	flowField.Compute(targets);
+	const double serialMs = ElapsedMs(start);
+	vector<int> serial(static_cast<size_t>(size) * size);
+	for (int i = 0; i < size; i++)
+	{
+		for (int j = 0; j < size; j++)
+		{
+			serial[static_cast<size_t>(i) * size + j] = flowField.GetDistance(i, j);
+		}
+	}
+
+	flowField.SetThreads(0);
+	start = Clock::now();
+	flowField.Compute(targets);
+	const double parallelMs = ElapsedMs(start);
+	bool identical = true;
+	for (int i = 0; i < size && identical; i++)
+	{
+		for (int j = 0; j < size && identical; j++)
+		{
+			identical = serial[static_cast<size_t>(i) * size + j] == flowField.GetDistance(i, j);
+		}
+	}
+
+	cout << "Compute on 1 thread: " << serialMs << " ms" << '\n';
+	cout << "Compute on " << flowField.GetThreads() << " threads: " << parallelMs << " ms ("
+		<< (identical ? "identical" : "DIFFERENT") << " field)" << '\n';
+
+	start = Clock::now();
+	int moved = 0;
+	for (auto& enemy : crowd)
+	{
+		Location next(0, 0);
+		if (flowField.NextStep(enemy, next))
+		{
+			enemy = next;
+			++moved;
+		}
+	}
+	cout << "Step " << enemies << " enemies along the field: " << ElapsedMs(start) << " ms (" << moved << " moved)" << '\n';
+
+	Pathfinder pathfinder(space);
+	vector<Location> path;
+	const int searched = min(enemies, 50);
+	start = Clock::now();
+	for (int i = 0; i < searched; i++)
+	{
+		pathfinder.FindPath(crowd[i], target, path);
+	}
+	cout << "Jump Point Search per enemy: " << ElapsedMs(start) / searched << " ms/enemy, "
+		<< ElapsedMs(start) / searched * enemies << " ms for the crowd (estimated from " << searched << ")" << '\n';
+
+	vector<Location> changed;
+	while (changed.size() < 10)
+	{
+		Location tile(coordinate(random), coordinate(random));
+		if (tile.x != target.x || tile.y != target.y)
+		{
+			space->SetFlags(tile.x, tile.y, space->GetFlags(tile.x, tile.y) ^ TILE_WALKABLE);
+			changed.push_back(tile);
+		}
+	}
+
+	start = Clock::now();
+	flowField.UpdateTiles(changed);
+	const double repairMs = ElapsedMs(start);
+	for (size_t i = 0; i < serial.size(); i++)
+	{
+		serial[i] = flowField.GetDistance(static_cast<int>(i / size), static_cast<int>(i % size));
+	}
+
+	start = Clock::now();
+	flowField.Compute(targets);
+	const double rebuildMs = ElapsedMs(start);
+	identical = true;
+	for (size_t i = 0; i < serial.size() && identical; i++)
+	{
+		identical = serial[i] == flowField.GetDistance(static_cast<int>(i / size), static_cast<int>(i % size));
+	}
+
+	cout << "Repair after 10 tiles toggled: " << repairMs << " ms, full rebuild: " << rebuildMs << " ms ("
+		<< (identical ? "identical" : "DIFFERENT") << " field)" << '\n';
+
+	ReleaseSpace(space);
+}
+
+void Benchmark::Hierarchical(int size, int queries)
+{
+	TileSpace<Tile*>* space = RandomSpace(size, size, 20, 29);
+	mt19937 random(1029);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+
+	// only long routes, where the abstract graph pays off
+	vector<Location> starts, goals;
+	while (static_cast<int>(starts.size()) < queries)
+	{
+		Location from(coordinate(random), coordinate(random));
+		Location to(coordinate(random), coordinate(random));
+		if (abs(from.x - to.x) + abs(from.y - to.y) >= size / 2
+			&& space->IsWalkable(from.x, from.y) && space->IsWalkable(to.x, to.y))
+		{
+			starts.push_back(from);
+			goals.push_back(to);
+		}
+	}
+
+	cout << "Hierarchical pathfinding benchmark (" << size << " x " << size << " tiles, " << queries << " queries)" << '\n';
+	cout << "==============================================" << '\n';
+
+	// nothing is avoided so both planners see the same walkable tiles
+	Clock::time_point start = Clock::now();
+	HierarchicalPathfinder hierarchical(space, 16, TILE_NONE);
+	cout << "Build abstract graph: " << ElapsedMs(start) << " ms (" << hierarchical.GetNodeCount() << " abstract nodes)" << '\n';
+
+	Pathfinder pathfinder(space);
+	vector<Location> path;
+	long long jpsCost = 0;
+	int jpsFound = 0;
+	start = Clock::now();
+	for (int i = 0; i < queries; i++)
+	{
+		if (pathfinder.FindPath(starts[i], goals[i], path))
+		{
+			++jpsFound;
+			jpsCost += pathfinder.GetLastCost();
+		}
+	}
+	const double jpsMs = ElapsedMs(start);
+
+	long long hpaCost[2] = { 0, 0 };
+	long long expanded = 0;
+	int hpaFound = 0;
+	double hpaMs[2] = { 0, 0 };
+	for (int pass = 0; pass < 2; pass++)
+	{
+		hpaFound = 0;
+		start = Clock::now();
+		for (int i = 0; i < queries; i++)
+		{
+			if (hierarchical.FindPath(starts[i], goals[i], path))
+			{
+				++hpaFound;
+				hpaCost[pass] += hierarchical.GetLastCost();
+			}
+			expanded += hierarchical.GetExpanded();
+		}
+		hpaMs[pass] = ElapsedMs(start);
+	}
+
+	cout << "Jump Point Search: " << jpsMs / queries << " ms/query, " << jpsFound << " routes found" << '\n';
+	cout << "HPA* cold cache: " << hpaMs[0] / queries << " ms/query, warm cache: " << hpaMs[1] / queries
+		<< " ms/query, " << expanded / (2 * queries) << " abstract nodes expanded/query, " << hpaFound << " routes found" << '\n';
+	if (jpsCost > 0)
+	{
+		cout << "HPA* routes are " << 100.0 * (hpaCost[0] - jpsCost) / jpsCost << "% longer than optimal, segment cache holds "
+			<< hierarchical.GetCacheBytes() / 1024 << " KB" << '\n';
+	}
+
+	vector<Location> changed;
+	while (changed.size() < 10)
+	{
+		Location tile(coordinate(random), coordinate(random));
+		space->SetFlags(tile.x, tile.y, space->GetFlags(tile.x, tile.y) ^ TILE_WALKABLE);
+		changed.push_back(tile);
+	}
+
+	start = Clock::now();
+	hierarchical.UpdateTiles(changed);
+	const double repairMs = ElapsedMs(start);
+	start = Clock::now();
+	HierarchicalPathfinder rebuilt(space, 16, TILE_NONE);
+	cout << "Repair after 10 tiles toggled: " << repairMs << " ms, full rebuild: " << ElapsedMs(start) << " ms" << '\n';
+
+	ReleaseSpace(space);
+}
+
+void Benchmark::Cooperative(int size, int agents, int ticks)
+{
+	TileSpace<Tile*>* space = RandomSpace(size, size, 10, 30);
+	mt19937 random(1030);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+
+	vector<Location> positions, goals;
+	unordered_map<int, int> taken;
+	while (static_cast<int>(positions.size()) < agents)
+	{
+		Location from(coordinate(random), coordinate(random));
+		Location to(coordinate(random), coordinate(random));
+		if (space->IsWalkable(from.x, from.y) && space->IsWalkable(to.x, to.y)
+			&& taken.emplace(from.x * size + from.y, 0).second)
+		{
+			positions.push_back(from);
+			goals.push_back(to);
+		}
+	}
+
+	cout << "Cooperative movement benchmark (" << size << " x " << size << " tiles, " << agents << " agents, " << ticks << " ticks)" << '\n';
+	cout << "==============================================" << '\n';
+
+	Pathfinder pathfinder(space);
+	vector<Location> path;
+	vector<Location> independent(positions);
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < agents; i++)
+	{
+		if (pathfinder.FindPath(positions[i], goals[i], path) && path.size() > 1)
+		{
+			independent[i] = path[1];
+		}
+	}
+	cout << "Independent Jump Point Search step: " << ElapsedMs(start) << " ms, "
+		<< CountCollisions(positions, independent, size) << " collisions" << '\n';
+
+	CooperativePlanner planner(space, 8);
+	long long expanded = 0;
+	int collisions = 0;
+	double totalMs = 0;
+	for (int tick = 0; tick < ticks; tick++)
+	{
+		start = Clock::now();
+		planner.Plan(positions, goals);
+		totalMs += ElapsedMs(start);
+		expanded += planner.GetExpanded();
+
+		vector<Location> next(positions);
+		for (int i = 0; i < agents; i++)
+		{
+			next[i] = planner.GetPlan(i)[1];
+		}
+		collisions += CountCollisions(positions, next, size);
+		positions.swap(next);
+	}
+
+	int arrived = 0;
+	for (int i = 0; i < agents; i++)
+	{
+		arrived += (positions[i].x == goals[i].x && positions[i].y == goals[i].y) ? 1 : 0;
+	}
+	cout << "Cooperative batch: " << totalMs / ticks << " ms/tick, " << expanded / ticks
+		<< " states expanded/tick, " << collisions << " collisions over " << ticks << " ticks, "
+		<< arrived << " agents at their goal" << '\n';
+
+	ReleaseSpace(space);
+}
+
+void Benchmark::SpatialIndex(int count, int queries)
+{
+	const int area = 4096;
+	const int radius = 8;
+	mt19937 random(1031);
+	uniform_int_distribution<int> coordinate(0, area - 1);
+	uniform_int_distribution<int> step(-1, 1);
+
+	cout << "Spatial index benchmark (" << count << " characters on " << area << " x " << area << " tiles, "
+		<< queries << " queries)" << '\n';
+	cout << "==============================================" << '\n';
+
+	vector<Character*> crowd;
+	crowd.reserve(count);
+	for (int i = 0; i < count; i++)
+	{
+		crowd.push_back(new Enemy("Crowd", 100, 10));
+		crowd.back()->Relocate(coordinate(random), coordinate(random));
+	}
+
+	SpatialHash<Character*> index(radius);
+	Clock::time_point start = Clock::now();
+	for (auto* character : crowd)
+	{
+		character->SetSpatialIndex(&index);
+	}
+	cout << "Index " << count << " characters: " << ElapsedMs(start) << " ms" << '\n';
+
+	start = Clock::now();
+	for (auto* character : crowd)
+	{
+		const Location* loc = character->GetLocation();
+		character->Relocate(min(max(loc->x + step(random), 0), area - 1), min(max(loc->y + step(random), 0), area - 1));
+	}
+	cout << "Move every character one step: " << ElapsedMs(start) << " ms" << '\n';
+
+	vector<Location> centers;
+	for (int i = 0; i < queries; i++)
+	{
+		centers.push_back(*crowd[coordinate(random) % count]->GetLocation());
+	}
+
+	vector<Character*> found;
+	long long hashHits = 0;
+	start = Clock::now();
+	for (const auto& center : centers)
+	{
+		found.clear();
+		index.QueryRadius(center, radius, found);
+		hashHits += found.size();
+	}
+	const double hashRadiusMs = ElapsedMs(start);
+
+	long long rectHits = 0;
+	start = Clock::now();
+	for (const auto& center : centers)
+	{
+		found.clear();
+		index.QueryRect(center.x - radius, center.y - 2 * radius, center.x + radius, center.y + 2 * radius, found);
+		rectHits += found.size();
+	}
+	const double hashRectMs = ElapsedMs(start);
+
+	// a full scan of every character is what Map::characters offers without the index
+	const int scanned = min(queries, 200);
+	long long scanHits = 0;
+	start = Clock::now();
+	for (int i = 0; i < scanned; i++)
+	{
+		for (const auto* character : crowd)
+		{
+			const long long dx = character->GetLocation()->x - centers[i].x;
+			const long long dy = character->GetLocation()->y - centers[i].y;
+			scanHits += (dx * dx + dy * dy <= static_cast<long long>(radius) * radius) ? 1 : 0;
+		}
+	}
+	const double scanMs = ElapsedMs(start);
+
+	long long checkHits = 0;
+	for (int i = 0; i < scanned; i++)
+	{
+		found.clear();
+		index.QueryRadius(centers[i], radius, found);
+		checkHits += found.size();
+	}
+
+	cout << "Radius " << radius << " queries: " << hashRadiusMs * 1000 / queries << " us/query through the index, "
+		<< scanMs * 1000 / scanned << " us/query scanning (" << hashHits / queries << " characters/query, "
+		<< ((checkHits == scanHits) ? "same" : "DIFFERENT") << " results)" << '\n';
+	cout << "Rectangle " << 2 * radius + 1 << " x " << 4 * radius + 1 << " queries: " << hashRectMs * 1000 / queries
+		<< " us/query (" << rectHits / queries << " characters/query)" << '\n';
+
+	for (auto* character : crowd)
+	{
+		delete character;
+	}
+}
+
+void Benchmark::NearestNeighbours(int count, int queries)
+{
+	const int area = 4096;
+	const int k = 8;
+	const int radius = 16;
+	mt19937 random(1032);
+	uniform_int_distribution<int> coordinate(0, area - 1);
+	normal_distribution<double> spread(0.0, 24.0);
+
+	// nine in ten positions crowd around a few hot spots, the rest are scattered
+	vector<Location> hotSpots;
+	for (int i = 0; i < 32; i++)
+	{
+		hotSpots.push_back(Location(coordinate(random), coordinate(random)));
+	}
+	vector<Location> positions;
+	for (int i = 0; i < count; i++)
+	{
+		if (i % 10 == 0)
+		{
+			positions.push_back(Location(coordinate(random), coordinate(random)));
+			continue;
+		}
+		const Location& spot = hotSpots[i % hotSpots.size()];
+		positions.push_back(Location(min(max(spot.x + static_cast<int>(spread(random)), 0), area - 1),
+			min(max(spot.y + static_cast<int>(spread(random)), 0), area - 1)));
+	}
+
+	cout << "Nearest neighbour benchmark (" << count << " clustered positions, " << queries << " queries)" << '\n';
+	cout << "==============================================" << '\n';
+
+	KdTree<int> tree;
+	Clock::time_point start = Clock::now();
+	const int rebuilds = 10;
+	for (int r = 0; r < rebuilds; r++)
+	{
+		tree.Clear();
+		for (int i = 0; i < count; i++)
+		{
+			tree.Add(i, positions[i]);
+		}
+		tree.Build();
+	}
+	cout << "Rebuild k-d tree: " << ElapsedMs(start) / rebuilds << " ms" << '\n';
+
+	vector<Location> centers;
+	for (int i = 0; i < queries; i++)
+	{
+		centers.push_back(positions[coordinate(random) % count]);
+	}
+
+	auto distance = [&](int id, const Location& center)
+	{
+		const long long dx = positions[id].x - center.x;
+		const long long dy = positions[id].y - center.y;
+		return dx * dx + dy * dy;
+	};
+
+	vector<int> found;
+	start = Clock::now();
+	for (const auto& center : centers)
+	{
+		tree.Nearest(center, k, found);
+	}
+	const double treeMs = ElapsedMs(start);
+
+	const int scanned = min(queries, 200);
+	vector<long long> distances(count);
+	bool same = true;
+	start = Clock::now();
+	for (int q = 0; q < scanned; q++)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			distances[i] = distance(i, centers[q]);
+		}
+		nth_element(distances.begin(), distances.begin() + k - 1, distances.end());
+		const long long kth = distances[k - 1];
+
+		tree.Nearest(centers[q], k, found);
+		same = same && static_cast<int>(found.size()) == k && distance(found.back(), centers[q]) == kth;
+	}
+	const double scanMs = ElapsedMs(start);
+
+	cout << k << " nearest: " << treeMs * 1000 / queries << " us/query through the tree, "
+		<< scanMs * 1000 / scanned << " us/query scanning (" << (same ? "same" : "DIFFERENT") << " distances)" << '\n';
+
+	SpatialHash<int> hash(radius);
+	for (int i = 0; i < count; i++)
+	{
+		hash.Insert(i, positions[i]);
+	}
+
+	long long treeHits = 0, hashHits = 0;
+	start = Clock::now();
+	for (const auto& center : centers)
+	{
+		found.clear();
+		tree.QueryRadius(center, radius, found);
+		treeHits += found.size();
+	}
+	const double treeRadiusMs = ElapsedMs(start);
+
+	start = Clock::now();
+	for (const auto& center : centers)
+	{
+		found.clear();
+		hash.QueryRadius(center, radius, found);
+		hashHits += found.size();
+	}
+	const double hashRadiusMs = ElapsedMs(start);
+
+	cout << "Radius " << radius << " queries: " << treeRadiusMs * 1000 / queries << " us/query through the tree, "
+		<< hashRadiusMs * 1000 / queries << " us/query through the spatial hash ("
+		<< treeHits / queries << " positions/query, " << ((treeHits == hashHits) ? "same" : "DIFFERENT") << " results)" << '\n';
+}
+
+void Benchmark::FieldsOfView(int size, int viewers)
+{
+	const int radius = 12;
+	TileSpace<Tile*>* space = RandomSpace(size, size, 20, 33);
+	mt19937 random(1033);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+	uniform_int_distribution<int> step(-1, 1);
+
+	vector<Location> origins;
+	while (static_cast<int>(origins.size()) < viewers)
+	{
+		Location origin(coordinate(random), coordinate(random));
+		if (space->IsWalkable(origin.x, origin.y))
+		{
+			origins.push_back(origin);
+		}
+	}
+
+	cout << "Field of view benchmark (" << size << " x " << size << " tiles, " << viewers << " viewers, radius " << radius << ")" << '\n';
+	cout << "==============================================" << '\n';
+
+	FieldOfView serial(space, 1);
+	FieldOfView parallel(space, 0);
+	for (const auto& origin : origins)
+	{
+		serial.AddViewer(origin, radius);
+		parallel.AddViewer(origin, radius);
+	}
+
+	Clock::time_point start = Clock::now();
+	serial.Update();
+	const double serialMs = ElapsedMs(start);
+	start = Clock::now();
+	parallel.Update();
+	const double parallelMs = ElapsedMs(start);
+
+	long long visible = 0;
+	for (int i = 0; i < viewers; i++)
+	{
+		visible += serial.GetVisibility(i).Count();
+	}
+	cout << "Batch on 1 thread: " << serialMs << " ms, on " << parallel.GetThreads() << " threads: " << parallelMs
+		<< " ms (" << visible / viewers << " tiles visible/viewer, "
+		<< serial.GetVisibility(0).GetRows() * serial.GetVisibility(0).GetWordsPerRow() * 8 << " bytes/viewer)" << '\n';
+
+	for (int i = 0; i < viewers; i += 10)
+	{
+		Location next(origins[i].x + step(random), origins[i].y + step(random));
+		if (space->IsWalkable(next.x, next.y))
+		{
+			origins[i] = next;
+		}
+		serial.MoveViewer(i, origins[i]);
+	}
+	start = Clock::now();
+	int recomputed = serial.Update();
+	cout << "Update after a tenth of the viewers moved: " << ElapsedMs(start) << " ms (" << recomputed << " recomputed)" << '\n';
+
+	vector<Location> changed;
+	while (changed.size() < 10)
+	{
+		Location tile(coordinate(random), coordinate(random));
+		space->SetFlags(tile.x, tile.y, space->GetFlags(tile.x, tile.y) ^ TILE_OPAQUE);
+		changed.push_back(tile);
+	}
+	serial.OpacityChanged(changed);
+	start = Clock::now();
+	recomputed = serial.Update();
+	cout << "Update after 10 tiles changed opacity: " << ElapsedMs(start) << " ms (" << recomputed << " recomputed)" << '\n';
+
+	ReleaseSpace(space);
+}
+
+void Benchmark::Bitboards(int size, int queries)
+{
+	TileSpace<Tile*>* space = RandomSpace(size, size, 20, 34);
+	mt19937 random(1034);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+	for (int i = 0; i < size * size / 50; i++)
+	{
+		const int row = coordinate(random);
+		const int col = coordinate(random);
+		space->SetFlags(row, col, space->GetFlags(row, col) | TILE_OCCUPIED);
+	}
+
+	Location origin(coordinate(random), coordinate(random));
+	while (!space->IsWalkable(origin.x, origin.y) || (space->GetFlags(origin.x, origin.y) & TILE_OCCUPIED) != 0)
+	{
+		origin = Location(coordinate(random), coordinate(random));
+	}
+
+	cout << "Bitboard benchmark (" << size << " x " << size << " tiles, 20% walls, 2% occupied)" << '\n';
+	cout << "==============================================" << '\n';
+
+	Clock::time_point start = Clock::now();
+	TileBitboards boards(space);
+	cout << "Build from the flag layer: " << ElapsedMs(start) << " ms (" << boards.GetFree().Count() << " free tiles)" << '\n';
+
+	// the same movement rules over the flag bytes: eight directions, free tiles, no corner cutting
+	const int dRows[] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+	const int dCols[] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+	auto isFree = [space](int row, int col)
+	{
+		return space->IsWalkable(row, col) && (space->GetFlags(row, col) & TILE_OCCUPIED) == 0;
+	};
+	auto byteMask = [&](int row, int col)
+	{
+		unsigned int mask = 0;
+		for (int d = 0; d < 8; d++)
+		{
+			if (isFree(row + dRows[d], col + dCols[d])
+				&& (d < 4 || (isFree(row + dRows[d], col) && isFree(row, col + dCols[d]))))
+			{
+				mask |= 1u << d;
+			}
+		}
+		return mask;
+	};
+
+	vector<int> depth(static_cast<size_t>(size) * size);
+	vector<Location> queue;
+	auto byteFlood = [&](int maxSteps)
+	{
+		fill(depth.begin(), depth.end(), -1);
+		queue.assign(1, origin);
+		depth[static_cast<size_t>(origin.x) * size + origin.y] = 0;
+		for (size_t head = 0; head < queue.size(); head++)
+		{
+			const Location current = queue[head];
+			const int next = depth[static_cast<size_t>(current.x) * size + current.y] + 1;
+			if (maxSteps >= 0 && next > maxSteps)
+			{
+				continue;
+			}
+			const unsigned int mask = byteMask(current.x, current.y);
+			for (int d = 0; d < 8; d++)
+			{
+				const size_t index = static_cast<size_t>(current.x + dRows[d]) * size + current.y + dCols[d];
+				if ((mask & (1u << d)) != 0 && depth[index] < 0)
+				{
+					depth[index] = next;
+					queue.push_back(Location(current.x + dRows[d], current.y + dCols[d]));
+				}
+			}
+		}
+		return static_cast<int>(queue.size());
+	};
+
+	for (int steps : { -1, 16 })
+	{
+		start = Clock::now();
+		const int byteCount = byteFlood(steps);
+		const double byteMs = ElapsedMs(start);
+		start = Clock::now();
+		const int boardCount = boards.Flood(origin, steps);
+		const double boardMs = ElapsedMs(start);
+		cout << "Flood fill " << ((steps < 0) ? string("of the whole region") : "within " + to_string(steps) + " moves")
+			<< ": bitboards " << boardMs << " ms, byte BFS " << byteMs << " ms (" << boardCount << " vs " << byteCount << " tiles reached)" << '\n';
+	}
+
+	vector<Location> tiles;
+	for (int i = 0; i < 4096; i++)
+	{
+		tiles.push_back(Location(coordinate(random), coordinate(random)));
+	}
+
+	unsigned long long byteSum = 0;
+	start = Clock::now();
+	for (int i = 0; i < queries; i++)
+	{
+		const Location& tile = tiles[i & 4095];
+		byteSum += byteMask(tile.x, tile.y);
+	}
+	const double byteMaskMs = ElapsedMs(start);
+
+	unsigned long long boardSum = 0;
+	start = Clock::now();
+	for (int i = 0; i < queries; i++)
+	{
+		const Location& tile = tiles[i & 4095];
+		boardSum += boards.NeighbourMask(tile.x, tile.y);
+	}
+	const double boardMaskMs = ElapsedMs(start);
+	cout << "Neighbour masks: bitboards " << boardMaskMs * 1e6 / queries << " ns, flag checks "
+		<< byteMaskMs * 1e6 / queries << " ns (checksums " << boardSum << " vs " << byteSum << ")" << '\n';
+
+	ReleaseSpace(space);
+}
+
+void Benchmark::MapGeneration(int rows, int cols)
+{
+	const unsigned int seed = 35;
+	const size_t tiles = static_cast<size_t>(rows) * cols;
+	const char* environNames[ENVIRON_COUNT] = { "Grass", "Dirt", "Water", "Rock", "Sand", "Snow", "Ice", "Lava" };
+
+	cout << "Map generation benchmark (" << rows << " x " << cols << " tiles, seed " << seed << ")" << '\n';
+	cout << "==============================================" << '\n';
+
+	MapGenerator generator(seed, 1);
+	TileSpace<Tile*>* reference = nullptr;
+	vector<int> threadCounts = { 1, 2, 4 };
+	threadCounts.push_back(MapGenerator(seed).GetThreads());
+
+	for (int threads : threadCounts)
+	{
+		generator.SetThreads(threads);
+		Clock::time_point start = Clock::now();
+		TileSpace<Tile*>* space = generator.Generate(rows, cols);
+		const double ms = ElapsedMs(start);
+
+		bool identical = true;
+		if (reference == nullptr)
+		{
+			reference = space;
+		}
+		else
+		{
+			identical = memcmp(space->GetFlagsLayer(), reference->GetFlagsLayer(), tiles) == 0
+				&& space->GetTerrainLayer() == reference->GetTerrainLayer();
+			delete space;
+		}
+		cout << threads << " thread(s): " << ms << " ms, " << static_cast<long long>(tiles / (ms / 1000.0))
+			<< " tiles/s" << (identical ? "" : " - MAP DIFFERS FROM 1 THREAD") << '\n';
+	}
+
+	vector<size_t> environs(ENVIRON_COUNT, 0);
+	size_t walkable = 0;
+	for (size_t i = 0; i < tiles; i++)
+	{
+		environs[reference->GetTerrainLayer().Get(i)]++;
+		walkable += reference->GetFlagsLayer()[i] & TILE_WALKABLE;
+	}
+	cout << "Walkable: " << walkable * 100 / tiles << "%, environs:";
+	for (int e = 0; e < ENVIRON_COUNT; e++)
+	{
+		cout << " " << environNames[e] << " " << environs[e] * 100 / tiles << "%";
+	}
+	cout << '\n';
+
+	generator.SetSeed(seed + 1);
+	TileSpace<Tile*>* other = generator.Generate(rows, cols);
+	cout << "Seed " << seed + 1 << " gives a different map: "
+		<< (!(other->GetTerrainLayer() == reference->GetTerrainLayer()) ? "yes" : "no") << '\n';
+	delete other;
+	delete reference;
+}
+
+void Benchmark::Regions(int size, int updates)
+{
+	MapGenerator generator(36);
+	generator.SetWallPercent(43);
+	TileSpace<Tile*>* space = generator.Generate(size, size);
+	mt19937 random(1036);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+
+	cout << "Region labeling benchmark (" << size << " x " << size << " generated cave, " << updates << " updates)" << '\n';
+	cout << "==============================================" << '\n';
+
+	Clock::time_point start = Clock::now();
+	Connectivity regions(space);
+	const double rebuildMs = ElapsedMs(start);
+	cout << "Two-pass labeling: " << rebuildMs << " ms (" << regions.GetRegionCount() << " regions)" << '\n';
+
+	// the search answer: flood from the entry point and look at the exits
+	const Location entry = *space->GetEntryPoint()->GetPosition();
+	const Location exits[] = { *space->GetExitOne()->GetPosition(), *space->GetExitTwo()->GetPosition(), *space->GetExitThree()->GetPosition() };
+	vector<unsigned char> seen;
+	vector<Location> queue;
+	start = Clock::now();
+	seen.assign(static_cast<size_t>(size) * size, 0);
+	queue.assign(1, entry);
+	seen[static_cast<size_t>(entry.x) * size + entry.y] = 1;
+	for (size_t head = 0; head < queue.size(); head++)
+	{
+		const Location current = queue[head];
+		const int dRows[] = { -1, 1, 0, 0 };
+		const int dCols[] = { 0, 0, -1, 1 };
+		for (int d = 0; d < 4; d++)
+		{
+			const int r = current.x + dRows[d];
+			const int c = current.y + dCols[d];
+			if (space->IsWalkable(r, c) && seen[static_cast<size_t>(r) * size + c] == 0)
+			{
+				seen[static_cast<size_t>(r) * size + c] = 1;
+				queue.push_back(Location(r, c));
+			}
+		}
+	}
+	int searched = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		searched |= seen[static_cast<size_t>(exits[i].x) * size + exits[i].y] << i;
+	}
+	const double searchMs = ElapsedMs(start);
+
+	const int lookups = 1000000;
+	int reachable = 0;
+	start = Clock::now();
+	for (int i = 0; i < lookups; i++)
+	{
+		reachable |= regions.ReachableExits();
+	}
+	cout << "Exits reachable from the entry: lookup " << ElapsedMs(start) * 1e6 / lookups << " ns, search "
+		<< searchMs << " ms (mask " << reachable << " vs " << searched << ")" << '\n';
+
+	vector<Location> pairs;
+	for (int i = 0; i < 2048; i++)
+	{
+		pairs.push_back(Location(coordinate(random), coordinate(random)));
+	}
+	int connected = 0;
+	start = Clock::now();
+	for (int i = 0; i < lookups; i++)
+	{
+		connected += regions.Connected(pairs[i & 2047], pairs[(i * 7 + 1) & 2047]) ? 1 : 0;
+	}
+	cout << "Connected(from, to): " << ElapsedMs(start) * 1e6 / lookups << " ns/query (" << connected << " connected pairs)" << '\n';
+
+	double openMs = 0, closeMs = 0;
+	int opened = 0, closed = 0;
+	vector<Location> changed(1, Location(0, 0));
+	for (int i = 0; i < updates; i++)
+	{
+		changed[0] = Location(coordinate(random), coordinate(random));
+		const bool opening = !space->IsWalkable(changed[0].x, changed[0].y);
+		space->SetFlags(changed[0].x, changed[0].y, opening ? TILE_WALKABLE : TILE_OPAQUE);
+		start = Clock::now();
+		regions.UpdateTiles(changed);
+		(opening ? openMs : closeMs) += ElapsedMs(start);
+		(opening ? opened : closed)++;
+	}
+	cout << "Incremental updates: open " << openMs * 1000 / max(opened, 1) << " us, close " << closeMs * 1000 / max(closed, 1)
+		<< " us on average (" << opened << " opened, " << closed << " closed), rebuild " << rebuildMs * 1000 << " us" << '\n';
+
+	// the same partition: every incremental region maps onto exactly one rebuilt region and back
+	Connectivity fresh(space);
+	unordered_map<int, int> forward, backward;
+	bool matches = fresh.GetRegionCount() == regions.GetRegionCount();
+	for (int r = 0; r < size && matches; r++)
+	{
+		for (int c = 0; c < size && matches; c++)
+		{
+			const int mine = regions.GetRegion(r, c);
+			const int theirs = fresh.GetRegion(r, c);
+			if ((mine == Connectivity::NO_REGION) != (theirs == Connectivity::NO_REGION))
+			{
+				matches = false;
+			}
+			else if (mine != Connectivity::NO_REGION)
+			{
+				matches = forward.insert(make_pair(mine, theirs)).first->second == theirs
+					&& backward.insert(make_pair(theirs, mine)).first->second == mine
+					&& regions.GetRegionSize(r, c) == fresh.GetRegionSize(r, c);
+			}
+		}
+	}
+	cout << "Incremental labels match a rebuild: " << (matches ? "yes" : "NO") << '\n';
+
+	delete space;
+}
+
+void Benchmark::AreaSums(int size, int queries)
+{
+	// the damage and healing of the Map's environs, damage only counts for hazards
+	const int damage[ENVIRON_COUNT] = { 15, 0, 8, 0, 5, 0, 30, 0 };
+	const int healing[ENVIRON_COUNT] = { 0, 10, 0, 14, 0, 25, 0, 22 };
+	TileSpace<Tile*>* space = MapGenerator(37).Generate(size, size);
+	mt19937 random(1037);
+	uniform_int_distribution<int> coordinate(0, size - 1);
+	uniform_int_distribution<int> extent(0, 63);
+
+	cout << "Summed-area table benchmark (" << size << " x " << size << " tiles, " << queries << " queries)" << '\n';
+	cout << "==============================================" << '\n';
+
+	for (int threads : { 1, 0 })
+	{
+		SummedAreaTable table(size, size, threads);
+		for (int r = 0; r < size; r++)
+		{
+			for (int c = 0; c < size; c++)
+			{
+				table.Set(r, c, damage[space->GetTerrain(r, c)]);
+			}
+		}
+		Clock::time_point start = Clock::now();
+		table.Sum(0, 0, 0, 0);
+		cout << "Full build on " << ((threads == 1) ? string("1 thread") : "every hardware thread") << ": " << ElapsedMs(start) << " ms" << '\n';
+	}
+
+	for (int e = 0; e < ENVIRON_COUNT; e++)
+	{
+		space->SetEnvironEffect(static_cast<unsigned char>(e), damage[e], healing[e]);
+	}
+	space->GetDamageInRect(0, 0, 0, 0);
+	space->GetHealingInRect(0, 0, 0, 0);
+
+	vector<int> rects;
+	for (int i = 0; i < 4096; i++)
+	{
+		const int top = coordinate(random);
+		const int left = coordinate(random);
+		rects.insert(rects.end(), { top, left, top + extent(random), left + extent(random) });
+	}
+
+	long long total = 0;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < queries; i++)
+	{
+		const int* rect = &rects[(i & 4095) * 4];
+		total += space->GetDamageInRect(rect[0], rect[1], rect[2], rect[3]) - space->GetHealingInRect(rect[0], rect[1], rect[2], rect[3]);
+	}
+	const double tableNs = ElapsedMs(start) * 1e6 / queries;
+
+	// adding up the tiles, on the first 4096 rectangles only
+	long long tableTotal = 0, tileTotal = 0;
+	start = Clock::now();
+	for (int i = 0; i < 4096; i++)
+	{
+		const int* rect = &rects[i * 4];
+		for (int r = rect[0]; r <= min(rect[2], size - 1); r++)
+		{
+			for (int c = rect[1]; c <= min(rect[3], size - 1); c++)
+			{
+				tileTotal += damage[space->GetTerrain(r, c)] - healing[space->GetTerrain(r, c)];
+			}
+		}
+	}
+	const double tileNs = ElapsedMs(start) * 1e6 / 4096;
+	for (int i = 0; i < 4096; i++)
+	{
+		const int* rect = &rects[i * 4];
+		tableTotal += space->GetDamageInRect(rect[0], rect[1], rect[2], rect[3]) - space->GetHealingInRect(rect[0], rect[1], rect[2], rect[3]);
+	}
+	cout << "Damage minus healing in rectangles up to 64 x 64: tables " << tableNs << " ns, adding tiles " << tileNs
+		<< " ns (totals " << tableTotal << " vs " << tileTotal << ", checksum " << total << ")" << '\n';
+
+	for (int changes : { 1, 100, 10000 })
+	{
+		for (int i = 0; i < changes; i++)
+		{
+			space->SetTerrain(coordinate(random), coordinate(random), static_cast<unsigned char>(coordinate(random) % ENVIRON_COUNT));
+		}
+		start = Clock::now();
+		space->GetDamageInRect(0, 0, 0, 0);
+		space->GetHealingInRect(0, 0, 0, 0);
+		cout << "First query after " << changes << " tiles changed Environ: " << ElapsedMs(start) << " ms" << '\n';
+	}
+
+	delete space;
+}
+
+void Benchmark::EnvironLayers(int size, int queries)
+{
+	const size_t tiles = static_cast<size_t>(size) * size;
+	mt19937 random(1038);
+	uniform_int_distribution<size_t> tile(0, tiles - 1);
+	vector<size_t> indices(queries);
+	for (size_t& index : indices)
+	{
+		index = tile(random);
+	}
+
+	cout << "Palette layer benchmark (" << size << " x " << size << " tiles, " << queries << " random reads and writes)" << '\n';
+	cout << "==============================================" << '\n';
+
+	// patches of 64 x 64 tiles cycling through the environs, as a generated world would have
+	PaletteLayer<unsigned char> layer(tiles, 0);
+	vector<unsigned char> bytes(tiles);
+	Clock::time_point start = Clock::now();
+	for (int r = 0; r < size; r++)
+	{
+		for (int c = 0; c < size; c++)
+		{
+			layer.Set(static_cast<size_t>(r) * size + c, static_cast<unsigned char>((r / 64 * 3 + c / 64) % ENVIRON_COUNT));
+		}
+	}
+	const double setMs = ElapsedMs(start);
+	layer.CopyTo(bytes.data());
+	cout << "Memory: packed " << layer.GetMemoryBytes() / (1024 * 1024) << " MB at " << layer.GetBits() << " bits per tile, byte per tile "
+		<< tiles / (1024 * 1024) << " MB, Environ pointer per tile " << tiles * sizeof(void*) / (1024 * 1024) << " MB" << '\n';
+	cout << "Filling every tile: " << setMs << " ms, " << static_cast<long long>(tiles / (setMs / 1000.0)) << " tiles/s" << '\n';
+
+	long long packedSum = 0, byteSum = 0;
+	start = Clock::now();
+	for (size_t index : indices)
+	{
+		packedSum += layer.Get(index);
+	}
+	const double packedReadNs = ElapsedMs(start) * 1e6 / queries;
+	start = Clock::now();
+	for (size_t index : indices)
+	{
+		byteSum += bytes[index];
+	}
+	const double byteReadNs = ElapsedMs(start) * 1e6 / queries;
+	cout << "Random reads: packed " << packedReadNs << " ns, bytes " << byteReadNs << " ns (sums "
+		<< packedSum << " vs " << byteSum << ")" << '\n';
+
+	start = Clock::now();
+	for (int i = 0; i < queries; i++)
+	{
+		layer.Set(indices[i], static_cast<unsigned char>(i % ENVIRON_COUNT));
+	}
+	const double packedWriteNs = ElapsedMs(start) * 1e6 / queries;
+	start = Clock::now();
+	for (int i = 0; i < queries; i++)
+	{
+		bytes[indices[i]] = static_cast<unsigned char>(i % ENVIRON_COUNT);
+	}
+	const double byteWriteNs = ElapsedMs(start) * 1e6 / queries;
+	cout << "Random writes: packed " << packedWriteNs << " ns, bytes " << byteWriteNs << " ns" << '\n';
+
+	start = Clock::now();
+	layer.Replace(static_cast<unsigned char>(ENVIRON_LAVA), static_cast<unsigned char>(ENVIRON_COUNT));
+	cout << "Turning every lava tile into a new Environ: " << ElapsedMs(start) << " ms" << '\n';
+	layer.Replace(static_cast<unsigned char>(ENVIRON_COUNT), static_cast<unsigned char>(ENVIRON_LAVA));
+
+	// eight more environs fill the 4 bit palette, the seventeenth widens every code
+	for (int e = ENVIRON_COUNT; e < 16; e++)
+	{
+		layer.Set(static_cast<size_t>(e), static_cast<unsigned char>(e));
+	}
+	start = Clock::now();
+	layer.Set(16, 16);
+	const double widenMs = ElapsedMs(start);
+	layer.Set(16, bytes[16]);
+	for (int e = ENVIRON_COUNT; e < 16; e++)
+	{
+		layer.Set(static_cast<size_t>(e), bytes[e]);
+	}
+
+	vector<unsigned char> unpacked(tiles);
+	layer.CopyTo(unpacked.data());
+	cout << "Seventeenth Environ: widened to " << layer.GetBits() << " bits in " << widenMs << " ms, now "
+		<< layer.GetMemoryBytes() / (1024 * 1024) << " MB, layers match: " << ((unpacked == bytes) ? "yes" : "no") << '\n';
+}
+
+void Benchmark::Rendering(int rows, int cols, int frames)
+{
+	const string framePath = "bench_frame.txt";
+	const int characters = 12;
+	TileSpace<Tile*>* space = MapGenerator(39).Generate(rows, cols);
+	mt19937 random(1039);
+	vector<int> positions;
+	for (int i = 0; i < characters; i++)
+	{
+		positions.push_back(static_cast<int>(random() % rows));
+		positions.push_back(static_cast<int>(random() % cols));
+	}
+
+	// every frame each character takes a step in a random direction
+	auto step = [&]()
+	{
+		for (int i = 0; i < characters; i++)
+		{
+			positions[i * 2] = min(max(positions[i * 2] + static_cast<int>(random() % 3) - 1, 0), rows - 1);
+			positions[i * 2 + 1] = min(max(positions[i * 2 + 1] + static_cast<int>(random() % 3) - 1, 0), cols - 1);
+		}
+	};
+	auto glyph = [&](int r, int c)
+	{
+		return space->IsWalkable(r, c) ? '_' : '|';
+	};
+
+	cout << "Frame rendering benchmark (" << rows << " x " << cols << " cells, " << characters << " moving characters, " << frames << " frames)" << '\n';
+	cout << "==============================================" << '\n';
+
+	ofstream lines(framePath, ios::binary);
+	Clock::time_point start = Clock::now();
+	for (int f = 0; f < frames; f++)
+	{
+		step();
+		for (int r = 0; r < rows; r++)
+		{
+			string line(cols, ' ');
+			for (int c = 0; c < cols; c++)
+			{
+				line[c] = glyph(r, c);
+			}
+			for (int i = 0; i < characters; i++)
+			{
+				if (positions[i * 2] == r)
+				{
+					line[positions[i * 2 + 1]] = (i == 0) ? '@' : 'M';
+				}
+			}
+			// the old renderer flushed every line, the baseline keeps that flush
+			lines << line << '\n';
+			lines.flush();
+		}
+	}
+	const double linesMs = ElapsedMs(start) / frames;
+	const long long lineBytes = static_cast<long long>(lines.tellp()) / frames;
+	lines.close();
+
+	ofstream diffed(framePath, ios::binary);
+	FrameRenderer frame(rows, cols);
+	long long frameBytes = 0;
+	start = Clock::now();
+	for (int f = 0; f < frames; f++)
+	{
+		step();
+		for (int r = 0; r < rows; r++)
+		{
+			for (int c = 0; c < cols; c++)
+			{
+				frame.Put(r, c, glyph(r, c));
+			}
+		}
+		for (int i = 0; i < characters; i++)
+		{
+			frame.Put(positions[i * 2], positions[i * 2 + 1], (i == 0) ? '@' : 'M', (i == 0) ? FRAME_CYAN | FRAME_BOLD : FRAME_RED);
+		}
+		frameBytes += static_cast<long long>(frame.Present(diffed));
+	}
+	const double frameMs = ElapsedMs(start) / frames;
+	diffed.close();
+	remove(framePath.c_str());
+
+	cout << "Printing every line: " << linesMs << " ms, " << lineBytes << " bytes and " << rows << " flushes per frame" << '\n';
+	cout << "Frame renderer: " << frameMs << " ms, " << frameBytes / frames << " bytes and 1 flush per frame" << '\n';
+	delete space;
+}
+
+void Benchmark::Viewport(int size, int steps)
+{
+	TileSpace<Tile*>* space = MapGenerator(40).Generate(size, size);
+	mt19937 random(1040);
+	const int rowSteps[] = { -1, 1, 0, 0 };
+	const int colSteps[] = { 0, 0, -1, 1 };
+
+	// a camera wandering around the middle of the map, one tile per step
+	vector<int> path;
+	int row = size / 2, col = size / 2;
+	for (int i = 0; i < steps; i++)
+	{
+		const int direction = static_cast<int>(random() % 4);
+		row = min(max(row + rowSteps[direction], 0), size - 1);
+		col = min(max(col + colSteps[direction], 0), size - 1);
+		path.push_back(row);
+		path.push_back(col);
+	}
+
+	cout << "Viewport benchmark (" << size << " x " << size << " tiles, " << MapView::VIEW_DEFAULT_ROWS << " x "
+		<< MapView::VIEW_DEFAULT_COLS << " viewport, " << steps << " steps)" << '\n';
+	cout << "==============================================" << '\n';
+
+	ostringstream screen;
+	FrameRenderer frame(MapView::VIEW_DEFAULT_ROWS, MapView::VIEW_DEFAULT_COLS);
+	MapView scrolling(space);
+	long long scrollingBytes = 0;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < steps; i++)
+	{
+		scrolling.CenterOn(path[i * 2], path[i * 2 + 1]);
+		scrolling.Draw(frame, 0, 0);
+		scrollingBytes += static_cast<long long>(frame.Present(screen));
+		screen.str("");
+	}
+	const double scrollingUs = ElapsedMs(start) * 1000.0 / steps;
+	cout << "Scrolling the cached viewport: " << scrollingUs << " us, " << scrolling.GetRenderedTiles() / steps
+		<< " tiles rendered and " << scrollingBytes / steps << " bytes per step" << '\n';
+
+	long long rendered = 0;
+	start = Clock::now();
+	for (int i = 0; i < steps; i++)
+	{
+		MapView fresh(space);
+		fresh.CenterOn(path[i * 2], path[i * 2 + 1]);
+		fresh.Draw(frame, 0, 0);
+		rendered += fresh.GetRenderedTiles();
+	}
+	const double freshUs = ElapsedMs(start) * 1000.0 / steps;
+	cout << "Rendering the viewport every step: " << freshUs << " us, " << rendered / steps << " tiles rendered per step" << '\n';
+
+	// the whole map once, what printing the TileSpace would cost every step
+	MapView whole(space, size, size);
+	FrameRenderer wholeFrame(size, size);
+	start = Clock::now();
+	whole.Draw(wholeFrame, 0, 0);
+	cout << "Rendering the whole map once: " << ElapsedMs(start) * 1000.0 << " us, " << whole.GetRenderedTiles() << " tiles" << '\n';
+	delete space;
+}
+
+void Benchmark::ActionTrees(int moves)
+{
+	// zero padded names sort in the same order as their numbers
+	vector<string> sorted(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		string number = to_string(i);
+		sorted[i] = "Move " + string(8 - min(number.size(), static_cast<size_t>(8)), '0') + number;
+	}
+	vector<string> shuffled = sorted;
+	shuffle(shuffled.begin(), shuffled.end(), mt19937(1041));
+	vector<int> order(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		order[i] = i;
+	}
+	shuffle(order.begin(), order.end(), mt19937(2041));
+	const int plainSorted = min(moves, 20000);
+
+	cout << "ActionTree benchmark (" << moves << " moves)" << '\n';
+	cout << "==============================================" << '\n';
+
+	// the catalog is interned once when it loads, in sorted order so symbols sort like names
+	Clock::time_point start = Clock::now();
+	vector<uint32_t> sortedSymbols(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		sortedSymbols[i] = ActionSymbols::Global().Intern(sorted[i]);
+	}
+	const double internMs = ElapsedMs(start);
+	vector<uint32_t> shuffledSymbols(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		shuffledSymbols[i] = ActionSymbols::Global().Find(shuffled[i]);
+	}
+	cout << "Interning the catalog: " << internMs * 1e6 / moves << " ns per name, "
+		<< ActionSymbols::Global().Size() << " symbols" << '\n';
+
+	struct Run
+	{
+		const char* name;
+		ActionTreeBalance balance;
+		const vector<string>* catalog;
+		const vector<uint32_t>* symbols;
+		int count;
+	};
+	const Run runs[] = {
+		{ "red-black, random order", ACTION_TREE_RED_BLACK, &shuffled, &shuffledSymbols, moves },
+		{ "red-black, sorted order", ACTION_TREE_RED_BLACK, &sorted, &sortedSymbols, moves },
+		{ "plain, random order", ACTION_TREE_PLAIN, &shuffled, &shuffledSymbols, moves },
+		{ "plain, sorted order", ACTION_TREE_PLAIN, &sorted, &sortedSymbols, plainSorted },
+	};
+	for (const Run& run : runs)
+	{
+		ActionTree* tree = new ActionTree(run.balance);
+		start = Clock::now();
+		for (int i = 0; i < run.count; i++)
+		{
+			tree->InsertNode((*run.symbols)[i]);
+		}
+		const double insertMs = ElapsedMs(start);
+
+		int found = 0;
+		start = Clock::now();
+		for (int i = 0; i < run.count; i++)
+		{
+			found += tree->Find((*run.symbols)[order[i] % run.count]) != nullptr;
+		}
+		const double findMs = ElapsedMs(start);
+
+		// looking up by name hashes it to its symbol first
+		int foundByName = 0;
+		start = Clock::now();
+		for (int i = 0; i < run.count; i++)
+		{
+			foundByName += tree->Find((*run.catalog)[order[i] % run.count]) != nullptr;
+		}
+		const double findByNameMs = ElapsedMs(start);
+		const int height = tree->GetHeight();
+		const size_t bytes = tree->GetMemoryBytes();
+
+		size_t letters = 0;
+		start = Clock::now();
+		for (const Node& node : *tree)
+		{
+			letters += node.GetAction().size();
+		}
+		const double walkMs = ElapsedMs(start);
+
+		// the nodes go with their blocks, no node is visited
+		start = Clock::now();
+		delete tree;
+		const double teardownMs = ElapsedMs(start);
+
+		cout << run.name << ", " << run.count << " moves: insert " << insertMs * 1e6 / run.count << " ns, lookup "
+			<< findMs * 1e6 / run.count << " ns (" << found << " found), by name " << findByNameMs * 1e6 / run.count
+			<< " ns (" << foundByName << " found), height " << height << '\n';
+		cout << "\tin order walk " << walkMs * 1e6 / run.count << " ns per move (" << letters << " letters), teardown "
+			<< teardownMs << " ms, " << static_cast<double>(bytes) / run.count << " bytes per move" << '\n';
+	}
+}
+
+void Benchmark::Attacks(int attacks)
+{
+	const string logPath = "bench_attack.txt";
+	const int health = 1000000;
+	string attackerName = "Attacker";
+	string targetName = "Target";
+	Character attacker(attackerName, 100, 80);
+	Character target(targetName, health, 80);
+	const vector<const ActionTree*> moves = attacker.GetAttackMoves();
+	const int trees = static_cast<int>(moves.size());
+
+	cout << "Attack benchmark (" << attacks << " attacks, " << moves[0]->GetSize() << " moves each)" << '\n';
+	cout << "==============================================" << '\n';
+
+	// attacks used to walk the tree and print every move, the printing goes to a file here
+	ofstream log(logPath, ios::binary);
+	streambuf* console = cout.rdbuf(log.rdbuf());
+	long long walkedDamage = 0;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < attacks; i++)
+	{
+		moves[i % trees]->InOrderTraverse();
+		walkedDamage += moves[i % trees]->GetDamage();
+	}
+	const double walkMs = ElapsedMs(start);
+	cout.rdbuf(console);
+	log.close();
+
+	long long comboDamage = 0;
+	start = Clock::now();
+	for (int i = 0; i < attacks; i++)
+	{
+		target.SetHealth(health);
+		attacker.Attack(&target, i % trees);
+		comboDamage += health - target.GetHealth();
+	}
+	const double comboMs = ElapsedMs(start);
+
+	cout << "Walk and print the tree: " << attacks / walkMs * 1000 << " attacks per second (" << walkedDamage << " damage)" << '\n';
+	cout << "Compiled combo: " << attacks / comboMs * 1000 << " attacks per second (" << comboDamage << " damage)" << '\n';
+	remove(logPath.c_str());
+}
+
+void Benchmark::Spawning(int enemies, int editEvery)
+{
+	cout << "Spawn benchmark (" << enemies << " enemies, every " << editEvery << "th learning a move of its own)" << '\n';
+	cout << "==============================================" << '\n';
+
+	vector<Enemy*> wave;
+	wave.reserve(enemies);
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < enemies; i++)
+	{
+		wave.push_back(new Enemy("Wave", 100, 10));
+	}
+	const double spawnMs = ElapsedMs(start);
+
+	start = Clock::now();
+	for (int i = 0; i < enemies; i += editEvery)
+	{
+		wave[i]->EditAttackMove(0)->InsertNode("Tail Whip", 5);
+	}
+	const double editMs = ElapsedMs(start);
+
+	// every tree is counted once however many enemies share it
+	unordered_set<const ActionTree*> trees;
+	size_t treeBytes = 0;
+	for (Enemy* enemy : wave)
+	{
+		for (const ActionTree* move : enemy->GetAttackMoves())
+		{
+			if (trees.insert(move).second)
+			{
+				treeBytes += sizeof(ActionTree) + move->GetMemoryBytes();
+			}
+		}
+	}
+
+	start = Clock::now();
+	for (Enemy* enemy : wave)
+	{
+		delete enemy;
+	}
+	const double despawnMs = ElapsedMs(start);
+
+	cout << "Spawn: " << spawnMs << " ms (" << spawnMs * 1e6 / enemies << " ns per enemy)" << '\n';
+	cout << "Copy on write edits: " << editMs << " ms for " << (enemies + editEvery - 1) / editEvery << " enemies" << '\n';
+	cout << "Attack move trees: " << trees.size() << " distinct, " << treeBytes / 1024 << " KB" << '\n';
+	cout << "Despawn: " << despawnMs << " ms" << '\n';
+}
+
+void Benchmark::MoveSelection(int moves, int picks)
+{
+	cout << "Move selection benchmark (" << moves << " moves, " << picks << " picks)" << '\n';
+	cout << "==============================================" << '\n';
+
+	vector<uint32_t> symbols(moves);
+	vector<int> damage(moves);
+	mt19937 random(1047);
+	for (int i = 0; i < moves; i++)
+	{
+		symbols[i] = ActionSymbols::Global().Intern("Skill " + to_string(i));
+		damage[i] = random() % 100;
+	}
+	shuffle(symbols.begin(), symbols.end(), random);
+
+	ActionTree plain(ACTION_TREE_RED_BLACK);
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < moves; i++)
+	{
+		plain.InsertNode(symbols[i], damage[i]);
+	}
+	const double plainMs = ElapsedMs(start);
+
+	ActionTree ordered(ACTION_TREE_RED_BLACK);
+	ordered.SetOrderStatistics(true);
+	start = Clock::now();
+	for (int i = 0; i < moves; i++)
+	{
+		ordered.InsertNode(symbols[i], damage[i]);
+	}
+	const double orderedMs = ElapsedMs(start);
+	cout << "Insert: " << plainMs * 1e6 / moves << " ns without statistics, " << orderedMs * 1e6 / moves
+		<< " ns with them, " << static_cast<double>(ordered.GetMemoryBytes()) / moves << " bytes per move against "
+		<< static_cast<double>(plain.GetMemoryBytes()) / moves << '\n';
+
+	// the walks only get a slice of the picks, each one costs a pass over the tree
+	const int walks = max(1, picks / 1000);
+	vector<uint32_t> places(picks);
+	for (int i = 0; i < picks; i++)
+	{
+		places[i] = random() % moves;
+	}
+
+	long long checksum = 0;
+	start = Clock::now();
+	for (int i = 0; i < picks; i++)
+	{
+		checksum += ordered.Select(places[i])->GetDamage();
+	}
+	const double selectNs = ElapsedMs(start) * 1e6 / picks;
+
+	long long walkedChecksum = 0;
+	start = Clock::now();
+	for (int i = 0; i < walks; i++)
+	{
+		ActionTree::Iterator move = plain.begin();
+		for (uint32_t k = 0; k < places[i]; k++)
+		{
+			++move;
+		}
+		walkedChecksum += move->GetDamage();
+	}
+	const double selectWalkNs = ElapsedMs(start) * 1e6 / walks;
+	cout << "Select: " << selectNs << " ns, walking " << selectWalkNs << " ns (" << checksum << " damage)" << '\n';
+
+	vector<const Node*> targets(picks);
+	for (int i = 0; i < picks; i++)
+	{
+		targets[i] = ordered.Find(symbols[places[i]]);
+	}
+	long long rankSum = 0;
+	start = Clock::now();
+	for (int i = 0; i < picks; i++)
+	{
+		rankSum += ordered.Rank(targets[i]);
+	}
+	const double rankNs = ElapsedMs(start) * 1e6 / picks;
+
+	long long walkedRankSum = 0;
+	start = Clock::now();
+	for (int i = 0; i < walks; i++)
+	{
+		const Node* target = plain.Find(symbols[places[i]]);
+		uint32_t rank = 0;
+		for (ActionTree::Iterator move = plain.begin(); &*move != target; ++move)
+		{
+			rank++;
+		}
+		walkedRankSum += rank;
+	}
+	const double rankWalkNs = ElapsedMs(start) * 1e6 / walks;
+	cout << "Rank: " << rankNs << " ns, walking " << rankWalkNs << " ns (" << rankSum / picks << " average place)" << '\n';
+
+	long long sampled = 0;
+	start = Clock::now();
+	for (int i = 0; i < picks; i++)
+	{
+		sampled += ordered.Sample(random)->GetDamage();
+	}
+	const double sampleNs = ElapsedMs(start) * 1e6 / picks;
+
+	// without the statistics a weighted draw needs the total, then a walk to where the draw falls
+	long long walkedSampled = 0;
+	start = Clock::now();
+	for (int i = 0; i < walks; i++)
+	{
+		long long total = 0;
+		for (const Node& move : plain)
+		{
+			total += move.GetDamage();
+		}
+		long long point = uniform_int_distribution<long long>(0, total - 1)(random);
+		for (const Node& move : plain)
+		{
+			point -= move.GetDamage();
+			if (point < 0)
+			{
+				walkedSampled += move.GetDamage();
+				break;
+			}
+		}
+	}
+	const double sampleWalkNs = ElapsedMs(start) * 1e6 / walks;
+	cout << "Weighted draw: " << sampleNs << " ns, walking " << sampleWalkNs << " ns (" << static_cast<double>(sampled) / picks
+		<< " average damage, " << static_cast<double>(walkedSampled) / walks << " walking)" << '\n';
+}
+
+void Benchmark::BulkLoading(int moves)
+{
+	cout << "Bulk load benchmark (" << moves << " moves)" << '\n';
+	cout << "==============================================" << '\n';
+
+	vector<ActionTree::Move> sorted(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		sorted[i].symbol = ActionSymbols::Global().Intern("Catalog " + to_string(i));
+		sorted[i].damage = i % 100;
+	}
+	vector<ActionTree::Move> shuffled = sorted;
+	shuffle(shuffled.begin(), shuffled.end(), mt19937(1048));
+
+	struct Run
+	{
+		const char* name;
+		const vector<ActionTree::Move>* catalog;
+		bool bulk;
+	};
+	const Run runs[] = {
+		{ "InsertNode, random order", &shuffled, false },
+		{ "InsertNode, sorted order", &sorted, false },
+		{ "BulkLoad, random order", &shuffled, true },
+		{ "BulkLoad, sorted order", &sorted, true },
+	};
+	for (const Run& run : runs)
+	{
+		ActionTree tree(ACTION_TREE_RED_BLACK);
+		Clock::time_point start = Clock::now();
+		if (run.bulk)
+		{
+			tree.BulkLoad(run.catalog->begin(), run.catalog->end());
+		}
+		else
+		{
+			for (const ActionTree::Move& move : *run.catalog)
+			{
+				tree.InsertNode(move.symbol, move.damage);
+			}
+		}
+		const double loadMs = ElapsedMs(start);
+
+		long long damage = 0;
+		start = Clock::now();
+		for (const Node& node : tree)
+		{
+			damage += node.GetDamage();
+		}
+		const double walkMs = ElapsedMs(start);
+
+		cout << run.name << ": " << loadMs << " ms (" << loadMs * 1e6 / moves << " ns per move), height " << tree.GetHeight()
+			<< ", in order walk " << walkMs * 1e6 / moves << " ns per move (" << damage << " damage)" << '\n';
+	}
+}
+
+void Benchmark::ComboDetection(int characters, int actions)
+{
+	const int moves = 1000;
+	const int combos = 300;
+	const int longest = 4;
+
+	cout << "Combo benchmark (" << characters << " characters, " << actions << " moves, " << combos << " combos)" << '\n';
+	cout << "==============================================" << '\n';
+
+	// combos are drawn from a small set of favourite moves, so streams complete them often
+	mt19937 random(1049);
+	vector<uint32_t> symbols(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		symbols[i] = ActionSymbols::Global().Intern("Technique " + to_string(i));
+	}
+	const int favourites = 12;
+	ComboDetector detector;
+	vector<vector<uint32_t>> registered;
+	for (int c = 0; c < combos; c++)
+	{
+		vector<uint32_t> combo(2 + random() % (longest - 1));
+		for (uint32_t& move : combo)
+		{
+			move = symbols[random() % favourites];
+		}
+		detector.Register("Combo " + to_string(c), combo, 1);
+		registered.push_back(combo);
+	}
+	Clock::time_point start = Clock::now();
+	detector.Compile();
+	cout << "Compile: " << ElapsedMs(start) << " ms, " << detector.GetStateCount() << " states, "
+		<< detector.GetMemoryBytes() / 1024 << " KB" << '\n';
+
+	vector<uint32_t> stream(actions);
+	vector<int> actor(actions);
+	for (int i = 0; i < actions; i++)
+	{
+		stream[i] = symbols[(random() % 4 == 0) ? random() % moves : random() % favourites];
+		actor[i] = random() % characters;
+	}
+
+	vector<uint32_t> states(characters, ComboDetector::COMBO_START);
+	long long matched = 0;
+	start = Clock::now();
+	for (int i = 0; i < actions; i++)
+	{
+		uint32_t& state = states[actor[i]];
+		state = detector.Step(state, stream[i]);
+		matched += detector.GetMatchCount(state);
+	}
+	const double automatonNs = ElapsedMs(start) * 1e6 / actions;
+
+	// the last moves of each character, newest last, checked against every combo
+	vector<uint32_t> history(static_cast<size_t>(characters) * longest, ActionSymbols::ACTION_SYMBOL_NONE);
+	long long checked = 0;
+	start = Clock::now();
+	for (int i = 0; i < actions; i++)
+	{
+		uint32_t* last = &history[static_cast<size_t>(actor[i]) * longest];
+		copy(last + 1, last + longest, last);
+		last[longest - 1] = stream[i];
+		for (const vector<uint32_t>& combo : registered)
+		{
+			checked += equal(combo.begin(), combo.end(), last + longest - combo.size());
+		}
+	}
+	const double checkNs = ElapsedMs(start) * 1e6 / actions;
+	cout << "Automaton: " << automatonNs << " ns per move (" << matched << " combos), checking every combo: "
+		<< checkNs << " ns per move (" << checked << " combos)" << '\n';
+
+	// the default attack runs Hammer Swing, Head Butt, Jab Punch, Uppercut Punch
+	ComboDetector fighting;
+	fighting.Register("One Two", vector<string>{ "Jab Punch", "Uppercut Punch" }, 2);
+	fighting.Register("Follow Through", vector<string>{ "Uppercut Punch", "Hammer Swing" }, 1);
+	fighting.Compile();
+	string targetName = "Target";
+	Character target(targetName, INT32_MAX, 0);
+	vector<Enemy*> wave;
+	for (int i = 0; i < characters; i++)
+	{
+		wave.push_back(new Enemy("Wave", 100, 10));
+	}
+	const int attacks = actions / 4;
+	for (int detect = 0; detect < 2; detect++)
+	{
+		for (Enemy* enemy : wave)
+		{
+			enemy->SetComboDetector(detect ? &fighting : nullptr);
+		}
+		target.SetHealth(INT32_MAX);
+		start = Clock::now();
+		for (int i = 0; i < attacks; i++)
+		{
+			wave[i % characters]->Attack(&target, 0);
+		}
+		const double ms = ElapsedMs(start);
+		long long landed = 0;
+		for (Enemy* enemy : wave)
+		{
+			landed += enemy->GetCombosLanded();
+		}
+		cout << (detect ? "Attacks with combos: " : "Attacks without combos: ") << attacks / ms * 1000.0 << " attacks per second, "
+			<< landed << " combos landed, " << static_cast<long long>(INT32_MAX) - target.GetHealth() << " damage" << '\n';
+	}
+	for (Enemy* enemy : wave)
+	{
+		delete enemy;
+	}
+}
+
+void Benchmark::MoveCatalogs(int moves)
+{
+	cout << "Move catalog benchmark (" << moves << " moves)" << '\n';
+	cout << "==============================================" << '\n';
+
+	// names share prefixes the way skills, items and scripted actions do
+	const char* const kinds[] = { "Uppercut ", "Upward Slash ", "Jab ", "Fireball ", "Potion of ", "Scroll of ", "Script/Quest/", "Downward Kick " };
+	mt19937 random(1050);
+	vector<uint32_t> catalog(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		catalog[i] = ActionSymbols::Global().Intern(string(kinds[random() % 8]) + to_string(i));
+	}
+	vector<string> lookups(moves);
+	for (int i = 0; i < moves; i++)
+	{
+		lookups[i] = ActionSymbols::Global().GetName(catalog[random() % moves]);
+	}
+
+	ActionTree tree(ACTION_TREE_RED_BLACK);
+	Clock::time_point start = Clock::now();
+	for (uint32_t symbol : catalog)
+	{
+		tree.InsertNode(symbol, symbol % 100);
+	}
+	const double insertMs = ElapsedMs(start);
+
+	int found = 0;
+	start = Clock::now();
+	for (const string& action : lookups)
+	{
+		found += (tree.Find(action) != nullptr) ? 1 : 0;
+	}
+	const double findMs = ElapsedMs(start);
+
+	long long damage = 0;
+	start = Clock::now();
+	for (const Node& node : tree)
+	{
+		damage += node.GetDamage();
+	}
+	const double walkMs = ElapsedMs(start);
+
+	// moves are ordered by symbol, so a prefix query checks the name of every move
+	const ActionSymbols& symbols = ActionSymbols::Global();
+	int prefixed = 0;
+	start = Clock::now();
+	for (const Node& node : tree)
+	{
+		if (symbols.GetLength(node.GetSymbol()) >= 2 && symbols.GetData(node.GetSymbol())[0] == 'U' && symbols.GetData(node.GetSymbol())[1] == 'p')
+		{
+			++prefixed;
+		}
+	}
+	const double prefixMs = ElapsedMs(start);
+
+	cout << "ActionTree, red-black: insert " << insertMs * 1e6 / moves << " ns, find " << findMs * 1e6 / moves << " ns (" << found
+		<< " found), walk " << walkMs * 1e6 / moves << " ns a move (" << damage << " damage), \"Up\" prefix " << prefixMs * 1000
+		<< " us (" << prefixed << " moves), height " << tree.GetHeight() << ", " << static_cast<double>(tree.GetMemoryBytes()) / moves
+		<< " bytes a move" << '\n';
+
+	TimeMoveCatalog<1>(catalog, lookups, ElapsedMs);
+	TimeMoveCatalog<2>(catalog, lookups, ElapsedMs);
+	TimeMoveCatalog<4>(catalog, lookups, ElapsedMs);
+}
@@ -0,0 +1,278 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+class Tile;
+template <typename T> class TileSpace;
+/**
+ * @file Benchmark.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the Benchmark class which groups the
+ * timing runs used to measure the game's data structures on large inputs. Every benchmark
+ * prints its own report to the console and is started from the 'bench' command of the Map.
+ *
+ * Methods:
+ * --------
+ * > Run(name: string) - Runs the benchmark with the given name.
+ * > List() - Prints the names of the available benchmarks.
+ * > MapLoad(rows: int, cols: int) - Compares parsing a map against loading it mapped from disk.
+ * > Pathfinding(size: int, queries: int) - Compares A* and Jump Point Search on a square map.
+ * > FlowFields(size: int, enemies: int) - Compares a shared flow field against a search per enemy.
+ * > Hierarchical(size: int, queries: int) - Compares HPA* against Jump Point Search on long routes.
+ * > Cooperative(size: int, agents: int, ticks: int) - Moves a crowd with reservations against independent searches.
+ * > SpatialIndex(count: int, queries: int) - Compares range queries through the spatial hash against a full scan.
+ * > NearestNeighbours(count: int, queries: int) - Compares k-d tree queries on a clustered crowd against a scan and the hash.
+ * > FieldsOfView(size: int, viewers: int) - Times batched and incremental shadowcasting for many viewers.
+ * > Bitboards(size: int, queries: int) - Compares bitboard flood fills and neighbour masks against the byte flag layer.
+ * > MapGeneration(rows: int, cols: int) - Times procedural generation on several thread counts and checks the maps match.
+ * > Regions(size: int, updates: int) - Times region labeling, exit reachability and incremental updates against searches.
+ * > AreaSums(size: int, queries: int) - Compares summed-area table rectangle totals against adding up the tiles.
+ * > EnvironLayers(size: int, queries: int) - Compares the palette packed Environ layer against a byte per tile.
+ * > Rendering(rows: int, cols: int, frames: int) - Compares diffed frames against printing every line with a flush.
+ * > Viewport(size: int, steps: int) - Compares scrolling the cached viewport against rendering it and the whole map every step.
+ * > ActionTrees(moves: int) - Times interning, inserting, looking up, walking and freeing moves in red-black and plain ActionTrees.
+ * > Attacks(attacks: int) - Compares attacking from a compiled combo against walking and printing the tree.
+ * > Spawning(enemies: int, editEvery: int) - Times spawning a wave of enemies and counts the attack move trees they need.
+ * > MoveSelection(moves: int, picks: int) - Compares order statistic select, rank and weighted draws against walking the tree.
+ * > BulkLoading(moves: int) - Compares building an ActionTree from a catalog with BulkLoad() against inserting every move.
+ * > ComboDetection(characters: int, actions: int) - Compares the combo automaton against matching every combo on each move.
+ * > MoveCatalogs(moves: int) - Compares ActionBTrees of a few node sizes against a red-black ActionTree on a large catalog.
+ */
+class Benchmark
+{
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * @brief Measures the time passed since a starting point.
+	 * @param start - the starting point.
+	 * @return the elapsed time in milliseconds.
+	*/
+	static double ElapsedMs(Clock::time_point start);
+
+	/**
+	 * @brief Builds a TileSpace with randomly scattered walls and wall segments. The same
+	 * seed always gives the same map.
+	 * @param rows - the number of rows in the map.
+	 * @param cols - the number of columns in the map.
+	 * @param wallPercent - roughly how many tiles out of a hundred are walls.
+	 * @param seed - the seed of the random layout.
+	 * @return a pointer to the new TileSpace, released with ReleaseSpace().
+	*/
+	static TileSpace<Tile*>* RandomSpace(int rows, int cols, int wallPercent, unsigned int seed);
+
+	/**
+	 * @brief Deletes a TileSpace made by RandomSpace() along with its backing file.
+	 * @param space - the TileSpace to delete.
+	*/
+	static void ReleaseSpace(TileSpace<Tile*>* space);
+
+public:
+	/**
+	 * @brief Runs the benchmark with the given name.
+	 * @param name - the name of the benchmark as printed by List().
+	*/
+	static void Run(const std::string& name);
+
+	/**
+	 * @brief Prints the names of the available benchmarks.
+	*/
+	static void List();
+
+	/**
+	 * @brief Compares the startup time of building a map by parsing an ASCII layout with
+	 * loading the same map from the memory mapped binary format, then checks that copies with
+	 * a broken layer descriptor fail to load or only read inside the file.
+	 * @param rows - the number of rows in the map.
+	 * @param cols - the number of columns in the map.
+	*/
+	static void MapLoad(int rows, int cols);
+
+	/**
+	 * @brief Runs the same random queries through plain A* and Jump Point Search and reports
+	 * the tiles expanded and the time taken per query.
+	 * @param size - the number of rows and columns of the map.
+	 * @param queries - the number of queries to run.
+	*/
+	static void Pathfinding(int size, int queries);
+
+	/**
+	 * @brief Times building a flow field on one and on every hardware thread, repairing it
+	 * after a few tiles change and moving a crowd of enemies along it, against running a
+	 * Jump Point Search for every enemy.
+	 * @param size - the number of rows and columns of the map.
+	 * @param enemies - the number of enemies chasing the target.
+	*/
+	static void FlowFields(int size, int enemies);
+
+	/**
+	 * @brief Times building the HPA* abstract graph, runs the same long-range queries through
+	 * HPA* and Jump Point Search, and times repairing the graph after a few tiles change.
+	 * @param size - the number of rows and columns of the map.
+	 * @param queries - the number of queries to run.
+	*/
+	static void Hierarchical(int size, int queries);
+
+	/**
+	 * @brief Moves a crowd of agents towards random goals with the cooperative planner,
+	 * checking every tick for agents sharing or swapping tiles, and counts the collisions the
+	 * same crowd would cause with every agent running its own Jump Point Search.
+	 * @param size - the number of rows and columns of the map.
+	 * @param agents - the number of agents moving every tick.
+	 * @param ticks - the number of ticks to simulate.
+	*/
+	static void Cooperative(int size, int agents, int ticks);
+
+	/**
+	 * @brief Scatters characters over a large area, then times moving all of them through the
+	 * spatial hash and answering radius and rectangle queries against scanning every character.
+	 * @param count - the number of characters.
+	 * @param queries - the number of queries of each kind.
+	*/
+	static void SpatialIndex(int count, int queries);
+
+	/**
+	 * @brief Gathers a crowd into dense clusters over a sparse background, then times
+	 * rebuilding the k-d tree, k nearest queries against a full scan and radius queries
+	 * against the spatial hash.
+	 * @param count - the number of positions.
+	 * @param queries - the number of queries of each kind.
+	*/
+	static void NearestNeighbours(int count, int queries);
+
+	/**
+	 * @brief Computes the field of view of many viewers in one batch on one and on every
+	 * hardware thread, then times the incremental update after a tenth of the viewers move
+	 * and after a few tiles change opacity.
+	 * @param size - the number of rows and columns of the map.
+	 * @param viewers - the number of viewers.
+	*/
+	static void FieldsOfView(int size, int viewers);
+
+	/**
+	 * @brief Floods the reachable area of a map through the bitboards and with a breadth first
+	 * search over the flag bytes, then compares neighbour masks read from the free layer
+	 * against eight flag checks per tile.
+	 * @param size - the number of rows and columns of the map.
+	 * @param queries - the number of neighbour mask queries.
+	*/
+	static void Bitboards(int size, int queries);
+
+	/**
+	 * @brief Generates the same seeded map on one, two, four and every hardware thread,
+	 * reporting tiles generated per second and checking every run produced the same layers.
+	 * @param rows - the number of rows of the map.
+	 * @param cols - the number of columns of the map.
+	*/
+	static void MapGeneration(int rows, int cols);
+
+	/**
+	 * @brief Labels the regions of a generated cave map, compares exit reachability lookups
+	 * against a breadth first search, then opens and closes random tiles one at a time and
+	 * checks the incremental labels against a rebuild.
+	 * @param size - the number of rows and columns of the map.
+	 * @param updates - the number of tiles toggled.
+	*/
+	static void Regions(int size, int updates);
+
+	/**
+	 * @brief Builds the damage and healing tables of a generated map on one and on every
+	 * hardware thread, compares rectangle totals against adding up the tiles, and times the
+	 * lazy rebuild of dirty bands after a few tiles change Environ.
+	 * @param size - the number of rows and columns of the map.
+	 * @param queries - the number of rectangle queries.
+	*/
+	static void AreaSums(int size, int queries);
+
+	/**
+	 * @brief Fills a palette packed Environ layer the size of a whole world, reports its memory
+	 * against a byte and a pointer per tile, times random reads and writes against a byte array,
+	 * and times renaming an Environ and widening the codes when a seventeenth Environ arrives.
+	 * @param size - the number of rows and columns of the world.
+	 * @param queries - the number of random reads and writes.
+	*/
+	static void EnvironLayers(int size, int queries);
+
+	/**
+	 * @brief Draws frames of a generated map with a handful of moving characters into a file,
+	 * once printing and flushing every line and once through the FrameRenderer, and compares
+	 * the time, bytes and flushes per frame.
+	 * @param rows - the number of rows of the frame.
+	 * @param cols - the number of columns of the frame.
+	 * @param frames - the number of frames drawn.
+	*/
+	static void Rendering(int rows, int cols, int frames);
+
+	/**
+	 * @brief Walks a camera one tile at a time across a generated map and compares redrawing
+	 * the frame through the scrolling MapView against rendering the whole viewport every step,
+	 * and against rendering the whole map.
+	 * @param size - the number of rows and columns of the map.
+	 * @param steps - the number of steps the camera takes.
+	*/
+	static void Viewport(int size, int steps);
+
+	/**
+	 * @brief Interns a move catalog, inserts it into ActionTrees in random and in sorted order, then looks
+	 * every move up by symbol and by name, comparing the red-black tree against the plain one, then times walking
+	 * each tree in order and tearing it down. The plain tree only gets a slice of the sorted catalog, since it degenerates
+	 * into a list.
+	 * @param moves - the number of moves in the catalog.
+	*/
+	static void ActionTrees(int moves);
+
+	/**
+	 * @brief Attacks with a character over and over, first the way attacks used to run, walking
+	 * the move tree and printing every move, then from the compiled combo, and reports the
+	 * attacks per second of both.
+	 * @param attacks - the number of attacks of each kind.
+	*/
+	static void Attacks(int attacks);
+
+	/**
+	 * @brief Spawns a wave of enemies, which share the default attack moves, has some of them
+	 * change a move, which copies it for them alone, then despawns the wave. Reports the times
+	 * and the memory held by the distinct trees.
+	 * @param enemies - the number of enemies in the wave.
+	 * @param editEvery - one enemy in this many changes a move.
+	*/
+	static void Spawning(int enemies, int editEvery);
+
+	/**
+	 * @brief Fills an ActionTree with moves of random damage, then picks moves by place in
+	 * order, finds the places of moves and draws moves weighted by damage, with the order
+	 * statistics and by walking the moves in order. Also times inserting with the
+	 * statistics kept.
+	 * @param moves - the number of moves in the tree.
+	 * @param picks - the number of picks of each kind.
+	*/
+	static void MoveSelection(int moves, int picks);
+
+	/**
+	 * @brief Loads a move catalog into a red-black ActionTree by inserting every move and with
+	 * BulkLoad(), from random and from sorted order, and times each along with a walk over
+	 * the loaded tree.
+	 * @param moves - the number of moves in the catalog.
+	*/
+	static void BulkLoading(int moves);
+
+	/**
+	 * @brief Registers a few hundred random combos, then feeds random moves from many
+	 * characters to the ComboDetector, each with a state of its own, and to a check of every
+	 * combo against the last moves of the character, and compares the time and the matches.
+	 * Finishes with a wave of enemies attacking with and without a detector.
+	 * @param characters - the number of characters.
+	 * @param actions - the number of moves fed in all.
+	*/
+	static void ComboDetection(int characters, int actions);
+
+	/**
+	 * @brief Fills a red-black ActionTree and ActionBTrees of 1, 2 and 4 cache lines a node
+	 * with a catalog of skill, item and scripted move names, then times inserting, finding
+	 * every move by name, walking in order and listing the moves starting with "Up", and
+	 * reports the memory each holds.
+	 * @param moves - the number of moves in the catalog.
+	*/
+	static void MoveCatalogs(int moves);
+};
@@ -0,0 +1,383 @@
+#pragma once
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Counts the set bits of a word, compiling to a single popcount where available.
+*/
+inline int PopCount(uint64_t word)
+{
+	return static_cast<int>(std::bitset<64>(word).count());
+}
+/**
+ * @file BitGrid.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the BitGrid class, a rectangle of bits packed 64 to a word,
+ * one bit per tile. Every row starts on a fresh word so a row can be read or written a word at
+ * a time and the bits of one tile sit at (row * wordsPerRow + col / 64, col % 64). A 1K x 1K
+ * grid takes 128 KB instead of the megabyte a byte per tile would.
+ *
+ * Grids of the same dimensions combine as bitboards: AND, OR and XOR handle 64 tiles per
+ * instruction, Shift() moves a whole grid one tile in any direction with word shifts that
+ * carry bits across word boundaries, and counting uses popcount. Bits past the last column of
+ * every row are kept cleared so counts and shifts never see tiles outside the grid.
+ *
+ * Properties:
+ * -----------
+ * > _rows, _cols: int - The dimensions of the grid.
+ * > _wordsPerRow: int - The number of 64 bit words holding one row.
+ * > _words: vector<uint64_t> - The packed bits, row after row.
+ *
+ * Methods:
+ * --------
+ * > BitGrid(rows: int, cols: int) - Creates a grid with every bit cleared.
+ * > Resize(rows: int, cols: int) - Changes the dimensions, clearing every bit.
+ * > Get(row, col), Set(row, col), Reset(row, col) - Single bit access.
+ * > Clear() - Clears every bit.
+ * > Count(): int - The number of set bits.
+ * > CountRect(top, left, bottom, right): int - The number of set bits inside a rectangle.
+ * > Any(): bool - Whether any bit is set.
+ * > And(other), Or(other), AndNot(other), Xor(other), Invert() - Layer algebra, a word at a time.
+ * > Shift(source, dRow, dCol) - Copies a grid moved one tile in any of the eight directions.
+ * > GetRows(), GetCols(), GetWordsPerRow() - The dimensions of the grid.
+ * > GetWords(): uint64_t* - The packed words for whole-word operations.
+ */
+class BitGrid
+{
+private:
+	int _rows;
+	int _cols;
+	int _wordsPerRow;
+	std::vector<uint64_t> _words;
+
+	/**
+	 * @brief The mask of the bits of the last word of a row that hold tiles.
+	*/
+	uint64_t TailMask() const
+	{
+		return ((_cols & 63) == 0) ? ~uint64_t(0) : ((uint64_t(1) << (_cols & 63)) - 1);
+	}
+
+	/**
+	 * @brief Throws when another grid has different dimensions.
+	*/
+	void CheckSameSize(const BitGrid& other) const
+	{
+		if (other._rows != _rows || other._cols != _cols)
+		{
+			throw std::out_of_range("Grid dimensions differ");
+		}
+	}
+
+public:
+	/**
+	 * @brief Creates a grid with every bit cleared.
+	 * @param rows - the number of rows.
+	 * @param cols - the number of columns.
+	*/
+	explicit BitGrid(int rows = 0, int cols = 0) : _rows(0), _cols(0), _wordsPerRow(0)
+	{
+		Resize(rows, cols);
+	}
+
+	/**
+	 * @brief Changes the dimensions of the grid and clears every bit, keeping the storage
+	 * when it is large enough.
+	 * @param rows - the number of rows.
+	 * @param cols - the number of columns.
+	*/
+	void Resize(int rows, int cols)
+	{
+		if (rows < 0 || cols < 0)
+		{
+			throw std::out_of_range("Grid dimensions must not be negative");
+		}
+		_rows = rows;
+		_cols = cols;
+		_wordsPerRow = (cols + 63) >> 6;
+		_words.assign(static_cast<size_t>(rows) * _wordsPerRow, 0);
+	}
+
+	/**
+	 * @brief Reads the bit of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return a boolean value indicating whether the bit is set.
+	*/
+	bool Get(int row, int col) const
+	{
+		return ((_words[static_cast<size_t>(row) * _wordsPerRow + (col >> 6)] >> (col & 63)) & 1) != 0;
+	}
+
+	/**
+	 * @brief Sets the bit of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	*/
+	void Set(int row, int col)
+	{
+		_words[static_cast<size_t>(row) * _wordsPerRow + (col >> 6)] |= uint64_t(1) << (col & 63);
+	}
+
+	/**
+	 * @brief Clears the bit of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	*/
+	void Reset(int row, int col)
+	{
+		_words[static_cast<size_t>(row) * _wordsPerRow + (col >> 6)] &= ~(uint64_t(1) << (col & 63));
+	}
+
+	/**
+	 * @brief Clears every bit.
+	*/
+	void Clear()
+	{
+		std::fill(_words.begin(), _words.end(), 0);
+	}
+
+	/**
+	 * @brief Counts the set bits.
+	 * @return an integer representing the number of set bits.
+	*/
+	int Count() const
+	{
+		int count = 0;
+		for (uint64_t word : _words)
+		{
+			count += PopCount(word);
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Counts the set bits inside a rectangle of tiles, all bounds inclusive and clipped
+	 * to the grid.
+	 * @param top - the first row.
+	 * @param left - the first column.
+	 * @param bottom - the last row.
+	 * @param right - the last column.
+	 * @return an integer representing the number of set bits.
+	*/
+	int CountRect(int top, int left, int bottom, int right) const
+	{
+		top = std::max(top, 0);
+		left = std::max(left, 0);
+		bottom = std::min(bottom, _rows - 1);
+		right = std::min(right, _cols - 1);
+		if (top > bottom || left > right)
+		{
+			return 0;
+		}
+
+		const int firstWord = left >> 6;
+		const int lastWord = right >> 6;
+		const uint64_t firstMask = ~uint64_t(0) << (left & 63);
+		const uint64_t lastMask = ((right & 63) == 63) ? ~uint64_t(0) : ((uint64_t(1) << ((right & 63) + 1)) - 1);
+
+		int count = 0;
+		for (int row = top; row <= bottom; row++)
+		{
+			const uint64_t* words = &_words[static_cast<size_t>(row) * _wordsPerRow];
+			for (int w = firstWord; w <= lastWord; w++)
+			{
+				uint64_t word = words[w];
+				if (w == firstWord)
+				{
+					word &= firstMask;
+				}
+				if (w == lastWord)
+				{
+					word &= lastMask;
+				}
+				count += PopCount(word);
+			}
+		}
+		return count;
+	}
+
+	/**
+	 * @brief Checks whether any bit is set.
+	 * @return a boolean value indicating whether a bit is set.
+	*/
+	bool Any() const
+	{
+		for (uint64_t word : _words)
+		{
+			if (word != 0)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/**
+	 * @brief Keeps only the bits also set in another grid of the same dimensions.
+	 * @param other - the grid to intersect with.
+	*/
+	void And(const BitGrid& other)
+	{
+		CheckSameSize(other);
+		for (size_t i = 0; i < _words.size(); i++)
+		{
+			_words[i] &= other._words[i];
+		}
+	}
+
+	/**
+	 * @brief Adds the bits set in another grid of the same dimensions.
+	 * @param other - the grid to unite with.
+	*/
+	void Or(const BitGrid& other)
+	{
+		CheckSameSize(other);
+		for (size_t i = 0; i < _words.size(); i++)
+		{
+			_words[i] |= other._words[i];
+		}
+	}
+
+	/**
+	 * @brief Clears the bits set in another grid of the same dimensions.
+	 * @param other - the grid to subtract.
+	*/
+	void AndNot(const BitGrid& other)
+	{
+		CheckSameSize(other);
+		for (size_t i = 0; i < _words.size(); i++)
+		{
+			_words[i] &= ~other._words[i];
+		}
+	}
+
+	/**
+	 * @brief Flips the bits set in another grid of the same dimensions.
+	 * @param other - the grid to combine with.
+	*/
+	void Xor(const BitGrid& other)
+	{
+		CheckSameSize(other);
+		for (size_t i = 0; i < _words.size(); i++)
+		{
+			_words[i] ^= other._words[i];
+		}
+	}
+
+	/**
+	 * @brief Flips every bit of the grid.
+	*/
+	void Invert()
+	{
+		const uint64_t tail = TailMask();
+		for (size_t i = 0; i < _words.size(); i++)
+		{
+			_words[i] = ~_words[i];
+			if ((i + 1) % _wordsPerRow == 0)
+			{
+				_words[i] &= tail;
+			}
+		}
+	}
+
+	/**
+	 * @brief Replaces this grid with another grid of the same dimensions moved one tile.
+	 * Bits moved past an edge are dropped and the tiles uncovered at the opposite edge are cleared.
+	 * @param source - the grid to move, which may not be this grid.
+	 * @param dRow - -1 to move every bit one row up, 1 to move it one row down, 0 to keep the row.
+	 * @param dCol - -1 to move every bit one column left, 1 to move it one column right, 0 to keep the column.
+	*/
+	void Shift(const BitGrid& source, int dRow, int dCol)
+	{
+		CheckSameSize(source);
+		if (&source == this || dRow < -1 || dRow > 1 || dCol < -1 || dCol > 1)
+		{
+			throw std::out_of_range("Shift needs another grid and steps of at most one tile");
+		}
+
+		const uint64_t tail = TailMask();
+		for (int row = 0; row < _rows; row++)
+		{
+			uint64_t* target = &_words[static_cast<size_t>(row) * _wordsPerRow];
+			const int sourceRow = row - dRow;
+			if (sourceRow < 0 || sourceRow >= _rows)
+			{
+				std::fill(target, target + _wordsPerRow, 0);
+				continue;
+			}
+
+			const uint64_t* words = &source._words[static_cast<size_t>(sourceRow) * _wordsPerRow];
+			for (int w = 0; w < _wordsPerRow; w++)
+			{
+				if (dCol == 0)
+				{
+					target[w] = words[w];
+				}
+				else if (dCol > 0)
+				{
+					// higher columns sit in higher bits, the top bit of the previous word carries in
+					target[w] = (words[w] << 1) | ((w > 0) ? (words[w - 1] >> 63) : 0);
+				}
+				else
+				{
+					target[w] = (words[w] >> 1) | ((w + 1 < _wordsPerRow) ? (words[w + 1] << 63) : 0);
+				}
+			}
+			if (_wordsPerRow > 0)
+			{
+				target[_wordsPerRow - 1] &= tail;
+			}
+		}
+	}
+
+	/**
+	 * @brief Getter for the number of rows.
+	 * @return an integer representing the number of rows.
+	*/
+	int GetRows() const
+	{
+		return _rows;
+	}
+
+	/**
+	 * @brief Getter for the number of columns.
+	 * @return an integer representing the number of columns.
+	*/
+	int GetCols() const
+	{
+		return _cols;
+	}
+
+	/**
+	 * @brief Getter for the number of words holding one row.
+	 * @return an integer representing the words per row.
+	*/
+	int GetWordsPerRow() const
+	{
+		return _wordsPerRow;
+	}
+
+	/**
+	 * @brief Getter for the packed words, row after row.
+	 * @return a pointer to the first word.
+	*/
+	const uint64_t* GetWords() const
+	{
+		return _words.data();
+	}
+
+	/**
+	 * @brief Getter for the packed words, row after row. Bits past the last column of a row
+	 * must be left cleared.
+	 * @return a pointer to the first word.
+	*/
+	uint64_t* GetWords()
+	{
+		return _words.data();
+	}
+};
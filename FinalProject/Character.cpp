@@ -1,5 +1,27 @@
 #include "Character.h"
+#include "ComboDetector.h"
 #include <iostream>
+
+namespace
+{
+	const int DEFAULT_ATTACK_MOVES = 3;
+
+	/**
+	 * @brief The default attack move, built once and shared by every character until one changes it.
+	*/
+	const std::shared_ptr<ActionTree>& DefaultAttackMove()
+	{
+		static const std::shared_ptr<ActionTree> move = []()
+		{
+			std::shared_ptr<ActionTree> tree = std::make_shared<ActionTree>();
+			// compiled up front, so characters attacking with it only ever read it
+			tree->GetCombo();
+			return tree;
+		}();
+		return move;
+	}
+}
+
 Character::Character()
 {
 	_name = "Default Character";
@@ -8,13 +30,14 @@ Character::Character()
 	_backpack = new Backpack();
 	_inHand = &_backpack->GetItemBag().GetCurrentItem();
 	_loc = new Location(0,0);
-	_attackMoves = {
-		new ActionTree(),
-		new ActionTree(),
-		new ActionTree(),
-	};
+	_attackMoves.assign(DEFAULT_ATTACK_MOVES, DefaultAttackMove());
 	_maxPower = 200;
 	_messages = new Message();
+	_spatialIndex = nullptr;
+	_comboDetector = nullptr;
+	_comboState = ComboDetector::COMBO_START;
+	_comboVersion = 0;
+	_combosLanded = 0;
 }
 
 Character::Character(std::string& name, int health, int ammo)
@@ -25,13 +48,14 @@ Character::Character(std::string& name, int health, int ammo)
 	_backpack = new Backpack();
 	_inHand = &_backpack->GetItemBag().GetCurrentItem();
 	_loc = new Location(0, 0);
-	_attackMoves = {
-		new ActionTree(),
-		new ActionTree(),
-		new ActionTree(),
-	};
+	_attackMoves.assign(DEFAULT_ATTACK_MOVES, DefaultAttackMove());
 	_maxPower = 200;
 	_messages = new Message();
+	_spatialIndex = nullptr;
+	_comboDetector = nullptr;
+	_comboState = ComboDetector::COMBO_START;
+	_comboVersion = 0;
+	_combosLanded = 0;
 }
 
 Character::Character(const Character& character)
@@ -39,21 +63,24 @@ Character::Character(const Character& character)
 	_name = character._name;
 	_health = character._health;
 	_ammo = character._ammo;
-	_backpack = character._backpack;
+	_backpack = new Backpack(*character._backpack);
 	_inHand = character._inHand;
-	_loc = character._loc;
+	_loc = new Location(character._loc->x, character._loc->y);
 	_attackMoves = character._attackMoves;
 	_maxPower = character._maxPower;
+	_messages = new Message();
+	_spatialIndex = nullptr;
+	_comboDetector = character._comboDetector;
+	_comboState = ComboDetector::COMBO_START;
+	_comboVersion = (_comboDetector == nullptr) ? 0 : _comboDetector->GetVersion();
+	_combosLanded = 0;
 }
 
 Character::~Character()
 {
+	SetSpatialIndex(nullptr);
 	delete _backpack;
 	delete _loc;
-	for (auto& move : _attackMoves)
-	{
-		delete move;
-	}
 }
 
 std::string Character::GetName() const
@@ -91,9 +118,24 @@ Location* Character::GetLocation() const
 	return _loc;
 }
 
-std::vector<ActionTree*> Character::GetAttackMoves() const
+std::vector<const ActionTree*> Character::GetAttackMoves() const
+{
+	std::vector<const ActionTree*> moves;
+	for (const auto& move : _attackMoves)
+	{
+		moves.push_back(move.get());
+	}
+	return moves;
+}
+
+ActionTree* Character::EditAttackMove(int index)
 {
-	return _attackMoves;
+	std::shared_ptr<ActionTree>& move = _attackMoves.at(index);
+	if (move.use_count() > 1)
+	{
+		move = std::make_shared<ActionTree>(*move);
+	}
+	return move.get();
 }
 
 int Character::GetMaxPower() const
@@ -134,13 +176,67 @@ void Character::SetInHand(Item* inHand)
 void Character::SetLocation(Location* loc)
 {
 	_loc = loc;
+	if (_spatialIndex != nullptr)
+	{
+		_spatialIndex->Update(this, *_loc);
+	}
+}
+
+void Character::Relocate(int row, int col)
+{
+	_loc->x = row;
+	_loc->y = col;
+	if (_spatialIndex != nullptr)
+	{
+		_spatialIndex->Update(this, *_loc);
+	}
+}
+
+SpatialHash<Character*>* Character::GetSpatialIndex() const
+{
+	return _spatialIndex;
 }
 
-void Character::SetAttackMoves(std::vector<ActionTree*>& attackMoves)
+void Character::SetSpatialIndex(SpatialHash<Character*>* index)
+{
+	if (_spatialIndex != nullptr)
+	{
+		_spatialIndex->Remove(this);
+	}
+	_spatialIndex = index;
+	if (_spatialIndex != nullptr)
+	{
+		_spatialIndex->Insert(this, *_loc);
+	}
+}
+
+void Character::SetAttackMoves(const std::vector<std::shared_ptr<ActionTree>>& attackMoves)
 {
 	_attackMoves = attackMoves;
 }
 
+ComboDetector* Character::GetComboDetector() const
+{
+	return _comboDetector;
+}
+
+void Character::SetComboDetector(ComboDetector* detector)
+{
+	_comboDetector = detector;
+	_comboState = ComboDetector::COMBO_START;
+	_comboVersion = (detector == nullptr) ? 0 : detector->GetVersion();
+}
+
+uint32_t Character::GetComboState() const
+{
+	return _comboState;
+}
+
+int Character::GetCombosLanded() const
+{
+	return _combosLanded;
+}
+
 void Character::SetMaxPower(int maxPower)
 {
 	_maxPower = maxPower;
@@ -153,15 +249,40 @@ const Character& Character::operator*() const
 
 void Character::Attack(Character* target, int moveIndex)
 {
-	_attackMoves[moveIndex]->InOrderTraverse();
-	if (target->GetHealth() - _attackMoves[moveIndex]->GetDamage() < 0)
+	// the moves land in order from the compiled combo, the tree is only walked when it changed
+	const ActionTree::Combo& combo = _attackMoves[moveIndex]->GetCombo();
+	int health = target->GetHealth();
+	if (_comboDetector == nullptr)
+	{
+		for (size_t i = 0; i < combo.damage.size() && health >= 0; i++)
+		{
+			health -= combo.damage[i];
+		}
+	}
+	else
+	{
+		// a state from before the detector was last compiled means nothing to it now
+		if (_comboVersion != _comboDetector->GetVersion())
+		{
+			_comboState = ComboDetector::COMBO_START;
+			_comboVersion = _comboDetector->GetVersion();
+		}
+		for (size_t i = 0; i < combo.damage.size() && health >= 0; i++)
+		{
+			_comboState = _comboDetector->Step(_comboState, combo.moves[i]);
+			_combosLanded += _comboDetector->GetMatchCount(_comboState);
+			health -= combo.damage[i] + _comboDetector->GetBonus(_comboState);
+		}
+	}
+
+	if (health < 0)
 	{
 		target->SetHealth(0);
-		std::cout << target->GetName() << " is slain" << std::endl;
+		std::cout << target->GetName() << " is slain\n";
 	}
 	else
 	{
-		target->SetHealth(target->GetHealth() - _attackMoves[moveIndex]->GetDamage());
+		target->SetHealth(health);
 	}
 }
 
@@ -169,15 +290,15 @@ void Character::Interact(Environ* env)
 {
 	if (env->GetHazard())
 	{
-		std::cout << "You have been hurt by the " << env->GetName() << std::endl;
+		std::cout << "You have been hurt by the " << env->GetName() << '\n';
 		SetHealth(GetHealth() - env->GetDamage());
-		std::cout << "Your health is now " << GetHealth() << std::endl;
+		std::cout << "Your health is now " << GetHealth() << '\n';
 	}
 	else
 	{
-		std::cout << "You've attained a health boost from " << env->GetName() << std::endl;
+		std::cout << "You've attained a health boost from " << env->GetName() << '\n';
 		SetHealth(GetHealth() + env->GetDamage());
-		std::cout << "Your health is now " << GetHealth() << std::endl;
+		std::cout << "Your health is now " << GetHealth() << '\n';
 	}
 }
 
@@ -193,17 +314,17 @@ void Character::SendMessage(Character* target, std::string& message)
 
 void Character::ShowStats()
 {
-	std::cout << "Name: " << GetName() << std::endl;
-	std::cout << "Health: " << GetHealth() << std::endl;
-	std::cout << "Ammo: " << GetAmmo() << std::endl;
-	std::cout << "Location: " << GetLocation()->x << ", " << GetLocation()->y << std::endl;
-	std::cout << "In Hand: " << GetInHand()->GetName() << std::endl;
-	std::cout << "Backpack: " << "Empty - Yet to collect items" << std::endl;
+	std::cout << "Name: " << GetName() << '\n';
+	std::cout << "Health: " << GetHealth() << '\n';
+	std::cout << "Ammo: " << GetAmmo() << '\n';
+	std::cout << "Location: " << GetLocation()->x << ", " << GetLocation()->y << '\n';
+	std::cout << "In Hand: " << GetInHand()->GetName() << '\n';
+	std::cout << "Backpack: " << "Empty - Yet to collect items\n";
 	GetBackpack()->Display();
-	std::cout << "Attack Moves: " << std::endl;
+	std::cout << "Attack Moves: \n";
 	for (int i = 0; i < static_cast<int>(_attackMoves.size()); i++)
 	{
-		std::cout << i << ": " << std::endl;
+		std::cout << i << ": \n";
 		_attackMoves[i]->InOrderTraverse();
 	}
 }
@@ -218,17 +339,17 @@ void Character::ShowMessages() const
 			(msg.GetPrevious() == Message::NULL_MESSAGE)
 			? "None"
 			: "You had a Previous message to this"
-		) << std::endl;
-		std::cout << "From: " << msg.GetSender()->GetName() << std::endl;
-		std::cout << "To: " << msg.GetReceiver()->GetName() << std::endl;
-		std::cout << "Message: " << msg.GetMessage() << std::endl;
-		std::cout << "Date: " << msg.GetDate() << std::endl;
+		) << '\n';
+		std::cout << "From: " << msg.GetSender()->GetName() << '\n';
+		std::cout << "To: " << msg.GetReceiver()->GetName() << '\n';
+		std::cout << "Message: " << msg.GetMessage() << '\n';
+		std::cout << "Date: " << msg.GetDate() << '\n';
 		std::cout << "Reply To Message" << (
 			(msg.GetResponse() == Message::NULL_MESSAGE) 
 			? "You haven't replied to this message"
 			: "You've replied to this Message"
-		) << std::endl;
-		std::cout << std::endl;
+		) << '\n';
+		std::cout << '\n';
 
 		current = *current.GetResponse();
 	}
@@ -6,8 +6,11 @@
 #include <string>
 #include <vector>
 #include "BidirectionalList.h"
+#include "SpatialHash.h"
+#include <memory>
 
 class Message;
+class ComboDetector;
 /**
  * @file Character.h
  * @author Billy Ndegwah Micah
@@ -15,6 +18,16 @@ class Message;
  * Description: This is the definition of the Character class from which both the
  * Player and Enemy extend.
  *
+ * Attack moves are shared: every character starts out with the same default ActionTrees,
+ * built once, and copies of a character share its trees. The trees are reference counted
+ * and a character only gets a private copy of one when it changes it through
+ * EditAttackMove(), so a wave of enemies costs no trees at all until one of them learns a
+ * move of its own.
+ *
+ * A character can be given a ComboDetector, shared by any number of characters, and then
+ * keeps its own place in it: every move it lands moves that place on by one step, and a
+ * combo completed by the move adds its bonus damage to the attack.
+ *
  * Properties
  * ----------
  * > _name: string - This is the name of the character
@@ -23,9 +36,13 @@ class Message;
  * > _backpack: Backpack* - This is the backpack of the character
  * > _inHand: Item* - This is the item in the hand of the character
  * > _loc: Location* - This is the location of the character
- * > _attackMoves: vector<ActionTree> - This is the list of attack moves of the character
+ * > _attackMoves: vector<shared_ptr<ActionTree>> - This is the list of attack moves of the character, shared until changed
  * > _maxPower: int - This is the maximum power of the character
  * > _messages: BidirectionalList<Message> - This is the list of messages of the character
+ * > _spatialIndex: SpatialHash<Character*>* - This is the spatial index kept in step with the location
+ * > _comboDetector: ComboDetector* - This is the combo detector the attacks are fed to
+ * > _comboState, _comboVersion: uint32_t - This is the state reached in the combo detector, and its version then
+ * > _combosLanded: int - This is the number of combos completed so far
  *
  * Methods
  * -------
@@ -34,8 +51,10 @@ class Message;
  * > Character(const Character& character) - This is the copy constructor for the class
  * > ~Character() - This is the destructor
  * > Getters and Setter for the properties
+ * > EditAttackMove(index: int) - This is the method for changing an attack move, copying it first if shared
  * > Attack() - This is the method for attacking
  * > Interact(env: Environ*) - This is the method for interacting with the environment
+ * > Relocate(row: int, col: int) - This is the method for moving the character to another tile
  * > ShowStats() - This is the method for showing the stats of the character
  *
  */
@@ -52,9 +71,14 @@ protected:
 	Backpack* _backpack;
 	Item* _inHand;
 	Location* _loc;
-	std::vector<ActionTree*> _attackMoves;
+	std::vector<std::shared_ptr<ActionTree>> _attackMoves;
 	int _maxPower;
 	Message* _messages;
+	SpatialHash<Character*>* _spatialIndex;
+	ComboDetector* _comboDetector;
+	uint32_t _comboState;
+	uint32_t _comboVersion;
+	int _combosLanded;
 
 public:
 	/**
@@ -71,7 +95,9 @@ public:
 	Character(std::string& name, int health, int ammo);
 
 	/**
-	 * @brief This is the copy constructor for the class
+	 * @brief This is the copy constructor for the class, the copy gets a backpack and
+	 * location of its own, shares the attack moves and the combo detector, and starts
+	 * its combos afresh
 	 * @param character - the character to be copied
 	*/
 	Character(const Character& character);
@@ -124,10 +150,18 @@ public:
 	Location* GetLocation() const;
 
 	/**
-	 * @brief Getter for the attack moves of the character
-	 * @return a pointer to the attack moves of the character
+	 * @brief Getter for the attack moves of the character, which may be shared with others
+	 * @return pointers to the attack moves of the character, read only
 	*/
-	std::vector<ActionTree*> GetAttackMoves() const;
+	std::vector<const ActionTree*> GetAttackMoves() const;
+
+	/**
+	 * @brief Getter for an attack move to be changed. A move shared with other characters
+	 * is copied first, so the change only reaches this character
+	 * @param index - the index of the attack move
+	 * @return a pointer to the character's own tree, to change before the character is copied again
+	*/
+	ActionTree* EditAttackMove(int index);
 
 	/**
 	 * @brief Getter for the maximum power of the character
@@ -178,10 +212,53 @@ public:
 	void SetLocation(Location* loc);
 
 	/**
-	 * @brief Setter for the attack moves of the character
+	 * @brief Moves the character to another tile, keeping its spatial index up to date
+	 * @param row - the row of the tile
+	 * @param col - the column of the tile
+	*/
+	void Relocate(int row, int col);
+
+	/**
+	 * @brief Getter for the spatial index the character is registered in
+	 * @return a pointer to the spatial index, nullptr if the character is not indexed
+	*/
+	SpatialHash<Character*>* GetSpatialIndex() const;
+
+	/**
+	 * @brief Setter for the spatial index of the character, leaving any previous index
+	 * @param index - the desired spatial index, nullptr to stop being indexed
+	*/
+	void SetSpatialIndex(SpatialHash<Character*>* index);
+
+	/**
+	 * @brief Getter for the combo detector the attacks of the character are fed to
+	 * @return a pointer to the combo detector, nullptr if combos are not detected
+	*/
+	ComboDetector* GetComboDetector() const;
+
+	/**
+	 * @brief Setter for the combo detector of the character, starting its combos afresh
+	 * @param detector - the desired combo detector, nullptr to stop detecting combos
+	*/
+	void SetComboDetector(ComboDetector* detector);
+
+	/**
+	 * @brief Getter for the state the character reached in its combo detector
+	 * @return the state of the automaton after the last move landed
+	*/
+	uint32_t GetComboState() const;
+
+	/**
+	 * @brief Getter for the number of combos the character completed
+	 * @return an integer representing the combos landed so far
+	*/
+	int GetCombosLanded() const;
+
+	/**
+	 * @brief Setter for the attack moves of the character, shared with whoever else holds them
 	 * @param attackMoves - the desired attack moves of the character
 	*/
-	void SetAttackMoves(std::vector<ActionTree*>& attackMoves);
+	void SetAttackMoves(const std::vector<std::shared_ptr<ActionTree>>& attackMoves);
 
 	/**
 	 * @brief Setter for the maximum power of the character
@@ -192,7 +269,9 @@ public:
 	const Character& operator*() const;
 
 	/**
-	 * @brief This is the method for attacking
+	 * @brief This is the method for attacking, the moves of the attack land in order from
+	 * the compiled combo of the tree, without walking it or printing. With a combo detector
+	 * each move also steps the combo state, and combos it completes deal their bonus.
 	 * @param target - pointer to the character to attack
 	 * @param moveIndex - the index of the attack move to use in attacking
 	*/
@@ -0,0 +1,180 @@
+#include "ComboDetector.h"
+#include "ActionSymbols.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+	const uint32_t NO_STATE = 0xFFFFFFFFu;
+}
+
+const uint32_t ComboDetector::COMBO_START;
+
+ComboDetector::ComboDetector()
+{
+	_version = 0;
+	Compile();
+}
+
+int ComboDetector::Register(const string& name, const vector<string>& moves, int bonus)
+{
+	vector<uint32_t> symbols;
+	for (const string& move : moves)
+	{
+		symbols.push_back(ActionSymbols::Global().Intern(move));
+	}
+	return Register(name, symbols, bonus);
+}
+
+int ComboDetector::Register(const string& name, const vector<uint32_t>& moves, int bonus)
+{
+	if (moves.empty())
+	{
+		throw out_of_range("A combo needs at least one move");
+	}
+	_combos.push_back(Combo{ name, moves, bonus });
+	return static_cast<int>(_combos.size()) - 1;
+}
+
+void ComboDetector::Compile()
+{
+	// letters go to the moves found in combos, every other move shares letter 0
+	_letters.clear();
+	_alphabet = 1;
+	for (const Combo& combo : _combos)
+	{
+		for (uint32_t symbol : combo.moves)
+		{
+			if (symbol >= _letters.size())
+			{
+				_letters.resize(symbol + 1, 0);
+			}
+			if (_letters[symbol] == 0)
+			{
+				_letters[symbol] = _alphabet++;
+			}
+		}
+	}
+
+	// the trie, its missing edges marked to be filled in below
+	_next.assign(_alphabet, NO_STATE);
+	vector<vector<uint32_t>> ending(1);
+	for (size_t c = 0; c < _combos.size(); c++)
+	{
+		uint32_t state = COMBO_START;
+		for (uint32_t symbol : _combos[c].moves)
+		{
+			uint32_t& edge = _next[state * _alphabet + _letters[symbol]];
+			if (edge == NO_STATE)
+			{
+				edge = static_cast<uint32_t>(ending.size());
+				ending.emplace_back();
+				_next.resize(_next.size() + _alphabet, NO_STATE);
+			}
+			// the resize may have moved the row, so the edge is read again from the table
+			state = _next[state * _alphabet + _letters[symbol]];
+		}
+		ending[state].push_back(static_cast<uint32_t>(c));
+	}
+	const uint32_t states = static_cast<uint32_t>(ending.size());
+
+	// breadth first, each state is reached after its failure link, which is shallower, so
+	// missing edges are copied from the failure link and its combos are already complete
+	vector<uint32_t> failure(states, COMBO_START);
+	vector<uint32_t> queue;
+	for (uint32_t letter = 0; letter < _alphabet; letter++)
+	{
+		uint32_t& edge = _next[letter];
+		if (edge == NO_STATE)
+		{
+			edge = COMBO_START;
+		}
+		else
+		{
+			queue.push_back(edge);
+		}
+	}
+	for (size_t head = 0; head < queue.size(); head++)
+	{
+		const uint32_t state = queue[head];
+		const vector<uint32_t>& inherited = ending[failure[state]];
+		ending[state].insert(ending[state].end(), inherited.begin(), inherited.end());
+		for (uint32_t letter = 0; letter < _alphabet; letter++)
+		{
+			uint32_t& edge = _next[state * _alphabet + letter];
+			const uint32_t fallback = _next[failure[state] * _alphabet + letter];
+			if (edge == NO_STATE)
+			{
+				edge = fallback;
+			}
+			else
+			{
+				failure[edge] = fallback;
+				queue.push_back(edge);
+			}
+		}
+	}
+
+	_matchStart.assign(1, 0);
+	_matches.clear();
+	_bonus.assign(states, 0);
+	for (uint32_t state = 0; state < states; state++)
+	{
+		for (uint32_t combo : ending[state])
+		{
+			_matches.push_back(combo);
+			_bonus[state] += _combos[combo].bonus;
+		}
+		_matchStart.push_back(static_cast<uint32_t>(_matches.size()));
+	}
+	_version++;
+}
+
+uint32_t ComboDetector::Step(uint32_t state, uint32_t symbol) const
+{
+	const uint32_t letter = (symbol < _letters.size()) ? _letters[symbol] : 0;
+	return _next[state * _alphabet + letter];
+}
+
+uint32_t ComboDetector::GetMatchCount(uint32_t state) const
+{
+	return _matchStart[state + 1] - _matchStart[state];
+}
+
+int ComboDetector::GetMatch(uint32_t state, uint32_t i) const
+{
+	return static_cast<int>(_matches[_matchStart[state] + i]);
+}
+
+int ComboDetector::GetBonus(uint32_t state) const
+{
+	return _bonus[state];
+}
+
+const string& ComboDetector::GetName(int combo) const
+{
+	return _combos[combo].name;
+}
+
+int ComboDetector::GetComboCount() const
+{
+	return static_cast<int>(_combos.size());
+}
+
+uint32_t ComboDetector::GetStateCount() const
+{
+	return static_cast<uint32_t>(_bonus.size());
+}
+
+uint32_t ComboDetector::GetVersion() const
+{
+	return _version;
+}
+
+size_t ComboDetector::GetMemoryBytes() const
+{
+	return (_letters.capacity() + _next.capacity() + _matchStart.capacity() + _matches.capacity()) * sizeof(uint32_t)
+		+ _bonus.capacity() * sizeof(int);
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+/**
+ * @file ComboDetector.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the ComboDetector class, a registry of
+ * combos, sequences of moves such as Jab Punch then Uppercut Punch, that recognises them in
+ * the moves characters attack with as they land.
+ *
+ * Moves are matched by their symbols in ActionSymbols::Global(). Compile() turns the
+ * registered combos into an Aho-Corasick automaton: a trie of the combos in which every
+ * state also knows where to go on any move, following failure links to the longest combo
+ * prefix that is still a suffix of what was seen, so the automaton never backs up. Only
+ * moves found in some combo get a letter of their own, every other move is letter 0 and
+ * sends the automaton back to the start, which keeps the table at one row of letters per
+ * state. Each state lists the combos that end there, its own and those of its failure
+ * links, and the bonus damage they add up to.
+ *
+ * The detector holds no per character data. A character keeps the state it reached,
+ * starting at COMBO_START, and hands it to Step() with each move, one table read a move
+ * however many combos and characters there are. Combos registered after Compile() only
+ * count once it is called again, which bumps the version, so holders of old states can
+ * tell they have to start over.
+ *
+ * Properties:
+ * -----------
+ * > _combos: vector<Combo> - The registered combos.
+ * > _letters: vector<uint32_t> - The letter of each symbol, 0 for moves in no combo.
+ * > _alphabet: uint32_t - The number of letters, 0 included.
+ * > _next: vector<uint32_t> - The state after each state and letter, a row per state.
+ * > _matchStart: vector<uint32_t> - Where the combos ending at each state start in _matches.
+ * > _matches: vector<uint32_t> - The combos ending at each state, state after state.
+ * > _bonus: vector<int> - The bonus damage of the combos ending at each state.
+ * > _version: uint32_t - The number of times the automaton was compiled.
+ *
+ * Methods:
+ * --------
+ * > Register(name, moves, bonus): int - Adds a combo, by move names or symbols.
+ * > Compile() - Builds the automaton from every registered combo.
+ * > Step(state, symbol): uint32_t - The state after a move.
+ * > GetMatchCount(state), GetMatch(state, i) - The combos a state completes.
+ * > GetBonus(state): int - The bonus damage of the combos a state completes.
+ * > GetName(combo), GetComboCount(), GetStateCount(), GetVersion(), GetMemoryBytes() - Getters.
+ */
+class ComboDetector
+{
+public:
+	static const uint32_t COMBO_START = 0;
+
+private:
+	/**
+	 * @brief A registered combo.
+	*/
+	struct Combo
+	{
+		std::string name;
+		std::vector<uint32_t> moves;
+		int bonus;
+	};
+
+	std::vector<Combo> _combos;
+	std::vector<uint32_t> _letters;
+	uint32_t _alphabet;
+	std::vector<uint32_t> _next;
+	std::vector<uint32_t> _matchStart;
+	std::vector<uint32_t> _matches;
+	std::vector<int> _bonus;
+	uint32_t _version;
+
+public:
+	/**
+	 * @brief Creates a detector without combos, every move leaves it at COMBO_START.
+	*/
+	ComboDetector();
+
+	/**
+	 * @brief Registers a combo by the names of its moves, interning them.
+	 * @param name - the name of the combo.
+	 * @param moves - the moves of the combo in order, at least one.
+	 * @param bonus - the extra damage the combo deals when it lands.
+	 * @return the id of the combo.
+	*/
+	int Register(const std::string& name, const std::vector<std::string>& moves, int bonus = 0);
+
+	/**
+	 * @brief Registers a combo by the symbols of its moves.
+	 * @param name - the name of the combo.
+	 * @param moves - the symbols of the moves of the combo in order, at least one.
+	 * @param bonus - the extra damage the combo deals when it lands.
+	 * @return the id of the combo.
+	*/
+	int Register(const std::string& name, const std::vector<uint32_t>& moves, int bonus = 0);
+
+	/**
+	 * @brief Builds the automaton from every combo registered so far and bumps the version.
+	 * Takes time and memory in proportion to the number of states times the number of moves
+	 * found in combos.
+	*/
+	void Compile();
+
+	/**
+	 * @brief Moves the automaton on by one move.
+	 * @param state - the state reached so far, COMBO_START at first.
+	 * @param symbol - the symbol of the move.
+	 * @return the state after the move.
+	*/
+	uint32_t Step(uint32_t state, uint32_t symbol) const;
+
+	/**
+	 * @brief Getter for the number of combos a state completes.
+	 * @param state - a state of the automaton.
+	 * @return the number of combos ending with the last move.
+	*/
+	uint32_t GetMatchCount(uint32_t state) const;
+
+	/**
+	 * @brief Getter for a combo a state completes.
+	 * @param state - a state of the automaton.
+	 * @param i - which of its combos, from 0 to GetMatchCount(state) - 1.
+	 * @return the id of the combo.
+	*/
+	int GetMatch(uint32_t state, uint32_t i) const;
+
+	/**
+	 * @brief Getter for the bonus damage of a state.
+	 * @param state - a state of the automaton.
+	 * @return the bonus damage of every combo ending with the last move.
+	*/
+	int GetBonus(uint32_t state) const;
+
+	/**
+	 * @brief Getter for the name of a combo.
+	 * @param combo - the id of the combo.
+	 * @return the name it was registered with.
+	*/
+	const std::string& GetName(int combo) const;
+
+	/**
+	 * @brief Getter for the number of registered combos.
+	 * @return the number of combos, compiled or not.
+	*/
+	int GetComboCount() const;
+
+	/**
+	 * @brief Getter for the number of states of the automaton.
+	 * @return the number of states, COMBO_START included.
+	*/
+	uint32_t GetStateCount() const;
+
+	/**
+	 * @brief Getter for the version.
+	 * @return the number of times the automaton was compiled.
+	*/
+	uint32_t GetVersion() const;
+
+	/**
+	 * @brief Getter for the memory the automaton holds.
+	 * @return the number of bytes in its tables.
+	*/
+	size_t GetMemoryBytes() const;
+};
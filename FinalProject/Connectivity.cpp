@@ -0,0 +1,380 @@
+#include "Connectivity.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+namespace
+{
+	const int NEIGHBOUR_ROWS[] = { -1, 1, 0, 0 };
+	const int NEIGHBOUR_COLS[] = { 0, 0, -1, 1 };
+	// splits may walk this share of the map before a rebuild is cheaper
+	const size_t SPLIT_BUDGET_DIVISOR = 32;
+}
+
+const int Connectivity::NO_REGION;
+
+Connectivity::Connectivity(const TileSpace<Tile*>* space)
+{
+	_space = space;
+	_flags = space->GetFlagsLayer();
+	_rows = space->GetRows();
+	_cols = space->GetCols();
+	_generation = 0;
+	Rebuild();
+}
+
+bool Connectivity::Walkable(int row, int col) const
+{
+	return row >= 0 && row < _rows && col >= 0 && col < _cols
+		&& (_flags[static_cast<size_t>(row) * _cols + col] & TILE_WALKABLE) != 0;
+}
+
+void Connectivity::Rebuild()
+{
+	const size_t tiles = static_cast<size_t>(_rows) * _cols;
+	_label.assign(tiles, NO_REGION);
+	_owner.assign(tiles, 0);
+	_stamp.assign(tiles, 0);
+	_generation = 0;
+	_regions.Clear();
+
+	// first pass, every tile takes the set of the neighbour above or to its left
+	for (int row = 0; row < _rows; row++)
+	{
+		for (int col = 0; col < _cols; col++)
+		{
+			const size_t index = static_cast<size_t>(row) * _cols + col;
+			if ((_flags[index] & TILE_WALKABLE) == 0)
+			{
+				continue;
+			}
+
+			const int north = (row > 0) ? _label[index - _cols] : NO_REGION;
+			const int west = (col > 0) ? _label[index - 1] : NO_REGION;
+			if (north == NO_REGION && west == NO_REGION)
+			{
+				_label[index] = _regions.MakeSet(1);
+				continue;
+			}
+
+			_label[index] = (north != NO_REGION) ? north : west;
+			_regions.AddWeight(_label[index], 1);
+			if (north != NO_REGION && west != NO_REGION)
+			{
+				_regions.Union(north, west);
+			}
+		}
+	}
+
+	// second pass, every tile points straight at its root
+	_regionCount = 0;
+	for (int& label : _label)
+	{
+		if (label != NO_REGION)
+		{
+			label = _regions.Find(label);
+		}
+	}
+	for (int id = 0; id < _regions.Size(); id++)
+	{
+		if (_regions.Find(id) == id)
+		{
+			_regionCount++;
+		}
+	}
+}
+
+void Connectivity::Open(int index)
+{
+	const int row = index / _cols;
+	const int col = index % _cols;
+	int region = NO_REGION;
+
+	for (int d = 0; d < 4; d++)
+	{
+		const int r = row + NEIGHBOUR_ROWS[d];
+		const int c = col + NEIGHBOUR_COLS[d];
+		const int neighbour = (r >= 0 && r < _rows && c >= 0 && c < _cols) ? _label[static_cast<size_t>(r) * _cols + c] : NO_REGION;
+		if (neighbour == NO_REGION)
+		{
+			continue;
+		}
+
+		if (region == NO_REGION)
+		{
+			region = _regions.Find(neighbour);
+			_regions.AddWeight(region, 1);
+		}
+		else if (_regions.Find(neighbour) != _regions.Find(region))
+		{
+			region = _regions.Union(region, neighbour);
+			_regionCount--;
+		}
+	}
+
+	if (region == NO_REGION)
+	{
+		region = _regions.MakeSet(1);
+		_regionCount++;
+	}
+	_label[index] = region;
+}
+
+bool Connectivity::Split(int region, const vector<int>& seeds, size_t& budget)
+{
+	++_generation;
+	const int searches = static_cast<int>(seeds.size());
+	if (static_cast<int>(_queues.size()) < searches)
+	{
+		_queues.resize(searches);
+	}
+
+	// searches that met share a group; the root of a group counts its running searches and
+	// heads a list of its members, so neither needs a scan over every search
+	vector<int> group(searches), heads(searches, 0), live(searches, 0);
+	vector<int> first(searches), last(searches), nextMember(searches, -1);
+	vector<bool> spent(searches, false);
+	auto root = [&](int search)
+	{
+		while (group[search] != search)
+		{
+			search = group[search] = group[group[search]];
+		}
+		return search;
+	};
+
+	vector<int> running, dried, dry;
+	for (int s = 0; s < searches; s++)
+	{
+		group[s] = s;
+		_queues[s].clear();
+		if (_stamp[seeds[s]] == _generation)
+		{
+			// the same tile was given twice, an empty search joined to the first one
+			group[s] = root(_owner[seeds[s]]);
+			continue;
+		}
+		_stamp[seeds[s]] = _generation;
+		_owner[seeds[s]] = s;
+		_queues[s].push_back(seeds[s]);
+		first[s] = last[s] = s;
+		live[s] = 1;
+		running.push_back(s);
+	}
+
+	int active = static_cast<int>(running.size());
+	size_t reached = 0;
+	while (active > 1)
+	{
+		// only running searches take a step, the ones that run dry drop out of the list
+		size_t kept = 0;
+		for (size_t i = 0; i < running.size(); i++)
+		{
+			const int s = running[i];
+			const int index = _queues[s][heads[s]++];
+			const int row = index / _cols;
+			const int col = index % _cols;
+			for (int d = 0; d < 4; d++)
+			{
+				const int r = row + NEIGHBOUR_ROWS[d];
+				const int c = col + NEIGHBOUR_COLS[d];
+				if (!Walkable(r, c))
+				{
+					continue;
+				}
+
+				const int next = r * _cols + c;
+				if (_stamp[next] != _generation)
+				{
+					_stamp[next] = _generation;
+					_owner[next] = s;
+					_queues[s].push_back(next);
+					reached++;
+					continue;
+				}
+
+				const int other = root(_owner[next]);
+				const int mine = root(s);
+				if (other != mine)
+				{
+					group[other] = mine;
+					live[mine] += live[other];
+					nextMember[last[mine]] = first[other];
+					last[mine] = last[other];
+					active--;
+				}
+			}
+
+			if (heads[s] < static_cast<int>(_queues[s].size()))
+			{
+				running[kept++] = s;
+			}
+			else
+			{
+				live[root(s)]--;
+				dried.push_back(s);
+			}
+		}
+		running.resize(kept);
+
+		// the searches are more work than a rebuild, which the caller falls back to
+		if (reached > budget)
+		{
+			return false;
+		}
+
+		// a group whose searches all ran dry has walked around a whole piece
+		dry.clear();
+		for (int s : dried)
+		{
+			const int g = root(s);
+			if (live[g] == 0 && !spent[g])
+			{
+				spent[g] = true;
+				dry.push_back(g);
+			}
+		}
+		dried.clear();
+
+		// the last piece standing keeps the region, every other piece gets a set of its own
+		const int keep = (active == static_cast<int>(dry.size())) ? 1 : 0;
+		for (size_t i = keep; i < dry.size(); i++)
+		{
+			int size = 0;
+			for (int t = first[dry[i]]; t != -1; t = nextMember[t])
+			{
+				size += static_cast<int>(_queues[t].size());
+			}
+
+			const int piece = _regions.MakeSet(size);
+			for (int t = first[dry[i]]; t != -1; t = nextMember[t])
+			{
+				for (int tile : _queues[t])
+				{
+					_label[tile] = piece;
+				}
+			}
+			_regions.AddWeight(region, -size);
+			_regionCount++;
+		}
+		active -= static_cast<int>(dry.size());
+	}
+	budget -= reached;
+	return true;
+}
+
+void Connectivity::UpdateTiles(const vector<Location>& changed)
+{
+	vector<int> closed;
+	for (const Location& tile : changed)
+	{
+		if (tile.x < 0 || tile.x >= _rows || tile.y < 0 || tile.y >= _cols)
+		{
+			continue;
+		}
+		const int index = tile.x * _cols + tile.y;
+		const bool walkable = (_flags[index] & TILE_WALKABLE) != 0;
+		if (walkable && _label[index] == NO_REGION)
+		{
+			Open(index);
+		}
+		else if (!walkable && _label[index] != NO_REGION)
+		{
+			// taken out right away, the searches below walk the final map
+			const int region = _regions.Find(_label[index]);
+			_label[index] = NO_REGION;
+			_regions.AddWeight(region, -1);
+			if (_regions.GetWeight(region) == 0)
+			{
+				_regionCount--;
+			}
+			closed.push_back(index);
+		}
+	}
+
+	vector<pair<int, int>> seeds;
+	for (int index : closed)
+	{
+		const int row = index / _cols;
+		const int col = index % _cols;
+		for (int d = 0; d < 4; d++)
+		{
+			const int r = row + NEIGHBOUR_ROWS[d];
+			const int c = col + NEIGHBOUR_COLS[d];
+			if (Walkable(r, c))
+			{
+				const int next = r * _cols + c;
+				seeds.push_back(make_pair(_regions.Find(_label[next]), next));
+			}
+		}
+	}
+
+	// a region can only split along its own closed tiles, so each region is checked on its own
+	sort(seeds.begin(), seeds.end());
+	seeds.erase(unique(seeds.begin(), seeds.end()), seeds.end());
+	// searches that walk more tiles than a rebuild touches give up, and the map is relabeled
+	size_t budget = static_cast<size_t>(_rows) * _cols / SPLIT_BUDGET_DIVISOR;
+	vector<int> group;
+	for (size_t i = 0; i < seeds.size(); i++)
+	{
+		group.push_back(seeds[i].second);
+		if (i + 1 == seeds.size() || seeds[i + 1].first != seeds[i].first)
+		{
+			if (group.size() > 1 && !Split(seeds[i].first, group, budget))
+			{
+				Rebuild();
+				return;
+			}
+			group.clear();
+		}
+	}
+}
+
+int Connectivity::GetRegion(int row, int col) const
+{
+	if (row < 0 || row >= _rows || col < 0 || col >= _cols)
+	{
+		return NO_REGION;
+	}
+	const int label = _label[static_cast<size_t>(row) * _cols + col];
+	return (label == NO_REGION) ? NO_REGION : _regions.Find(label);
+}
+
+int Connectivity::GetRegionSize(int row, int col) const
+{
+	const int region = GetRegion(row, col);
+	return (region == NO_REGION) ? 0 : _regions.GetWeight(region);
+}
+
+bool Connectivity::Connected(const Location& from, const Location& to) const
+{
+	const int region = GetRegion(from.x, from.y);
+	return region != NO_REGION && region == GetRegion(to.x, to.y);
+}
+
+int Connectivity::ReachableExits() const
+{
+	const Tile* entry = _space->GetEntryPoint();
+	const Tile* exits[] = { _space->GetExitOne(), _space->GetExitTwo(), _space->GetExitThree() };
+	int reachable = 0;
+	if (entry == nullptr)
+	{
+		return reachable;
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		if (exits[i] != nullptr && Connected(*entry->GetPosition(), *exits[i]->GetPosition()))
+		{
+			reachable |= 1 << i;
+		}
+	}
+	return reachable;
+}
+
+int Connectivity::GetRegionCount() const
+{
+	return _regionCount;
+}
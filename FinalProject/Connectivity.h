@@ -0,0 +1,146 @@
+#pragma once
+#include "TileSpace.h"
+#include "DisjointSet.h"
+
+#include <vector>
+/**
+ * @file Connectivity.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the Connectivity class which labels
+ * the connected regions of walkable tiles of a TileSpace, so asking whether two tiles, or the
+ * entry point and an exit, are connected is a lookup instead of a search. Characters move in
+ * eight directions but never cut corners, so a diagonal step is only allowed when both tiles
+ * beside it are walkable, and those two tiles already connect the ends of the step. Regions
+ * are therefore exactly the four-connected components of walkable tiles.
+ *
+ * Rebuild() is the classic two-pass labeling: the first pass gives every walkable tile the set
+ * of its north or west neighbour, or a new set, merging the two when they differ, and the
+ * second pass points every tile straight at its root. Tiles keep the set id they were given and
+ * a disjoint-set forest maps ids to regions, so merging regions never rewrites tiles.
+ *
+ * UpdateTiles() follows changes to TILE_WALKABLE. An opened tile joins the regions of its
+ * neighbours by union. A closed tile may split its region, which a union-find cannot undo, so
+ * breadth first searches start together from the neighbours of the closed tiles, one step each
+ * in turn, merging when they meet. A search that runs out of tiles before meeting the others has
+ * walked around a piece that broke off, and only that piece is given a new set id. The cost is
+ * bounded by the smaller pieces, not by the region. A search step costs many times a step of
+ * Rebuild(), so an update whose searches reach more than 1/32 of the map rebuilds instead.
+ *
+ * Properties:
+ * -----------
+ * > _space: TileSpace<Tile*>* - The TileSpace whose regions are labeled.
+ * > _flags: unsigned char* - The TileFlags layer of the TileSpace.
+ * > _rows, _cols: int - The dimensions of the TileSpace.
+ * > _label: vector<int> - The set id of every tile, NO_REGION for tiles that are not walkable.
+ * > _regions: DisjointSet - Maps set ids to regions, weighted by the number of tiles.
+ * > _regionCount: int - The number of regions.
+ * > _queues: vector<vector<int>> - The tiles reached by every search of a split check.
+ * > _owner, _stamp: vector - The search that reached a tile and the split check it belongs to.
+ * > _generation: unsigned int - The stamp of the current split check.
+ *
+ * Methods:
+ * --------
+ * > Connectivity(space) - Labels the regions of a TileSpace.
+ * > Rebuild() - Labels every region from scratch.
+ * > UpdateTiles(changed) - Follows tiles that were opened or closed.
+ * > GetRegion(row, col): int - The region of a tile, NO_REGION if it is not walkable.
+ * > GetRegionSize(row, col): int - The number of tiles in the region of a tile.
+ * > Connected(from, to): bool - Whether a character can walk between two tiles.
+ * > ReachableExits(): int - Which exits can be reached from the entry point.
+ * > GetRegionCount(): int - The number of regions.
+ */
+class Connectivity
+{
+public:
+	static const int NO_REGION = -1;
+
+private:
+	const TileSpace<Tile*>* _space;
+	const unsigned char* _flags;
+	int _rows;
+	int _cols;
+	std::vector<int> _label;
+	// lookups shorten paths in the forest without changing any answer
+	mutable DisjointSet _regions;
+	int _regionCount;
+	std::vector<std::vector<int>> _queues;
+	std::vector<int> _owner;
+	std::vector<unsigned int> _stamp;
+	unsigned int _generation;
+
+	/**
+	 * @brief Checks whether a tile is inside the TileSpace and walkable.
+	*/
+	bool Walkable(int row, int col) const;
+
+	/**
+	 * @brief Gives a tile that became walkable a region, merging the regions around it.
+	*/
+	void Open(int index);
+
+	/**
+	 * @brief Searches from the tiles left next to closed tiles of one region and gives every
+	 * piece that broke off a region of its own. The last piece keeps the region.
+	 * @param region - the root of the region the tiles were closed in.
+	 * @param seeds - the walkable tiles of the region next to the closed tiles.
+	 * @param budget - the tiles the searches may still reach, less the tiles they reached.
+	 * @return a boolean value, false when the budget ran out and the labels need a rebuild.
+	*/
+	bool Split(int region, const std::vector<int>& seeds, size_t& budget);
+
+public:
+	/**
+	 * @brief Labels the regions of a TileSpace.
+	 * @param space - the TileSpace to label.
+	*/
+	explicit Connectivity(const TileSpace<Tile*>* space);
+
+	/**
+	 * @brief Labels every region from scratch with two passes over the TileSpace.
+	*/
+	void Rebuild();
+
+	/**
+	 * @brief Follows tiles whose TILE_WALKABLE flag changed since the last update. Tiles whose
+	 * flag did not change are ignored.
+	 * @param changed - the tiles that were opened or closed.
+	*/
+	void UpdateTiles(const std::vector<Location>& changed);
+
+	/**
+	 * @brief Getter for the region of a tile. Ids stay valid until the next update.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return the id of the region, NO_REGION if the tile is outside the map or not walkable.
+	*/
+	int GetRegion(int row, int col) const;
+
+	/**
+	 * @brief Getter for the size of the region of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return an integer representing the number of tiles in the region, 0 if the tile is not walkable.
+	*/
+	int GetRegionSize(int row, int col) const;
+
+	/**
+	 * @brief Checks whether a character can walk from one tile to another.
+	 * @param from - the first tile.
+	 * @param to - the second tile.
+	 * @return a boolean value indicating whether both tiles are walkable and in the same region.
+	*/
+	bool Connected(const Location& from, const Location& to) const;
+
+	/**
+	 * @brief Checks which exits of the TileSpace can be reached from its entry point.
+	 * @return bit 0 set when the first exit is reachable, bit 1 for the second and bit 2 for the third.
+	*/
+	int ReachableExits() const;
+
+	/**
+	 * @brief Getter for the number of regions.
+	 * @return an integer representing the number of connected regions of walkable tiles.
+	*/
+	int GetRegionCount() const;
+};
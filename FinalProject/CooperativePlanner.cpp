@@ -0,0 +1,217 @@
+#include "CooperativePlanner.h"
+#include "Pathfinder.h"
+#include "Character.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+	// the first entry is waiting in place, the rest are the eight moves
+	const int ACTIONS[9][2] = {
+		{ 0, 0 },
+		{ -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+		{ -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 }
+	};
+}
+
+CooperativePlanner::CooperativePlanner(const TileSpace<Tile*>* space, int window)
+{
+	if (window < 1)
+	{
+		throw out_of_range("Window must be at least one tick");
+	}
+
+	_flags = space->GetFlagsLayer();
+	_rows = space->GetRows();
+	_cols = space->GetCols();
+	_window = window;
+	_span = 2 * window + 1;
+	_nodes.assign(static_cast<size_t>(window + 1) * _span * _span, SearchNode{ 0, -1, 0, 0 });
+	_open.Reserve(static_cast<int>(_nodes.size()));
+	_generation = 0;
+	_rotation = 0;
+	_expanded = 0;
+}
+
+bool CooperativePlanner::Walkable(int row, int col) const
+{
+	return row >= 0 && row < _rows && col >= 0 && col < _cols
+		&& (_flags[row * _cols + col] & TILE_WALKABLE) != 0;
+}
+
+int CooperativePlanner::Distance(int row, int col, const Location& goal) const
+{
+	const int dRow = abs(row - goal.x);
+	const int dCol = abs(col - goal.y);
+	const int diagonal = min(dRow, dCol);
+	return Pathfinder::DIAGONAL_COST * diagonal + Pathfinder::STRAIGHT_COST * (max(dRow, dCol) - diagonal);
+}
+
+bool CooperativePlanner::PlanAgent(int agent, const Location& start, const Location& goal)
+{
+	vector<Location>& plan = _plans[agent];
+	plan.clear();
+
+	if (++_generation == 0)
+	{
+		for (auto& node : _nodes)
+		{
+			node.seen = 0;
+			node.closed = 0;
+		}
+		_generation = 1;
+	}
+	_open.Clear();
+
+	// states are numbered inside the box the agent can reach: (tick, row, column) offsets
+	// from the start, each offset shifted by the window so it is never negative
+	auto stateOf = [&](int row, int col, int tick)
+	{
+		return (tick * _span + row - start.x + _window) * _span + col - start.y + _window;
+	};
+
+	const int first = stateOf(start.x, start.y, 0);
+	_nodes[first] = SearchNode{ 0, -1, _generation, 0 };
+	_open.Push(first, Distance(start.x, start.y, goal));
+
+	while (!_open.IsEmpty())
+	{
+		const int current = _open.Pop();
+		const int tick = current / (_span * _span);
+		const int row = start.x + (current / _span) % _span - _window;
+		const int col = start.y + current % _span - _window;
+
+		if (tick == _window)
+		{
+			plan.resize(_window + 1, start);
+			for (int state = current, t = _window; state >= 0; state = _nodes[state].parent, t--)
+			{
+				plan[t] = Location(start.x + (state / _span) % _span - _window, start.y + state % _span - _window);
+				_reservations.Reserve(plan[t].x * _cols + plan[t].y, t, agent);
+			}
+			return true;
+		}
+
+		_nodes[current].closed = _generation;
+		++_expanded;
+		const int tile = row * _cols + col;
+
+		for (const auto& action : ACTIONS)
+		{
+			const int nRow = row + action[0];
+			const int nCol = col + action[1];
+			const bool wait = action[0] == 0 && action[1] == 0;
+			const bool diagonal = action[0] != 0 && action[1] != 0;
+			if (!wait && (!Walkable(nRow, nCol) || (diagonal && (!Walkable(nRow, col) || !Walkable(row, nCol)))))
+			{
+				continue;
+			}
+
+			const int nTile = nRow * _cols + nCol;
+			if (!_reservations.IsFree(nTile, tick + 1, agent))
+			{
+				continue;
+			}
+
+			// an agent standing on the target now and moving onto this tile next is a head-on swap
+			const int owner = _reservations.Owner(nTile, tick);
+			if (!wait && owner >= 0 && owner != agent && _reservations.Owner(tile, tick + 1) == owner)
+			{
+				continue;
+			}
+
+			const int next = stateOf(nRow, nCol, tick + 1);
+			SearchNode& node = _nodes[next];
+			if (node.closed == _generation)
+			{
+				continue;
+			}
+
+			// waiting on the goal is free so arriving early and staying is the cheapest plan
+			int stepCost = diagonal ? Pathfinder::DIAGONAL_COST : Pathfinder::STRAIGHT_COST;
+			if (wait && row == goal.x && col == goal.y)
+			{
+				stepCost = 0;
+			}
+
+			const int g = _nodes[current].g + stepCost;
+			if (node.seen != _generation || g < node.g)
+			{
+				node.seen = _generation;
+				node.g = g;
+				node.parent = current;
+				_open.Push(next, g + Distance(nRow, nCol, goal));
+			}
+		}
+	}
+
+	// boxed in for the whole window, the tile reserved for the first move is still ours
+	plan.assign(2, start);
+	return false;
+}
+
+void CooperativePlanner::Plan(const vector<Location>& starts, const vector<Location>& goals)
+{
+	if (starts.size() != goals.size())
+	{
+		throw out_of_range("Every agent needs exactly one goal");
+	}
+
+	const int agents = static_cast<int>(starts.size());
+	_reservations.Clear();
+	_plans.resize(agents);
+	_expanded = 0;
+
+	for (int i = 0; i < agents; i++)
+	{
+		const int tile = starts[i].x * _cols + starts[i].y;
+		_reservations.Reserve(tile, 0, i);
+		_reservations.Reserve(tile, 1, i);
+	}
+
+	for (int k = 0; k < agents; k++)
+	{
+		const int agent = (k + _rotation) % agents;
+		PlanAgent(agent, starts[agent], goals[agent]);
+	}
+	_rotation = (agents > 0) ? (_rotation + 1) % agents : 0;
+}
+
+const vector<Location>& CooperativePlanner::GetPlan(int agent) const
+{
+	if (agent < 0 || agent >= static_cast<int>(_plans.size()))
+	{
+		throw out_of_range("Agent index out of range");
+	}
+	return _plans[agent];
+}
+
+void CooperativePlanner::Step(const vector<Character*>& characters, const vector<Location>& goals)
+{
+	vector<Location> starts;
+	starts.reserve(characters.size());
+	for (const Character* character : characters)
+	{
+		starts.push_back(*character->GetLocation());
+	}
+
+	Plan(starts, goals);
+	for (size_t i = 0; i < characters.size(); i++)
+	{
+		characters[i]->Relocate(_plans[i][1].x, _plans[i][1].y);
+	}
+}
+
+int CooperativePlanner::GetWindow() const
+{
+	return _window;
+}
+
+int CooperativePlanner::GetExpanded() const
+{
+	return _expanded;
+}
@@ -0,0 +1,137 @@
+#pragma once
+#include "TileSpace.h"
+#include "IndexedHeap.h"
+#include "ReservationTable.h"
+
+#include <vector>
+
+class Character;
+/**
+ * @file CooperativePlanner.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the CooperativePlanner class which moves
+ * a batch of characters in the same tick without collisions, following Windowed Hierarchical
+ * Cooperative A* (WHCA*). Agents plan one after another over a short window of ticks with a
+ * space-time A* whose states are (tile, tick) pairs, and every planned step is written to a
+ * ReservationTable that the agents planning later must respect. Besides the eight moves an
+ * agent may wait where it stands. Two agents never hold the same tile at the same tick and
+ * never swap tiles along an edge.
+ *
+ * Before anyone plans, every agent reserves its current tile for the first two ticks, so an
+ * agent always has the option to stay put and nobody can step onto it during the next move.
+ * That makes every batch resolve in a single pass: the first step of every plan is conflict
+ * free even when an agent finds no plan at all. The order agents plan in rotates between
+ * batches so no agent is always last. Only the first step of a plan is meant to be taken,
+ * the next batch plans again with the window moved forward.
+ *
+ * The space-time search of one agent never travels more than window tiles, so its states fit
+ * a dense box of (2 * window + 1)^2 * (window + 1) records reused across agents.
+ *
+ * Properties:
+ * -----------
+ * > _flags: unsigned char* - The TileFlags layer of the TileSpace.
+ * > _rows, _cols: int - The dimensions of the TileSpace.
+ * > _window: int - The number of ticks planned ahead.
+ * > _span: int - The side of the box an agent can reach within the window.
+ * > _reservations: ReservationTable - The tiles held by every agent at every tick.
+ * > _nodes: vector<SearchNode> - The space-time search arena.
+ * > _open: IndexedHeap<int> - The open list of the space-time search.
+ * > _plans: vector<vector<Location>> - The planned tile of every agent at every tick.
+ * > _rotation: int - The agent planning first in the next batch.
+ * > _expanded: int - The states expanded by the last batch.
+ *
+ * Methods:
+ * --------
+ * > CooperativePlanner(space, window) - Creates a planner for a TileSpace.
+ * > Plan(starts, goals) - Plans a conflict free window for every agent.
+ * > GetPlan(agent): vector<Location> - The planned tiles of an agent, one per tick.
+ * > Step(characters, goals) - Plans a batch and moves every character one step.
+ * > GetWindow(), GetExpanded() - The window length and statistics of the last batch.
+ */
+class CooperativePlanner
+{
+private:
+	/**
+	 * @brief The search record of a space-time state, valid while seen matches the generation.
+	*/
+	struct SearchNode
+	{
+		int g;
+		int parent;
+		unsigned int seen;
+		unsigned int closed;
+	};
+
+	const unsigned char* _flags;
+	int _rows;
+	int _cols;
+	int _window;
+	int _span;
+	ReservationTable _reservations;
+	std::vector<SearchNode> _nodes;
+	IndexedHeap<int> _open;
+	unsigned int _generation;
+	std::vector<std::vector<Location>> _plans;
+	int _rotation;
+	int _expanded;
+
+	/**
+	 * @brief Checks whether a tile is inside the TileSpace and walkable.
+	*/
+	bool Walkable(int row, int col) const;
+
+	/**
+	 * @brief The octile distance between two tiles.
+	*/
+	int Distance(int row, int col, const Location& goal) const;
+
+	/**
+	 * @brief Runs the space-time search of one agent against the current reservations and
+	 * reserves the plan it finds. An agent that finds no plan waits on its tile.
+	 * @return a boolean value indicating whether a plan covering the whole window was found.
+	*/
+	bool PlanAgent(int agent, const Location& start, const Location& goal);
+
+public:
+	/**
+	 * @brief Creates a planner for a TileSpace.
+	 * @param space - the TileSpace the agents move on.
+	 * @param window - the number of ticks planned ahead.
+	*/
+	explicit CooperativePlanner(const TileSpace<Tile*>* space, int window = 8);
+
+	/**
+	 * @brief Plans a conflict free window for every agent of a batch in one pass.
+	 * @param starts - the current tile of every agent.
+	 * @param goals - the tile every agent is heading to.
+	*/
+	void Plan(const std::vector<Location>& starts, const std::vector<Location>& goals);
+
+	/**
+	 * @brief Getter for the plan of an agent from the last batch.
+	 * @param agent - the index of the agent in the batch.
+	 * @return the tile of the agent at every tick, starting with its current tile.
+	*/
+	const std::vector<Location>& GetPlan(int agent) const;
+
+	/**
+	 * @brief Plans a batch for a group of characters and moves each one to the first step
+	 * of its plan.
+	 * @param characters - the characters moving this tick.
+	 * @param goals - the tile every character is heading to.
+	*/
+	void Step(const std::vector<Character*>& characters, const std::vector<Location>& goals);
+
+	/**
+	 * @brief Getter for the number of ticks planned ahead.
+	 * @return an integer representing the window length.
+	*/
+	int GetWindow() const;
+
+	/**
+	 * @brief Getter for the number of space-time states expanded by the last batch.
+	 * @return an integer representing the number of expanded states.
+	*/
+	int GetExpanded() const;
+};
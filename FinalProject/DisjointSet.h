@@ -0,0 +1,128 @@
+#pragma once
+#include <stdexcept>
+#include <utility>
+#include <vector>
+/**
+ * @file DisjointSet.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the DisjointSet class, a disjoint-set forest over integer
+ * ids. Find() halves the path it walks so trees stay almost flat, and Union() hangs the
+ * smaller set under the larger, which keeps both operations at amortised inverse Ackermann
+ * cost, a small constant in practice. Every set carries a weight, by default its number of
+ * members, which callers may adjust when members leave a set behind the forest's back.
+ *
+ * Properties:
+ * -----------
+ * > _parent: vector<int> - The parent of every id, roots are their own parent.
+ * > _weight: vector<int> - The weight of every set, valid at the roots.
+ *
+ * Methods:
+ * --------
+ * > MakeSet(weight: int): int - Adds a new set and returns its id.
+ * > Find(id: int): int - The root of the set holding an id.
+ * > Union(one: int, other: int): int - Merges two sets and returns the new root.
+ * > GetWeight(id: int): int - The weight of the set holding an id.
+ * > AddWeight(id: int, delta: int) - Changes the weight of the set holding an id.
+ * > Size(): int - The number of ids.
+ * > Clear() - Removes every set.
+ */
+class DisjointSet
+{
+private:
+	std::vector<int> _parent;
+	std::vector<int> _weight;
+
+public:
+	/**
+	 * @brief Adds a new set holding only a new id.
+	 * @param weight - the weight of the set.
+	 * @return the id of the new set.
+	*/
+	int MakeSet(int weight = 1)
+	{
+		_parent.push_back(static_cast<int>(_parent.size()));
+		_weight.push_back(weight);
+		return _parent.back();
+	}
+
+	/**
+	 * @brief Finds the root of the set holding an id, pointing every other node on the way at its grandparent.
+	 * @param id - the id to look up.
+	 * @return the root id of its set.
+	*/
+	int Find(int id)
+	{
+		if (id < 0 || id >= static_cast<int>(_parent.size()))
+		{
+			throw std::out_of_range("Disjoint set id out of range");
+		}
+		while (_parent[id] != id)
+		{
+			_parent[id] = _parent[_parent[id]];
+			id = _parent[id];
+		}
+		return id;
+	}
+
+	/**
+	 * @brief Merges the sets holding two ids, hanging the lighter tree under the heavier.
+	 * @param one - an id of the first set.
+	 * @param other - an id of the second set.
+	 * @return the root of the merged set.
+	*/
+	int Union(int one, int other)
+	{
+		one = Find(one);
+		other = Find(other);
+		if (one == other)
+		{
+			return one;
+		}
+		if (_weight[one] < _weight[other])
+		{
+			std::swap(one, other);
+		}
+		_parent[other] = one;
+		_weight[one] += _weight[other];
+		return one;
+	}
+
+	/**
+	 * @brief Getter for the weight of the set holding an id.
+	 * @param id - an id of the set.
+	 * @return an integer representing the weight of the set.
+	*/
+	int GetWeight(int id)
+	{
+		return _weight[Find(id)];
+	}
+
+	/**
+	 * @brief Changes the weight of the set holding an id.
+	 * @param id - an id of the set.
+	 * @param delta - the amount to add, negative to remove.
+	*/
+	void AddWeight(int id, int delta)
+	{
+		_weight[Find(id)] += delta;
+	}
+
+	/**
+	 * @brief Getter for the number of ids handed out.
+	 * @return an integer representing the number of ids.
+	*/
+	int Size() const
+	{
+		return static_cast<int>(_parent.size());
+	}
+
+	/**
+	 * @brief Removes every set.
+	*/
+	void Clear()
+	{
+		_parent.clear();
+		_weight.clear();
+	}
+};
@@ -1,77 +1,65 @@
 #include "Enemy.h"
+#include "Pathfinder.h"
+#include "FlowField.h"
+#include <algorithm>
 #include <iostream>
+#include <limits>
 
 using namespace std;
 
 Enemy::Enemy()
 {
-	_name = "Default Character";
-	_health = 100;
-	_ammo = 80;
-	 _backpack = new Backpack();
-	 _inHand = &_backpack->GetItemBag().GetCurrentItem();
-	_loc = new Location(0, 0);
-	_attackMoves = {
-		new ActionTree(),
-		new ActionTree(),
-		new ActionTree(),
-	};
-	_maxPower = 200;
+	// the backpack, location and attack moves come from the Character constructor
 }
 
 Enemy::Enemy(string name, int health, int ammo)
 	: Character(name, health, ammo)
 {
-	 _backpack = new Backpack();
-	 _inHand = &_backpack->GetItemBag().GetCurrentItem();
-	_loc = new Location(0, 0);
-	_attackMoves = {
-		new ActionTree(),
-		new ActionTree(),
-		new ActionTree(),
-	};
-	_maxPower = 200;
 }
 
 Enemy::Enemy(const Enemy& enemy) : Character(enemy)
 {
-	_name = enemy._name;
-	_health = enemy._health;
-	_ammo = enemy._ammo;
-	 _backpack = enemy._backpack;
-	 _inHand = enemy._inHand;
-	_loc = enemy._loc;
-	_attackMoves = enemy._attackMoves;
-	_maxPower = enemy._maxPower;
 }
 
 Enemy::Enemy(const Character& enemy) : Character(enemy)
 {
-	 _backpack = new Backpack();
-	 _inHand = &_backpack->GetItemBag().GetCurrentItem();
-	_loc = new Location(0, 0);
-	_attackMoves = {
-				new ActionTree(),
-				new ActionTree(),
-				new ActionTree(),
-			};
-	_maxPower = 200;
 }
 
 Enemy::~Enemy()
 {
-	delete _backpack;
-	delete _loc;
-	for (auto& move : _attackMoves)
-	{
-		delete move;
-	}
+	// the backpack, location and attack moves are released by ~Character
 }
 
 void Enemy::Slay(Character* character)
 {
-	cout << _name << " slays " << character->GetName() << endl;
+	cout << _name << " slays " << character->GetName() << '\n';
 	_attackMoves[0]->PreOrderTraverse();
 
-	character->SetHealth(character->GetHealth() - _attackMoves[0]->GetDamage());
+	// the damage of a large move tree can take health past the range of an int
+	const long long health = character->GetHealth() - _attackMoves[0]->GetDamage();
+	character->SetHealth(static_cast<int>(max<long long>(health, numeric_limits<int>::min())));
+}
+
+bool Enemy::Chase(Character* character, Pathfinder* pathfinder)
+{
+	vector<Location> path;
+	if (!pathfinder->FindPath(*_loc, *character->GetLocation(), path) || path.size() < 2)
+	{
+		return false;
+	}
+
+	Relocate(path[1].x, path[1].y);
+	return true;
+}
+
+bool Enemy::FollowFlow(const FlowField* flowField)
+{
+	Location next(0, 0);
+	if (!flowField->NextStep(*_loc, next))
+	{
+		return false;
+	}
+
+	Relocate(next.x, next.y);
+	return true;
 }
\ No newline at end of file
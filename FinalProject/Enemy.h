@@ -1,5 +1,8 @@
 #pragma once
 #include "Character.h"
+
+class Pathfinder;
+class FlowField;
 /**
  * @file Enemy.h
  * @author Billy Ndegwah Micah
@@ -18,6 +21,8 @@
  * > Enemy(const Enemy& enemy) - Copy constructor
  * > ~Enemy() - Destructor
  * > Slay(character: Character*) - Method to attack a character
+ * > Chase(character: Character*, pathfinder: Pathfinder*) - Method to step towards a character
+ * > FollowFlow(flowField: FlowField*) - Method to step along a flow field
  *
  */
 class Enemy : public Character
@@ -59,4 +64,19 @@ public:
 	 * @param character - the target character
 	*/
 	void Slay(Character* character);
+
+	/**
+	 * @brief This method moves the enemy one tile along the shortest route towards a character
+	 * @param character - the character to chase
+	 * @param pathfinder - the pathfinder of the TileSpace both characters stand on
+	 * @return a boolean value indicating whether the enemy moved
+	*/
+	bool Chase(Character* character, Pathfinder* pathfinder);
+
+	/**
+	 * @brief This method moves the enemy one tile along a flow field towards its target
+	 * @param flowField - the flow field computed for the target
+	 * @return a boolean value indicating whether the enemy moved
+	*/
+	bool FollowFlow(const FlowField* flowField);
 };
\ No newline at end of file
@@ -84,10 +84,10 @@ void Environ::SetHealing(int healing)
 
 void Environ::Print() const
 {
-	cout << "Name: " << _name << endl;
-	cout << "Description: " << _description << endl;
-	cout << "Hazard: " << ( (_hazard) ? "True" : "False" ) << endl;
-	cout << "Damage: " << _damage << endl;
-	cout << "Healing: " << _healing << endl;
-	cout << endl;
+	cout << "Name: " << _name << '\n';
+	cout << "Description: " << _description << '\n';
+	cout << "Hazard: " << ( (_hazard) ? "True" : "False" ) << '\n';
+	cout << "Damage: " << _damage << '\n';
+	cout << "Healing: " << _healing << '\n';
+	cout << '\n';
 }
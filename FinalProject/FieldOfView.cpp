@@ -0,0 +1,267 @@
+#include "FieldOfView.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+	int FloorDiv(int numerator, int denominator)
+	{
+		return (numerator >= 0) ? numerator / denominator : -((denominator - 1 - numerator) / denominator);
+	}
+
+	int CeilDiv(int numerator, int denominator)
+	{
+		return -FloorDiv(-numerator, denominator);
+	}
+}
+
+const int FieldOfView::FOV_PARALLEL_VIEWERS;
+
+FieldOfView::FieldOfView(const TileSpace<Tile*>* space, int threads)
+{
+	_flags = space->GetFlagsLayer();
+	_rows = space->GetRows();
+	_cols = space->GetCols();
+	SetThreads(threads);
+}
+
+bool FieldOfView::Blocks(int row, int col) const
+{
+	return row < 0 || row >= _rows || col < 0 || col >= _cols
+		|| (_flags[row * _cols + col] & TILE_OPAQUE) != 0;
+}
+
+void FieldOfView::CheckViewer(int viewer) const
+{
+	if (viewer < 0 || viewer >= static_cast<int>(_viewers.size()))
+	{
+		throw out_of_range("Viewer id out of range");
+	}
+}
+
+void FieldOfView::Compute(Viewer& viewer, vector<Row>& stack) const
+{
+	const int radius = viewer.radius;
+	const int side = 2 * radius + 1;
+	if (viewer.visible.GetRows() == side && viewer.visible.GetCols() == side)
+	{
+		viewer.visible.Clear();
+	}
+	else
+	{
+		viewer.visible.Resize(side, side);
+	}
+
+	const int limit = radius * radius;
+	auto reveal = [&](int row, int col)
+	{
+		const int dRow = row - viewer.row;
+		const int dCol = col - viewer.col;
+		if (row >= 0 && row < _rows && col >= 0 && col < _cols && dRow * dRow + dCol * dCol <= limit)
+		{
+			viewer.visible.Set(dRow + radius, dCol + radius);
+		}
+	};
+
+	reveal(viewer.row, viewer.col);
+	for (int quadrant = 0; quadrant < 4; quadrant++)
+	{
+		// maps a (depth, column) position of the quadrant onto the map, depth grows away from
+		// the viewer and columns run across the quadrant
+		auto transform = [&](int depth, int col, int& mapRow, int& mapCol)
+		{
+			switch (quadrant)
+			{
+			case 0: mapRow = viewer.row - depth; mapCol = viewer.col + col; break;
+			case 1: mapRow = viewer.row + depth; mapCol = viewer.col + col; break;
+			case 2: mapRow = viewer.row + col; mapCol = viewer.col + depth; break;
+			default: mapRow = viewer.row + col; mapCol = viewer.col - depth; break;
+			}
+		};
+
+		stack.clear();
+		stack.push_back(Row{ 1, -1, 1, 1, 1 });
+		while (!stack.empty())
+		{
+			Row row = stack.back();
+			stack.pop_back();
+			if (row.depth > radius)
+			{
+				continue;
+			}
+
+			// the columns whose centers round into the sector between the two slopes
+			const int minCol = FloorDiv(2 * row.depth * row.startNum + row.startDen, 2 * row.startDen);
+			const int maxCol = CeilDiv(2 * row.depth * row.endNum - row.endDen, 2 * row.endDen);
+
+			int previous = -1;
+			for (int col = minCol; col <= maxCol; col++)
+			{
+				int mapRow, mapCol;
+				transform(row.depth, col, mapRow, mapCol);
+				const int wall = Blocks(mapRow, mapCol) ? 1 : 0;
+
+				// floors only show when their center is inside the sector, which keeps sight symmetric
+				const bool symmetric = col * row.startDen >= row.depth * row.startNum
+					&& col * row.endDen <= row.depth * row.endNum;
+				if (wall == 1 || symmetric)
+				{
+					reveal(mapRow, mapCol);
+				}
+
+				if (previous == 1 && wall == 0)
+				{
+					row.startNum = 2 * col - 1;
+					row.startDen = 2 * row.depth;
+				}
+				if (previous == 0 && wall == 1)
+				{
+					stack.push_back(Row{ row.depth + 1, row.startNum, row.startDen, 2 * col - 1, 2 * row.depth });
+				}
+				previous = wall;
+			}
+
+			if (previous == 0)
+			{
+				stack.push_back(Row{ row.depth + 1, row.startNum, row.startDen, row.endNum, row.endDen });
+			}
+		}
+	}
+	viewer.dirty = false;
+}
+
+int FieldOfView::AddViewer(const Location& origin, int radius)
+{
+	if (radius < 0)
+	{
+		throw out_of_range("Sight radius must not be negative");
+	}
+	_viewers.push_back(Viewer{ origin.x, origin.y, radius, true, BitGrid() });
+	return static_cast<int>(_viewers.size()) - 1;
+}
+
+void FieldOfView::MoveViewer(int viewer, const Location& origin)
+{
+	CheckViewer(viewer);
+	Viewer& moved = _viewers[viewer];
+	if (moved.row != origin.x || moved.col != origin.y)
+	{
+		moved.row = origin.x;
+		moved.col = origin.y;
+		moved.dirty = true;
+	}
+}
+
+void FieldOfView::OpacityChanged(const vector<Location>& changed)
+{
+	for (auto& viewer : _viewers)
+	{
+		for (const Location& tile : changed)
+		{
+			if (abs(tile.x - viewer.row) <= viewer.radius && abs(tile.y - viewer.col) <= viewer.radius)
+			{
+				viewer.dirty = true;
+				break;
+			}
+		}
+	}
+}
+
+int FieldOfView::Update()
+{
+	vector<int> dirty;
+	for (int i = 0; i < static_cast<int>(_viewers.size()); i++)
+	{
+		if (_viewers[i].dirty)
+		{
+			dirty.push_back(i);
+		}
+	}
+
+	const int count = static_cast<int>(dirty.size());
+	const int workers = (count >= FOV_PARALLEL_VIEWERS) ? min(_threads, count / (FOV_PARALLEL_VIEWERS / 2)) : 1;
+	if (static_cast<int>(_stacks.size()) < workers)
+	{
+		_stacks.resize(workers);
+	}
+
+	// every worker owns a contiguous share of the viewers and its own scan stack
+	auto work = [&](int worker)
+	{
+		const int first = static_cast<int>(static_cast<long long>(count) * worker / workers);
+		const int last = static_cast<int>(static_cast<long long>(count) * (worker + 1) / workers);
+		for (int i = first; i < last; i++)
+		{
+			Compute(_viewers[dirty[i]], _stacks[worker]);
+		}
+	};
+
+	vector<thread> threads;
+	for (int w = 1; w < workers; w++)
+	{
+		threads.emplace_back(work, w);
+	}
+	work(0);
+	for (auto& worker : threads)
+	{
+		worker.join();
+	}
+	return count;
+}
+
+bool FieldOfView::IsVisible(int viewer, int row, int col) const
+{
+	CheckViewer(viewer);
+	const Viewer& seen = _viewers[viewer];
+	const int localRow = row - seen.row + seen.radius;
+	const int localCol = col - seen.col + seen.radius;
+	return localRow >= 0 && localRow < seen.visible.GetRows()
+		&& localCol >= 0 && localCol < seen.visible.GetCols()
+		&& seen.visible.Get(localRow, localCol);
+}
+
+const BitGrid& FieldOfView::GetVisibility(int viewer) const
+{
+	CheckViewer(viewer);
+	return _viewers[viewer].visible;
+}
+
+void FieldOfView::RevealInto(int viewer, BitGrid& explored) const
+{
+	CheckViewer(viewer);
+	if (explored.GetRows() != _rows || explored.GetCols() != _cols)
+	{
+		throw out_of_range("Explored grid must match the TileSpace");
+	}
+
+	const Viewer& seen = _viewers[viewer];
+	for (int r = 0; r < seen.visible.GetRows(); r++)
+	{
+		for (int c = 0; c < seen.visible.GetCols(); c++)
+		{
+			if (seen.visible.Get(r, c))
+			{
+				explored.Set(seen.row - seen.radius + r, seen.col - seen.radius + c);
+			}
+		}
+	}
+}
+
+void FieldOfView::SetThreads(int threads)
+{
+	if (threads <= 0)
+	{
+		threads = static_cast<int>(thread::hardware_concurrency());
+	}
+	_threads = max(threads, 1);
+}
+
+int FieldOfView::GetThreads() const
+{
+	return _threads;
+}
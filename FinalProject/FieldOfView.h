@@ -0,0 +1,168 @@
+#pragma once
+#include "TileSpace.h"
+#include "BitGrid.h"
+
+#include <vector>
+/**
+ * @file FieldOfView.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the FieldOfView class which computes
+ * what characters can see on a TileSpace for fog-of-war and targeting. It uses symmetric
+ * shadowcasting: each of the four quadrants around a viewer is scanned row by row, and walls
+ * cast shadows described by a pair of rational slopes, so no floating point is involved. A
+ * floor tile is visible only when its center lies inside the visible sector, which makes
+ * sight symmetric: if one viewer sees a floor tile, a viewer standing there sees it back.
+ * Tiles with TILE_OPAQUE block sight and are visible themselves. Sight is limited to a circle.
+ *
+ * Every viewer owns a BitGrid covering the square around it, one bit per tile, so a
+ * thousand viewers on a large map cost a few hundred bytes each. Update() recomputes only
+ * the viewers that moved or that can see a tile whose opacity changed, splitting them over
+ * several threads when there are many. The scan stack is kept per thread between calls so
+ * recomputing does not allocate.
+ *
+ * Properties:
+ * -----------
+ * > _flags: unsigned char* - The TileFlags layer of the TileSpace.
+ * > _rows, _cols: int - The dimensions of the TileSpace.
+ * > _viewers: vector<Viewer> - The position, radius, visibility and state of every viewer.
+ * > _stacks: vector<vector<Row>> - The shadowcasting scan stack of every thread.
+ * > _threads: int - The number of threads used by Update() on large batches.
+ *
+ * Methods:
+ * --------
+ * > FieldOfView(space, threads) - Creates an engine with no viewers.
+ * > AddViewer(origin, radius): int - Registers a viewer and returns its id.
+ * > MoveViewer(viewer, origin) - Moves a viewer, marking it for recomputation.
+ * > OpacityChanged(changed) - Marks the viewers in sight of changed tiles for recomputation.
+ * > Update(): int - Recomputes every marked viewer.
+ * > IsVisible(viewer, row, col): bool - Whether a viewer sees a tile.
+ * > GetVisibility(viewer): BitGrid - The bits of a viewer, centered on its origin.
+ * > RevealInto(viewer, explored) - Sets the bits a viewer sees in a map-sized BitGrid.
+ * > SetThreads(threads), GetThreads() - The number of threads used by Update().
+ */
+class FieldOfView
+{
+public:
+	static const int FOV_PARALLEL_VIEWERS = 64;
+
+private:
+	/**
+	 * @brief A row of a quadrant still to be scanned, bounded by two slopes kept as fractions.
+	*/
+	struct Row
+	{
+		int depth;
+		int startNum;
+		int startDen;
+		int endNum;
+		int endDen;
+	};
+
+	/**
+	 * @brief A registered viewer and the bits it sees.
+	*/
+	struct Viewer
+	{
+		int row;
+		int col;
+		int radius;
+		bool dirty;
+		BitGrid visible;
+	};
+
+	const unsigned char* _flags;
+	int _rows;
+	int _cols;
+	std::vector<Viewer> _viewers;
+	std::vector<std::vector<Row>> _stacks;
+	int _threads;
+
+	/**
+	 * @brief Checks whether a tile blocks sight. Tiles outside the map block sight.
+	*/
+	bool Blocks(int row, int col) const;
+
+	/**
+	 * @brief Recomputes the visibility of one viewer with the given scan stack.
+	*/
+	void Compute(Viewer& viewer, std::vector<Row>& stack) const;
+
+	/**
+	 * @brief Throws when a viewer id is not registered.
+	*/
+	void CheckViewer(int viewer) const;
+
+public:
+	/**
+	 * @brief Creates an engine with no viewers.
+	 * @param space - the TileSpace the viewers look over.
+	 * @param threads - the number of threads for large batches, 0 to use every hardware thread.
+	*/
+	explicit FieldOfView(const TileSpace<Tile*>* space, int threads = 0);
+
+	/**
+	 * @brief Registers a viewer. Its visibility is computed by the next Update().
+	 * @param origin - the tile the viewer stands on.
+	 * @param radius - how far the viewer sees, in tiles.
+	 * @return the id of the viewer.
+	*/
+	int AddViewer(const Location& origin, int radius);
+
+	/**
+	 * @brief Moves a viewer, marking it for recomputation when it changed tile.
+	 * @param viewer - the id of the viewer.
+	 * @param origin - the tile the viewer now stands on.
+	*/
+	void MoveViewer(int viewer, const Location& origin);
+
+	/**
+	 * @brief Marks for recomputation every viewer whose sight radius covers a tile whose
+	 * TILE_OPAQUE flag changed.
+	 * @param changed - the tiles whose opacity changed.
+	*/
+	void OpacityChanged(const std::vector<Location>& changed);
+
+	/**
+	 * @brief Recomputes the visibility of every marked viewer in one batch.
+	 * @return an integer representing the number of viewers recomputed.
+	*/
+	int Update();
+
+	/**
+	 * @brief Checks whether a viewer sees a tile, as of the last Update().
+	 * @param viewer - the id of the viewer.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return a boolean value indicating whether the tile is visible.
+	*/
+	bool IsVisible(int viewer, int row, int col) const;
+
+	/**
+	 * @brief Getter for the bits of a viewer. Bit (r, c) stands for the map tile
+	 * (originRow - radius + r, originCol - radius + c).
+	 * @param viewer - the id of the viewer.
+	 * @return the visibility grid of the viewer.
+	*/
+	const BitGrid& GetVisibility(int viewer) const;
+
+	/**
+	 * @brief Sets the bit of every tile a viewer sees in a grid covering the whole map, for
+	 * building fog-of-war.
+	 * @param viewer - the id of the viewer.
+	 * @param explored - a BitGrid with the dimensions of the TileSpace.
+	*/
+	void RevealInto(int viewer, BitGrid& explored) const;
+
+	/**
+	 * @brief Setter for the number of threads used by Update() on large batches.
+	 * @param threads - the desired number of threads, 0 to use every hardware thread.
+	*/
+	void SetThreads(int threads);
+
+	/**
+	 * @brief Getter for the number of threads used by Update() on large batches.
+	 * @return an integer representing the number of threads.
+	*/
+	int GetThreads() const;
+};
@@ -0,0 +1,466 @@
+#include "FlowField.h"
+
+#include <algorithm>
+#include <functional>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+	const int DIRECTIONS[8][2] = {
+		{ -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+		{ -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 }
+	};
+
+	const unsigned char MARK_AFFECTED = 1;
+	const unsigned char MARK_TOUCHED = 2;
+	const unsigned char MARK_RESOLVE = 4;
+}
+
+const int FlowField::FLOW_UNREACHABLE;
+const unsigned char FlowField::FLOW_NONE;
+const int FlowField::FLOW_PARALLEL_TILES;
+
+FlowField::FlowField(const TileSpace<Tile*>* space, int threads)
+{
+	_space = space;
+	_flags = space->GetFlagsLayer();
+	_rows = space->GetRows();
+	_cols = space->GetCols();
+
+	const size_t tiles = static_cast<size_t>(_rows) * _cols;
+	_distance.assign(tiles, FLOW_UNREACHABLE);
+	_direction.assign(tiles, FLOW_NONE);
+	_isTarget.assign(tiles, 0);
+	_marks.assign(tiles, 0);
+	_repair.Reserve(static_cast<int>(tiles));
+	SetThreads(threads);
+}
+
+bool FlowField::Walkable(int row, int col) const
+{
+	return row >= 0 && row < _rows && col >= 0 && col < _cols
+		&& (_flags[row * _cols + col] & TILE_WALKABLE) != 0;
+}
+
+int FlowField::StepCost(int row, int col, int direction) const
+{
+	const int nRow = row + DIRECTIONS[direction][0];
+	const int nCol = col + DIRECTIONS[direction][1];
+	if (!Walkable(nRow, nCol))
+	{
+		return 0;
+	}
+	if (direction >= 4)
+	{
+		return (Walkable(nRow, col) && Walkable(row, nCol)) ? 14 : 0;
+	}
+	return 10;
+}
+
+void FlowField::SearchStrip(int firstRow, int lastRow, IndexedHeap<int>& heap)
+{
+	const int offset = firstRow * _cols;
+	while (!heap.IsEmpty())
+	{
+		const int index = heap.Pop() + offset;
+		const int row = index / _cols;
+		const int col = index % _cols;
+		const int distance = _distance[index];
+
+		for (int d = 0; d < 8; d++)
+		{
+			const int nRow = row + DIRECTIONS[d][0];
+			if (nRow < firstRow || nRow >= lastRow)
+			{
+				continue;
+			}
+
+			const int cost = StepCost(row, col, d);
+			const int next = nRow * _cols + col + DIRECTIONS[d][1];
+			if (cost != 0 && distance + cost < _distance[next])
+			{
+				_distance[next] = distance + cost;
+				heap.Push(next - offset, distance + cost);
+			}
+		}
+	}
+}
+
+void FlowField::SeedFromHalo(int row, int haloRow, int firstRow, const vector<int>& halo, IndexedHeap<int>& heap)
+{
+	const int dRow = haloRow - row;
+	for (int col = 0; col < _cols; col++)
+	{
+		const int index = row * _cols + col;
+		if (!Walkable(row, col))
+		{
+			continue;
+		}
+
+		for (int d = 0; d < 8; d++)
+		{
+			if (DIRECTIONS[d][0] != dRow)
+			{
+				continue;
+			}
+
+			const int cost = StepCost(row, col, d);
+			if (cost != 0 && halo[col + DIRECTIONS[d][1]] + cost < _distance[index])
+			{
+				_distance[index] = halo[col + DIRECTIONS[d][1]] + cost;
+				heap.Push(index - firstRow * _cols, _distance[index]);
+			}
+		}
+	}
+}
+
+void FlowField::ResolveDirection(int index)
+{
+	const int row = index / _cols;
+	const int col = index % _cols;
+	unsigned char best = FLOW_NONE;
+
+	if (_isTarget[index] == 0 && _distance[index] < FLOW_UNREACHABLE && Walkable(row, col))
+	{
+		int bestCost = FLOW_UNREACHABLE;
+		for (int d = 0; d < 8; d++)
+		{
+			const int cost = StepCost(row, col, d);
+			if (cost == 0)
+			{
+				continue;
+			}
+
+			const int next = (row + DIRECTIONS[d][0]) * _cols + col + DIRECTIONS[d][1];
+			if (_distance[next] + cost < bestCost)
+			{
+				bestCost = _distance[next] + cost;
+				best = static_cast<unsigned char>(d);
+			}
+		}
+	}
+	_direction[index] = best;
+}
+
+void FlowField::ResolveDirections(int firstRow, int lastRow)
+{
+	for (int index = firstRow * _cols; index < lastRow * _cols; index++)
+	{
+		ResolveDirection(index);
+	}
+}
+
+void FlowField::Compute(const vector<Location>& targets)
+{
+	fill(_distance.begin(), _distance.end(), FLOW_UNREACHABLE);
+	fill(_isTarget.begin(), _isTarget.end(), 0);
+	for (const auto& target : targets)
+	{
+		if (target.x >= 0 && target.x < _rows && target.y >= 0 && target.y < _cols)
+		{
+			const int index = target.x * _cols + target.y;
+			_isTarget[index] = 1;
+			if (Walkable(target.x, target.y))
+			{
+				_distance[index] = 0;
+			}
+		}
+	}
+
+	const long long tiles = static_cast<long long>(_rows) * _cols;
+	int strips = (tiles >= FLOW_PARALLEL_TILES) ? min(_threads, _rows / 16) : 1;
+	strips = max(strips, 1);
+
+	vector<int> bounds(strips + 1);
+	vector<IndexedHeap<int>> heaps(strips);
+	vector<vector<int>> topHalo(strips, vector<int>(_cols, FLOW_UNREACHABLE));
+	vector<vector<int>> bottomHalo(strips, vector<int>(_cols, FLOW_UNREACHABLE));
+	for (int s = 0; s <= strips; s++)
+	{
+		bounds[s] = static_cast<int>(static_cast<long long>(_rows) * s / strips);
+	}
+
+	// first round: every strip searches from the targets inside it
+	auto seedTargets = [&](int s)
+	{
+		heaps[s].Reserve((bounds[s + 1] - bounds[s]) * _cols);
+		for (int index = bounds[s] * _cols; index < bounds[s + 1] * _cols; index++)
+		{
+			if (_distance[index] == 0)
+			{
+				heaps[s].Push(index - bounds[s] * _cols, 0);
+			}
+		}
+		SearchStrip(bounds[s], bounds[s + 1], heaps[s]);
+	};
+
+	// later rounds: every strip continues from the edge rows of its neighbours
+	auto seedHalos = [&](int s)
+	{
+		if (s > 0)
+		{
+			SeedFromHalo(bounds[s], bounds[s] - 1, bounds[s], topHalo[s], heaps[s]);
+		}
+		if (s < strips - 1)
+		{
+			SeedFromHalo(bounds[s + 1] - 1, bounds[s + 1], bounds[s], bottomHalo[s], heaps[s]);
+		}
+		SearchStrip(bounds[s], bounds[s + 1], heaps[s]);
+	};
+
+	auto runStrips = [&](const function<void(int)>& work)
+	{
+		vector<thread> workers;
+		for (int s = 1; s < strips; s++)
+		{
+			workers.emplace_back(work, s);
+		}
+		work(0);
+		for (auto& worker : workers)
+		{
+			worker.join();
+		}
+	};
+
+	runStrips(seedTargets);
+	while (strips > 1)
+	{
+		bool changed = false;
+		for (int s = 0; s < strips; s++)
+		{
+			if (s > 0)
+			{
+				const int* row = &_distance[static_cast<size_t>(bounds[s] - 1) * _cols];
+				changed = changed || !equal(topHalo[s].begin(), topHalo[s].end(), row);
+				topHalo[s].assign(row, row + _cols);
+			}
+			if (s < strips - 1)
+			{
+				const int* row = &_distance[static_cast<size_t>(bounds[s + 1]) * _cols];
+				changed = changed || !equal(bottomHalo[s].begin(), bottomHalo[s].end(), row);
+				bottomHalo[s].assign(row, row + _cols);
+			}
+		}
+
+		if (!changed)
+		{
+			break;
+		}
+		runStrips(seedHalos);
+	}
+
+	runStrips([&](int s) { ResolveDirections(bounds[s], bounds[s + 1]); });
+}
+
+void FlowField::UpdateTiles(const vector<Location>& changed)
+{
+	vector<int> affected;
+	vector<int> touched;
+	vector<int> resolve;
+
+	// the changed tiles and the tiles whose first step was a diagonal around a changed tile
+	for (const auto& tile : changed)
+	{
+		if (tile.x < 0 || tile.x >= _rows || tile.y < 0 || tile.y >= _cols)
+		{
+			continue;
+		}
+
+		const int index = tile.x * _cols + tile.y;
+		if ((_marks[index] & MARK_AFFECTED) == 0)
+		{
+			_marks[index] |= MARK_AFFECTED;
+			affected.push_back(index);
+		}
+
+		for (const auto& direction : DIRECTIONS)
+		{
+			const int row = tile.x + direction[0];
+			const int col = tile.y + direction[1];
+			if (row < 0 || row >= _rows || col < 0 || col >= _cols)
+			{
+				continue;
+			}
+
+			const int neighbour = row * _cols + col;
+			const unsigned char step = _direction[neighbour];
+			if ((_marks[neighbour] & MARK_AFFECTED) == 0 && step != FLOW_NONE && StepCost(row, col, step) == 0)
+			{
+				_marks[neighbour] |= MARK_AFFECTED;
+				affected.push_back(neighbour);
+			}
+		}
+	}
+
+	// every tile whose route runs through an affected tile is affected as well
+	for (size_t i = 0; i < affected.size(); i++)
+	{
+		const int row = affected[i] / _cols;
+		const int col = affected[i] % _cols;
+		for (int d = 0; d < 8; d++)
+		{
+			const int fromRow = row - DIRECTIONS[d][0];
+			const int fromCol = col - DIRECTIONS[d][1];
+			if (fromRow < 0 || fromRow >= _rows || fromCol < 0 || fromCol >= _cols)
+			{
+				continue;
+			}
+
+			const int from = fromRow * _cols + fromCol;
+			if ((_marks[from] & MARK_AFFECTED) == 0 && _direction[from] == d)
+			{
+				_marks[from] |= MARK_AFFECTED;
+				affected.push_back(from);
+			}
+		}
+	}
+
+	for (int index : affected)
+	{
+		const bool open = Walkable(index / _cols, index % _cols);
+		_distance[index] = (open && _isTarget[index] != 0) ? 0 : FLOW_UNREACHABLE;
+		_direction[index] = FLOW_NONE;
+	}
+
+	// seed the affected tiles from their unaffected neighbours, and requeue the tiles around
+	// the changed ones because opening a tile can also open diagonal steps between them
+	_repair.Clear();
+	for (int index : affected)
+	{
+		const int row = index / _cols;
+		const int col = index % _cols;
+		if (!Walkable(row, col))
+		{
+			continue;
+		}
+
+		for (int d = 0; d < 8; d++)
+		{
+			const int cost = StepCost(row, col, d);
+			const int next = (row + DIRECTIONS[d][0]) * _cols + col + DIRECTIONS[d][1];
+			if (cost != 0 && _distance[next] + cost < _distance[index])
+			{
+				_distance[index] = _distance[next] + cost;
+			}
+		}
+		if (_distance[index] < FLOW_UNREACHABLE)
+		{
+			_repair.Push(index, _distance[index]);
+		}
+	}
+	for (const auto& tile : changed)
+	{
+		for (const auto& direction : DIRECTIONS)
+		{
+			const int row = tile.x + direction[0];
+			const int col = tile.y + direction[1];
+			if (Walkable(row, col) && _distance[row * _cols + col] < FLOW_UNREACHABLE)
+			{
+				_repair.Push(row * _cols + col, _distance[row * _cols + col]);
+			}
+		}
+	}
+
+	while (!_repair.IsEmpty())
+	{
+		const int index = _repair.Pop();
+		const int row = index / _cols;
+		const int col = index % _cols;
+		for (int d = 0; d < 8; d++)
+		{
+			const int cost = StepCost(row, col, d);
+			const int next = (row + DIRECTIONS[d][0]) * _cols + col + DIRECTIONS[d][1];
+			if (cost != 0 && _distance[index] + cost < _distance[next])
+			{
+				_distance[next] = _distance[index] + cost;
+				_repair.Push(next, _distance[next]);
+				if ((_marks[next] & (MARK_AFFECTED | MARK_TOUCHED)) == 0)
+				{
+					_marks[next] |= MARK_TOUCHED;
+					touched.push_back(next);
+				}
+			}
+		}
+	}
+
+	// a tile's first step depends on the costs around it, so resolve the neighbourhood too
+	for (const vector<int>* list : { &affected, &touched })
+	{
+		for (int index : *list)
+		{
+			const int row = index / _cols;
+			const int col = index % _cols;
+			for (int dRow = -1; dRow <= 1; dRow++)
+			{
+				for (int dCol = -1; dCol <= 1; dCol++)
+				{
+					const int r = row + dRow;
+					const int c = col + dCol;
+					if (r >= 0 && r < _rows && c >= 0 && c < _cols && (_marks[r * _cols + c] & MARK_RESOLVE) == 0)
+					{
+						_marks[r * _cols + c] |= MARK_RESOLVE;
+						resolve.push_back(r * _cols + c);
+					}
+				}
+			}
+		}
+	}
+
+	for (int index : resolve)
+	{
+		ResolveDirection(index);
+		_marks[index] = 0;
+	}
+	for (int index : affected)
+	{
+		_marks[index] = 0;
+	}
+	for (int index : touched)
+	{
+		_marks[index] = 0;
+	}
+}
+
+int FlowField::GetDistance(int row, int col) const
+{
+	return _distance[static_cast<size_t>(row) * _cols + col];
+}
+
+unsigned char FlowField::GetDirection(int row, int col) const
+{
+	return _direction[static_cast<size_t>(row) * _cols + col];
+}
+
+bool FlowField::NextStep(const Location& from, Location& next) const
+{
+	if (from.x < 0 || from.x >= _rows || from.y < 0 || from.y >= _cols)
+	{
+		return false;
+	}
+
+	const unsigned char step = _direction[static_cast<size_t>(from.x) * _cols + from.y];
+	if (step == FLOW_NONE)
+	{
+		return false;
+	}
+
+	next.x = from.x + DIRECTIONS[step][0];
+	next.y = from.y + DIRECTIONS[step][1];
+	return true;
+}
+
+void FlowField::SetThreads(int threads)
+{
+	if (threads <= 0)
+	{
+		threads = static_cast<int>(thread::hardware_concurrency());
+	}
+	_threads = max(threads, 1);
+}
+
+int FlowField::GetThreads() const
+{
+	return _threads;
+}
@@ -0,0 +1,154 @@
+#pragma once
+#include "TileSpace.h"
+#include "IndexedHeap.h"
+
+#include <vector>
+/**
+ * @file FlowField.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the FlowField class, a Dijkstra map
+ * over a TileSpace. One multi-source search from the target tiles (usually the Player)
+ * stores the route cost of every tile to the nearest target and the direction of the first
+ * step along that route, so any number of enemies can follow the field with an O(1) lookup
+ * instead of running their own search. Moves and costs are the same as the Pathfinder's:
+ * eight directions, straight steps cost 10, diagonal steps 14 and no corner cutting.
+ *
+ * On large maps Compute() splits the rows into strips, one per thread. Every strip runs
+ * Dijkstra inside its own rows and the strips then swap their boundary rows and repeat
+ * until no boundary changes. Shortest distances are unique so the field is identical no
+ * matter how many threads run. When only a few tiles change, UpdateTiles() repairs the field
+ * locally: tiles whose route ran through a changed tile are reset and searched again, and
+ * tiles that gained a shorter route through a newly opened tile are lowered.
+ *
+ * Properties:
+ * -----------
+ * > _space: TileSpace<Tile*>* - The TileSpace the field covers.
+ * > _flags: unsigned char* - The TileFlags layer of the TileSpace.
+ * > _rows, _cols: int - The dimensions of the TileSpace.
+ * > _threads: int - The number of threads used by Compute() on large maps.
+ * > _distance: vector<int> - The route cost of every tile to the nearest target.
+ * > _direction: vector<unsigned char> - The first step of every tile, FLOW_NONE if there is none.
+ * > _isTarget: vector<unsigned char> - Marks the target tiles of the last Compute().
+ * > _repair: IndexedHeap<int> - The open list used by UpdateTiles().
+ * > _marks: vector<unsigned char> - Scratch marks used by UpdateTiles().
+ *
+ * Methods:
+ * --------
+ * > FlowField(space: TileSpace<Tile*>*, threads: int) - Creates an empty field for a TileSpace.
+ * > Compute(targets: vector<Location>) - Rebuilds the whole field for a set of targets.
+ * > UpdateTiles(changed: vector<Location>) - Repairs the field after the flags of a few tiles changed.
+ * > GetDistance(row, col): int - The route cost of a tile, FLOW_UNREACHABLE if none.
+ * > GetDirection(row, col): unsigned char - The index of the first step of a tile.
+ * > NextStep(from, next): bool - The tile to step onto from a tile.
+ * > SetThreads(threads), GetThreads() - The number of threads used by Compute().
+ */
+class FlowField
+{
+public:
+	static const int FLOW_UNREACHABLE = 0x3fffffff;
+	static const unsigned char FLOW_NONE = 8;
+	static const int FLOW_PARALLEL_TILES = 256 * 256;
+
+private:
+	const TileSpace<Tile*>* _space;
+	const unsigned char* _flags;
+	int _rows;
+	int _cols;
+	int _threads;
+	std::vector<int> _distance;
+	std::vector<unsigned char> _direction;
+	std::vector<unsigned char> _isTarget;
+	IndexedHeap<int> _repair;
+	std::vector<unsigned char> _marks;
+
+	/**
+	 * @brief Checks whether a tile is inside the TileSpace and walkable.
+	*/
+	bool Walkable(int row, int col) const;
+
+	/**
+	 * @brief Checks whether a character may step from a tile in a direction.
+	 * @return the cost of the step, 0 if the step is not allowed.
+	*/
+	int StepCost(int row, int col, int direction) const;
+
+	/**
+	 * @brief Runs Dijkstra inside a strip of rows, starting from the tiles already in the heap.
+	 * Tiles outside the strip are never written.
+	*/
+	void SearchStrip(int firstRow, int lastRow, IndexedHeap<int>& heap);
+
+	/**
+	 * @brief Lowers the tiles of a strip's edge row that can be reached more cheaply from a
+	 * snapshot of the neighbouring strip's edge row, and queues them for the strip search.
+	*/
+	void SeedFromHalo(int row, int haloRow, int firstRow, const std::vector<int>& halo, IndexedHeap<int>& heap);
+
+	/**
+	 * @brief Chooses the cheapest first step of every tile in a range of rows.
+	*/
+	void ResolveDirections(int firstRow, int lastRow);
+
+	/**
+	 * @brief Chooses the cheapest first step of a single tile.
+	*/
+	void ResolveDirection(int index);
+
+public:
+	/**
+	 * @brief Creates an empty field for a TileSpace. Every tile starts unreachable.
+	 * @param space - the TileSpace the field covers.
+	 * @param threads - the number of threads for large maps, 0 to use every hardware thread.
+	*/
+	explicit FlowField(const TileSpace<Tile*>* space, int threads = 0);
+
+	/**
+	 * @brief Rebuilds the whole field so it leads to the nearest of the targets.
+	 * @param targets - the tiles the field leads to, tiles that are not walkable are ignored.
+	*/
+	void Compute(const std::vector<Location>& targets);
+
+	/**
+	 * @brief Repairs the field after the TileFlags of a few tiles changed, touching only the
+	 * tiles whose route or cost is affected by the change.
+	 * @param changed - the tiles whose flags changed since the field was last computed.
+	*/
+	void UpdateTiles(const std::vector<Location>& changed);
+
+	/**
+	 * @brief Getter for the route cost from a tile to the nearest target.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return an integer representing the route cost, FLOW_UNREACHABLE if no target can be reached.
+	*/
+	int GetDistance(int row, int col) const;
+
+	/**
+	 * @brief Getter for the first step of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return the index of the step direction, FLOW_NONE on targets and unreachable tiles.
+	*/
+	unsigned char GetDirection(int row, int col) const;
+
+	/**
+	 * @brief Looks up the tile to step onto from a tile to get closer to a target.
+	 * @param from - the current tile.
+	 * @param next - receives the tile to step onto.
+	 * @return a boolean value indicating whether there is a step to take.
+	*/
+	bool NextStep(const Location& from, Location& next) const;
+
+	/**
+	 * @brief Setter for the number of threads used by Compute() on large maps.
+	 * @param threads - the desired number of threads, 0 to use every hardware thread.
+	*/
+	void SetThreads(int threads);
+
+	/**
+	 * @brief Getter for the number of threads used by Compute() on large maps.
+	 * @return an integer representing the number of threads.
+	*/
+	int GetThreads() const;
+};
@@ -0,0 +1,239 @@
+#include "FrameRenderer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+namespace
+{
+	const char* const RESET_SEQUENCE = "\x1b[0m";
+	const char* const CLEAR_SEQUENCE = "\x1b[2J";
+	const char* const HOME_SEQUENCE = "\x1b[H";
+	const char* const CLEAR_BELOW_SEQUENCE = "\x1b[J";
+}
+
+const int FrameRenderer::FRAME_MAX_GAP;
+
+FrameRenderer::FrameRenderer(int rows, int cols)
+{
+	Resize(rows, cols);
+}
+
+void FrameRenderer::Resize(int rows, int cols)
+{
+	if (rows < 0 || cols < 0)
+	{
+		throw out_of_range("Frame dimensions must not be negative");
+	}
+	_rows = rows;
+	_cols = cols;
+	const size_t cells = static_cast<size_t>(rows) * cols;
+	_glyphs.assign(cells, ' ');
+	_attributes.assign(cells, FRAME_PLAIN);
+	_shownGlyphs.assign(cells, ' ');
+	_shownAttributes.assign(cells, FRAME_PLAIN);
+	_invalid = true;
+}
+
+void FrameRenderer::Clear(char glyph, unsigned char attribute)
+{
+	fill(_glyphs.begin(), _glyphs.end(), glyph);
+	fill(_attributes.begin(), _attributes.end(), attribute);
+}
+
+void FrameRenderer::Put(int row, int col, char glyph, unsigned char attribute)
+{
+	if (row < 0 || row >= _rows || col < 0 || col >= _cols)
+	{
+		return;
+	}
+	const size_t index = static_cast<size_t>(row) * _cols + col;
+	_glyphs[index] = glyph;
+	_attributes[index] = attribute;
+}
+
+int FrameRenderer::Write(int row, int col, const string& text, unsigned char attribute)
+{
+	if (row < 0 || row >= _rows)
+	{
+		return 0;
+	}
+
+	const int first = max(col, 0);
+	const int last = min(col + static_cast<int>(text.size()), _cols);
+	for (int c = first; c < last; c++)
+	{
+		const size_t index = static_cast<size_t>(row) * _cols + c;
+		_glyphs[index] = text[c - col];
+		_attributes[index] = attribute;
+	}
+	return max(last - first, 0);
+}
+
+void FrameRenderer::WriteCells(int row, int col, const char* glyphs, const unsigned char* attributes, int count)
+{
+	if (row < 0 || row >= _rows)
+	{
+		return;
+	}
+
+	const int first = max(col, 0);
+	const int last = min(col + count, _cols);
+	if (first < last)
+	{
+		const size_t index = static_cast<size_t>(row) * _cols + first;
+		memcpy(&_glyphs[index], glyphs + (first - col), last - first);
+		memcpy(&_attributes[index], attributes + (first - col), last - first);
+	}
+}
+
+bool FrameRenderer::Changed(size_t index) const
+{
+	return _glyphs[index] != _shownGlyphs[index] || _attributes[index] != _shownAttributes[index];
+}
+
+void FrameRenderer::AppendMove(int row, int col)
+{
+	_output += "\x1b[";
+	_output += to_string(row + 1);
+	_output += ';';
+	_output += to_string(col + 1);
+	_output += 'H';
+}
+
+void FrameRenderer::AppendAttribute(unsigned char attribute)
+{
+	_output += "\x1b[0";
+	if ((attribute & FRAME_BOLD) != 0)
+	{
+		_output += ";1";
+	}
+	if ((attribute & 7) != 0)
+	{
+		_output += ";3";
+		_output += static_cast<char>('0' + (attribute & 7));
+	}
+	_output += 'm';
+}
+
+size_t FrameRenderer::Present(ostream& out)
+{
+	_output.clear();
+	if (_invalid)
+	{
+		_output += RESET_SEQUENCE;
+		_output += CLEAR_SEQUENCE;
+	}
+
+	// the terminal is left plain after every frame
+	unsigned char current = FRAME_PLAIN;
+	int cursorRow = -1;
+	int cursorCol = -1;
+	bool drawn = false;
+	for (int row = 0; row < _rows; row++)
+	{
+		const size_t start = static_cast<size_t>(row) * _cols;
+		if (!_invalid && memcmp(_glyphs.data() + start, _shownGlyphs.data() + start, _cols) == 0
+			&& memcmp(_attributes.data() + start, _shownAttributes.data() + start, _cols) == 0)
+		{
+			continue;
+		}
+
+		for (int col = 0; col < _cols; col++)
+		{
+			const size_t index = static_cast<size_t>(row) * _cols + col;
+			if (!_invalid && !Changed(index))
+			{
+				continue;
+			}
+
+			bool rewrite = row == cursorRow && col > cursorCol && col - cursorCol <= FRAME_MAX_GAP;
+			for (int c = cursorCol; rewrite && c < col; c++)
+			{
+				rewrite = _attributes[index - (col - c)] == current;
+			}
+			if (rewrite)
+			{
+				// the unchanged cells in between are cheaper to repeat than to jump
+				_output.append(&_glyphs[index - (col - cursorCol)], col - cursorCol);
+			}
+			else if (row != cursorRow || col != cursorCol)
+			{
+				AppendMove(row, col);
+			}
+
+			if (_attributes[index] != current)
+			{
+				current = _attributes[index];
+				AppendAttribute(current);
+			}
+			_output += _glyphs[index];
+			drawn = true;
+
+			// past the last column the cursor position depends on the terminal
+			cursorRow = (col + 1 < _cols) ? row : -1;
+			cursorCol = col + 1;
+		}
+	}
+
+	if (drawn || _invalid)
+	{
+		if (current != FRAME_PLAIN)
+		{
+			_output += RESET_SEQUENCE;
+		}
+		AppendMove(_rows, 0);
+		_output += CLEAR_BELOW_SEQUENCE;
+	}
+	_shownGlyphs = _glyphs;
+	_shownAttributes = _attributes;
+	_invalid = false;
+
+	if (!_output.empty())
+	{
+		out.write(_output.data(), static_cast<streamsize>(_output.size()));
+		out.flush();
+	}
+	return _output.size();
+}
+
+void FrameRenderer::Invalidate()
+{
+	_invalid = true;
+}
+
+void FrameRenderer::ClearScreen(ostream& out)
+{
+	out << RESET_SEQUENCE << CLEAR_SEQUENCE << HOME_SEQUENCE;
+	out.flush();
+}
+
+int FrameRenderer::GetRows() const
+{
+	return _rows;
+}
+
+int FrameRenderer::GetCols() const
+{
+	return _cols;
+}
+
+char FrameRenderer::GetGlyph(int row, int col) const
+{
+	if (row < 0 || row >= _rows || col < 0 || col >= _cols)
+	{
+		throw out_of_range("Cell outside the frame");
+	}
+	return _glyphs[static_cast<size_t>(row) * _cols + col];
+}
+
+unsigned char FrameRenderer::GetAttribute(int row, int col) const
+{
+	if (row < 0 || row >= _rows || col < 0 || col >= _cols)
+	{
+		throw out_of_range("Cell outside the frame");
+	}
+	return _attributes[static_cast<size_t>(row) * _cols + col];
+}
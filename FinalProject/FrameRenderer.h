@@ -0,0 +1,197 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <vector>
+/**
+ * @file FrameRenderer.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the FrameRenderer class which draws
+ * frames of ASCII cells to an ANSI terminal. The game composes a frame into a back buffer of
+ * glyphs and attributes, cell by cell, without touching the console. Present() then compares
+ * it against the frame that is on screen and writes only the cells that changed, moving the
+ * cursor with ANSI escape sequences, all gathered into one string and sent with a single
+ * write and a single flush. A frame where one character moved costs a few dozen bytes
+ * instead of the whole screen, and no line ever flushes on its own.
+ *
+ * Short gaps of unchanged cells between changed ones are written over rather than skipped,
+ * since a cursor move costs more bytes than the cells it jumps. The first frame, and any frame
+ * after Invalidate(), clears the screen and is written out in full.
+ *
+ * Properties:
+ * -----------
+ * > _rows, _cols: int - The dimensions of the frame in cells.
+ * > _glyphs, _attributes: vector - The frame being composed.
+ * > _shownGlyphs, _shownAttributes: vector - The frame on screen.
+ * > _invalid: bool - Whether the screen must be redrawn in full.
+ * > _output: string - The escape sequences and cells of the frame being presented, kept between frames.
+ *
+ * Methods:
+ * --------
+ * > FrameRenderer(rows: int, cols: int) - Creates a blank frame.
+ * > Resize(rows, cols) - Changes the dimensions, redrawing in full next time.
+ * > Clear(glyph, attribute) - Fills the frame being composed.
+ * > Put(row, col, glyph, attribute) - Sets one cell, ignoring cells outside the frame.
+ * > Write(row, col, text, attribute): int - Writes text along a row, clipped to the frame.
+ * > WriteCells(row, col, glyphs, attributes, count) - Copies a run of ready made cells along a row.
+ * > Present(out): size_t - Writes the changed cells to the terminal in one write.
+ * > Invalidate() - Forces the next Present() to redraw every cell.
+ * > ClearScreen(out) - Clears the terminal with escape sequences instead of a shell command.
+ * > GetRows(), GetCols(), GetGlyph(row, col), GetAttribute(row, col) - Frame access.
+ */
+class FrameRenderer
+{
+public:
+	static const int FRAME_MAX_GAP = 4;
+
+private:
+	int _rows;
+	int _cols;
+	std::vector<char> _glyphs;
+	std::vector<unsigned char> _attributes;
+	std::vector<char> _shownGlyphs;
+	std::vector<unsigned char> _shownAttributes;
+	bool _invalid;
+	std::string _output;
+
+	/**
+	 * @brief Appends the escape sequence moving the cursor to a cell.
+	*/
+	void AppendMove(int row, int col);
+
+	/**
+	 * @brief Appends the escape sequence selecting an attribute.
+	*/
+	void AppendAttribute(unsigned char attribute);
+
+	/**
+	 * @brief Checks whether a cell differs from the one on screen.
+	*/
+	bool Changed(size_t index) const;
+
+public:
+	/**
+	 * @brief Creates a frame of blank cells. Nothing is drawn until the first Present().
+	 * @param rows - the number of rows of cells.
+	 * @param cols - the number of columns of cells.
+	*/
+	FrameRenderer(int rows = 0, int cols = 0);
+
+	/**
+	 * @brief Changes the dimensions of the frame, blanking it and redrawing in full on the next Present().
+	 * @param rows - the number of rows of cells.
+	 * @param cols - the number of columns of cells.
+	*/
+	void Resize(int rows, int cols);
+
+	/**
+	 * @brief Fills every cell of the frame being composed.
+	 * @param glyph - the character of every cell.
+	 * @param attribute - the FrameAttribute of every cell.
+	*/
+	void Clear(char glyph = ' ', unsigned char attribute = 0);
+
+	/**
+	 * @brief Sets one cell of the frame being composed. Cells outside the frame are ignored so
+	 * callers can draw partly visible shapes without clipping them.
+	 * @param row - the row of the cell.
+	 * @param col - the column of the cell.
+	 * @param glyph - the character of the cell.
+	 * @param attribute - the FrameAttribute of the cell.
+	*/
+	void Put(int row, int col, char glyph, unsigned char attribute = 0);
+
+	/**
+	 * @brief Writes text along a row of the frame being composed, clipped to the frame.
+	 * @param row - the row of the text.
+	 * @param col - the column of the first character.
+	 * @param text - the text to write, on one line.
+	 * @param attribute - the FrameAttribute of the text.
+	 * @return the number of characters that landed inside the frame.
+	*/
+	int Write(int row, int col, const std::string& text, unsigned char attribute = 0);
+
+	/**
+	 * @brief Copies a run of cells along a row of the frame being composed, clipped to the frame,
+	 * for callers that keep rendered cells of their own.
+	 * @param row - the row of the run.
+	 * @param col - the column of the first cell.
+	 * @param glyphs - the characters of the cells.
+	 * @param attributes - the FrameAttribute of every cell.
+	 * @param count - the number of cells.
+	*/
+	void WriteCells(int row, int col, const char* glyphs, const unsigned char* attributes, int count);
+
+	/**
+	 * @brief Writes the cells that changed since the last frame, leaving the cursor on the line
+	 * below the frame, with anything printed there since the last frame erased, so prompts
+	 * and ordinary output carry on underneath.
+	 * @param out - the stream of the terminal.
+	 * @return the number of bytes written, 0 when nothing changed.
+	*/
+	size_t Present(std::ostream& out);
+
+	/**
+	 * @brief Forces the next Present() to clear the screen and draw every cell, for when other
+	 * output has scrolled or overwritten the frame.
+	*/
+	void Invalidate();
+
+	/**
+	 * @brief Clears the terminal and homes the cursor.
+	 * @param out - the stream of the terminal.
+	*/
+	static void ClearScreen(std::ostream& out);
+
+	/**
+	 * @brief Getter for the number of rows.
+	 * @return an integer representing the rows of cells.
+	*/
+	int GetRows() const;
+
+	/**
+	 * @brief Getter for the number of columns.
+	 * @return an integer representing the columns of cells.
+	*/
+	int GetCols() const;
+
+	/**
+	 * @brief Getter for the glyph of a cell of the frame being composed.
+	 * @param row - the row of the cell.
+	 * @param col - the column of the cell.
+	 * @return the character of the cell.
+	*/
+	char GetGlyph(int row, int col) const;
+
+	/**
+	 * @brief Getter for the attribute of a cell of the frame being composed.
+	 * @param row - the row of the cell.
+	 * @param col - the column of the cell.
+	 * @return the FrameAttribute of the cell.
+	*/
+	unsigned char GetAttribute(int row, int col) const;
+};
+
+/**
+ * FrameAttribute enum
+ *
+ * @brief The colour and weight of a cell. The low three bits pick a foreground colour and
+ * FRAME_BOLD may be added to any of them.
+ *
+ * Values:
+ * FRAME_PLAIN - The terminal's default colour.
+ * FRAME_RED to FRAME_WHITE - The ANSI foreground colours, black left out.
+ * FRAME_BOLD - Bright or bold text.
+*/
+enum FrameAttribute : unsigned char
+{
+	FRAME_PLAIN = 0,
+	FRAME_RED = 1,
+	FRAME_GREEN = 2,
+	FRAME_YELLOW = 3,
+	FRAME_BLUE = 4,
+	FRAME_MAGENTA = 5,
+	FRAME_CYAN = 6,
+	FRAME_WHITE = 7,
+	FRAME_BOLD = 8
+};
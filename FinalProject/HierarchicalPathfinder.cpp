@@ -0,0 +1,568 @@
+#include "HierarchicalPathfinder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+namespace
+{
+	const int DIRECTIONS[8][2] = {
+		{ -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+		{ -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 }
+	};
+
+	const int UNREACHABLE = 0x3fffffff;
+
+	// runs of open border tiles at least this long get an entrance at both ends instead of one
+	// in the middle, so routes hugging either end of a wide opening do not detour
+	const int ENTRANCE_SPLIT = 6;
+
+	const size_t DEFAULT_CACHE_LIMIT = 4 * 1024 * 1024;
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder(const TileSpace<Tile*>* space, int clusterSize, unsigned char avoid)
+{
+	if (clusterSize < 2)
+	{
+		throw out_of_range("Cluster size must be at least 2");
+	}
+
+	_flags = space->GetFlagsLayer();
+	_rows = space->GetRows();
+	_cols = space->GetCols();
+	_clusterSize = clusterSize;
+	_clusterRows = (_rows + clusterSize - 1) / clusterSize;
+	_clusterCols = (_cols + clusterSize - 1) / clusterSize;
+	_avoid = avoid;
+	_generation = 0;
+	_expanded = 0;
+	_lastCost = -1;
+	_cacheBytes = 0;
+	_cacheLimit = DEFAULT_CACHE_LIMIT;
+
+	_localDist.assign(static_cast<size_t>(clusterSize) * clusterSize, UNREACHABLE);
+	_localParent.assign(_localDist.size(), -1);
+	_localHeap.Reserve(clusterSize * clusterSize);
+
+	const int clusters = _clusterRows * _clusterCols;
+	_clusterNodes.resize(clusters);
+	_borderNodes.resize(static_cast<size_t>(clusters) * 2);
+	for (int border = 0; border < clusters * 2; border++)
+	{
+		BuildBorder(border);
+	}
+	for (int cluster = 0; cluster < clusters; cluster++)
+	{
+		BuildClusterEdges(cluster);
+	}
+}
+
+bool HierarchicalPathfinder::Passable(int row, int col) const
+{
+	if (row < 0 || row >= _rows || col < 0 || col >= _cols)
+	{
+		return false;
+	}
+	const unsigned char flags = _flags[row * _cols + col];
+	return (flags & TILE_WALKABLE) != 0 && (flags & _avoid) == 0;
+}
+
+int HierarchicalPathfinder::ClusterOf(int tile) const
+{
+	return (tile / _cols / _clusterSize) * _clusterCols + (tile % _cols) / _clusterSize;
+}
+
+void HierarchicalPathfinder::ClusterBounds(int cluster, int& top, int& left, int& bottom, int& right) const
+{
+	top = (cluster / _clusterCols) * _clusterSize;
+	left = (cluster % _clusterCols) * _clusterSize;
+	bottom = min(top + _clusterSize, _rows);
+	right = min(left + _clusterSize, _cols);
+}
+
+int HierarchicalPathfinder::Distance(int from, int to) const
+{
+	const int dRow = abs(from / _cols - to / _cols);
+	const int dCol = abs(from % _cols - to % _cols);
+	const int diagonal = min(dRow, dCol);
+	return Pathfinder::DIAGONAL_COST * diagonal + Pathfinder::STRAIGHT_COST * (max(dRow, dCol) - diagonal);
+}
+
+int HierarchicalPathfinder::AddNode(int tile, int cluster)
+{
+	int id;
+	if (_freeNodes.empty())
+	{
+		id = static_cast<int>(_nodes.size());
+		_nodes.push_back(AbstractNode());
+	}
+	else
+	{
+		id = _freeNodes.back();
+		_freeNodes.pop_back();
+	}
+
+	AbstractNode& node = _nodes[id];
+	node.tile = tile;
+	node.cluster = cluster;
+	node.partner = -1;
+	node.alive = true;
+	node.edges.clear();
+	_clusterNodes[cluster].push_back(id);
+	return id;
+}
+
+void HierarchicalPathfinder::BuildBorder(int border)
+{
+	for (int id : _borderNodes[border])
+	{
+		AbstractNode& node = _nodes[id];
+		vector<int>& owner = _clusterNodes[node.cluster];
+		owner.erase(find(owner.begin(), owner.end(), id));
+		node.alive = false;
+		node.partner = -1;
+		node.edges.clear();
+		_freeNodes.push_back(id);
+	}
+	_borderNodes[border].clear();
+
+	const int cluster = border / 2;
+	const bool bottomBorder = (border % 2) != 0;
+	if ((bottomBorder && cluster / _clusterCols + 1 >= _clusterRows)
+		|| (!bottomBorder && cluster % _clusterCols + 1 >= _clusterCols))
+	{
+		return;
+	}
+
+	int top, left, bottom, right;
+	ClusterBounds(cluster, top, left, bottom, right);
+	const int other = cluster + (bottomBorder ? _clusterCols : 1);
+	const int first = bottomBorder ? left : top;
+	const int last = bottomBorder ? right : bottom;
+
+	// the tile on this cluster's side and on the other cluster's side at a border position
+	auto inside = [&](int k) { return bottomBorder ? (bottom - 1) * _cols + k : k * _cols + right - 1; };
+	auto outside = [&](int k) { return bottomBorder ? bottom * _cols + k : k * _cols + right; };
+	auto place = [&](int k)
+	{
+		const int near = AddNode(inside(k), cluster);
+		const int far = AddNode(outside(k), other);
+		_nodes[near].partner = far;
+		_nodes[far].partner = near;
+		_borderNodes[border].push_back(near);
+		_borderNodes[border].push_back(far);
+	};
+
+	int runStart = -1;
+	for (int k = first; k <= last; k++)
+	{
+		const bool open = k < last
+			&& Passable(inside(k) / _cols, inside(k) % _cols)
+			&& Passable(outside(k) / _cols, outside(k) % _cols);
+		if (open && runStart < 0)
+		{
+			runStart = k;
+		}
+		else if (!open && runStart >= 0)
+		{
+			if (k - runStart >= ENTRANCE_SPLIT)
+			{
+				place(runStart);
+				place(k - 1);
+			}
+			else
+			{
+				place((runStart + k - 1) / 2);
+			}
+			runStart = -1;
+		}
+	}
+}
+
+void HierarchicalPathfinder::BuildClusterEdges(int cluster)
+{
+	const vector<int>& nodes = _clusterNodes[cluster];
+	for (int from : nodes)
+	{
+		_nodes[from].edges.clear();
+		SearchCluster(cluster, _nodes[from].tile);
+		for (int to : nodes)
+		{
+			const int cost = LocalDistance(cluster, _nodes[to].tile);
+			if (to != from && cost < UNREACHABLE)
+			{
+				_nodes[from].edges.push_back(Edge{ to, cost });
+			}
+		}
+	}
+	EvictCluster(cluster);
+}
+
+void HierarchicalPathfinder::SearchCluster(int cluster, int source)
+{
+	int top, left, bottom, right;
+	ClusterBounds(cluster, top, left, bottom, right);
+
+	fill(_localDist.begin(), _localDist.end(), UNREACHABLE);
+	_localHeap.Clear();
+
+	const int start = (source / _cols - top) * _clusterSize + (source % _cols - left);
+	_localDist[start] = 0;
+	_localParent[start] = -1;
+	_localHeap.Push(start, 0);
+
+	while (!_localHeap.IsEmpty())
+	{
+		const int current = _localHeap.Pop();
+		const int row = top + current / _clusterSize;
+		const int col = left + current % _clusterSize;
+
+		for (const auto& direction : DIRECTIONS)
+		{
+			const int nRow = row + direction[0];
+			const int nCol = col + direction[1];
+			if (nRow < top || nRow >= bottom || nCol < left || nCol >= right || !Passable(nRow, nCol))
+			{
+				continue;
+			}
+
+			const bool diagonal = direction[0] != 0 && direction[1] != 0;
+			if (diagonal && (!Passable(nRow, col) || !Passable(row, nCol)))
+			{
+				continue;
+			}
+
+			const int next = (nRow - top) * _clusterSize + (nCol - left);
+			const int cost = _localDist[current] + (diagonal ? Pathfinder::DIAGONAL_COST : Pathfinder::STRAIGHT_COST);
+			if (cost < _localDist[next])
+			{
+				_localDist[next] = cost;
+				_localParent[next] = current;
+				_localHeap.Push(next, cost);
+			}
+		}
+	}
+}
+
+int HierarchicalPathfinder::LocalDistance(int cluster, int tile) const
+{
+	int top, left, bottom, right;
+	ClusterBounds(cluster, top, left, bottom, right);
+	return _localDist[(tile / _cols - top) * _clusterSize + (tile % _cols - left)];
+}
+
+void HierarchicalPathfinder::AppendLocalPath(int cluster, int tile, vector<int>& tiles) const
+{
+	int top, left, bottom, right;
+	ClusterBounds(cluster, top, left, bottom, right);
+
+	const size_t first = tiles.size();
+	int local = (tile / _cols - top) * _clusterSize + (tile % _cols - left);
+	while (_localParent[local] >= 0)
+	{
+		tiles.push_back((top + local / _clusterSize) * _cols + left + local % _clusterSize);
+		local = _localParent[local];
+	}
+	reverse(tiles.begin() + first, tiles.end());
+}
+
+void HierarchicalPathfinder::AppendSegment(int from, int to, vector<int>& tiles)
+{
+	const uint64_t key = (static_cast<uint64_t>(from) << 32) | static_cast<uint32_t>(to);
+	auto cached = _cacheIndex.find(key);
+	if (cached != _cacheIndex.end())
+	{
+		_cache.splice(_cache.begin(), _cache, cached->second);
+		tiles.insert(tiles.end(), cached->second->tiles.begin(), cached->second->tiles.end());
+		return;
+	}
+
+	const int cluster = _nodes[from].cluster;
+	_segment.clear();
+	SearchCluster(cluster, _nodes[from].tile);
+	AppendLocalPath(cluster, _nodes[to].tile, _segment);
+	tiles.insert(tiles.end(), _segment.begin(), _segment.end());
+
+	const size_t bytes = sizeof(CachedSegment) + _segment.size() * sizeof(int);
+	if (bytes > _cacheLimit)
+	{
+		return;
+	}
+	_cache.push_front(CachedSegment{ key, cluster, _segment });
+	_cacheIndex[key] = _cache.begin();
+	_cacheBytes += bytes;
+	TrimCache();
+}
+
+void HierarchicalPathfinder::EvictCluster(int cluster)
+{
+	for (auto segment = _cache.begin(); segment != _cache.end();)
+	{
+		if (segment->cluster == cluster)
+		{
+			_cacheBytes -= sizeof(CachedSegment) + segment->tiles.size() * sizeof(int);
+			_cacheIndex.erase(segment->key);
+			segment = _cache.erase(segment);
+		}
+		else
+		{
+			++segment;
+		}
+	}
+}
+
+void HierarchicalPathfinder::TrimCache()
+{
+	while (_cacheBytes > _cacheLimit && !_cache.empty())
+	{
+		const CachedSegment& oldest = _cache.back();
+		_cacheBytes -= sizeof(CachedSegment) + oldest.tiles.size() * sizeof(int);
+		_cacheIndex.erase(oldest.key);
+		_cache.pop_back();
+	}
+}
+
+bool HierarchicalPathfinder::FindPath(const Location& from, const Location& to, vector<Location>& path)
+{
+	path.clear();
+	_expanded = 0;
+	_lastCost = -1;
+	if (!Passable(from.x, from.y) || !Passable(to.x, to.y))
+	{
+		return false;
+	}
+
+	const int start = from.x * _cols + from.y;
+	const int goal = to.x * _cols + to.y;
+	const int startCluster = ClusterOf(start);
+	const int goalCluster = ClusterOf(goal);
+
+	// the start and goal take the two ids after the last abstract node for this query only
+	const int startId = static_cast<int>(_nodes.size());
+	const int goalId = startId + 1;
+	if (_search.size() < _nodes.size() + 2)
+	{
+		_search.resize(_nodes.size() + 2, SearchNode{ 0, -1, 0 });
+		_open.Reserve(static_cast<int>(_search.size()));
+	}
+	if (++_generation == 0)
+	{
+		for (auto& node : _search)
+		{
+			node.seen = 0;
+		}
+		_generation = 1;
+	}
+	_open.Clear();
+
+	SearchCluster(startCluster, start);
+	_startEdges.clear();
+	for (int id : _clusterNodes[startCluster])
+	{
+		const int cost = LocalDistance(startCluster, _nodes[id].tile);
+		if (cost < UNREACHABLE)
+		{
+			_startEdges.push_back(Edge{ id, cost });
+		}
+	}
+	if (startCluster == goalCluster && LocalDistance(startCluster, goal) < UNREACHABLE)
+	{
+		_startEdges.push_back(Edge{ goalId, LocalDistance(startCluster, goal) });
+	}
+
+	SearchCluster(goalCluster, goal);
+	_goalEdges.clear();
+	for (int id : _clusterNodes[goalCluster])
+	{
+		const int cost = LocalDistance(goalCluster, _nodes[id].tile);
+		if (cost < UNREACHABLE)
+		{
+			_goalEdges.push_back(Edge{ id, cost });
+		}
+	}
+
+	auto relax = [&](int id, int parent, int g)
+	{
+		SearchNode& node = _search[id];
+		if (node.seen != _generation || g < node.g)
+		{
+			node.seen = _generation;
+			node.g = g;
+			node.parent = parent;
+			_open.Push(id, g + ((id == goalId) ? 0 : Distance(_nodes[id].tile, goal)));
+		}
+	};
+
+	_search[startId] = SearchNode{ 0, -1, _generation };
+	_open.Push(startId, Distance(start, goal));
+	bool found = false;
+	while (!_open.IsEmpty())
+	{
+		const int current = _open.Pop();
+		if (current == goalId)
+		{
+			found = true;
+			break;
+		}
+
+		++_expanded;
+		const int g = _search[current].g;
+		if (current == startId)
+		{
+			for (const Edge& edge : _startEdges)
+			{
+				relax(edge.to, current, g + edge.cost);
+			}
+			continue;
+		}
+
+		const AbstractNode& node = _nodes[current];
+		relax(node.partner, current, g + Pathfinder::STRAIGHT_COST);
+		for (const Edge& edge : node.edges)
+		{
+			relax(edge.to, current, g + edge.cost);
+		}
+		if (node.cluster == goalCluster)
+		{
+			for (const Edge& edge : _goalEdges)
+			{
+				if (edge.to == current)
+				{
+					relax(goalId, current, g + edge.cost);
+				}
+			}
+		}
+	}
+	if (!found)
+	{
+		return false;
+	}
+
+	_route.clear();
+	for (int id = goalId; id >= 0; id = _search[id].parent)
+	{
+		_route.push_back(id);
+	}
+	reverse(_route.begin(), _route.end());
+
+	_tiles.clear();
+	_tiles.push_back(start);
+	for (size_t i = 0; i + 1 < _route.size(); i++)
+	{
+		const int a = _route[i];
+		const int b = _route[i + 1];
+		const int target = (b == goalId) ? goal : _nodes[b].tile;
+		if (a == startId)
+		{
+			SearchCluster(startCluster, start);
+			AppendLocalPath(startCluster, target, _tiles);
+		}
+		else if (b == goalId)
+		{
+			SearchCluster(goalCluster, _nodes[a].tile);
+			AppendLocalPath(goalCluster, goal, _tiles);
+		}
+		else if (_nodes[a].partner == b)
+		{
+			_tiles.push_back(target);
+		}
+		else
+		{
+			AppendSegment(a, b, _tiles);
+		}
+	}
+
+	path.reserve(_tiles.size());
+	for (int tile : _tiles)
+	{
+		path.push_back(Location(tile / _cols, tile % _cols));
+	}
+	_lastCost = _search[goalId].g;
+	return true;
+}
+
+void HierarchicalPathfinder::UpdateTiles(const vector<Location>& changed)
+{
+	vector<int> borders;
+	vector<int> clusters;
+	for (const Location& tile : changed)
+	{
+		if (tile.x < 0 || tile.x >= _rows || tile.y < 0 || tile.y >= _cols)
+		{
+			continue;
+		}
+
+		const int cluster = ClusterOf(tile.x * _cols + tile.y);
+		int top, left, bottom, right;
+		ClusterBounds(cluster, top, left, bottom, right);
+		clusters.push_back(cluster);
+
+		// entrances only depend on the two lines of tiles either side of a border
+		if (tile.y == left && left > 0)
+		{
+			borders.push_back(2 * (cluster - 1));
+		}
+		if (tile.y == right - 1)
+		{
+			borders.push_back(2 * cluster);
+		}
+		if (tile.x == top && top > 0)
+		{
+			borders.push_back(2 * (cluster - _clusterCols) + 1);
+		}
+		if (tile.x == bottom - 1)
+		{
+			borders.push_back(2 * cluster + 1);
+		}
+	}
+
+	sort(borders.begin(), borders.end());
+	borders.erase(unique(borders.begin(), borders.end()), borders.end());
+	for (int border : borders)
+	{
+		BuildBorder(border);
+		clusters.push_back(border / 2);
+		if (border % 2 == 0 && border / 2 % _clusterCols + 1 < _clusterCols)
+		{
+			clusters.push_back(border / 2 + 1);
+		}
+		else if (border % 2 == 1 && border / 2 / _clusterCols + 1 < _clusterRows)
+		{
+			clusters.push_back(border / 2 + _clusterCols);
+		}
+	}
+
+	sort(clusters.begin(), clusters.end());
+	clusters.erase(unique(clusters.begin(), clusters.end()), clusters.end());
+	for (int cluster : clusters)
+	{
+		BuildClusterEdges(cluster);
+	}
+}
+
+void HierarchicalPathfinder::SetCacheLimit(size_t bytes)
+{
+	_cacheLimit = bytes;
+	TrimCache();
+}
+
+size_t HierarchicalPathfinder::GetCacheBytes() const
+{
+	return _cacheBytes;
+}
+
+int HierarchicalPathfinder::GetNodeCount() const
+{
+	return static_cast<int>(_nodes.size() - _freeNodes.size());
+}
+
+int HierarchicalPathfinder::GetExpanded() const
+{
+	return _expanded;
+}
+
+int HierarchicalPathfinder::GetLastCost() const
+{
+	return _lastCost;
+}
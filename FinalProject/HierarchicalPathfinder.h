@@ -0,0 +1,256 @@
+#pragma once
+#include "TileSpace.h"
+#include "IndexedHeap.h"
+#include "Pathfinder.h"
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+/**
+ * @file HierarchicalPathfinder.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the HierarchicalPathfinder class which
+ * answers long-range route queries on large maps with HPA*. The TileSpace is cut into square
+ * clusters. Wherever two neighbouring clusters share a run of passable tiles along their border
+ * an entrance is placed, giving one abstract node on each side of the border, and the route cost
+ * between every pair of abstract nodes inside a cluster is precomputed. A query connects its
+ * start and goal to the nodes of their clusters, searches the small abstract graph and only then
+ * refines each abstract edge into tiles with a search bounded to a single cluster.
+ *
+ * Refined segments are kept in an LRU cache whose size is bounded in bytes. When tiles change
+ * (for example when an Environ's hazard is toggled) only the clusters holding those tiles, and
+ * the neighbours sharing a rebuilt border, are recomputed and dropped from the cache.
+ *
+ * Moves and costs match the Pathfinder: eight directions, straight steps cost 10, diagonal steps
+ * 14 and no corner cutting. A tile is passable when it is walkable and has none of the flags in
+ * the avoid mask. Routes are near optimal rather than optimal, as with any HPA*.
+ *
+ * Properties:
+ * -----------
+ * > _flags: unsigned char* - The TileFlags layer of the TileSpace.
+ * > _rows, _cols: int - The dimensions of the TileSpace.
+ * > _clusterSize: int - The number of rows and columns of a cluster.
+ * > _clusterRows, _clusterCols: int - The number of clusters down and across the map.
+ * > _avoid: unsigned char - TileFlags that make a walkable tile impassable.
+ * > _nodes: vector<AbstractNode> - The abstract nodes, dead nodes are reused.
+ * > _freeNodes: vector<int> - The ids of dead nodes.
+ * > _clusterNodes: vector<vector<int>> - The abstract nodes of every cluster.
+ * > _borderNodes: vector<vector<int>> - The abstract nodes created by every border.
+ * > _search: vector<SearchNode> - The abstract search arena.
+ * > _open: IndexedHeap<int> - The abstract open list.
+ * > _startEdges, _goalEdges: vector<Edge> - The routes linking a query's start and goal to their clusters.
+ * > _route, _tiles: vector<int> - The abstract and refined route of the last query.
+ * > _local*: The arena of the search bounded to one cluster.
+ * > _cache, _cacheIndex: The LRU cache of refined segments.
+ * > _cacheBytes, _cacheLimit: size_t - The memory used by and allowed for the cache.
+ *
+ * Methods:
+ * --------
+ * > HierarchicalPathfinder(space, clusterSize, avoid) - Builds the abstract graph of a TileSpace.
+ * > FindPath(from, to, path): bool - Computes a route between two tiles.
+ * > UpdateTiles(changed) - Recomputes the clusters holding tiles whose flags changed.
+ * > SetCacheLimit(bytes), GetCacheBytes() - The memory bound of the segment cache.
+ * > GetNodeCount(), GetExpanded(), GetLastCost() - Statistics of the graph and the last query.
+ */
+class HierarchicalPathfinder
+{
+private:
+	/**
+	 * @brief A precomputed route between two abstract nodes of the same cluster.
+	*/
+	struct Edge
+	{
+		int to;
+		int cost;
+	};
+
+	/**
+	 * @brief An abstract node sitting on one side of an entrance.
+	*/
+	struct AbstractNode
+	{
+		int tile;
+		int cluster;
+		int partner;
+		bool alive;
+		std::vector<Edge> edges;
+	};
+
+	/**
+	 * @brief The abstract search record of a node, valid while seen matches the generation.
+	*/
+	struct SearchNode
+	{
+		int g;
+		int parent;
+		unsigned int seen;
+	};
+
+	/**
+	 * @brief A refined segment in the LRU cache.
+	*/
+	struct CachedSegment
+	{
+		uint64_t key;
+		int cluster;
+		std::vector<int> tiles;
+	};
+
+	const unsigned char* _flags;
+	int _rows;
+	int _cols;
+	int _clusterSize;
+	int _clusterRows;
+	int _clusterCols;
+	unsigned char _avoid;
+
+	std::vector<AbstractNode> _nodes;
+	std::vector<int> _freeNodes;
+	std::vector<std::vector<int>> _clusterNodes;
+	std::vector<std::vector<int>> _borderNodes;
+
+	std::vector<SearchNode> _search;
+	IndexedHeap<int> _open;
+	unsigned int _generation;
+	std::vector<Edge> _startEdges;
+	std::vector<Edge> _goalEdges;
+	std::vector<int> _route;
+	std::vector<int> _tiles;
+	int _expanded;
+	int _lastCost;
+
+	std::vector<int> _localDist;
+	std::vector<int> _localParent;
+	IndexedHeap<int> _localHeap;
+	std::vector<int> _segment;
+
+	std::list<CachedSegment> _cache;
+	std::unordered_map<uint64_t, std::list<CachedSegment>::iterator> _cacheIndex;
+	size_t _cacheBytes;
+	size_t _cacheLimit;
+
+	/**
+	 * @brief Checks whether a tile is inside the map, walkable and not avoided.
+	*/
+	bool Passable(int row, int col) const;
+
+	/**
+	 * @brief The index of the cluster holding a tile.
+	*/
+	int ClusterOf(int tile) const;
+
+	/**
+	 * @brief The first row and column of a cluster and one past its last row and column.
+	*/
+	void ClusterBounds(int cluster, int& top, int& left, int& bottom, int& right) const;
+
+	/**
+	 * @brief Adds an abstract node, reusing a dead one when possible.
+	*/
+	int AddNode(int tile, int cluster);
+
+	/**
+	 * @brief Removes the entrances of a border and places them again from the current tiles.
+	 * Border 2 * c is the right border of cluster c and border 2 * c + 1 its bottom border.
+	*/
+	void BuildBorder(int border);
+
+	/**
+	 * @brief Recomputes the routes between all abstract nodes of a cluster.
+	*/
+	void BuildClusterEdges(int cluster);
+
+	/**
+	 * @brief Runs Dijkstra from a tile without leaving its cluster, filling the local arena.
+	*/
+	void SearchCluster(int cluster, int source);
+
+	/**
+	 * @brief The route cost to a tile found by the last SearchCluster().
+	*/
+	int LocalDistance(int cluster, int tile) const;
+
+	/**
+	 * @brief Appends the tiles of the route to a tile found by the last SearchCluster(),
+	 * excluding the source tile.
+	*/
+	void AppendLocalPath(int cluster, int tile, std::vector<int>& tiles) const;
+
+	/**
+	 * @brief Appends the refined route between two abstract nodes of the same cluster,
+	 * using the cache when the segment is already known.
+	*/
+	void AppendSegment(int from, int to, std::vector<int>& tiles);
+
+	/**
+	 * @brief Drops the cached segments of a cluster.
+	*/
+	void EvictCluster(int cluster);
+
+	/**
+	 * @brief Drops the least recently used segments until the cache fits its limit.
+	*/
+	void TrimCache();
+
+	/**
+	 * @brief The octile distance between two tiles.
+	*/
+	int Distance(int from, int to) const;
+
+public:
+	/**
+	 * @brief Builds the clusters, entrances and intra-cluster routes of a TileSpace.
+	 * @param space - the TileSpace to compute routes on.
+	 * @param clusterSize - the number of rows and columns of a cluster.
+	 * @param avoid - TileFlags that make a walkable tile impassable, e.g. TILE_HAZARD.
+	*/
+	HierarchicalPathfinder(const TileSpace<Tile*>* space, int clusterSize = 16, unsigned char avoid = TILE_HAZARD);
+
+	/**
+	 * @brief Computes a route by searching the abstract graph and refining the abstract edges.
+	 * @param from - the starting tile.
+	 * @param to - the goal tile.
+	 * @param path - receives every tile of the route, from the start to the goal inclusive.
+	 * @return a boolean value indicating whether a route exists.
+	*/
+	bool FindPath(const Location& from, const Location& to, std::vector<Location>& path);
+
+	/**
+	 * @brief Recomputes the clusters holding tiles whose flags changed, together with the
+	 * neighbouring clusters when a changed tile sits on a cluster border.
+	 * @param changed - the tiles whose flags changed.
+	*/
+	void UpdateTiles(const std::vector<Location>& changed);
+
+	/**
+	 * @brief Setter for the memory bound of the segment cache.
+	 * @param bytes - the most memory the cached segments may take.
+	*/
+	void SetCacheLimit(size_t bytes);
+
+	/**
+	 * @brief Getter for the memory taken by the cached segments.
+	 * @return the number of bytes used by the cache.
+	*/
+	size_t GetCacheBytes() const;
+
+	/**
+	 * @brief Getter for the number of live abstract nodes.
+	 * @return an integer representing the number of abstract nodes.
+	*/
+	int GetNodeCount() const;
+
+	/**
+	 * @brief Getter for the number of abstract nodes expanded by the last query.
+	 * @return an integer representing the number of expanded nodes.
+	*/
+	int GetExpanded() const;
+
+	/**
+	 * @brief Getter for the cost of the route found by the last query.
+	 * @return an integer representing the route cost, -1 if no route was found.
+	*/
+	int GetLastCost() const;
+};
@@ -0,0 +1,232 @@
+#pragma once
+#include <stdexcept>
+#include <vector>
+/**
+ * @file IndexedHeap.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the IndexedHeap class, a binary min-heap of integer ids
+ * (for example tile indices) ordered by a priority of type T. The heap remembers where every
+ * id sits so the priority of an id already in the heap can be lowered in O(log n). All storage
+ * is reserved up front for a fixed number of ids, so pushing, popping and clearing never
+ * allocate and the same heap can be reused across many searches.
+ *
+ * Properties:
+ * -----------
+ * > _heap: vector<int> - The ids in heap order.
+ * > _priorities: vector<T> - The priority of every id, indexed by id.
+ * > _positions: vector<int> - The slot of every id in _heap, -1 when the id is not in the heap.
+ * > _size: int - The number of ids currently in the heap.
+ *
+ * Methods:
+ * --------
+ * > IndexedHeap() - This is the default constructor of the IndexedHeap class.
+ * > IndexedHeap(capacity: int) - Creates a heap able to hold the ids 0 to capacity - 1.
+ * > Reserve(capacity: int) - Resizes the heap for a new range of ids, emptying it.
+ * > Push(id: int, priority: T) - Adds an id or lowers the priority of an id already in the heap.
+ * > Pop(): int - Removes and returns the id with the smallest priority.
+ * > Top(): int - Returns the id with the smallest priority.
+ * > Contains(id: int): bool - Checks whether an id is in the heap.
+ * > Clear() - Removes all ids from the heap in O(size).
+ * > Size(), IsEmpty() - The number of ids in the heap.
+ */
+template <class T>
+class IndexedHeap
+{
+private:
+	std::vector<int> _heap;
+	std::vector<T> _priorities;
+	std::vector<int> _positions;
+	int _size;
+
+	/**
+	 * @brief Moves the id at a slot up until its parent has a smaller priority.
+	 * @param slot - the slot of the id to move.
+	*/
+	void SiftUp(int slot)
+	{
+		const int id = _heap[slot];
+		while (slot > 0)
+		{
+			const int parent = (slot - 1) >> 1;
+			if (!(_priorities[id] < _priorities[_heap[parent]]))
+			{
+				break;
+			}
+			_heap[slot] = _heap[parent];
+			_positions[_heap[slot]] = slot;
+			slot = parent;
+		}
+		_heap[slot] = id;
+		_positions[id] = slot;
+	}
+
+	/**
+	 * @brief Moves the id at a slot down until both children have larger priorities.
+	 * @param slot - the slot of the id to move.
+	*/
+	void SiftDown(int slot)
+	{
+		const int id = _heap[slot];
+		while (true)
+		{
+			int child = 2 * slot + 1;
+			if (child >= _size)
+			{
+				break;
+			}
+			if (child + 1 < _size && _priorities[_heap[child + 1]] < _priorities[_heap[child]])
+			{
+				++child;
+			}
+			if (!(_priorities[_heap[child]] < _priorities[id]))
+			{
+				break;
+			}
+			_heap[slot] = _heap[child];
+			_positions[_heap[slot]] = slot;
+			slot = child;
+		}
+		_heap[slot] = id;
+		_positions[id] = slot;
+	}
+
+public:
+	/**
+	 * @brief This is the default constructor of the IndexedHeap class.
+	*/
+	IndexedHeap() : _size(0)
+	{
+	}
+
+	/**
+	 * @brief This is the overloaded constructor of the IndexedHeap class.
+	 * @param capacity - the number of ids the heap can hold.
+	*/
+	explicit IndexedHeap(int capacity) : _size(0)
+	{
+		Reserve(capacity);
+	}
+
+	/**
+	 * @brief Resizes the heap so it can hold the ids 0 to capacity - 1. The heap is emptied.
+	 * @param capacity - the number of ids the heap can hold.
+	*/
+	void Reserve(int capacity)
+	{
+		_heap.assign(capacity, 0);
+		_priorities.assign(capacity, T());
+		_positions.assign(capacity, -1);
+		_size = 0;
+	}
+
+	/**
+	 * @brief Adds an id to the heap, or updates its priority if it is already in the heap.
+	 * @param id - the id to add.
+	 * @param priority - the priority of the id.
+	*/
+	void Push(int id, T priority)
+	{
+		if (id < 0 || id >= static_cast<int>(_positions.size()))
+		{
+			throw std::out_of_range("Heap id out of range");
+		}
+
+		const int slot = _positions[id];
+		_priorities[id] = priority;
+		if (slot < 0)
+		{
+			_heap[_size] = id;
+			SiftUp(_size++);
+		}
+		else
+		{
+			SiftUp(slot);
+			SiftDown(_positions[id]);
+		}
+	}
+
+	/**
+	 * @brief Removes the id with the smallest priority from the heap.
+	 * @return the id with the smallest priority.
+	*/
+	int Pop()
+	{
+		if (_size == 0)
+		{
+			throw std::out_of_range("Heap is empty");
+		}
+
+		const int top = _heap[0];
+		_positions[top] = -1;
+		if (--_size > 0)
+		{
+			_heap[0] = _heap[_size];
+			SiftDown(0);
+		}
+		return top;
+	}
+
+	/**
+	 * @brief Returns the id with the smallest priority without removing it.
+	 * @return the id with the smallest priority.
+	*/
+	int Top() const
+	{
+		if (_size == 0)
+		{
+			throw std::out_of_range("Heap is empty");
+		}
+		return _heap[0];
+	}
+
+	/**
+	 * @brief Getter for the priority last given to an id.
+	 * @param id - the id to look up.
+	 * @return the priority of the id.
+	*/
+	T GetPriority(int id) const
+	{
+		return _priorities[id];
+	}
+
+	/**
+	 * @brief Checks whether an id is currently in the heap.
+	 * @param id - the id to look up.
+	 * @return a boolean value indicating whether the id is in the heap.
+	*/
+	bool Contains(int id) const
+	{
+		return _positions[id] >= 0;
+	}
+
+	/**
+	 * @brief Removes every id from the heap. Only the slots in use are touched.
+	*/
+	void Clear()
+	{
+		for (int i = 0; i < _size; i++)
+		{
+			_positions[_heap[i]] = -1;
+		}
+		_size = 0;
+	}
+
+	/**
+	 * @brief Getter for the number of ids in the heap.
+	 * @return an integer representing the number of ids in the heap.
+	*/
+	int Size() const
+	{
+		return _size;
+	}
+
+	/**
+	 * @brief Checks whether the heap is empty.
+	 * @return a boolean value indicating whether the heap is empty.
+	*/
+	bool IsEmpty() const
+	{
+		return _size == 0;
+	}
+};
@@ -61,9 +61,9 @@ void Item::PowerUp(int strength, int range)
 	_strength += strength;
 	_range += range;
 
-	cout << "Powered up!" << endl;
-	cout << "Strength: " << _strength << endl;
-	cout << "Range: " << _range << endl;
+	cout << "Powered up!\n";
+	cout << "Strength: " << _strength << '\n';
+	cout << "Range: " << _range << '\n';
 }
 
 const Item& Item::operator*()
@@ -73,8 +73,8 @@ const Item& Item::operator*()
 
 void Item::Print() const
 {
-	cout << "\tName: " << _name << endl;
-	cout << "\tStrength: " << _strength << endl;
-	cout << "\tRange: " << _range << endl;
-	cout << "\t------------------" << endl;
+	cout << "\tName: " << _name << '\n';
+	cout << "\tStrength: " << _strength << '\n';
+	cout << "\tRange: " << _range << '\n';
+	cout << "\t------------------\n";
 }
\ No newline at end of file
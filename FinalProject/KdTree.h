@@ -0,0 +1,276 @@
+#pragma once
+#include "Tile.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+/**
+ * @file KdTree.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the KdTree class, a two dimensional k-d tree over item
+ * positions answering nearest, k nearest and radius queries. The tree is meant to be rebuilt
+ * in bulk once per tick: items are added with Add() and Build() arranges them in place. There
+ * are no node objects or child pointers. The tree is implicit in one flat array of points:
+ * the node of a range of the array is its middle point, which splits the range into the left
+ * and right subtrees, and a parallel byte array holds the axis each node splits on. Ranges of
+ * at most KD_LEAF_SIZE points are scanned linearly as leaves.
+ *
+ * Every node splits along the axis on which its range is spread the widest, so clustered
+ * crowds still produce balanced, compact cells where a fixed grid would fill a few cells and
+ * leave the rest empty. Storage is kept between builds so rebuilding every tick does not
+ * allocate once the population settles.
+ *
+ * Properties:
+ * -----------
+ * > _points: vector<Point> - The items and their tiles in tree order.
+ * > _axis: vector<unsigned char> - The split axis of the node stored at every index, 0 for rows.
+ * > _best: vector<pair<long long, int>> - Scratch max-heap of the best candidates of a query.
+ *
+ * Methods:
+ * --------
+ * > Clear() - Removes every item.
+ * > Add(item: T, loc: Location) - Adds an item for the next Build().
+ * > Build() - Arranges the added items into the tree in O(n log n).
+ * > Nearest(loc: Location, k: int, result: vector<T>, accept) - The k items closest to a tile.
+ * > QueryRadius(center: Location, radius: int, result: vector<T>) - Items within a distance of a tile.
+ * > Size(): int - The number of items in the tree.
+ */
+
+const int KD_LEAF_SIZE = 8;
+
+template <class T>
+class KdTree
+{
+private:
+	struct Point
+	{
+		int coord[2];
+		T item;
+	};
+
+	std::vector<Point> _points;
+	std::vector<unsigned char> _axis;
+	std::vector<std::pair<long long, int>> _best;
+
+	static long long SquaredDistance(const Point& point, int x, int y)
+	{
+		const long long dx = point.coord[0] - x;
+		const long long dy = point.coord[1] - y;
+		return dx * dx + dy * dy;
+	}
+
+	/**
+	 * @brief Arranges a range of points into a subtree rooted at its middle point.
+	*/
+	void Build(int lo, int hi)
+	{
+		if (hi - lo <= KD_LEAF_SIZE)
+		{
+			return;
+		}
+
+		int minimum[2] = { _points[lo].coord[0], _points[lo].coord[1] };
+		int maximum[2] = { minimum[0], minimum[1] };
+		for (int i = lo + 1; i < hi; i++)
+		{
+			for (int a = 0; a < 2; a++)
+			{
+				minimum[a] = std::min(minimum[a], _points[i].coord[a]);
+				maximum[a] = std::max(maximum[a], _points[i].coord[a]);
+			}
+		}
+
+		const int axis = (maximum[1] - minimum[1] > maximum[0] - minimum[0]) ? 1 : 0;
+		const int mid = lo + (hi - lo) / 2;
+		std::nth_element(_points.begin() + lo, _points.begin() + mid, _points.begin() + hi,
+			[axis](const Point& a, const Point& b) { return a.coord[axis] < b.coord[axis]; });
+		_axis[mid] = static_cast<unsigned char>(axis);
+
+		Build(lo, mid);
+		Build(mid + 1, hi);
+	}
+
+	/**
+	 * @brief Offers a point to the best candidates of a k nearest query.
+	*/
+	void Offer(int index, long long distance, int k)
+	{
+		if (static_cast<int>(_best.size()) < k)
+		{
+			_best.emplace_back(distance, index);
+			std::push_heap(_best.begin(), _best.end());
+		}
+		else if (std::make_pair(distance, index) < _best.front())
+		{
+			std::pop_heap(_best.begin(), _best.end());
+			_best.back() = std::make_pair(distance, index);
+			std::push_heap(_best.begin(), _best.end());
+		}
+	}
+
+	template <class Accept>
+	void SearchNearest(int lo, int hi, int x, int y, int k, Accept& accept)
+	{
+		if (hi - lo <= KD_LEAF_SIZE)
+		{
+			for (int i = lo; i < hi; i++)
+			{
+				if (accept(_points[i].item))
+				{
+					Offer(i, SquaredDistance(_points[i], x, y), k);
+				}
+			}
+			return;
+		}
+
+		const int mid = lo + (hi - lo) / 2;
+		const Point& node = _points[mid];
+		if (accept(node.item))
+		{
+			Offer(mid, SquaredDistance(node, x, y), k);
+		}
+
+		// search the side holding the query first, the far side only while it could still
+		// hold something closer than the worst candidate
+		const long long difference = static_cast<long long>(_axis[mid] == 0 ? x : y) - node.coord[_axis[mid]];
+		if (difference < 0)
+		{
+			SearchNearest(lo, mid, x, y, k, accept);
+		}
+		else
+		{
+			SearchNearest(mid + 1, hi, x, y, k, accept);
+		}
+
+		if (static_cast<int>(_best.size()) < k || difference * difference <= _best.front().first)
+		{
+			if (difference < 0)
+			{
+				SearchNearest(mid + 1, hi, x, y, k, accept);
+			}
+			else
+			{
+				SearchNearest(lo, mid, x, y, k, accept);
+			}
+		}
+	}
+
+	void SearchRadius(int lo, int hi, int x, int y, int radius, std::vector<T>& result) const
+	{
+		const long long limit = static_cast<long long>(radius) * radius;
+		if (hi - lo <= KD_LEAF_SIZE)
+		{
+			for (int i = lo; i < hi; i++)
+			{
+				if (SquaredDistance(_points[i], x, y) <= limit)
+				{
+					result.push_back(_points[i].item);
+				}
+			}
+			return;
+		}
+
+		const int mid = lo + (hi - lo) / 2;
+		const Point& node = _points[mid];
+		if (SquaredDistance(node, x, y) <= limit)
+		{
+			result.push_back(node.item);
+		}
+
+		const int difference = (_axis[mid] == 0 ? x : y) - node.coord[_axis[mid]];
+		if (difference <= radius)
+		{
+			SearchRadius(lo, mid, x, y, radius, result);
+		}
+		if (difference >= -radius)
+		{
+			SearchRadius(mid + 1, hi, x, y, radius, result);
+		}
+	}
+
+public:
+	/**
+	 * @brief Removes every item, keeping the storage for the next build.
+	*/
+	void Clear()
+	{
+		_points.clear();
+	}
+
+	/**
+	 * @brief Adds an item for the next Build(). Queries only see items added before the last build.
+	 * @param item - the item to add.
+	 * @param loc - the tile of the item.
+	*/
+	void Add(T item, const Location& loc)
+	{
+		_points.push_back(Point{ { loc.x, loc.y }, item });
+	}
+
+	/**
+	 * @brief Arranges the added items into the tree.
+	*/
+	void Build()
+	{
+		_axis.resize(_points.size());
+		Build(0, static_cast<int>(_points.size()));
+	}
+
+	/**
+	 * @brief Finds the k items closest to a tile among those an accept test lets through,
+	 * closest first. Items at the same distance come in tree order.
+	 * @param loc - the tile to measure from.
+	 * @param k - the largest number of items to return.
+	 * @param result - receives the items found.
+	 * @param accept - a callable taking an item and returning whether it may be returned.
+	*/
+	template <class Accept>
+	void Nearest(const Location& loc, int k, std::vector<T>& result, Accept accept)
+	{
+		result.clear();
+		_best.clear();
+		if (k <= 0 || _points.empty())
+		{
+			return;
+		}
+
+		SearchNearest(0, static_cast<int>(_points.size()), loc.x, loc.y, k, accept);
+		std::sort_heap(_best.begin(), _best.end());
+		for (const auto& candidate : _best)
+		{
+			result.push_back(_points[candidate.second].item);
+		}
+	}
+
+	/**
+	 * @brief Finds the k items closest to a tile, closest first.
+	 * @param loc - the tile to measure from.
+	 * @param k - the largest number of items to return.
+	 * @param result - receives the items found.
+	*/
+	void Nearest(const Location& loc, int k, std::vector<T>& result)
+	{
+		Nearest(loc, k, result, [](const T&) { return true; });
+	}
+
+	/**
+	 * @brief Finds the items within a straight line distance of a tile.
+	 * @param center - the tile at the center of the circle.
+	 * @param radius - the largest distance in tiles, inclusive.
+	 * @param result - the items found are appended to it.
+	*/
+	void QueryRadius(const Location& center, int radius, std::vector<T>& result) const
+	{
+		SearchRadius(0, static_cast<int>(_points.size()), center.x, center.y, radius, result);
+	}
+
+	/**
+	 * @brief Getter for the number of items in the tree.
+	 * @return an integer representing the number of items.
+	*/
+	int Size() const
+	{
+		return static_cast<int>(_points.size());
+	}
+};
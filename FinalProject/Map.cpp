@@ -4,12 +4,32 @@
 #include "Enemy.h"
 #include "Player.h"
 #include "Stack.h"
+#include "Benchmark.h"
+#include "MapFile.h"
+#include "MapGenerator.h"
+
+#include <algorithm>
+#include <stdexcept>
 
 using namespace std;
 
+namespace
+{
+	// below this many characters a plain scan beats building and walking a k-d tree
+	const size_t KDTREE_MIN_POPULATION = 64;
+
+	bool IsHostile(const Character* one, const Character* other)
+	{
+		return (dynamic_cast<const Player*>(one) != nullptr) != (dynamic_cast<const Player*>(other) != nullptr);
+	}
+}
+
+const int Map::MAX_MAP_SIZE;
+
 Map::Map()
 {
 	tileSpace = new TileSpace<Tile*>();
+	mapView = nullptr;
 
 	vector<string> envNames = {
 		"Grass", "Dirt", "Water", "Rock",
@@ -50,17 +70,34 @@ Map::Map()
 	characters = {
 		player, playerMuncher, playerChomper, bigBoss
 	};
+	for (auto* character : characters)
+	{
+		character->SetSpatialIndex(&characterIndex);
+	}
+	ApplyEnvironEffects();
 }
 
 Map::Map(TileSpace<Tile*>* tSpace, std::vector<Environ*>& env, std::vector<Character*>& chrcters)
 {
 	tileSpace = tSpace;
+	mapView = nullptr;
 	environs = env;
 	characters = chrcters;
+	for (auto* character : characters)
+	{
+		character->SetSpatialIndex(&characterIndex);
+	}
+	ApplyEnvironEffects();
 }
 
 Map::~Map()
 {
+	// the index dies with the map, characters outliving it must not reach back into it
+	for (auto* character : characters)
+	{
+		character->SetSpatialIndex(nullptr);
+	}
+	delete mapView;
 	delete tileSpace;
 }
 
@@ -69,6 +106,20 @@ std::vector<Environ*> Map::GetEnviron() const
 	return environs;
 }
 
+Environ* Map::GetEnvironAt(int row, int col) const
+{
+	if (row < 0 || row >= tileSpace->GetRows() || col < 0 || col >= tileSpace->GetCols())
+	{
+		throw out_of_range("Tile outside the map");
+	}
+	const unsigned char terrain = tileSpace->GetTerrain(row, col);
+	if (terrain >= environs.size())
+	{
+		throw out_of_range("Tile Environ index has no Environ");
+	}
+	return environs[terrain];
+}
+
 std::vector<Character*> Map::GetCharacters() const
 {
 	return characters;
@@ -76,7 +127,7 @@ std::vector<Character*> Map::GetCharacters() const
 
 void Map::DemoUnidirectional() const
 {
-	cout << "Demo Unidirectional" << endl;
+	cout << "Demo Unidirectional\n";
 	UniDirectionalList<Environ> queue = UniDirectionalList<Environ>();
 
 	for (auto* env : environs) 
@@ -86,8 +137,8 @@ void Map::DemoUnidirectional() const
 	}
 	queue.Remove(1);
 	QueueNode<Environ>* current = queue.GetFirstNode();
-	cout << "UnShuffle Linked List" << endl;
-	cout << "===================" << endl;
+	cout << "UnShuffle Linked List\n";
+	cout << "===================\n";
 	while (current->GetNext() != nullptr) 
 	{
 		Environ envNode = *current->GetItem();
@@ -97,17 +148,17 @@ void Map::DemoUnidirectional() const
 
 	current = queue.GetFirstNode();
 	queue.Shuffle();
-	cout << "Shuffle Linked List" << endl;
-	cout << "===================" << endl;
+	cout << "Shuffle Linked List\n";
+	cout << "===================\n";
 	while (current->GetNext() != nullptr) 
 	{
 		Environ envNode = *current->GetItem();
 		envNode.Print();
 		cout << queue.GetFirstNode()->GetItem()->GetName()
-		<< " Node Popped" << endl;
+		<< " Node Popped\n";
 
 		queue.Pop();
-		cout << endl;
+		cout << '\n';
 		current = current->GetNext();
 	}
 }
@@ -115,20 +166,20 @@ void Map::DemoUnidirectional() const
 void Map::DemoTrees() const
 {
 	ActionTree* tree = new ActionTree();
-	cout << "InOrder Traversal of the Tree" << endl;
-	cout << "=============================" << endl;
+	cout << "InOrder Traversal of the Tree\n";
+	cout << "=============================\n";
 	tree->InOrderTraverse();
-	cout << "PreOrder Traversal of the Tree" << endl;
-	cout << "==============================" << endl;
+	cout << "PreOrder Traversal of the Tree\n";
+	cout << "==============================\n";
 	tree->PreOrderTraverse();
-	cout << "PostOrder Traversal of the Tree" << endl;
-	cout << "===============================" << endl;
+	cout << "PostOrder Traversal of the Tree\n";
+	cout << "===============================\n";
 	tree->PostOrderTraverse();
 }
 
 void Map::DemoBidirectional() const
 {
-	cout << "Demo Bidirectional" << endl;
+	cout << "Demo Bidirectional\n";
 	Player* player = new Player(*characters[0]);
 	Enemy* playerMuncher = new Enemy(*characters[1]);
 
@@ -168,17 +219,17 @@ void Map::DemoStack() const
 		Environ envNode = *stack.Peek()->GetItem();
 		envNode.Print();
 		cout << stack.Peek()->GetItem()->GetName()
-			<< " Node Popped" << endl;
+			<< " Node Popped\n";
 
 		stack.Pop();
-		cout << endl;
+		cout << '\n';
 	}
 
-	cout << "===============================" << endl;
-	cout << "Stack is now Empty !!" << endl;
-	cout << "===============================" << endl;
-	cout << "Adding new Environ to the stack" << endl;
-	cout << "===============================" << endl;
+	cout << "===============================\n";
+	cout << "Stack is now Empty !!\n";
+	cout << "===============================\n";
+	cout << "Adding new Environ to the stack\n";
+	cout << "===============================\n";
 
 	string name = "Oasis", name2 = "Volcano", name3 = "Cave";
 	string description = "[N] Region for the player to hydrate and refresh",
@@ -198,31 +249,31 @@ void Map::DemoStack() const
 		Environ envNode = *stack.Peek()->GetItem();
 		envNode.Print();
 		cout << stack.Peek()->GetItem()->GetName()
-			<< " Node Popped" << endl;
+			<< " Node Popped\n";
 
 		stack.Pop();
-		cout << endl;
+		cout << '\n';
 	}
 }
 
 void Map::DemoIterators() const
 {
-	cout << "Player Backpack" << endl;
+	cout << "Player Backpack\n";
 	Backpack* playerBackpack = characters[0]->GetBackpack();
 	playerBackpack->Display();
 
 	Iterator1D<Item> itemBag = playerBackpack->GetItemBag();
 	Iterator1D<Weapon> weaponBag = playerBackpack->GetWeaponBag();
 
-	std::cout << "Player's Backpack" << std::endl;
-	std::cout << "==================" << std::endl;
+	std::cout << "Player's Backpack\n";
+	std::cout << "==================\n";
 	for (int i = 0; i < 4; ++i)
 	{
 		itemBag[i].Print();
 	}
 
-	std::cout << "Player's Weapons Pack" << std::endl;
-	std::cout << "=====================" << std::endl;
+	std::cout << "Player's Weapons Pack\n";
+	std::cout << "=====================\n";
 	for (int i = 0; i < 4; ++i)
 	{
 		weaponBag[i].Print();
@@ -234,13 +285,108 @@ void Map::ClearConsole() const
 {
 	#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
 		system("cls");
-	#elif __APPLE__
-		system("clear");
-	#elif __linux__
-		system("clear");
+	#else
+		FrameRenderer::ClearScreen(cout);
 	#endif
 }
 
+void Map::ShowMap(bool redraw)
+{
+	if (mapView == nullptr)
+	{
+		mapView = new MapView(tileSpace);
+	}
+	const int viewRows = mapView->GetViewRows();
+	const int viewCols = mapView->GetViewCols();
+	if (frame.GetRows() != viewRows + 3 || frame.GetCols() != viewCols + 2)
+	{
+		frame.Resize(viewRows + 3, viewCols + 2);
+	}
+
+	const Location* player = characters[0]->GetLocation();
+	mapView->CenterOn(player->x, player->y);
+
+	// a border of '=' like the ASCII maps around the viewport, and a status line below
+	frame.Clear('=');
+	mapView->Draw(frame, 1, 1);
+	for (size_t i = characters.size(); i-- > 0;)
+	{
+		int viewRow, viewCol;
+		const bool isPlayer = dynamic_cast<const Player*>(characters[i]) != nullptr;
+		if (mapView->ToView(characters[i]->GetLocation()->x, characters[i]->GetLocation()->y, viewRow, viewCol))
+		{
+			frame.Put(viewRow + 1, viewCol + 1, isPlayer ? '@' : 'M', isPlayer ? FRAME_CYAN | FRAME_BOLD : FRAME_RED | FRAME_BOLD);
+		}
+	}
+	frame.Write(viewRows + 2, 0, string(viewCols + 2, ' '));
+	frame.Write(viewRows + 2, 0, characters[0]->GetName() + " at (" + to_string(player->x) + ", " + to_string(player->y) + ") of "
+		+ to_string(tileSpace->GetRows()) + " x " + to_string(tileSpace->GetCols()));
+
+	// the prompt scrolls the console between commands, only Walk() keeps the frame in place
+	if (redraw)
+	{
+		frame.Invalidate();
+	}
+	frame.Present(cout);
+}
+
+void Map::Walk()
+{
+	const int rowSteps[] = { -1, 1, 0, 0 };
+	const int colSteps[] = { 0, 0, -1, 1 };
+	const string keys = "wsad";
+	string moves;
+	ShowMap();
+	while (true)
+	{
+		cout << "Move with w, a, s and d, several at once, or q to stop: ";
+		if (!getline(cin, moves) || moves == "q")
+		{
+			break;
+		}
+
+		for (char key : moves)
+		{
+			const size_t direction = keys.find(key);
+			if (direction == string::npos)
+			{
+				continue;
+			}
+			const Location* at = characters[0]->GetLocation();
+			const int row = at->x + rowSteps[direction];
+			const int col = at->y + colSteps[direction];
+			if (tileSpace->IsWalkable(row, col))
+			{
+				characters[0]->Relocate(row, col);
+			}
+		}
+		ShowMap(false);
+	}
+}
+
+void Map::Generate(int size, unsigned int seed)
+{
+	if (size <= 0 || size > MAX_MAP_SIZE)
+	{
+		throw out_of_range("Map size must be from 1 to " + to_string(MAX_MAP_SIZE));
+	}
+
+	TileSpace<Tile*>* generated = MapGenerator(seed).Generate(size, size);
+	delete mapView;
+	mapView = nullptr;
+	delete tileSpace;
+	tileSpace = generated;
+	ApplyEnvironEffects();
+
+	// the player starts on the entry point and the enemies guard the exits
+	const Tile* spots[] = { tileSpace->GetEntryPoint(), tileSpace->GetExitOne(), tileSpace->GetExitTwo(), tileSpace->GetExitThree() };
+	for (size_t i = 0; i < characters.size(); i++)
+	{
+		const Location* spot = spots[min(i, static_cast<size_t>(3))]->GetPosition();
+		characters[i]->Relocate(spot->x, spot->y);
+	}
+}
+
 void Map::ShowEnviron() const
 {
 	for (auto* env : environs)
@@ -257,6 +403,93 @@ void Map::ShowCharacters() const
 	}
 }
 
+void Map::ToggleHazard(int index, std::vector<Location>& changed)
+{
+	if (index < 0 || index >= static_cast<int>(environs.size()))
+	{
+		throw out_of_range("Environ index out of range");
+	}
+
+	// pathfinders cache routes over the flag layer, they repair from the changed tiles
+	environs[index]->ToggleHazard();
+	tileSpace->ApplyHazard(static_cast<unsigned char>(index), environs[index]->GetHazard(), changed);
+	tileSpace->SetEnvironEffect(static_cast<unsigned char>(index),
+		environs[index]->GetHazard() ? environs[index]->GetDamage() : 0, environs[index]->GetHealing());
+
+	// the viewport keeps rendered tiles, the hazard glyphs in view are drawn again
+	if (mapView != nullptr)
+	{
+		mapView->TilesChanged(changed);
+	}
+}
+
+void Map::ApplyEnvironEffects()
+{
+	for (size_t i = 0; i < environs.size() && i < 256; i++)
+	{
+		tileSpace->SetEnvironEffect(static_cast<unsigned char>(i),
+			environs[i]->GetHazard() ? environs[i]->GetDamage() : 0, environs[i]->GetHealing());
+	}
+}
+
+std::vector<Character*> Map::CharactersInRange(const Character* character) const
+{
+	vector<Character*> inRange;
+	const int range = (character->GetInHand() != nullptr) ? character->GetInHand()->GetRange() : 0;
+	characterIndex.QueryRadius(*character->GetLocation(), range, inRange);
+	inRange.erase(remove(inRange.begin(), inRange.end(), character), inRange.end());
+	return inRange;
+}
+
+void Map::RebuildCharacterTree()
+{
+	characterTree.Clear();
+	if (characters.size() < KDTREE_MIN_POPULATION)
+	{
+		return;
+	}
+
+	for (auto* character : characters)
+	{
+		characterTree.Add(character, *character->GetLocation());
+	}
+	characterTree.Build();
+}
+
+std::vector<Character*> Map::NearestHostiles(const Character* character, int k)
+{
+	vector<Character*> nearest;
+	const Location& from = *character->GetLocation();
+	auto hostile = [character](const Character* other) { return IsHostile(character, other); };
+
+	// the tree is only trusted when it was built for the current population
+	if (characters.size() >= KDTREE_MIN_POPULATION && characterTree.Size() == static_cast<int>(characters.size()))
+	{
+		characterTree.Nearest(from, k, nearest, hostile);
+		return nearest;
+	}
+
+	vector<pair<long long, Character*>> scanned;
+	for (auto* other : characters)
+	{
+		if (hostile(other))
+		{
+			const long long dx = other->GetLocation()->x - from.x;
+			const long long dy = other->GetLocation()->y - from.y;
+			scanned.emplace_back(dx * dx + dy * dy, other);
+		}
+	}
+
+	const size_t count = min(scanned.size(), static_cast<size_t>(max(k, 0)));
+	partial_sort(scanned.begin(), scanned.begin() + count, scanned.end(),
+		[](const pair<long long, Character*>& a, const pair<long long, Character*>& b) { return a.first < b.first; });
+	for (size_t i = 0; i < count; i++)
+	{
+		nearest.push_back(scanned[i].second);
+	}
+	return nearest;
+}
+
 void Map::Fight()
 {
 	bool fighting = true;
@@ -265,27 +498,27 @@ void Map::Fight()
 	while (fighting)
 	{
 		ShowCharacters();
-		cout << "Who would you like to fight?" << endl;
+		cout << "Who would you like to fight?\n";
 		getline(cin, response);
 
 		if (response == "menu")
 		{
-			cout << "You go back to the menu" << endl;
+			cout << "You go back to the menu\n";
 		}
 		else if (response == "main menu")
 		{
 			ClearConsole();
-			cout << "You go back to the menu" << endl;
+			cout << "You go back to the menu\n";
 			break;
 		}
 		else if (response == "quit")
 		{
-			cout << "You quit the game" << endl;
+			cout << "You quit the game\n";
 			fighting = false;
 		}
 		else
 		{
-			cout << "Invalid command. Please try again. Type 'help' to get some assistance" << endl;
+			cout << "Invalid command. Please try again. Type 'help' to get some assistance\n";
 		}
 
 	}
@@ -293,7 +526,7 @@ void Map::Fight()
 
 void Map::TakeCommands()
 {
-	const Map* map = new Map();
+	Map* map = new Map();
 	bool playing = true;
 
 	while (playing)
@@ -305,23 +538,28 @@ void Map::TakeCommands()
 		
 		if (command == "help")
 		{
-			cout << "Commands: " << endl;
-			cout << "\thelp - \t\tdisplays this message" << endl;
-			cout << "\tenvs - \t\tShows the environment Items in the game" << endl;
-			cout << "\tquit - \t\tdisplays the current room" << endl;
-			cout << "\tchars - \t\tShows Characters in the game" << endl;
-			cout << "\tfight - \t\topens a door" << endl;
-			cout << "\ttrees - \t\tDemonstrates the tree data structures" << endl;
-			cout << "\tclear - \t\tclears the screen" << endl;
-			cout << "\tunidirectional - \t\tDemonstrates a Unidirectional List" << endl;
-			cout << "\tbidirectional - \t\tDemonstrates a Bidirectional List" << endl;
-			cout << "\tstack - \t\tDemonstrates a Stack Data Structure" << endl;
-			cout << "\titerators - \t\tDemonstrates the implementation of an Iterator" << endl;
-			cout << "\texamine - \t\texamines" << endl;
+			cout << "Commands: \n";
+			cout << "\thelp - \t\tdisplays this message\n";
+			cout << "\tenvs - \t\tShows the environment Items in the game\n";
+			cout << "\tquit - \t\tdisplays the current room\n";
+			cout << "\tchars - \t\tShows Characters in the game\n";
+			cout << "\tfight - \t\topens a door\n";
+			cout << "\ttrees - \t\tDemonstrates the tree data structures\n";
+			cout << "\tclear - \t\tclears the screen\n";
+			cout << "\tmap - \t\tDraws the map around the player\n";
+			cout << "\twalk - \t\tWalks the player around the map\n";
+			cout << "\tgenerate - \t\tReplaces the map with a generated one\n";
+			cout << "\tunidirectional - \t\tDemonstrates a Unidirectional List\n";
+			cout << "\tbidirectional - \t\tDemonstrates a Bidirectional List\n";
+			cout << "\tstack - \t\tDemonstrates a Stack Data Structure\n";
+			cout << "\titerators - \t\tDemonstrates the implementation of an Iterator\n";
+			cout << "\texamine - \t\texamines\n";
+			cout << "\tconvert - \t\tConverts an ASCII map into the binary map format\n";
+			cout << "\tbench - \t\tRuns a benchmark of the game's data structures\n";
 		}
 		else if (command == "quit")
 		{
-			cout << "Goodbye!" << endl;
+			cout << "Goodbye!\n";
 			playing = false;
 		}
 		else if (command == "envs")
@@ -334,18 +572,44 @@ void Map::TakeCommands()
 		}
 		else if (command == "fight")
 		{
-			cout << "You open the door and see a monster!" << endl;
-			cout << "You fight the monster and win!" << endl;
+			cout << "You open the door and see a monster!\n";
+			cout << "You fight the monster and win!\n";
 		}
 		else if (command == "trees")
 		{
-			cout << "Action Trees" << endl;
+			cout << "Action Trees\n";
 			map->DemoTrees();
 		}
 		else if (command == "clear")
 		{
 			map->ClearConsole();
 		}
+		else if (command == "map")
+		{
+			map->ShowMap();
+		}
+		else if (command == "walk")
+		{
+			map->Walk();
+		}
+		else if (command == "generate")
+		{
+			string size, seed;
+			cout << "Map size: ";
+			getline(cin, size);
+			cout << "Seed: ";
+			getline(cin, seed);
+
+			try
+			{
+				map->Generate(stoi(size), static_cast<unsigned int>(stoul(seed)));
+				map->ShowMap();
+			}
+			catch (const logic_error& error)
+			{
+				cout << "Invalid map size or seed: " << error.what() << "\n";
+			}
+		}
 		else if (command == "unidirectional")
 		{
 			map->DemoUnidirectional();
@@ -362,9 +626,35 @@ void Map::TakeCommands()
 		{
 			map->DemoStack();
 		}
+		else if (command == "convert")
+		{
+			string textPath, mapPath;
+			cout << "ASCII map to convert: ";
+			getline(cin, textPath);
+			cout << "Binary map to write: ";
+			getline(cin, mapPath);
+
+			try
+			{
+				MapFile::ConvertAscii(textPath, mapPath);
+				cout << "Map written to " << mapPath << '\n';
+			}
+			catch (const runtime_error& error)
+			{
+				cout << error.what() << '\n';
+			}
+		}
+		else if (command == "bench")
+		{
+			Benchmark::List();
+			cout << "Enter a benchmark: ";
+			string name;
+			getline(cin, name);
+			Benchmark::Run(name);
+		}
 		else
 		{
-			cout << "Invalid command. Please try again. Type 'help' to get some assistance" << endl;
+			cout << "Invalid command. Please try again. Type 'help' to get some assistance\n";
 		}
 	}
 
@@ -373,8 +663,8 @@ void Map::TakeCommands()
 
 void Map::Begin()
 {
-	cout << "Welcome to the game!" << endl;
-	cout << "Type 'help' for a list of commands." << endl;
+	cout << "Welcome to the game!\n";
+	cout << "Type 'help' for a list of commands.\n";
 	
 	TakeCommands();
 }
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "Character.h"
 #include "Environ.h"
 #include "TileSpace.h"
+#include "KdTree.h"
+#include "FrameRenderer.h"
+#include "MapView.h"
 /**
  * @file Map.h
  * @author Billy Ndegwah Micah
@@ -13,27 +16,48 @@
  * > tileSpace: TileSpace - The tile space of the map
  * > environs: Environ - The environment of the map
  * > characters: Character - The characters in the map
+ * > characterIndex: SpatialHash<Character*> - The characters indexed by their tile
+ * > characterTree: KdTree<Character*> - The characters arranged for nearest queries, rebuilt every tick
+ * > frame: FrameRenderer - The frame the map is drawn into, only changed cells reach the console
+ * > mapView: MapView* - The viewport of the tile space around the player, created by the first ShowMap()
  *
  * Methods:
  * > Map() - Default constructor
  * > Map(TileSpace, Environ, Character) - Constructor
  * > GetCharacters() - Returns the characters in the map
  * > GetEnviron() - Returns the environment of the map
+ * > GetEnvironAt(row, col) - Returns the Environ of a tile
+ * > ToggleHazard(index, changed) - Toggles an Environ's hazard and flags its tiles
+ * > ApplyEnvironEffects() - Copies the damage and healing of every Environ onto its tiles
+ * > ShowMap(redraw) - Draws the viewport around the player and the characters in it through the frame renderer
+ * > Walk() - Moves the player around the map, redrawing only what changed
+ * > Generate(size, seed) - Replaces the tile space with a generated map, at most MAX_MAP_SIZE tiles a side
+ * > CharactersInRange(character) - Returns the characters within reach of a character's item
+ * > RebuildCharacterTree() - Rebuilds the k-d tree once the characters have moved
+ * > NearestHostiles(character, k) - Returns the k closest characters on the other side
  * > TakeCommands() - Takes commands from the user
  *
  */
 class Map
 {
 public:
+	// keeps a generated map in memory and its tile indexes well inside an int
+	static const int MAX_MAP_SIZE = 8192;
+
 	TileSpace<Tile*>* tileSpace;
 	std::vector<Environ*> environs;
 	std::vector <Character*> characters;
+	SpatialHash<Character*> characterIndex;
+	KdTree<Character*> characterTree;
+	FrameRenderer frame;
+	MapView* mapView;
 
 	Map();
 	Map(TileSpace<Tile*>* tSpace, std::vector<Environ*>& env, std::vector<Character*>& chrcters);
 	~Map();
 	std::vector<Character*> GetCharacters() const;
 	std::vector<Environ*> GetEnviron() const;
+	Environ* GetEnvironAt(int row, int col) const;
 
 	void DemoUnidirectional() const;
 	void DemoTrees() const;
@@ -43,6 +67,14 @@ public:
 	void ClearConsole() const;
 	void ShowEnviron() const;
 	void ShowCharacters() const;
+	void ToggleHazard(int index, std::vector<Location>& changed);
+	void ApplyEnvironEffects();
+	void ShowMap(bool redraw = true);
+	void Walk();
+	void Generate(int size, unsigned int seed);
+	std::vector<Character*> CharactersInRange(const Character* character) const;
+	void RebuildCharacterTree();
+	std::vector<Character*> NearestHostiles(const Character* character, int k);
 	void Fight();
 
 	static void TakeCommands();
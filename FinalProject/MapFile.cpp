@@ -0,0 +1,373 @@
+#include "MapFile.h"
+#include "Tile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+	const char MAP_FILE_MAGIC[4] = { 'J', 'T', 'M', 'P' };
+	const uint32_t MAP_FILE_LAYERS = 3;
+
+	uint64_t AlignUp(uint64_t value)
+	{
+		return (value + MAP_FILE_ALIGNMENT - 1) & ~static_cast<uint64_t>(MAP_FILE_ALIGNMENT - 1);
+	}
+
+	/**
+	 * @brief Checks that a stored point is unset or a tile of the map.
+	*/
+	bool PointFits(MapFilePoint point, int32_t rows, int32_t cols)
+	{
+		return (point.x == -1 && point.y == -1)
+			|| (point.x >= 0 && point.x < rows && point.y >= 0 && point.y < cols);
+	}
+
+	/**
+	 * @brief Checks that a known layer is stored the way its readers use it. Unknown layers
+	 * are skipped by every reader, so any kind is accepted for them.
+	*/
+	bool KindFits(const MapFileLayer& layer)
+	{
+		switch (layer.id)
+		{
+		case MAP_LAYER_FLAGS:
+			return layer.bytesPerTile == 1 && layer.bitsPerCode == 0;
+		case MAP_LAYER_TERRAIN:
+			return layer.bytesPerTile == 0 && layer.bitsPerCode != 0;
+		case MAP_LAYER_TERRAIN_PALETTE:
+			return layer.bytesPerTile == 0 && layer.bitsPerCode == 0;
+		default:
+			return true;
+		}
+	}
+}
+
+MapFile::MapFile(const string& path)
+{
+	_path = path;
+	_base = nullptr;
+	_length = 0;
+	_header = nullptr;
+	_layers = nullptr;
+	_fileHandle = nullptr;
+	_mappingHandle = nullptr;
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		throw runtime_error("Unable to open map file " + path);
+	}
+
+	LARGE_INTEGER size;
+	GetFileSizeEx(file, &size);
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		CloseHandle(file);
+		throw runtime_error("Unable to map map file " + path);
+	}
+
+	_fileHandle = file;
+	_mappingHandle = mapping;
+	_length = static_cast<size_t>(size.QuadPart);
+	_base = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+	if (_base == nullptr)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+		throw runtime_error("Unable to map map file " + path);
+	}
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		throw runtime_error("Unable to open map file " + path);
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		throw runtime_error("Unable to read map file " + path);
+	}
+
+	_length = static_cast<size_t>(info.st_size);
+	void* view = mmap(nullptr, _length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (view == MAP_FAILED)
+	{
+		throw runtime_error("Unable to map map file " + path);
+	}
+	_base = static_cast<unsigned char*>(view);
+#endif
+
+	_header = reinterpret_cast<MapFileHeader*>(_base);
+	bool valid = _length >= sizeof(MapFileHeader)
+		&& memcmp(_header->magic, MAP_FILE_MAGIC, sizeof(MAP_FILE_MAGIC)) == 0
+		&& _header->version == MAP_FILE_VERSION
+		&& _header->headerSize == sizeof(MapFileHeader)
+		&& _header->rows > 0 && _header->cols > 0
+		&& _header->layerTableOffset % alignof(MapFileLayer) == 0
+		&& _header->layerTableOffset + static_cast<uint64_t>(_header->layerCount) * sizeof(MapFileLayer) <= _length
+		&& PointFits(_header->entry, _header->rows, _header->cols);
+	for (int i = 0; i < MAP_FILE_EXITS && valid; i++)
+	{
+		valid = PointFits(_header->exits[i], _header->rows, _header->cols);
+	}
+
+	if (valid)
+	{
+		_layers = reinterpret_cast<MapFileLayer*>(_base + _header->layerTableOffset);
+		for (uint32_t i = 0; i < _header->layerCount && valid; i++)
+		{
+			const MapFileLayer& layer = _layers[i];
+			const uint64_t tiles = static_cast<uint64_t>(_header->rows) * _header->cols;
+			// the size is compared against the room left after the offset, so the sum cannot wrap
+			valid = KindFits(layer) && layer.offset % MAP_FILE_ALIGNMENT == 0
+				&& layer.offset <= _length && layer.size <= _length - layer.offset;
+			if (layer.bytesPerTile != 0)
+			{
+				valid = valid && layer.bitsPerCode == 0
+					&& layer.size % layer.bytesPerTile == 0 && layer.size / layer.bytesPerTile == tiles;
+			}
+			else if (layer.bitsPerCode != 0)
+			{
+				// codes never straddle words, so a word holds 64 / bitsPerCode of them, none when wider
+				const uint64_t perWord = 64 / layer.bitsPerCode;
+				valid = valid && perWord != 0 && (layer.bitsPerCode & (layer.bitsPerCode - 1)) == 0
+					&& layer.size == (tiles + perWord - 1) / perWord * sizeof(uint64_t);
+			}
+		}
+	}
+
+	if (!valid)
+	{
+		Release();
+		throw runtime_error("Invalid or unsupported map file " + path);
+	}
+}
+
+MapFile::~MapFile()
+{
+	Release();
+}
+
+void MapFile::Release()
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
+	if (_base != nullptr)
+	{
+		UnmapViewOfFile(_base);
+	}
+	if (_mappingHandle != nullptr)
+	{
+		CloseHandle(static_cast<HANDLE>(_mappingHandle));
+	}
+	if (_fileHandle != nullptr)
+	{
+		CloseHandle(static_cast<HANDLE>(_fileHandle));
+	}
+#else
+	if (_base != nullptr)
+	{
+		munmap(_base, _length);
+	}
+#endif
+	_base = nullptr;
+	_mappingHandle = nullptr;
+	_fileHandle = nullptr;
+}
+
+int MapFile::GetRows() const
+{
+	return _header->rows;
+}
+
+int MapFile::GetCols() const
+{
+	return _header->cols;
+}
+
+unsigned char* MapFile::GetLayer(uint32_t id) const
+{
+	const MapFileLayer* layer = GetLayerInfo(id);
+	return (layer == nullptr) ? nullptr : _base + layer->offset;
+}
+
+const MapFileLayer* MapFile::GetLayerInfo(uint32_t id) const
+{
+	for (uint32_t i = 0; i < _header->layerCount; i++)
+	{
+		if (_layers[i].id == id)
+		{
+			return &_layers[i];
+		}
+	}
+	return nullptr;
+}
+
+MapFilePoint MapFile::GetEntry() const
+{
+	return _header->entry;
+}
+
+MapFilePoint MapFile::GetExit(int index) const
+{
+	if (index < 0 || index >= MAP_FILE_EXITS)
+	{
+		throw out_of_range("Exit index out of range");
+	}
+	return _header->exits[index];
+}
+
+void MapFile::Save(const string& path, int rows, int cols,
+	const unsigned char* flags, const PaletteLayer<unsigned char>& terrain,
+	MapFilePoint entry, const MapFilePoint* exits)
+{
+	const uint64_t tiles = static_cast<uint64_t>(rows) * cols;
+
+	MapFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, MAP_FILE_MAGIC, sizeof(MAP_FILE_MAGIC));
+	header.version = MAP_FILE_VERSION;
+	header.headerSize = sizeof(MapFileHeader);
+	header.rows = rows;
+	header.cols = cols;
+	header.layerCount = MAP_FILE_LAYERS;
+	header.layerTableOffset = sizeof(MapFileHeader);
+	header.entry = entry;
+	for (int i = 0; i < MAP_FILE_EXITS; i++)
+	{
+		header.exits[i] = exits[i];
+	}
+
+	// the terrain goes out packed as it is held, so loading maps the codes instead of unpacking them
+	vector<unsigned char> palette(terrain.GetPaletteSize());
+	for (size_t code = 0; code < palette.size(); code++)
+	{
+		palette[code] = terrain.GetPaletteEntry(static_cast<unsigned int>(code));
+	}
+
+	MapFileLayer layers[MAP_FILE_LAYERS];
+	memset(layers, 0, sizeof(layers));
+	const unsigned char* data[MAP_FILE_LAYERS] = { flags, reinterpret_cast<const unsigned char*>(terrain.GetWords()), palette.data() };
+	layers[0].id = MAP_LAYER_FLAGS;
+	layers[0].bytesPerTile = 1;
+	layers[0].size = tiles;
+	layers[1].id = MAP_LAYER_TERRAIN;
+	layers[1].bitsPerCode = static_cast<uint32_t>(terrain.GetBits());
+	layers[1].size = terrain.GetWordCount() * sizeof(uint64_t);
+	layers[2].id = MAP_LAYER_TERRAIN_PALETTE;
+	layers[2].size = palette.size();
+	uint64_t offset = AlignUp(sizeof(MapFileHeader) + sizeof(layers));
+	for (uint32_t i = 0; i < MAP_FILE_LAYERS; i++)
+	{
+		layers[i].offset = offset;
+		offset = AlignUp(offset + layers[i].size);
+	}
+
+	ofstream out(path, ios::binary | ios::trunc);
+	if (!out)
+	{
+		throw runtime_error("Unable to write map file " + path);
+	}
+
+	const char padding[MAP_FILE_ALIGNMENT] = {};
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(layers), sizeof(layers));
+	uint64_t written = sizeof(header) + sizeof(layers);
+	for (uint32_t i = 0; i < MAP_FILE_LAYERS; i++)
+	{
+		out.write(padding, static_cast<streamsize>(layers[i].offset - written));
+		out.write(reinterpret_cast<const char*>(data[i]), static_cast<streamsize>(layers[i].size));
+		written = layers[i].offset + layers[i].size;
+	}
+
+	if (!out)
+	{
+		throw runtime_error("Unable to write map file " + path);
+	}
+}
+
+void MapFile::ConvertAscii(const string& textPath, const string& mapPath)
+{
+	ifstream in(textPath);
+	if (!in)
+	{
+		throw runtime_error("Unable to open ASCII map " + textPath);
+	}
+
+	vector<string> lines;
+	string line;
+	size_t cols = 0;
+	while (getline(in, line))
+	{
+		if (!line.empty() && line.back() == '\r')
+		{
+			line.pop_back();
+		}
+		cols = (line.size() > cols) ? line.size() : cols;
+		lines.push_back(line);
+	}
+
+	if (lines.empty() || cols == 0)
+	{
+		throw runtime_error("ASCII map " + textPath + " is empty");
+	}
+
+	const int rows = static_cast<int>(lines.size());
+	vector<unsigned char> flags(static_cast<size_t>(rows) * cols, TILE_NONE);
+	vector<unsigned char> terrain(static_cast<size_t>(rows) * cols, 0);
+	MapFilePoint entry = { -1, -1 };
+	MapFilePoint exits[MAP_FILE_EXITS] = { { -1, -1 }, { -1, -1 }, { -1, -1 } };
+	int exitCount = 0;
+
+	for (int i = 0; i < rows; i++)
+	{
+		for (size_t j = 0; j < lines[i].size(); j++)
+		{
+			const char symbol = lines[i][j];
+			const size_t index = i * cols + j;
+
+			if (symbol == '=' || symbol == '|' || symbol == '#')
+			{
+				flags[index] = TILE_OPAQUE;
+				continue;
+			}
+
+			flags[index] = TILE_WALKABLE;
+			if (symbol >= '0' && symbol <= '9')
+			{
+				terrain[index] = static_cast<unsigned char>(symbol - '0');
+			}
+			else if (symbol == 'E')
+			{
+				entry = { i, static_cast<int32_t>(j) };
+			}
+			else if (symbol == 'X' && exitCount < MAP_FILE_EXITS)
+			{
+				exits[exitCount++] = { i, static_cast<int32_t>(j) };
+			}
+		}
+	}
+
+	PaletteLayer<unsigned char> packed(terrain.size(), 0);
+	packed.Assign(terrain.data());
+	Save(mapPath, rows, static_cast<int>(cols), flags.data(), packed, entry, exits);
+}
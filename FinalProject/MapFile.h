@@ -0,0 +1,205 @@
+#pragma once
+#include "PaletteLayer.h"
+
+#include <cstdint>
+#include <string>
+/**
+ * @file MapFile.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the MapFile class which handles the
+ * versioned binary format used to store prebuilt maps on disk. A map file is laid out as
+ * a fixed size header, a table of layer descriptors and then the raw layer data, with every
+ * layer starting on a MAP_FILE_ALIGNMENT boundary. Opening a map file maps it into memory
+ * so the TileSpace reads its flag layer and its packed terrain codes straight from the mapped
+ * pages without parsing or unpacking; only the terrain palette, a few bytes, is copied.
+ * Pages are mapped copy-on-write so edits to a loaded map stay private to the process.
+ * Opening checks the header and the layer table, including that every known layer is stored
+ * as the kind listed below, but not the tiles in the layers.
+ *
+ * File Layout:
+ * ------------
+ * > MapFileHeader - magic, version, dimensions, entry and exit points
+ * > MapFileLayer[layerCount] - one descriptor for every layer in the file
+ * > layer data - per layer, row-major, one of:
+ *		rows * cols * bytesPerTile bytes, one value per tile (the flags)
+ *		64 bit words of bitsPerCode wide codes, as a PaletteLayer packs them (the terrain)
+ *		size bytes not tied to tiles (the terrain palette)
+ *
+ * Properties:
+ * -----------
+ * > _path: string - The path of the opened map file.
+ * > _base: unsigned char* - The start of the mapped view of the file.
+ * > _length: size_t - The number of bytes mapped.
+ * > _header: MapFileHeader* - The header at the start of the mapped view.
+ * > _layers: MapFileLayer* - The layer table inside the mapped view.
+ * > _fileHandle: void* - The native file handle (Windows only).
+ * > _mappingHandle: void* - The native mapping handle (Windows only).
+ *
+ * Methods:
+ * --------
+ * > MapFile(path: string) - Opens and maps the map file found at the path.
+ * > ~MapFile() - Unmaps the file and releases the native handles.
+ * > GetRows(), GetCols() - The dimensions of the stored map.
+ * > GetLayer(id: uint32_t): unsigned char* - The mapped data of a layer, nullptr if absent.
+ * > GetLayerInfo(id: uint32_t): const MapFileLayer* - The descriptor of a layer, nullptr if absent.
+ * > GetEntry(), GetExit(index: int) - The entry and exit metadata of the map.
+ * > Save(...) - Writes map layers out in the binary format.
+ * > ConvertAscii(textPath: string, mapPath: string) - Converts an ASCII map into the binary format.
+ */
+
+const uint32_t MAP_FILE_VERSION = 2;
+const uint32_t MAP_FILE_ALIGNMENT = 64;
+const int MAP_FILE_EXITS = 3;
+
+/**
+ * @brief Identifiers of the layers that can be stored in a map file.
+*/
+enum MapLayerId : uint32_t
+{
+	MAP_LAYER_FLAGS = 1,
+	MAP_LAYER_TERRAIN = 2,
+	MAP_LAYER_TERRAIN_PALETTE = 3
+};
+
+/**
+ * @brief A tile coordinate as stored on disk, x is the row and y is the column
+ * just like the Location class. A coordinate of (-1, -1) marks an unset point.
+*/
+struct MapFilePoint
+{
+	int32_t x;
+	int32_t y;
+};
+
+/**
+ * @brief The header found at the start of every map file (64 bytes).
+*/
+struct MapFileHeader
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t headerSize;
+	int32_t rows;
+	int32_t cols;
+	uint32_t layerCount;
+	uint32_t layerTableOffset;
+	uint32_t reserved;
+	MapFilePoint entry;
+	MapFilePoint exits[MAP_FILE_EXITS];
+};
+
+/**
+ * @brief The descriptor of a single layer in the layer table (32 bytes). Layers of one value
+ * per tile set bytesPerTile, packed layers set bitsPerCode instead, and tables not tied to
+ * tiles set neither.
+*/
+struct MapFileLayer
+{
+	uint32_t id;
+	uint32_t bytesPerTile;
+	uint64_t offset;
+	uint64_t size;
+	uint32_t bitsPerCode;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(MapFileHeader) == 64, "MapFileHeader must stay 64 bytes");
+static_assert(sizeof(MapFileLayer) == 32, "MapFileLayer must stay 32 bytes");
+
+class MapFile
+{
+private:
+	std::string _path;
+	unsigned char* _base;
+	size_t _length;
+	MapFileHeader* _header;
+	MapFileLayer* _layers;
+	void* _fileHandle;
+	void* _mappingHandle;
+
+	/**
+	 * @brief Unmaps the view and closes the native handles.
+	*/
+	void Release();
+
+public:
+	/**
+	 * @brief Opens the map file and maps it into memory. Throws a runtime_error if the
+	 * file cannot be mapped or is not a valid map file of a supported version.
+	 * @param path - the path of the map file.
+	*/
+	explicit MapFile(const std::string& path);
+
+	/**
+	 * @brief The destructor unmaps the file.
+	*/
+	~MapFile();
+
+	MapFile(const MapFile& other) = delete;
+	MapFile& operator=(const MapFile& other) = delete;
+
+	/**
+	 * @brief Getter for the number of rows in the stored map.
+	 * @return an integer representing the number of rows.
+	*/
+	int GetRows() const;
+
+	/**
+	 * @brief Getter for the number of columns in the stored map.
+	 * @return an integer representing the number of columns.
+	*/
+	int GetCols() const;
+
+	/**
+	 * @brief Getter for the mapped data of a layer.
+	 * @param id - the identifier of the layer.
+	 * @return a pointer to the first byte of the layer or nullptr when the layer is missing.
+	*/
+	unsigned char* GetLayer(uint32_t id) const;
+
+	/**
+	 * @brief Getter for the descriptor of a layer.
+	 * @param id - the identifier of the layer.
+	 * @return a pointer to the descriptor in the layer table or nullptr when the layer is missing.
+	*/
+	const MapFileLayer* GetLayerInfo(uint32_t id) const;
+
+	/**
+	 * @brief Getter for the entry point of the map.
+	 * @return the stored entry point.
+	*/
+	MapFilePoint GetEntry() const;
+
+	/**
+	 * @brief Getter for one of the exit points of the map.
+	 * @param index - the index of the exit, between 0 and MAP_FILE_EXITS - 1.
+	 * @return the stored exit point.
+	*/
+	MapFilePoint GetExit(int index) const;
+
+	/**
+	 * @brief Writes map layers into a binary map file. Throws a runtime_error if the file
+	 * cannot be written.
+	 * @param path - the path to write to.
+	 * @param rows - the number of rows in the map.
+	 * @param cols - the number of columns in the map.
+	 * @param flags - rows * cols bytes of TileFlags.
+	 * @param terrain - the Environ indices, written packed with their palette.
+	 * @param entry - the entry point of the map.
+	 * @param exits - the MAP_FILE_EXITS exit points of the map.
+	*/
+	static void Save(const std::string& path, int rows, int cols,
+		const unsigned char* flags, const PaletteLayer<unsigned char>& terrain,
+		MapFilePoint entry, const MapFilePoint* exits);
+
+	/**
+	 * @brief Converts an ASCII drawn map into the binary map format. Every line of the text file
+	 * is a row of the map. '=', '|' and '#' are walls, 'E' is the entry, 'X' marks up to three
+	 * exits, the digits '0' to '9' are walkable tiles on that Environ index and any other
+	 * character is plain walkable ground.
+	 * @param textPath - the path of the ASCII map.
+	 * @param mapPath - the path of the binary map to write.
+	*/
+	static void ConvertAscii(const std::string& textPath, const std::string& mapPath);
+};
@@ -0,0 +1,269 @@
+#include "MapGenerator.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+namespace
+{
+	// salts keeping the wall, elevation and moisture layers independent for one seed
+	const unsigned int SALT_WALLS = 0x9e3779b9u;
+	const unsigned int SALT_ELEVATION = 0x85ebca6bu;
+	const unsigned int SALT_MOISTURE = 0xc2b2ae35u;
+
+	const int NOISE_OCTAVES = 3;
+	const int CORNER_CLEARING = 2;
+
+	// elevation bands from the lowest up, moisture splits the bands into wet and dry Environs
+	const float WATER_LEVEL = 0.36f;
+	const float SHORE_LEVEL = 0.40f;
+	const float HIGHLAND_LEVEL = 0.60f;
+	const float PEAK_LEVEL = 0.68f;
+	const float WET = 0.5f;
+	const float ARID = 0.35f;
+
+	float SmoothStep(float t)
+	{
+		return t * t * (3.0f - 2.0f * t);
+	}
+
+	unsigned char EnvironAt(float elevation, float moisture)
+	{
+		if (elevation < WATER_LEVEL)
+		{
+			return ENVIRON_WATER;
+		}
+		if (elevation < SHORE_LEVEL)
+		{
+			return ENVIRON_SAND;
+		}
+		if (elevation < HIGHLAND_LEVEL)
+		{
+			return (moisture >= WET) ? ENVIRON_GRASS : ENVIRON_DIRT;
+		}
+		if (elevation < PEAK_LEVEL)
+		{
+			return (moisture < ARID) ? ENVIRON_LAVA : ENVIRON_ROCK;
+		}
+		return (moisture >= WET) ? ENVIRON_SNOW : ENVIRON_ICE;
+	}
+}
+
+const int MapGenerator::MAPGEN_PARALLEL_ROWS;
+
+MapGenerator::MapGenerator(unsigned int seed, int threads)
+{
+	_seed = seed;
+	_scale = 48;
+	_wallPercent = 45;
+	_smoothing = 4;
+	SetThreads(threads);
+}
+
+unsigned int MapGenerator::Hash(unsigned int seed, int x, int y)
+{
+	unsigned int h = seed ^ (static_cast<unsigned int>(x) * 0x27d4eb2du);
+	h ^= h >> 15;
+	h *= 0x2c1b3c6du;
+	h ^= static_cast<unsigned int>(y) * 0x165667b1u;
+	h ^= h >> 16;
+	h *= 0x7feb352du;
+	h ^= h >> 15;
+	h *= 0x846ca68bu;
+	h ^= h >> 16;
+	return h;
+}
+
+void MapGenerator::NoiseRow(unsigned int salt, int row, int cols, vector<float>& values) const
+{
+	const unsigned int seed = _seed ^ salt;
+	values.assign(cols, 0.0f);
+	float amplitude = 1.0f;
+	float weight = 0.0f;
+	int cell = _scale;
+
+	for (int octave = 0; octave < NOISE_OCTAVES && cell >= 2; octave++)
+	{
+		const unsigned int octaveSeed = seed + static_cast<unsigned int>(octave) * SALT_WALLS;
+		auto lattice = [&](int r, int c)
+		{
+			return static_cast<float>(Hash(octaveSeed, r, c) >> 8) * (1.0f / 16777216.0f);
+		};
+
+		// the row sits between two lattice rows, the four corners only change every cell columns
+		const int latticeRow = row / cell;
+		const float u = SmoothStep(static_cast<float>(row - latticeRow * cell) / cell);
+		for (int first = 0; first < cols; first += cell)
+		{
+			const int latticeCol = first / cell;
+			const float left = lattice(latticeRow, latticeCol) * (1.0f - u) + lattice(latticeRow + 1, latticeCol) * u;
+			const float right = lattice(latticeRow, latticeCol + 1) * (1.0f - u) + lattice(latticeRow + 1, latticeCol + 1) * u;
+			const int last = min(first + cell, cols);
+			for (int col = first; col < last; col++)
+			{
+				const float v = SmoothStep(static_cast<float>(col - first) / cell);
+				values[col] += (left * (1.0f - v) + right * v) * amplitude;
+			}
+		}
+		weight += amplitude;
+		amplitude *= 0.5f;
+		cell /= 2;
+	}
+
+	if (weight > 0.0f)
+	{
+		for (float& value : values)
+		{
+			value /= weight;
+		}
+	}
+}
+
+void MapGenerator::ForEachStrip(int rows, const function<void(int, int)>& work) const
+{
+	const int workers = max(1, min(_threads, rows / MAPGEN_PARALLEL_ROWS));
+	auto strip = [&](int worker)
+	{
+		work(static_cast<int>(static_cast<long long>(rows) * worker / workers),
+			static_cast<int>(static_cast<long long>(rows) * (worker + 1) / workers));
+	};
+
+	vector<thread> threads;
+	for (int w = 1; w < workers; w++)
+	{
+		threads.emplace_back(strip, w);
+	}
+	strip(0);
+	for (auto& worker : threads)
+	{
+		worker.join();
+	}
+}
+
+TileSpace<Tile*>* MapGenerator::Generate(int rows, int cols)
+{
+	TileSpace<Tile*>* space = new TileSpace<Tile*>(rows, cols);
+	Fill(space);
+	return space;
+}
+
+void MapGenerator::Fill(TileSpace<Tile*>* space)
+{
+	const int rows = space->GetRows();
+	const int cols = space->GetCols();
+
+	// the wall layers carry a border of walls so the automaton never checks bounds
+	const int stride = cols + 2;
+	_walls.assign(static_cast<size_t>(rows + 2) * stride, 1);
+	_buffer.assign(_walls.size(), 1);
+
+	const unsigned int threshold = static_cast<unsigned int>(_wallPercent);
+	ForEachStrip(rows, [&](int firstRow, int lastRow)
+	{
+		for (int row = firstRow; row < lastRow; row++)
+		{
+			unsigned char* walls = &_walls[static_cast<size_t>(row + 1) * stride + 1];
+			for (int col = 0; col < cols; col++)
+			{
+				walls[col] = (Hash(_seed ^ SALT_WALLS, row, col) % 100 < threshold) ? 1 : 0;
+			}
+		}
+	});
+
+	for (int step = 0; step < _smoothing; step++)
+	{
+		ForEachStrip(rows, [&](int firstRow, int lastRow)
+		{
+			for (int row = firstRow; row < lastRow; row++)
+			{
+				const unsigned char* above = &_walls[static_cast<size_t>(row) * stride + 1];
+				const unsigned char* middle = above + stride;
+				const unsigned char* below = middle + stride;
+				unsigned char* next = &_buffer[static_cast<size_t>(row + 1) * stride + 1];
+				for (int col = 0; col < cols; col++)
+				{
+					const int count = above[col - 1] + above[col] + above[col + 1]
+						+ middle[col - 1] + middle[col] + middle[col + 1]
+						+ below[col - 1] + below[col] + below[col + 1];
+					next[col] = (count >= 5) ? 1 : 0;
+				}
+			}
+		});
+		_walls.swap(_buffer);
+	}
+
+	// the terrain is packed into shared words, so the strips write it unpacked into the spare
+	// automaton buffer and the TileSpace packs it in one pass afterwards
+	unsigned char* terrain = _buffer.data();
+	ForEachStrip(rows, [&](int firstRow, int lastRow)
+	{
+		vector<float> elevation, moisture;
+		for (int row = firstRow; row < lastRow; row++)
+		{
+			NoiseRow(SALT_ELEVATION, row, cols, elevation);
+			NoiseRow(SALT_MOISTURE, row, cols, moisture);
+			const unsigned char* walls = &_walls[static_cast<size_t>(row + 1) * stride + 1];
+			for (int col = 0; col < cols; col++)
+			{
+				const bool corner = (row < CORNER_CLEARING || row >= rows - CORNER_CLEARING)
+					&& (col < CORNER_CLEARING || col >= cols - CORNER_CLEARING);
+				space->SetFlags(row, col, (walls[col] != 0 && !corner) ? TILE_OPAQUE : TILE_WALKABLE);
+				terrain[static_cast<size_t>(row) * cols + col] = EnvironAt(elevation[col], moisture[col]);
+			}
+		}
+	});
+	space->LoadTerrain(terrain);
+}
+
+void MapGenerator::SetSeed(unsigned int seed)
+{
+	_seed = seed;
+}
+
+unsigned int MapGenerator::GetSeed() const
+{
+	return _seed;
+}
+
+void MapGenerator::SetScale(int scale)
+{
+	if (scale < 2)
+	{
+		throw out_of_range("Noise scale must be at least 2 tiles");
+	}
+	_scale = scale;
+}
+
+void MapGenerator::SetWallPercent(int percent)
+{
+	if (percent < 0 || percent > 100)
+	{
+		throw out_of_range("Wall percent must be between 0 and 100");
+	}
+	_wallPercent = percent;
+}
+
+void MapGenerator::SetSmoothing(int steps)
+{
+	if (steps < 0)
+	{
+		throw out_of_range("Smoothing steps must not be negative");
+	}
+	_smoothing = steps;
+}
+
+void MapGenerator::SetThreads(int threads)
+{
+	if (threads <= 0)
+	{
+		threads = static_cast<int>(thread::hardware_concurrency());
+	}
+	_threads = max(threads, 1);
+}
+
+int MapGenerator::GetThreads() const
+{
+	return _threads;
+}
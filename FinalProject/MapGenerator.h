@@ -0,0 +1,165 @@
+#pragma once
+#include "TileSpace.h"
+
+#include <functional>
+#include <vector>
+/**
+ * @file MapGenerator.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the MapGenerator class which builds
+ * TileSpaces of any size from a seed. Walls start as seeded random noise and are smoothed
+ * into caves by a cellular automaton: a tile becomes a wall when at least five of the nine
+ * tiles around it, itself included, are walls, with the outside of the map counting as wall.
+ * The Environ of every tile comes from two layers of seeded fractal value noise, elevation
+ * and moisture, so grass, water, sand, rock, lava, snow and ice form regions instead of
+ * speckles. The corners hold the entry point and exits and are always cleared.
+ *
+ * Every random value is a hash of the seed and the coordinates of the tile rather than a
+ * draw from a shared generator, and every automaton step reads only the previous step. So
+ * the rows can be split into strips, one per thread, and the map is identical for the same
+ * seed no matter how many threads run.
+ *
+ * Walls are written as TILE_OPAQUE without TILE_WALKABLE, everything else as TILE_WALKABLE.
+ * TILE_HAZARD is left to the Map, which knows which environs are hazardous.
+ *
+ * Properties:
+ * -----------
+ * > _seed: unsigned int - The seed of the map.
+ * > _threads: int - The number of threads used by Generate().
+ * > _scale: int - The size in tiles of the largest noise features.
+ * > _wallPercent: int - The share of tiles seeded as walls before smoothing.
+ * > _smoothing: int - The number of cellular automaton steps.
+ * > _walls, _buffer: vector<unsigned char> - The wall layers of the automaton, with a one tile border.
+ *		Once smoothing is done the buffer holds the unpacked terrain.
+ *
+ * Methods:
+ * --------
+ * > MapGenerator(seed: unsigned int, threads: int) - Creates a generator with the default settings.
+ * > Generate(rows: int, cols: int): TileSpace<Tile*>* - Creates and fills a new TileSpace.
+ * > Fill(space: TileSpace<Tile*>*) - Overwrites the layers of an existing TileSpace.
+ * > SetSeed(seed), GetSeed() - The seed of the map.
+ * > SetScale(scale), SetWallPercent(percent), SetSmoothing(steps) - The shape of the map.
+ * > SetThreads(threads), GetThreads() - The number of threads used by Generate().
+ */
+class MapGenerator
+{
+public:
+	static const int MAPGEN_PARALLEL_ROWS = 64;
+
+private:
+	unsigned int _seed;
+	int _threads;
+	int _scale;
+	int _wallPercent;
+	int _smoothing;
+	std::vector<unsigned char> _walls;
+	std::vector<unsigned char> _buffer;
+
+	/**
+	 * @brief Mixes the seed and a pair of coordinates into 32 well spread bits.
+	*/
+	static unsigned int Hash(unsigned int seed, int x, int y);
+
+	/**
+	 * @brief Seeded fractal value noise along a row of tiles, smoothly interpolated between
+	 * lattice points, so each lattice point is hashed once per row rather than once per tile.
+	 * @param values - receives a value in [0, 1) for every column.
+	*/
+	void NoiseRow(unsigned int salt, int row, int cols, std::vector<float>& values) const;
+
+	/**
+	 * @brief Runs work over strips of rows, one strip per thread, and waits for all of them.
+	 * @param work - called with the first row and one past the last row of a strip.
+	*/
+	void ForEachStrip(int rows, const std::function<void(int, int)>& work) const;
+
+public:
+	/**
+	 * @brief Creates a generator with the default settings.
+	 * @param seed - the seed of the maps to generate.
+	 * @param threads - the number of threads to use, 0 to use every hardware thread.
+	*/
+	explicit MapGenerator(unsigned int seed, int threads = 0);
+
+	/**
+	 * @brief Creates a layer-only TileSpace and fills it.
+	 * @param rows - the number of rows.
+	 * @param cols - the number of columns.
+	 * @return a pointer to the new TileSpace, owned by the caller.
+	*/
+	TileSpace<Tile*>* Generate(int rows, int cols);
+
+	/**
+	 * @brief Overwrites the flag and terrain layers of a TileSpace with a generated map.
+	 * @param space - the TileSpace to fill.
+	*/
+	void Fill(TileSpace<Tile*>* space);
+
+	/**
+	 * @brief Setter for the seed.
+	 * @param seed - the desired seed.
+	*/
+	void SetSeed(unsigned int seed);
+
+	/**
+	 * @brief Getter for the seed.
+	 * @return the seed of the maps generated.
+	*/
+	unsigned int GetSeed() const;
+
+	/**
+	 * @brief Setter for the size of the largest Environ regions.
+	 * @param scale - the desired size in tiles, at least 2.
+	*/
+	void SetScale(int scale);
+
+	/**
+	 * @brief Setter for the share of tiles seeded as walls. Around 45 gives caves, lower gives open ground.
+	 * @param percent - the desired share, from 0 to 100.
+	*/
+	void SetWallPercent(int percent);
+
+	/**
+	 * @brief Setter for the number of smoothing steps.
+	 * @param steps - the desired number of cellular automaton steps, 0 to keep the raw noise.
+	*/
+	void SetSmoothing(int steps);
+
+	/**
+	 * @brief Setter for the number of threads used by Generate().
+	 * @param threads - the desired number of threads, 0 to use every hardware thread.
+	*/
+	void SetThreads(int threads);
+
+	/**
+	 * @brief Getter for the number of threads used by Generate().
+	 * @return an integer representing the number of threads.
+	*/
+	int GetThreads() const;
+};
+
+/**
+ * MapEnviron enum
+ *
+ * @brief The Environ indices the MapGenerator writes to the terrain layer, in the order the
+ * Map creates its environs.
+ *
+ * Values:
+ * ENVIRON_GRASS, ENVIRON_DIRT - Lowland, wet and dry.
+ * ENVIRON_WATER, ENVIRON_SAND - Lakes and their shores.
+ * ENVIRON_ROCK, ENVIRON_LAVA - Highland, with lava in its driest parts.
+ * ENVIRON_SNOW, ENVIRON_ICE - Peaks, wet and dry.
+*/
+enum MapEnviron : unsigned char
+{
+	ENVIRON_GRASS = 0,
+	ENVIRON_DIRT = 1,
+	ENVIRON_WATER = 2,
+	ENVIRON_ROCK = 3,
+	ENVIRON_SAND = 4,
+	ENVIRON_SNOW = 5,
+	ENVIRON_ICE = 6,
+	ENVIRON_LAVA = 7,
+	ENVIRON_COUNT = 8
+};
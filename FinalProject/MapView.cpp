@@ -0,0 +1,226 @@
+#include "MapView.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+namespace
+{
+	int Wrap(int value, int size)
+	{
+		value %= size;
+		return (value < 0) ? value + size : value;
+	}
+}
+
+const int MapView::VIEW_DEFAULT_ROWS;
+const int MapView::VIEW_DEFAULT_COLS;
+
+MapView::MapView(const TileSpace<Tile*>* space, int viewRows, int viewCols)
+{
+	_space = space;
+	_viewRows = max(min(viewRows, space->GetRows()), 0);
+	_viewCols = max(min(viewCols, space->GetCols()), 0);
+	_top = 0;
+	_left = 0;
+	_glyphs.assign(static_cast<size_t>(_viewRows) * _viewCols, ' ');
+	_attributes.assign(_glyphs.size(), FRAME_PLAIN);
+	_ringRow = 0;
+	_ringCol = 0;
+	_valid = false;
+	_renderedTiles = 0;
+
+	const Tile* exits[] = { space->GetExitOne(), space->GetExitTwo(), space->GetExitThree() };
+	for (const Tile* exit : exits)
+	{
+		if (exit != nullptr)
+		{
+			_markers.push_back({ exit->GetPosition()->x, exit->GetPosition()->y, 'X', FRAME_YELLOW });
+		}
+	}
+	if (space->GetEntryPoint() != nullptr)
+	{
+		_markers.push_back({ space->GetEntryPoint()->GetPosition()->x, space->GetEntryPoint()->GetPosition()->y, 'E', FRAME_GREEN });
+	}
+}
+
+void MapView::RenderTile(int viewRow, int viewCol)
+{
+	const int row = _top + viewRow;
+	const int col = _left + viewCol;
+	const size_t index = static_cast<size_t>(Wrap(_ringRow + viewRow, _viewRows)) * _viewCols + Wrap(_ringCol + viewCol, _viewCols);
+
+	// walls '|', hazards '^' and floor '_', as in the ASCII maps
+	const unsigned char flags = _space->GetFlags(row, col);
+	char glyph = '_';
+	unsigned char attribute = FRAME_PLAIN;
+	if ((flags & TILE_WALKABLE) == 0)
+	{
+		glyph = '|';
+	}
+	else if ((flags & TILE_HAZARD) != 0)
+	{
+		glyph = '^';
+		attribute = FRAME_RED;
+	}
+
+	// the last marker wins, so the entry shows when it shares a tile with an exit
+	for (const Marker& marker : _markers)
+	{
+		if (marker.row == row && marker.col == col)
+		{
+			glyph = marker.glyph;
+			attribute = marker.attribute;
+		}
+	}
+
+	_glyphs[index] = glyph;
+	_attributes[index] = attribute;
+	_renderedTiles++;
+}
+
+void MapView::RenderRows(int firstRow, int lastRow)
+{
+	for (int r = firstRow; r < lastRow; r++)
+	{
+		for (int c = 0; c < _viewCols; c++)
+		{
+			RenderTile(r, c);
+		}
+	}
+}
+
+void MapView::RenderCols(int firstCol, int lastCol)
+{
+	for (int r = 0; r < _viewRows; r++)
+	{
+		for (int c = firstCol; c < lastCol; c++)
+		{
+			RenderTile(r, c);
+		}
+	}
+}
+
+void MapView::CenterOn(int row, int col)
+{
+	ScrollTo(row - _viewRows / 2, col - _viewCols / 2);
+}
+
+void MapView::ScrollTo(int top, int left)
+{
+	top = max(min(top, _space->GetRows() - _viewRows), 0);
+	left = max(min(left, _space->GetCols() - _viewCols), 0);
+	const int rowShift = top - _top;
+	const int colShift = left - _left;
+
+	if (!_valid || abs(rowShift) >= _viewRows || abs(colShift) >= _viewCols)
+	{
+		_top = top;
+		_left = left;
+		Refresh();
+		return;
+	}
+
+	// the columns scroll first, still at the old rows, then the rows at the new columns
+	if (colShift != 0)
+	{
+		_ringCol = Wrap(_ringCol + colShift, _viewCols);
+		_left = left;
+		if (colShift > 0)
+		{
+			RenderCols(_viewCols - colShift, _viewCols);
+		}
+		else
+		{
+			RenderCols(0, -colShift);
+		}
+	}
+	if (rowShift != 0)
+	{
+		_ringRow = Wrap(_ringRow + rowShift, _viewRows);
+		_top = top;
+		if (rowShift > 0)
+		{
+			RenderRows(_viewRows - rowShift, _viewRows);
+		}
+		else
+		{
+			RenderRows(0, -rowShift);
+		}
+	}
+}
+
+void MapView::TilesChanged(const vector<Location>& changed)
+{
+	if (!_valid)
+	{
+		return;
+	}
+
+	int viewRow, viewCol;
+	for (const Location& tile : changed)
+	{
+		if (ToView(tile.x, tile.y, viewRow, viewCol))
+		{
+			RenderTile(viewRow, viewCol);
+		}
+	}
+}
+
+void MapView::Refresh()
+{
+	_ringRow = 0;
+	_ringCol = 0;
+	RenderRows(0, _viewRows);
+	_valid = true;
+}
+
+void MapView::Draw(FrameRenderer& frame, int frameRow, int frameCol)
+{
+	if (!_valid)
+	{
+		Refresh();
+	}
+
+	// every cached row is the end of a viewport row followed by its start
+	for (int r = 0; r < _viewRows; r++)
+	{
+		const size_t start = static_cast<size_t>(Wrap(_ringRow + r, _viewRows)) * _viewCols;
+		const int head = _viewCols - _ringCol;
+		frame.WriteCells(frameRow + r, frameCol, &_glyphs[start + _ringCol], &_attributes[start + _ringCol], head);
+		frame.WriteCells(frameRow + r, frameCol + head, &_glyphs[start], &_attributes[start], _ringCol);
+	}
+}
+
+bool MapView::ToView(int row, int col, int& viewRow, int& viewCol) const
+{
+	viewRow = row - _top;
+	viewCol = col - _left;
+	return viewRow >= 0 && viewRow < _viewRows && viewCol >= 0 && viewCol < _viewCols;
+}
+
+int MapView::GetTop() const
+{
+	return _top;
+}
+
+int MapView::GetLeft() const
+{
+	return _left;
+}
+
+int MapView::GetViewRows() const
+{
+	return _viewRows;
+}
+
+int MapView::GetViewCols() const
+{
+	return _viewCols;
+}
+
+long long MapView::GetRenderedTiles() const
+{
+	return _renderedTiles;
+}
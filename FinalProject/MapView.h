@@ -0,0 +1,173 @@
+#pragma once
+#include "TileSpace.h"
+#include "FrameRenderer.h"
+
+#include <vector>
+/**
+ * @file MapView.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the MapView class which renders the part
+ * of a TileSpace that fits on screen, usually centred on the player. Only the tiles inside the
+ * viewport are ever turned into cells, so drawing a map of any size costs the same.
+ *
+ * The rendered cells are cached in a ring buffer the size of the viewport, wrapping in both
+ * directions. Scrolling moves the origin of the ring instead of the cells, and only the rows
+ * and columns that scrolled into view are rendered, so a player stepping one tile costs one row
+ * or one column of tiles rather than the whole viewport. Draw() copies the ring into a
+ * FrameRenderer in at most two runs per row, and the renderer then sends only the cells that
+ * changed on screen.
+ *
+ * Properties:
+ * -----------
+ * > _space: TileSpace<Tile*>* - The TileSpace being viewed.
+ * > _viewRows, _viewCols: int - The size of the viewport in tiles, never larger than the map.
+ * > _top, _left: int - The map tile shown in the top left corner of the viewport.
+ * > _glyphs, _attributes: vector - The rendered cells of the viewport, as a ring in both directions.
+ * > _ringRow, _ringCol: int - The cached row and column holding the top left corner.
+ * > _valid: bool - Whether the cache holds the current viewport.
+ * > _markers: vector<Marker> - The entry point and exits, drawn over their tiles.
+ * > _renderedTiles: long long - The number of tiles rendered so far.
+ *
+ * Methods:
+ * --------
+ * > MapView(space, viewRows, viewCols) - Creates a viewport in the top left corner of a map.
+ * > CenterOn(row, col) - Scrolls so a tile is as close to the middle as the map edges allow.
+ * > ScrollTo(top, left) - Scrolls the top left corner to a tile, clamped to the map.
+ * > TilesChanged(changed) - Renders again the tiles in view whose flags changed.
+ * > Refresh() - Renders the whole viewport again.
+ * > Draw(frame, frameRow, frameCol) - Copies the viewport into a frame.
+ * > ToView(row, col, viewRow, viewCol): bool - Where a map tile appears in the viewport.
+ * > GetTop(), GetLeft(), GetViewRows(), GetViewCols(), GetRenderedTiles() - Viewport details.
+ */
+class MapView
+{
+public:
+	static const int VIEW_DEFAULT_ROWS = 20;
+	static const int VIEW_DEFAULT_COLS = 60;
+
+private:
+	/**
+	 * @brief A tile drawn with a glyph of its own whatever its flags.
+	*/
+	struct Marker
+	{
+		int row;
+		int col;
+		char glyph;
+		unsigned char attribute;
+	};
+
+	const TileSpace<Tile*>* _space;
+	int _viewRows;
+	int _viewCols;
+	int _top;
+	int _left;
+	std::vector<char> _glyphs;
+	std::vector<unsigned char> _attributes;
+	int _ringRow;
+	int _ringCol;
+	bool _valid;
+	std::vector<Marker> _markers;
+	long long _renderedTiles;
+
+	/**
+	 * @brief Renders the tile at a viewport position into its cached cell.
+	*/
+	void RenderTile(int viewRow, int viewCol);
+
+	/**
+	 * @brief Renders every tile of a range of viewport rows.
+	*/
+	void RenderRows(int firstRow, int lastRow);
+
+	/**
+	 * @brief Renders every tile of a range of viewport columns.
+	*/
+	void RenderCols(int firstCol, int lastCol);
+
+public:
+	/**
+	 * @brief Creates a viewport showing the top left corner of a map.
+	 * @param space - the TileSpace to view.
+	 * @param viewRows - the height of the viewport in tiles, cut down to the map.
+	 * @param viewCols - the width of the viewport in tiles, cut down to the map.
+	*/
+	MapView(const TileSpace<Tile*>* space, int viewRows = VIEW_DEFAULT_ROWS, int viewCols = VIEW_DEFAULT_COLS);
+
+	/**
+	 * @brief Scrolls so a tile sits in the middle of the viewport, or as close to it as the
+	 * edges of the map allow.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	*/
+	void CenterOn(int row, int col);
+
+	/**
+	 * @brief Scrolls the top left corner of the viewport to a tile, clamped so the viewport stays
+	 * on the map. Only the rows and columns that come into view are rendered.
+	 * @param top - the row of the tile.
+	 * @param left - the column of the tile.
+	*/
+	void ScrollTo(int top, int left);
+
+	/**
+	 * @brief Renders again the tiles in view among those whose flags changed. Tiles out of view
+	 * are rendered when they scroll in.
+	 * @param changed - the tiles that changed.
+	*/
+	void TilesChanged(const std::vector<Location>& changed);
+
+	/**
+	 * @brief Renders every tile of the viewport again.
+	*/
+	void Refresh();
+
+	/**
+	 * @brief Copies the rendered viewport into a frame.
+	 * @param frame - the frame to draw into.
+	 * @param frameRow - the frame row of the top of the viewport.
+	 * @param frameCol - the frame column of the left of the viewport.
+	*/
+	void Draw(FrameRenderer& frame, int frameRow, int frameCol);
+
+	/**
+	 * @brief Finds where a map tile appears in the viewport.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @param viewRow - receives the viewport row of the tile.
+	 * @param viewCol - receives the viewport column of the tile.
+	 * @return a boolean value indicating whether the tile is in view.
+	*/
+	bool ToView(int row, int col, int& viewRow, int& viewCol) const;
+
+	/**
+	 * @brief Getter for the top row of the viewport.
+	 * @return the map row shown at the top.
+	*/
+	int GetTop() const;
+
+	/**
+	 * @brief Getter for the left column of the viewport.
+	 * @return the map column shown on the left.
+	*/
+	int GetLeft() const;
+
+	/**
+	 * @brief Getter for the height of the viewport.
+	 * @return an integer representing the rows of tiles in view.
+	*/
+	int GetViewRows() const;
+
+	/**
+	 * @brief Getter for the width of the viewport.
+	 * @return an integer representing the columns of tiles in view.
+	*/
+	int GetViewCols() const;
+
+	/**
+	 * @brief Getter for the number of tiles rendered so far, to see what scrolling costs.
+	 * @return the number of tiles turned into cells since the view was created.
+	*/
+	long long GetRenderedTiles() const;
+};
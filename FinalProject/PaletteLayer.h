@@ -0,0 +1,500 @@
+#pragma once
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+/**
+ * @file PaletteLayer.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the PaletteLayer class, a large array of values that only
+ * take a handful of distinct values, like the Environ of every tile of a map. Each distinct
+ * value is stored once in a palette and every element holds only its code in the palette,
+ * bit-packed into 64 bit words. Codes start at PALETTE_MIN_BITS bits, sixteen elements to a
+ * word, and the layer repacks itself at twice the width whenever a value is written that no
+ * longer fits the palette, so a 16K x 16K world of up to sixteen Environs takes 128 MB.
+ *
+ * Reading an element is a shift, a mask and a palette lookup. Writing an element that is
+ * already in the palette is a masked store. Replace() renames a value in O(1) by rewriting
+ * its palette entry, so swapping every tile of one Environ for a new one touches no tiles.
+ *
+ * The words can also live outside the layer, in the pages of a mapped map file: Attach()
+ * points the layer at them without copying, and writes go straight to them until the codes
+ * have to widen or the layer is filled again, when the layer moves into words of its own.
+ * Attached codes are not checked, so the palette is padded to cover every code of the width.
+ *
+ * Properties:
+ * -----------
+ * > _size: size_t - The number of elements.
+ * > _bits: int - The width of a code, a power of two.
+ * > _perWordShift: int - The base two logarithm of the number of codes per word.
+ * > _words: vector<uint64_t> - The packed codes owned by the layer, empty while attached.
+ * > _data: uint64_t* - The packed codes in use, _words or the attached words.
+ * > _wordCount: size_t - The number of packed words in use.
+ * > _palette: vector<T> - The value of every code.
+ * > _paletteCount: size_t - The number of palette entries in use, the rest pad an attached palette.
+ * > _codes: unordered_map<T, unsigned int> - The code of every value in the palette.
+ *
+ * Methods:
+ * --------
+ * > PaletteLayer(size: size_t, initial: T) - Creates a layer with every element set to one value.
+ * > Resize(size, initial) - Changes the size, setting every element to one value.
+ * > Get(index): T, GetCode(index): unsigned int - Reads an element or its code.
+ * > Set(index, value) - Writes an element, widening the codes when the palette outgrows them.
+ * > Assign(values) - Replaces every element from an unpacked array.
+ * > Attach(size, words, bits, palette, paletteSize) - Uses packed words kept elsewhere without copying them.
+ * > Fill(value) - Sets every element to one value and shrinks back to the narrowest codes.
+ * > Replace(from, to) - Changes every element holding one value to another.
+ * > Find(value): int - The code of a value, -1 if no element ever held it.
+ * > CopyTo(out) - Writes every element out unpacked.
+ * > Size(), GetBits(), GetPaletteSize(), GetPaletteEntry(code), GetMemoryBytes() - Layout details.
+ * > GetWords(), GetWordCount() - The packed codes, for writing them out.
+ */
+template <typename T>
+class PaletteLayer
+{
+public:
+	static const int PALETTE_MIN_BITS = 4;
+	static const size_t PALETTE_SCAN_LIMIT = 16;
+	static const int PALETTE_ATTACH_MAX_BITS = 16;
+
+private:
+	size_t _size;
+	int _bits;
+	int _perWordShift;
+	std::vector<uint64_t> _words;
+	uint64_t* _data;
+	size_t _wordCount;
+	std::vector<T> _palette;
+	size_t _paletteCount;
+	std::unordered_map<T, unsigned int> _codes;
+
+	/**
+	 * @brief Sets the code width and clears the words for it.
+	*/
+	void Layout(int bits)
+	{
+		_bits = bits;
+		_perWordShift = ShiftOf(bits);
+		_words.assign((_size + (size_t(1) << _perWordShift) - 1) >> _perWordShift, 0);
+		_data = _words.data();
+		_wordCount = _words.size();
+	}
+
+	/**
+	 * @brief The base two logarithm of the number of codes of a width in a word.
+	*/
+	static int ShiftOf(int bits)
+	{
+		int shift = 0;
+		while ((64 >> shift) > bits)
+		{
+			shift++;
+		}
+		return shift;
+	}
+
+	/**
+	 * @brief Writes a code, which must fit the current width.
+	*/
+	void SetCode(size_t index, unsigned int code)
+	{
+		const int offset = static_cast<int>(index & ((size_t(1) << _perWordShift) - 1)) * _bits;
+		const uint64_t mask = ((_bits == 64) ? ~uint64_t(0) : ((uint64_t(1) << _bits) - 1)) << offset;
+		uint64_t& word = _data[index >> _perWordShift];
+		word = (word & ~mask) | ((static_cast<uint64_t>(code) << offset) & mask);
+	}
+
+	/**
+	 * @brief Repacks every code at twice the width. Each word spreads over two, so working back
+	 * from the last word never overwrites a word that is still to be read and no copy is needed.
+	*/
+	void Widen()
+	{
+		if (_bits >= 32)
+		{
+			throw std::runtime_error("Palette outgrew 32 bit codes");
+		}
+
+		// attached words cannot grow, the layer takes a copy of its own first
+		if (_data != _words.data())
+		{
+			_words.assign(_data, _data + _wordCount);
+		}
+
+		const int bits = _bits;
+		const int perWord = 64 / bits;
+		const uint64_t mask = (uint64_t(1) << bits) - 1;
+		const size_t words = _words.size();
+		_words.resize(words * 2);
+		for (size_t w = words; w-- > 0;)
+		{
+			const uint64_t word = _words[w];
+			uint64_t low = 0;
+			uint64_t high = 0;
+			for (int i = 0; i < perWord / 2; i++)
+			{
+				low |= ((word >> (i * bits)) & mask) << (i * bits * 2);
+				high |= ((word >> ((i + perWord / 2) * bits)) & mask) << (i * bits * 2);
+			}
+			_words[w * 2] = low;
+			_words[w * 2 + 1] = high;
+		}
+		_bits = bits * 2;
+		_perWordShift--;
+		_words.resize((_size + (size_t(1) << _perWordShift) - 1) >> _perWordShift);
+		_data = _words.data();
+		_wordCount = _words.size();
+	}
+
+	/**
+	 * @brief The code of a value, adding it to the palette and widening when needed.
+	*/
+	unsigned int CodeOf(const T& value)
+	{
+		// a short palette is faster to scan than to hash into
+		if (_paletteCount <= PALETTE_SCAN_LIMIT)
+		{
+			for (size_t code = 0; code < _paletteCount; code++)
+			{
+				if (_palette[code] == value)
+				{
+					return static_cast<unsigned int>(code);
+				}
+			}
+		}
+		else
+		{
+			auto found = _codes.find(value);
+			if (found != _codes.end())
+			{
+				return found->second;
+			}
+		}
+
+		const unsigned int code = static_cast<unsigned int>(_paletteCount);
+		if (code >> _bits != 0)
+		{
+			Widen();
+		}
+		// an attached palette is padded, new values take the padding codes first
+		if (code < _palette.size())
+		{
+			_palette[code] = value;
+		}
+		else
+		{
+			_palette.push_back(value);
+		}
+		_paletteCount++;
+		_codes[value] = code;
+		return code;
+	}
+
+public:
+	/**
+	 * @brief Creates a layer with every element set to one value.
+	 * @param size - the number of elements.
+	 * @param initial - the value of every element.
+	*/
+	explicit PaletteLayer(size_t size = 0, const T& initial = T())
+	{
+		Resize(size, initial);
+	}
+
+	/**
+	 * @brief Copies another layer, attached or not, into words of its own.
+	 * @param other - the layer to copy.
+	*/
+	PaletteLayer(const PaletteLayer& other)
+	{
+		*this = other;
+	}
+
+	/**
+	 * @brief Copies another layer, attached or not, into words of its own.
+	 * @param other - the layer to copy.
+	 * @return the layer.
+	*/
+	PaletteLayer& operator=(const PaletteLayer& other)
+	{
+		if (this != &other)
+		{
+			_size = other._size;
+			_bits = other._bits;
+			_perWordShift = other._perWordShift;
+			_words.assign(other._data, other._data + other._wordCount);
+			_data = _words.data();
+			_wordCount = _words.size();
+			_palette = other._palette;
+			_paletteCount = other._paletteCount;
+			_codes = other._codes;
+		}
+		return *this;
+	}
+
+	/**
+	 * @brief Changes the number of elements, setting every element to one value.
+	 * @param size - the number of elements.
+	 * @param initial - the value of every element.
+	*/
+	void Resize(size_t size, const T& initial)
+	{
+		_size = size;
+		Fill(initial);
+	}
+
+	/**
+	 * @brief Getter for an element.
+	 * @param index - the index of the element.
+	 * @return the value of the element.
+	*/
+	const T& Get(size_t index) const
+	{
+		return _palette[GetCode(index)];
+	}
+
+	/**
+	 * @brief Getter for the palette code of an element.
+	 * @param index - the index of the element.
+	 * @return the code of the element.
+	*/
+	unsigned int GetCode(size_t index) const
+	{
+		const int offset = static_cast<int>(index & ((size_t(1) << _perWordShift) - 1)) * _bits;
+		const uint64_t mask = (_bits == 64) ? ~uint64_t(0) : ((uint64_t(1) << _bits) - 1);
+		return static_cast<unsigned int>((_data[index >> _perWordShift] >> offset) & mask);
+	}
+
+	/**
+	 * @brief Setter for an element. A value new to the palette may widen every code.
+	 * @param index - the index of the element.
+	 * @param value - the desired value.
+	*/
+	void Set(size_t index, const T& value)
+	{
+		if (index >= _size)
+		{
+			throw std::out_of_range("Palette layer index out of range");
+		}
+		SetCode(index, CodeOf(value));
+	}
+
+	/**
+	 * @brief Replaces every element from an unpacked array, rebuilding the palette from the
+	 * values it holds. Runs of one value skip the palette lookup.
+	 * @param values - an array of Size() values.
+	*/
+	void Assign(const T* values)
+	{
+		if (_size == 0)
+		{
+			return;
+		}
+
+		Fill(values[0]);
+		T last = values[0];
+		unsigned int code = 0;
+		for (size_t i = 1; i < _size; i++)
+		{
+			if (!(values[i] == last))
+			{
+				last = values[i];
+				code = CodeOf(last);
+			}
+			SetCode(i, code);
+		}
+	}
+
+	/**
+	 * @brief Points the layer at packed words kept elsewhere, such as the pages of a mapped
+	 * map file, without copying them. The words must outlive the layer, or its next Fill(),
+	 * and are written in place. Words read from a file can hold any code, so the palette is
+	 * padded with its first entry to all 2 ^ bits codes and every code reads as a value. The
+	 * padding codes are handed to new values before the codes widen.
+	 * @param size - the number of elements.
+	 * @param words - the packed codes, laid out as GetWords() lays them out.
+	 * @param bits - the width of a code, a power of two from PALETTE_MIN_BITS to PALETTE_ATTACH_MAX_BITS.
+	 * @param palette - the value of every code, copied into the layer.
+	 * @param paletteSize - the number of palette entries, at least one and at most 2 ^ bits.
+	*/
+	void Attach(size_t size, uint64_t* words, int bits, const T* palette, size_t paletteSize)
+	{
+		if (bits < PALETTE_MIN_BITS || bits > PALETTE_ATTACH_MAX_BITS || (bits & (bits - 1)) != 0
+			|| paletteSize == 0 || paletteSize > (uint64_t(1) << bits))
+		{
+			throw std::runtime_error("Palette layer codes do not fit their width");
+		}
+
+		_size = size;
+		_bits = bits;
+		_perWordShift = ShiftOf(bits);
+		_words.clear();
+		_data = words;
+		_wordCount = (_size + (size_t(1) << _perWordShift) - 1) >> _perWordShift;
+		_palette.assign(palette, palette + paletteSize);
+		_codes.clear();
+		for (size_t code = 0; code < paletteSize; code++)
+		{
+			_codes.emplace(_palette[code], static_cast<unsigned int>(code));
+		}
+		_paletteCount = paletteSize;
+		_palette.resize(size_t(1) << bits, _palette[0]);
+	}
+
+	/**
+	 * @brief Sets every element to one value, dropping the palette and going back to the narrowest codes.
+	 * @param value - the desired value.
+	*/
+	void Fill(const T& value)
+	{
+		_palette.assign(1, value);
+		_paletteCount = 1;
+		_codes.clear();
+		_codes[value] = 0;
+		Layout(PALETTE_MIN_BITS);
+	}
+
+	/**
+	 * @brief Changes every element holding one value to another. Renaming to a value not yet in
+	 * the palette only rewrites the palette entry; merging into a value already in it rewrites
+	 * the codes.
+	 * @param from - the value to replace.
+	 * @param to - the value to replace it with.
+	*/
+	void Replace(const T& from, const T& to)
+	{
+		auto found = _codes.find(from);
+		if (found == _codes.end() || from == to)
+		{
+			return;
+		}
+
+		const unsigned int code = found->second;
+		auto target = _codes.find(to);
+		if (target == _codes.end())
+		{
+			_codes.erase(found);
+			_palette[code] = to;
+			_codes[to] = code;
+			return;
+		}
+
+		// the old entry stays in the palette unused, so no other code moves
+		for (size_t i = 0; i < _size; i++)
+		{
+			if (GetCode(i) == code)
+			{
+				SetCode(i, target->second);
+			}
+		}
+	}
+
+	/**
+	 * @brief Looks up the palette code of a value.
+	 * @param value - the value to look up.
+	 * @return the code of the value, -1 if it is not in the palette.
+	*/
+	int Find(const T& value) const
+	{
+		auto found = _codes.find(value);
+		return (found == _codes.end()) ? -1 : static_cast<int>(found->second);
+	}
+
+	/**
+	 * @brief Writes every element out unpacked.
+	 * @param out - an array of Size() values.
+	*/
+	void CopyTo(T* out) const
+	{
+		for (size_t i = 0; i < _size; i++)
+		{
+			out[i] = Get(i);
+		}
+	}
+
+	/**
+	 * @brief Checks whether two layers hold the same values, whatever their palettes.
+	 * @param other - the layer to compare with.
+	 * @return a boolean value indicating whether every element matches.
+	*/
+	bool operator==(const PaletteLayer& other) const
+	{
+		if (_size != other._size)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < _size; i++)
+		{
+			if (!(Get(i) == other.Get(i)))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Getter for the number of elements.
+	 * @return the number of elements.
+	*/
+	size_t Size() const
+	{
+		return _size;
+	}
+
+	/**
+	 * @brief Getter for the width of a code.
+	 * @return an integer representing the bits per element.
+	*/
+	int GetBits() const
+	{
+		return _bits;
+	}
+
+	/**
+	 * @brief Getter for the number of palette entries.
+	 * @return the number of distinct values written since the last Fill().
+	*/
+	size_t GetPaletteSize() const
+	{
+		return _paletteCount;
+	}
+
+	/**
+	 * @brief Getter for a palette entry.
+	 * @param code - the code of the entry.
+	 * @return the value of the code.
+	*/
+	const T& GetPaletteEntry(unsigned int code) const
+	{
+		return _palette.at(code);
+	}
+
+	/**
+	 * @brief Getter for the packed codes.
+	 * @return a pointer to the first of GetWordCount() words.
+	*/
+	const uint64_t* GetWords() const
+	{
+		return _data;
+	}
+
+	/**
+	 * @brief Getter for the number of packed words.
+	 * @return the number of 64 bit words holding the codes.
+	*/
+	size_t GetWordCount() const
+	{
+		return _wordCount;
+	}
+
+	/**
+	 * @brief Getter for the memory held by the packed codes.
+	 * @return the number of bytes of codes, attached or not.
+	*/
+	size_t GetMemoryBytes() const
+	{
+		return _wordCount * sizeof(uint64_t);
+	}
+};
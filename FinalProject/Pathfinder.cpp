@@ -0,0 +1,379 @@
+#include "Pathfinder.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+namespace
+{
+	const int DIRECTIONS[8][2] = {
+		{ -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 },
+		{ -1, -1 }, { -1, 1 }, { 1, -1 }, { 1, 1 }
+	};
+
+	int Sign(int value)
+	{
+		return (value > 0) - (value < 0);
+	}
+}
+
+const int Pathfinder::STRAIGHT_COST;
+const int Pathfinder::DIAGONAL_COST;
+
+Pathfinder::Pathfinder(const TileSpace<Tile*>* space)
+{
+	_space = space;
+	_flags = space->GetFlagsLayer();
+	_rows = space->GetRows();
+	_cols = space->GetCols();
+	_nodes.assign(static_cast<size_t>(_rows) * _cols, SearchNode{ 0, -1, 0, 0 });
+	_open.Reserve(_rows * _cols);
+	_generation = 0;
+	_goal = -1;
+	_expanded = 0;
+	_lastCost = -1;
+}
+
+bool Pathfinder::Walkable(int row, int col) const
+{
+	return row >= 0 && row < _rows && col >= 0 && col < _cols
+		&& (_flags[row * _cols + col] & TILE_WALKABLE) != 0;
+}
+
+int Pathfinder::Distance(int from, int to) const
+{
+	const int dRow = abs(from / _cols - to / _cols);
+	const int dCol = abs(from % _cols - to % _cols);
+	const int diagonal = min(dRow, dCol);
+	return DIAGONAL_COST * diagonal + STRAIGHT_COST * (max(dRow, dCol) - diagonal);
+}
+
+void Pathfinder::BeginQuery()
+{
+	if (++_generation == 0)
+	{
+		// the stamps wrapped around, old records could look valid again
+		for (auto& node : _nodes)
+		{
+			node.seen = 0;
+			node.closed = 0;
+		}
+		_generation = 1;
+	}
+	_open.Clear();
+	_expanded = 0;
+	_lastCost = -1;
+}
+
+void Pathfinder::Relax(int from, int to, int stepCost)
+{
+	SearchNode& node = _nodes[to];
+	if (node.closed == _generation)
+	{
+		return;
+	}
+
+	const int g = _nodes[from].g + stepCost;
+	if (node.seen != _generation || g < node.g)
+	{
+		node.seen = _generation;
+		node.g = g;
+		node.parent = from;
+		_open.Push(to, g + Distance(to, _goal));
+	}
+}
+
+void Pathfinder::ExpandAStar(int index)
+{
+	const int row = index / _cols;
+	const int col = index % _cols;
+
+	for (const auto& direction : DIRECTIONS)
+	{
+		const int nRow = row + direction[0];
+		const int nCol = col + direction[1];
+		if (!Walkable(nRow, nCol))
+		{
+			continue;
+		}
+
+		const bool diagonal = direction[0] != 0 && direction[1] != 0;
+		if (diagonal && (!Walkable(nRow, col) || !Walkable(row, nCol)))
+		{
+			continue;
+		}
+		Relax(index, nRow * _cols + nCol, diagonal ? DIAGONAL_COST : STRAIGHT_COST);
+	}
+}
+
+void Pathfinder::JumpFrom(int index, int dRow, int dCol)
+{
+	const int row = index / _cols + dRow;
+	const int col = index % _cols + dCol;
+	const int jumpPoint = (dRow != 0 && dCol != 0)
+		? JumpDiagonal(row, col, dRow, dCol)
+		: JumpStraight(row, col, dRow, dCol);
+
+	if (jumpPoint >= 0)
+	{
+		Relax(index, jumpPoint, Distance(index, jumpPoint));
+	}
+}
+
+void Pathfinder::ExpandJumpPoints(int index)
+{
+	const int row = index / _cols;
+	const int col = index % _cols;
+	const int parent = _nodes[index].parent;
+
+	if (parent < 0)
+	{
+		for (const auto& direction : DIRECTIONS)
+		{
+			const bool diagonal = direction[0] != 0 && direction[1] != 0;
+			if (!diagonal || (Walkable(row + direction[0], col) && Walkable(row, col + direction[1])))
+			{
+				JumpFrom(index, direction[0], direction[1]);
+			}
+		}
+		return;
+	}
+
+	const int dRow = Sign(row - parent / _cols);
+	const int dCol = Sign(col - parent % _cols);
+
+	if (dRow != 0 && dCol != 0)
+	{
+		const bool rowOpen = Walkable(row + dRow, col);
+		const bool colOpen = Walkable(row, col + dCol);
+		if (rowOpen)
+		{
+			JumpFrom(index, dRow, 0);
+		}
+		if (colOpen)
+		{
+			JumpFrom(index, 0, dCol);
+		}
+		if (rowOpen && colOpen)
+		{
+			JumpFrom(index, dRow, dCol);
+		}
+	}
+	else if (dRow != 0)
+	{
+		const bool aheadOpen = Walkable(row + dRow, col);
+		const bool leftOpen = Walkable(row, col - 1);
+		const bool rightOpen = Walkable(row, col + 1);
+		if (aheadOpen)
+		{
+			JumpFrom(index, dRow, 0);
+			if (leftOpen)
+			{
+				JumpFrom(index, dRow, -1);
+			}
+			if (rightOpen)
+			{
+				JumpFrom(index, dRow, 1);
+			}
+		}
+		if (leftOpen)
+		{
+			JumpFrom(index, 0, -1);
+		}
+		if (rightOpen)
+		{
+			JumpFrom(index, 0, 1);
+		}
+	}
+	else
+	{
+		const bool aheadOpen = Walkable(row, col + dCol);
+		const bool upOpen = Walkable(row - 1, col);
+		const bool downOpen = Walkable(row + 1, col);
+		if (aheadOpen)
+		{
+			JumpFrom(index, 0, dCol);
+			if (upOpen)
+			{
+				JumpFrom(index, -1, dCol);
+			}
+			if (downOpen)
+			{
+				JumpFrom(index, 1, dCol);
+			}
+		}
+		if (upOpen)
+		{
+			JumpFrom(index, -1, 0);
+		}
+		if (downOpen)
+		{
+			JumpFrom(index, 1, 0);
+		}
+	}
+}
+
+int Pathfinder::JumpStraight(int row, int col, int dRow, int dCol) const
+{
+	while (Walkable(row, col))
+	{
+		const int index = row * _cols + col;
+		if (index == _goal)
+		{
+			return index;
+		}
+
+		// a side tile that was blocked one step back but is open here is a forced neighbour
+		if (dRow != 0)
+		{
+			if ((Walkable(row, col - 1) && !Walkable(row - dRow, col - 1))
+				|| (Walkable(row, col + 1) && !Walkable(row - dRow, col + 1)))
+			{
+				return index;
+			}
+		}
+		else
+		{
+			if ((Walkable(row - 1, col) && !Walkable(row - 1, col - dCol))
+				|| (Walkable(row + 1, col) && !Walkable(row + 1, col - dCol)))
+			{
+				return index;
+			}
+		}
+
+		row += dRow;
+		col += dCol;
+	}
+	return -1;
+}
+
+int Pathfinder::JumpDiagonal(int row, int col, int dRow, int dCol) const
+{
+	while (Walkable(row, col))
+	{
+		const int index = row * _cols + col;
+		if (index == _goal
+			|| JumpStraight(row + dRow, col, dRow, 0) >= 0
+			|| JumpStraight(row, col + dCol, 0, dCol) >= 0)
+		{
+			return index;
+		}
+
+		if (!Walkable(row + dRow, col) || !Walkable(row, col + dCol))
+		{
+			return -1;
+		}
+		row += dRow;
+		col += dCol;
+	}
+	return -1;
+}
+
+void Pathfinder::BuildPath(int start, vector<Location>& path) const
+{
+	path.clear();
+	path.push_back(Location(_goal / _cols, _goal % _cols));
+
+	int current = _goal;
+	while (current != start)
+	{
+		const int parent = _nodes[current].parent;
+		const int dRow = Sign(parent / _cols - current / _cols);
+		const int dCol = Sign(parent % _cols - current % _cols);
+
+		// jump points can be several tiles apart, walk the straight or diagonal line between them
+		int row = current / _cols;
+		int col = current % _cols;
+		while (row * _cols + col != parent)
+		{
+			row += dRow;
+			col += dCol;
+			path.push_back(Location(row, col));
+		}
+		current = parent;
+	}
+
+	reverse(path.begin(), path.end());
+}
+
+bool Pathfinder::FindPath(const Location& from, const Location& to, vector<Location>& path, bool jumpPoints)
+{
+	BeginQuery();
+	path.clear();
+	if (!Walkable(from.x, from.y) || !Walkable(to.x, to.y))
+	{
+		return false;
+	}
+
+	const int start = from.x * _cols + from.y;
+	_goal = to.x * _cols + to.y;
+
+	SearchNode& first = _nodes[start];
+	first.seen = _generation;
+	first.g = 0;
+	first.parent = -1;
+	_open.Push(start, Distance(start, _goal));
+
+	while (!_open.IsEmpty())
+	{
+		const int current = _open.Pop();
+		if (current == _goal)
+		{
+			_lastCost = _nodes[current].g;
+			BuildPath(start, path);
+			return true;
+		}
+
+		_nodes[current].closed = _generation;
+		++_expanded;
+		if (jumpPoints)
+		{
+			ExpandJumpPoints(current);
+		}
+		else
+		{
+			ExpandAStar(current);
+		}
+	}
+	return false;
+}
+
+bool Pathfinder::FindExitRoute(vector<Location>& path, bool jumpPoints)
+{
+	const Tile* entry = _space->GetEntryPoint();
+	const Tile* exits[] = { _space->GetExitOne(), _space->GetExitTwo(), _space->GetExitThree() };
+	int bestCost = -1;
+
+	path.clear();
+	if (entry == nullptr)
+	{
+		return false;
+	}
+
+	for (const Tile* exit : exits)
+	{
+		if (exit == nullptr || !FindPath(*entry->GetPosition(), *exit->GetPosition(), _scratch, jumpPoints))
+		{
+			continue;
+		}
+		if (bestCost < 0 || _lastCost < bestCost)
+		{
+			bestCost = _lastCost;
+			path.swap(_scratch);
+		}
+	}
+
+	_lastCost = bestCost;
+	return bestCost >= 0;
+}
+
+int Pathfinder::GetExpanded() const
+{
+	return _expanded;
+}
+
+int Pathfinder::GetLastCost() const
+{
+	return _lastCost;
+}
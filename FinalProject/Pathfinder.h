@@ -0,0 +1,162 @@
+#pragma once
+#include "TileSpace.h"
+#include "IndexedHeap.h"
+
+#include <vector>
+/**
+ * @file Pathfinder.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the Pathfinder class which computes
+ * shortest routes between tiles of a TileSpace. Characters move to any of the eight tiles
+ * around them, straight steps cost STRAIGHT_COST, diagonal steps cost DIAGONAL_COST and a
+ * diagonal step may not cut the corner of a tile that is not walkable. Queries run either
+ * plain A* or Jump Point Search, which gives the same optimal routes on this uniform cost
+ * grid while only expanding the jump points where the route can turn.
+ *
+ * The per-tile search records live in one arena that is allocated with the Pathfinder and
+ * reset between queries by bumping a generation counter, and the open list is a reusable
+ * IndexedHeap, so a query does not allocate (apart from growing the caller's path vector).
+ *
+ * Properties:
+ * -----------
+ * > _space: TileSpace<Tile*>* - The TileSpace routes are computed on.
+ * > _flags: unsigned char* - The TileFlags layer of the TileSpace.
+ * > _rows, _cols: int - The dimensions of the TileSpace.
+ * > _nodes: vector<SearchNode> - The search arena, one record per tile.
+ * > _open: IndexedHeap<int> - The open list ordered by estimated route cost.
+ * > _generation: unsigned int - The id of the current query, stamps valid arena records.
+ * > _goal: int - The tile index of the goal of the current query.
+ * > _expanded: int - The number of tiles expanded by the last query.
+ * > _lastCost: int - The cost of the route found by the last query.
+ * > _scratch: vector<Location> - Reused route buffer for comparing exits.
+ *
+ * Methods:
+ * --------
+ * > Pathfinder(space: TileSpace<Tile*>*) - Creates a Pathfinder for a TileSpace.
+ * > FindPath(from, to, path, jumpPoints): bool - Computes a route between two tiles.
+ * > FindExitRoute(path, jumpPoints): bool - Computes the cheapest route from the entry to an exit.
+ * > GetExpanded(): int - The number of tiles expanded by the last query.
+ * > GetLastCost(): int - The cost of the route found by the last query.
+ */
+class Pathfinder
+{
+public:
+	static const int STRAIGHT_COST = 10;
+	static const int DIAGONAL_COST = 14;
+
+private:
+	/**
+	 * @brief The search record of a single tile. A record is only valid for the query whose
+	 * generation is stored in seen.
+	*/
+	struct SearchNode
+	{
+		int g;
+		int parent;
+		unsigned int seen;
+		unsigned int closed;
+	};
+
+	const TileSpace<Tile*>* _space;
+	const unsigned char* _flags;
+	int _rows;
+	int _cols;
+	std::vector<SearchNode> _nodes;
+	IndexedHeap<int> _open;
+	unsigned int _generation;
+	int _goal;
+	int _expanded;
+	int _lastCost;
+	std::vector<Location> _scratch;
+
+	/**
+	 * @brief Checks whether a tile is inside the TileSpace and walkable.
+	*/
+	bool Walkable(int row, int col) const;
+
+	/**
+	 * @brief The octile distance between two tiles, used as the A* heuristic and as the
+	 * cost of a jump between two jump points.
+	*/
+	int Distance(int from, int to) const;
+
+	/**
+	 * @brief Invalidates the arena records of the previous query and empties the open list.
+	*/
+	void BeginQuery();
+
+	/**
+	 * @brief Opens a tile, or lowers its cost, when reaching it from another tile is cheaper.
+	*/
+	void Relax(int from, int to, int stepCost);
+
+	/**
+	 * @brief Expands all eight neighbours of a tile (plain A*).
+	*/
+	void ExpandAStar(int index);
+
+	/**
+	 * @brief Expands the pruned neighbours of a tile by jumping along each of them (JPS).
+	*/
+	void ExpandJumpPoints(int index);
+
+	/**
+	 * @brief Jumps from a tile in one direction and opens the jump point that is found.
+	*/
+	void JumpFrom(int index, int dRow, int dCol);
+
+	/**
+	 * @brief Scans along a row or column for the next jump point.
+	 * @return the tile index of the jump point, -1 if the scan hits a wall.
+	*/
+	int JumpStraight(int row, int col, int dRow, int dCol) const;
+
+	/**
+	 * @brief Scans along a diagonal for the next jump point.
+	 * @return the tile index of the jump point, -1 if the scan is blocked.
+	*/
+	int JumpDiagonal(int row, int col, int dRow, int dCol) const;
+
+	/**
+	 * @brief Follows the parent links back from the goal and fills in the tiles between jump points.
+	*/
+	void BuildPath(int start, std::vector<Location>& path) const;
+
+public:
+	/**
+	 * @brief Creates a Pathfinder and its search arena for a TileSpace.
+	 * @param space - the TileSpace to compute routes on.
+	*/
+	explicit Pathfinder(const TileSpace<Tile*>* space);
+
+	/**
+	 * @brief Computes the cheapest route between two tiles.
+	 * @param from - the starting tile.
+	 * @param to - the goal tile.
+	 * @param path - receives every tile of the route, from the start to the goal inclusive.
+	 * @param jumpPoints - true to use Jump Point Search, false for plain A*.
+	 * @return a boolean value indicating whether a route exists.
+	*/
+	bool FindPath(const Location& from, const Location& to, std::vector<Location>& path, bool jumpPoints = true);
+
+	/**
+	 * @brief Computes the cheapest route from the entry point of the TileSpace to any of its exits.
+	 * @param path - receives every tile of the route.
+	 * @param jumpPoints - true to use Jump Point Search, false for plain A*.
+	 * @return a boolean value indicating whether any exit can be reached.
+	*/
+	bool FindExitRoute(std::vector<Location>& path, bool jumpPoints = true);
+
+	/**
+	 * @brief Getter for the number of tiles expanded by the last query.
+	 * @return an integer representing the number of expanded tiles.
+	*/
+	int GetExpanded() const;
+
+	/**
+	 * @brief Getter for the cost of the route found by the last query.
+	 * @return an integer representing the route cost, -1 if no route was found.
+	*/
+	int GetLastCost() const;
+};
@@ -3,70 +3,31 @@
 using namespace std;
 Player::Player()
 {
-	_name = "Default Character";
-	_health = 100;
-	_ammo = 80;
-	_backpack = new Backpack();
-	_inHand = &_backpack->GetItemBag().GetCurrentItem();
-	_loc = new Location(0, 0);
-	_attackMoves = {
-		new ActionTree(),
-		new ActionTree(),
-		new ActionTree()
-	};
-	_maxPower = 200;
+	// the backpack, location and attack moves come from the Character constructor
 	_score = 0;
 }
 
 Player::Player(string name, int health, int ammo)
 	: Character(name, health, ammo)
 {
-	_backpack = new Backpack();
-	_inHand = &_backpack->GetItemBag().GetCurrentItem();
-	_loc = new Location(0, 0);
-	_attackMoves = {
-		new ActionTree(),
-		new ActionTree(),
-		new ActionTree(),
-	};
-	_maxPower = 200;
 	_score = 0;
 }
 
 Player::Player(const Player& player)
 	: Character(player)
 {
-	_backpack = player._backpack;
-	_inHand = player._inHand;
-	_loc = player._loc;
-	_attackMoves = player._attackMoves;
-	_maxPower = player._maxPower;
 	_score = player._score;
 }
 
 Player::Player(const Character& player)
 	: Character(player)
 {
-	_backpack = new Backpack();
-	_inHand = &_backpack->GetItemBag().GetCurrentItem();
-	_loc = new Location(0, 0);
-	_attackMoves = {
-			new ActionTree(),
-			new ActionTree(),
-			new ActionTree(),
-		};
-	_maxPower = 200;
 	_score = 0;
 }
 
 Player::~Player()
 {
-	delete _backpack;
-	delete _loc;
-	for (auto& move : _attackMoves)
-	{
-		delete move;
-	}
+	// the backpack, location and attack moves are released by ~Character
 }
 
 void Player::Move(Location* loc)
@@ -76,19 +37,19 @@ void Player::Move(Location* loc)
 
 void Player::ShowStats()
 {
-	cout << "Name: " << GetName() << endl;
-	cout << "Health: " << GetHealth() << endl;
-	cout << "Ammo: " << GetAmmo() << endl;
-	cout << "Location: " << GetLocation()->x << ", " << GetLocation()->y << endl;
-	cout << "In Hand: " << GetInHand()->GetName() << endl;
-	cout << "Backpack: " << endl;
+	cout << "Name: " << GetName() << '\n';
+	cout << "Health: " << GetHealth() << '\n';
+	cout << "Ammo: " << GetAmmo() << '\n';
+	cout << "Location: " << GetLocation()->x << ", " << GetLocation()->y << '\n';
+	cout << "In Hand: " << GetInHand()->GetName() << '\n';
+	cout << "Backpack: \n";
 	GetBackpack()->Display();
-	cout << "Attack Moves: " << endl;
+	cout << "Attack Moves: \n";
 	for (int i = 0; i < static_cast<int>(_attackMoves.size()); i++)
 	{
-		cout << i << ": " << _attackMoves[i]->GetCurrent()->GetAction() << endl;
+		cout << i << ": " << _attackMoves[i]->GetCurrent()->GetAction() << '\n';
 	}
-	cout << endl;
-	cout << "Player Score: " << _score << endl;
-	cout << endl;
+	cout << '\n';
+	cout << "Player Score: " << _score << '\n';
+	cout << '\n';
 }
\ No newline at end of file
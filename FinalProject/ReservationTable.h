@@ -0,0 +1,182 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+/**
+ * @file ReservationTable.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the ReservationTable class, a space-time hash table recording
+ * which agent holds a tile at a given tick. Keys pack the tick and the tile index into 64 bits
+ * and live in a flat open addressing table with linear probing, so a lookup is a multiply, a
+ * shift and usually a single cache line. Every slot carries the generation it was written in,
+ * which lets Clear() forget every reservation in O(1) between planning batches. The table
+ * doubles its capacity whenever it becomes half full.
+ *
+ * Properties:
+ * -----------
+ * > _slots: vector<Slot> - The open addressing table, its size is a power of two.
+ * > _bits: int - The base two logarithm of the table size.
+ * > _generation: unsigned int - Slots written in an older generation are empty.
+ * > _size: int - The number of reservations in the current generation.
+ *
+ * Methods:
+ * --------
+ * > ReservationTable(capacity: int) - Creates a table able to hold capacity reservations before growing.
+ * > Reserve(tile: int, tick: int, agent: int) - Gives a tile at a tick to an agent.
+ * > Owner(tile: int, tick: int): int - The agent holding a tile at a tick, -1 if it is free.
+ * > IsFree(tile: int, tick: int, agent: int): bool - Checks whether an agent may use a tile at a tick.
+ * > Clear() - Removes every reservation in O(1).
+ * > Size(): int - The number of reservations.
+ */
+class ReservationTable
+{
+private:
+	struct Slot
+	{
+		uint64_t key;
+		int agent;
+		unsigned int stamp;
+	};
+
+	std::vector<Slot> _slots;
+	int _bits;
+	unsigned int _generation;
+	int _size;
+
+	static uint64_t Key(int tile, int tick)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(tick)) << 32) | static_cast<uint32_t>(tile);
+	}
+
+	size_t Home(uint64_t key) const
+	{
+		// Fibonacci hashing, the top bits of the product are well mixed
+		return static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> (64 - _bits));
+	}
+
+	/**
+	 * @brief Finds the slot holding a key or the empty slot where it belongs.
+	*/
+	size_t Find(uint64_t key) const
+	{
+		const size_t mask = _slots.size() - 1;
+		size_t slot = Home(key);
+		while (_slots[slot].stamp == _generation && _slots[slot].key != key)
+		{
+			slot = (slot + 1) & mask;
+		}
+		return slot;
+	}
+
+	/**
+	 * @brief Doubles the table and reinserts the reservations of the current generation.
+	*/
+	void Grow()
+	{
+		std::vector<Slot> old;
+		old.swap(_slots);
+		_slots.assign(old.size() * 2, Slot{ 0, -1, 0 });
+		++_bits;
+
+		const unsigned int live = _generation;
+		_generation = 1;
+		for (const Slot& slot : old)
+		{
+			if (slot.stamp == live)
+			{
+				Slot& target = _slots[Find(slot.key)];
+				target = slot;
+				target.stamp = _generation;
+			}
+		}
+	}
+
+public:
+	/**
+	 * @brief Creates a table able to hold a number of reservations before it grows.
+	 * @param capacity - the expected number of reservations.
+	*/
+	explicit ReservationTable(int capacity = 1024) : _bits(4), _generation(1), _size(0)
+	{
+		while ((1 << _bits) < capacity * 2)
+		{
+			++_bits;
+		}
+		_slots.assign(static_cast<size_t>(1) << _bits, Slot{ 0, -1, 0 });
+	}
+
+	/**
+	 * @brief Gives a tile at a tick to an agent, replacing any earlier holder.
+	 * @param tile - the row-major index of the tile.
+	 * @param tick - the tick the tile is held at.
+	 * @param agent - the agent holding the tile.
+	*/
+	void Reserve(int tile, int tick, int agent)
+	{
+		if ((_size + 1) * 2 > static_cast<int>(_slots.size()))
+		{
+			Grow();
+		}
+
+		const uint64_t key = Key(tile, tick);
+		Slot& slot = _slots[Find(key)];
+		if (slot.stamp != _generation)
+		{
+			slot.key = key;
+			slot.stamp = _generation;
+			++_size;
+		}
+		slot.agent = agent;
+	}
+
+	/**
+	 * @brief Getter for the agent holding a tile at a tick.
+	 * @param tile - the row-major index of the tile.
+	 * @param tick - the tick to look at.
+	 * @return the id of the agent, -1 if the tile is free.
+	*/
+	int Owner(int tile, int tick) const
+	{
+		const Slot& slot = _slots[Find(Key(tile, tick))];
+		return (slot.stamp == _generation) ? slot.agent : -1;
+	}
+
+	/**
+	 * @brief Checks whether an agent may use a tile at a tick.
+	 * @param tile - the row-major index of the tile.
+	 * @param tick - the tick to look at.
+	 * @param agent - the agent asking.
+	 * @return a boolean value indicating whether the tile is free or already held by the agent.
+	*/
+	bool IsFree(int tile, int tick, int agent) const
+	{
+		const int owner = Owner(tile, tick);
+		return owner < 0 || owner == agent;
+	}
+
+	/**
+	 * @brief Removes every reservation by starting a new generation.
+	*/
+	void Clear()
+	{
+		if (++_generation == 0)
+		{
+			// the stamps wrapped around, old slots could look current again
+			for (Slot& slot : _slots)
+			{
+				slot.stamp = 0;
+			}
+			_generation = 1;
+		}
+		_size = 0;
+	}
+
+	/**
+	 * @brief Getter for the number of reservations.
+	 * @return an integer representing the number of reservations.
+	*/
+	int Size() const
+	{
+		return _size;
+	}
+};
@@ -0,0 +1,308 @@
+#pragma once
+#include "Tile.h"
+
+#include <cstdint>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+/**
+ * @file SpatialHash.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the SpatialHash class, a uniform grid of square cells that
+ * indexes items (usually Characters) by their tile. Only cells holding at least one item exist;
+ * they are found through a hash of the packed cell coordinates, so the index works on maps of
+ * any size and costs memory proportional to the number of items. Every cell keeps its items
+ * and their tiles in one contiguous bucket, and every item remembers its bucket and slot, so
+ * moving an item is O(1) and leaves the rest of the index untouched.
+ *
+ * Radius and rectangle queries only visit the cells overlapping the area asked for, so with
+ * a cell size close to the usual query radius they run in time proportional to the number of
+ * items returned rather than the number of items indexed.
+ *
+ * Properties:
+ * -----------
+ * > _cellSize: int - The number of rows and columns of a cell.
+ * > _cells: unordered_map<uint64_t, int> - The bucket of every occupied cell.
+ * > _buckets: vector<vector<Entry>> - The items of every cell and their tiles.
+ * > _freeBuckets: vector<int> - Buckets of cells that became empty, kept for reuse.
+ * > _handles: unordered_map<T, Handle> - The bucket and slot of every item.
+ *
+ * Methods:
+ * --------
+ * > SpatialHash(cellSize: int) - Creates an empty index.
+ * > Insert(item: T, loc: Location) - Adds an item on a tile.
+ * > Update(item: T, loc: Location) - Moves an item to a tile.
+ * > Remove(item: T) - Removes an item.
+ * > Contains(item: T): bool - Checks whether an item is indexed.
+ * > QueryRadius(center: Location, radius: int, result: vector<T>) - Items within a distance of a tile.
+ * > QueryRect(top, left, bottom, right, result: vector<T>) - Items inside a rectangle of tiles.
+ * > Size(): int - The number of items indexed.
+ * > Clear() - Removes every item.
+ */
+template <class T>
+class SpatialHash
+{
+private:
+	struct Entry
+	{
+		T item;
+		int x;
+		int y;
+	};
+
+	struct Handle
+	{
+		int bucket;
+		int slot;
+	};
+
+	int _cellSize;
+	std::unordered_map<uint64_t, int> _cells;
+	std::vector<std::vector<Entry>> _buckets;
+	std::vector<int> _freeBuckets;
+	std::unordered_map<T, Handle> _handles;
+
+	/**
+	 * @brief The cell coordinate of a tile coordinate, rounding towards negative infinity.
+	*/
+	int CellOf(int value) const
+	{
+		return (value >= 0) ? value / _cellSize : -((_cellSize - 1 - value) / _cellSize);
+	}
+
+	static uint64_t Key(int cellRow, int cellCol)
+	{
+		return (static_cast<uint64_t>(static_cast<uint32_t>(cellRow)) << 32) | static_cast<uint32_t>(cellCol);
+	}
+
+	/**
+	 * @brief The bucket of the cell holding a tile, created when absent.
+	*/
+	int BucketAt(int x, int y)
+	{
+		const uint64_t key = Key(CellOf(x), CellOf(y));
+		auto cell = _cells.find(key);
+		if (cell != _cells.end())
+		{
+			return cell->second;
+		}
+
+		int bucket;
+		if (_freeBuckets.empty())
+		{
+			bucket = static_cast<int>(_buckets.size());
+			_buckets.emplace_back();
+		}
+		else
+		{
+			bucket = _freeBuckets.back();
+			_freeBuckets.pop_back();
+		}
+		_cells.emplace(key, bucket);
+		return bucket;
+	}
+
+	/**
+	 * @brief Appends an item to a bucket and records where it went.
+	*/
+	void Place(Handle& handle, T item, int x, int y)
+	{
+		handle.bucket = BucketAt(x, y);
+		handle.slot = static_cast<int>(_buckets[handle.bucket].size());
+		_buckets[handle.bucket].push_back(Entry{ item, x, y });
+	}
+
+	/**
+	 * @brief Takes an item out of its bucket by moving the bucket's last item into its slot,
+	 * dropping the cell once it is empty.
+	*/
+	void Unplace(const Handle& handle)
+	{
+		std::vector<Entry>& entries = _buckets[handle.bucket];
+		const Entry removed = entries[handle.slot];
+		if (handle.slot + 1 != static_cast<int>(entries.size()))
+		{
+			entries[handle.slot] = entries.back();
+			_handles[entries[handle.slot].item].slot = handle.slot;
+		}
+		entries.pop_back();
+
+		if (entries.empty())
+		{
+			_cells.erase(Key(CellOf(removed.x), CellOf(removed.y)));
+			_freeBuckets.push_back(handle.bucket);
+		}
+	}
+
+	/**
+	 * @brief Appends the items of one cell that pass a test on their tile.
+	*/
+	template <class Test>
+	void Collect(int cellRow, int cellCol, Test test, std::vector<T>& result) const
+	{
+		auto cell = _cells.find(Key(cellRow, cellCol));
+		if (cell == _cells.end())
+		{
+			return;
+		}
+		for (const Entry& entry : _buckets[cell->second])
+		{
+			if (test(entry.x, entry.y))
+			{
+				result.push_back(entry.item);
+			}
+		}
+	}
+
+public:
+	/**
+	 * @brief Creates an empty index.
+	 * @param cellSize - the number of rows and columns of a cell, ideally close to the usual query radius.
+	*/
+	explicit SpatialHash(int cellSize = 8) : _cellSize(cellSize)
+	{
+		if (cellSize < 1)
+		{
+			throw std::out_of_range("Cell size must be at least 1");
+		}
+	}
+
+	/**
+	 * @brief Adds an item on a tile, or moves it there if it is already indexed.
+	 * @param item - the item to add.
+	 * @param loc - the tile of the item.
+	*/
+	void Insert(T item, const Location& loc)
+	{
+		auto found = _handles.find(item);
+		if (found != _handles.end())
+		{
+			Update(item, loc);
+			return;
+		}
+		Place(_handles[item], item, loc.x, loc.y);
+	}
+
+	/**
+	 * @brief Moves an indexed item to a tile. Items staying inside their cell are updated in place.
+	 * @param item - the item to move.
+	 * @param loc - the new tile of the item.
+	*/
+	void Update(T item, const Location& loc)
+	{
+		auto found = _handles.find(item);
+		if (found == _handles.end())
+		{
+			throw std::out_of_range("Item is not in the spatial index");
+		}
+
+		Handle& handle = found->second;
+		Entry& entry = _buckets[handle.bucket][handle.slot];
+		if (CellOf(entry.x) == CellOf(loc.x) && CellOf(entry.y) == CellOf(loc.y))
+		{
+			entry.x = loc.x;
+			entry.y = loc.y;
+			return;
+		}
+
+		const Handle old = handle;
+		Place(handle, item, loc.x, loc.y);
+		Unplace(old);
+	}
+
+	/**
+	 * @brief Removes an item from the index, doing nothing if it is not indexed.
+	 * @param item - the item to remove.
+	*/
+	void Remove(T item)
+	{
+		auto found = _handles.find(item);
+		if (found == _handles.end())
+		{
+			return;
+		}
+		const Handle handle = found->second;
+		_handles.erase(found);
+		Unplace(handle);
+	}
+
+	/**
+	 * @brief Checks whether an item is indexed.
+	 * @param item - the item to look for.
+	 * @return a boolean value indicating whether the item is indexed.
+	*/
+	bool Contains(T item) const
+	{
+		return _handles.find(item) != _handles.end();
+	}
+
+	/**
+	 * @brief Finds the items within a straight line distance of a tile.
+	 * @param center - the tile at the center of the circle.
+	 * @param radius - the largest distance in tiles, inclusive.
+	 * @param result - the items found are appended to it.
+	*/
+	void QueryRadius(const Location& center, int radius, std::vector<T>& result) const
+	{
+		const long long limit = static_cast<long long>(radius) * radius;
+		auto inside = [&](int x, int y)
+		{
+			const long long dx = x - center.x;
+			const long long dy = y - center.y;
+			return dx * dx + dy * dy <= limit;
+		};
+
+		for (int cellRow = CellOf(center.x - radius); cellRow <= CellOf(center.x + radius); cellRow++)
+		{
+			for (int cellCol = CellOf(center.y - radius); cellCol <= CellOf(center.y + radius); cellCol++)
+			{
+				Collect(cellRow, cellCol, inside, result);
+			}
+		}
+	}
+
+	/**
+	 * @brief Finds the items inside a rectangle of tiles, all bounds inclusive.
+	 * @param top - the first row of the rectangle.
+	 * @param left - the first column of the rectangle.
+	 * @param bottom - the last row of the rectangle.
+	 * @param right - the last column of the rectangle.
+	 * @param result - the items found are appended to it.
+	*/
+	void QueryRect(int top, int left, int bottom, int right, std::vector<T>& result) const
+	{
+		auto inside = [&](int x, int y)
+		{
+			return x >= top && x <= bottom && y >= left && y <= right;
+		};
+
+		for (int cellRow = CellOf(top); cellRow <= CellOf(bottom); cellRow++)
+		{
+			for (int cellCol = CellOf(left); cellCol <= CellOf(right); cellCol++)
+			{
+				Collect(cellRow, cellCol, inside, result);
+			}
+		}
+	}
+
+	/**
+	 * @brief Getter for the number of indexed items.
+	 * @return an integer representing the number of items.
+	*/
+	int Size() const
+	{
+		return static_cast<int>(_handles.size());
+	}
+
+	/**
+	 * @brief Removes every item from the index.
+	*/
+	void Clear()
+	{
+		_cells.clear();
+		_buckets.clear();
+		_freeBuckets.clear();
+		_handles.clear();
+	}
+};
@@ -0,0 +1,271 @@
+#pragma once
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+/**
+ * @file SummedAreaTable.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file defines the SummedAreaTable class which answers "what is the total
+ * of the values inside this rectangle" in O(1) for a grid of integer values, one per tile.
+ *
+ * A plain summed-area table stores the total of every rectangle anchored at the top left
+ * corner, so changing one value invalidates every row below it. Here the rows are cut into
+ * bands of SAT_BAND_ROWS rows instead. Every band keeps a table of its own rows only, and a
+ * small table of band totals holds, for every band, the column prefix sums of all rows above
+ * it. The total above and left of any tile is then one entry of each, so queries stay O(1),
+ * while a changed value only dirties its own band. Set() just records the value and marks the
+ * band; the next Sum() rebuilds the dirty bands, spread over several threads when there are
+ * many, and then the band totals from the first dirty band down.
+ *
+ * Within a band the running sum along a row is inherently serial, but adding the row above is
+ * an elementwise add of two contiguous rows that the compiler turns into vector instructions.
+ *
+ * Properties:
+ * -----------
+ * > _rows, _cols: int - The dimensions of the grid.
+ * > _bands: int - The number of row bands.
+ * > _threads: int - The number of threads used to rebuild many dirty bands.
+ * > _values: vector<int> - The value of every tile.
+ * > _local: vector<long long> - Per band prefix sums, (cols + 1) per row.
+ * > _across: vector<long long> - Column prefix sums of every row above each band, (cols + 1) per band.
+ * > _dirty: vector<unsigned char> - Marks the bands changed since the last rebuild.
+ * > _firstDirty: int - The first dirty band, _bands when every band is clean.
+ *
+ * Methods:
+ * --------
+ * > SummedAreaTable(rows: int, cols: int, threads: int) - Creates a table of zeros.
+ * > Resize(rows: int, cols: int) - Changes the dimensions, resetting every value to zero.
+ * > Set(row, col, value), Get(row, col) - Single value access.
+ * > Sum(top, left, bottom, right): long long - The total inside a rectangle.
+ * > GetDirtyBands(): int - The number of bands waiting to be rebuilt.
+ * > SetThreads(threads: int) - The number of threads used to rebuild.
+ */
+class SummedAreaTable
+{
+public:
+	static const int SAT_BAND_ROWS = 64;
+	static const int SAT_PARALLEL_BANDS = 8;
+
+private:
+	int _rows;
+	int _cols;
+	int _bands;
+	int _threads;
+	std::vector<int> _values;
+	std::vector<long long> _local;
+	std::vector<long long> _across;
+	std::vector<unsigned char> _dirty;
+	int _firstDirty;
+
+	/**
+	 * @brief Recomputes the prefix sums of the rows of one band.
+	*/
+	void RebuildBand(int band)
+	{
+		const int stride = _cols + 1;
+		const int first = band * SAT_BAND_ROWS;
+		const int last = std::min(first + SAT_BAND_ROWS, _rows);
+		for (int row = first; row < last; row++)
+		{
+			const int* values = &_values[static_cast<size_t>(row) * _cols];
+			long long* sums = &_local[static_cast<size_t>(row) * stride];
+			long long running = 0;
+			sums[0] = 0;
+			for (int col = 0; col < _cols; col++)
+			{
+				running += values[col];
+				sums[col + 1] = running;
+			}
+
+			if (row > first)
+			{
+				const long long* above = sums - stride;
+				for (int col = 1; col < stride; col++)
+				{
+					sums[col] += above[col];
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Rebuilds every dirty band and the band totals below the first of them.
+	*/
+	void Refresh()
+	{
+		if (_firstDirty >= _bands)
+		{
+			return;
+		}
+
+		std::vector<int> dirty;
+		for (int band = _firstDirty; band < _bands; band++)
+		{
+			if (_dirty[band] != 0)
+			{
+				dirty.push_back(band);
+				_dirty[band] = 0;
+			}
+		}
+
+		const int count = static_cast<int>(dirty.size());
+		const int workers = (count >= SAT_PARALLEL_BANDS) ? std::min(_threads, count) : 1;
+		auto work = [&](int worker)
+		{
+			for (int i = worker; i < count; i += workers)
+			{
+				RebuildBand(dirty[i]);
+			}
+		};
+		std::vector<std::thread> threads;
+		for (int w = 1; w < workers; w++)
+		{
+			threads.emplace_back(work, w);
+		}
+		work(0);
+		for (auto& worker : threads)
+		{
+			worker.join();
+		}
+
+		// every band below a dirty one sees new totals above it
+		const int stride = _cols + 1;
+		for (int band = _firstDirty; band < _bands; band++)
+		{
+			const int lastRow = std::min((band + 1) * SAT_BAND_ROWS, _rows) - 1;
+			const long long* above = &_across[static_cast<size_t>(band) * stride];
+			const long long* rows = &_local[static_cast<size_t>(lastRow) * stride];
+			long long* next = &_across[static_cast<size_t>(band + 1) * stride];
+			for (int col = 0; col < stride; col++)
+			{
+				next[col] = above[col] + rows[col];
+			}
+		}
+		_firstDirty = _bands;
+	}
+
+	/**
+	 * @brief The total of every value above row and left of col, both exclusive.
+	*/
+	long long Prefix(int row, int col) const
+	{
+		if (row == 0)
+		{
+			return 0;
+		}
+		const int stride = _cols + 1;
+		const int last = row - 1;
+		return _across[static_cast<size_t>(last / SAT_BAND_ROWS) * stride + col] + _local[static_cast<size_t>(last) * stride + col];
+	}
+
+public:
+	/**
+	 * @brief Creates a table with every value zero.
+	 * @param rows - the number of rows.
+	 * @param cols - the number of columns.
+	 * @param threads - the number of threads used to rebuild many dirty bands, 0 to use every hardware thread.
+	*/
+	explicit SummedAreaTable(int rows = 0, int cols = 0, int threads = 0) : _rows(0), _cols(0), _bands(0), _firstDirty(0)
+	{
+		SetThreads(threads);
+		Resize(rows, cols);
+	}
+
+	/**
+	 * @brief Changes the dimensions of the table, resetting every value to zero.
+	 * @param rows - the number of rows.
+	 * @param cols - the number of columns.
+	*/
+	void Resize(int rows, int cols)
+	{
+		if (rows < 0 || cols < 0)
+		{
+			throw std::out_of_range("Table dimensions must not be negative");
+		}
+		_rows = rows;
+		_cols = cols;
+		_bands = (rows + SAT_BAND_ROWS - 1) / SAT_BAND_ROWS;
+		_values.assign(static_cast<size_t>(rows) * cols, 0);
+		_local.assign(static_cast<size_t>(rows) * (cols + 1), 0);
+		_across.assign(static_cast<size_t>(_bands + 1) * (cols + 1), 0);
+		_dirty.assign(_bands, 0);
+		_firstDirty = _bands;
+	}
+
+	/**
+	 * @brief Setter for the value of a tile. The sums catch up on the next Sum().
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @param value - the desired value.
+	*/
+	void Set(int row, int col, int value)
+	{
+		int& current = _values[static_cast<size_t>(row) * _cols + col];
+		if (current != value)
+		{
+			current = value;
+			const int band = row / SAT_BAND_ROWS;
+			_dirty[band] = 1;
+			_firstDirty = std::min(_firstDirty, band);
+		}
+	}
+
+	/**
+	 * @brief Getter for the value of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return an integer representing the value.
+	*/
+	int Get(int row, int col) const
+	{
+		return _values[static_cast<size_t>(row) * _cols + col];
+	}
+
+	/**
+	 * @brief Totals the values inside a rectangle, all bounds inclusive and clipped to the grid.
+	 * Rebuilds the dirty bands first.
+	 * @param top - the first row.
+	 * @param left - the first column.
+	 * @param bottom - the last row.
+	 * @param right - the last column.
+	 * @return the total of the values.
+	*/
+	long long Sum(int top, int left, int bottom, int right)
+	{
+		top = std::max(top, 0);
+		left = std::max(left, 0);
+		bottom = std::min(bottom, _rows - 1);
+		right = std::min(right, _cols - 1);
+		if (top > bottom || left > right)
+		{
+			return 0;
+		}
+
+		Refresh();
+		return Prefix(bottom + 1, right + 1) - Prefix(top, right + 1) - Prefix(bottom + 1, left) + Prefix(top, left);
+	}
+
+	/**
+	 * @brief Getter for the number of bands waiting to be rebuilt.
+	 * @return an integer representing the number of dirty bands.
+	*/
+	int GetDirtyBands() const
+	{
+		return static_cast<int>(std::count(_dirty.begin(), _dirty.end(), 1));
+	}
+
+	/**
+	 * @brief Setter for the number of threads used to rebuild many dirty bands.
+	 * @param threads - the desired number of threads, 0 to use every hardware thread.
+	*/
+	void SetThreads(int threads)
+	{
+		if (threads <= 0)
+		{
+			threads = static_cast<int>(std::thread::hardware_concurrency());
+		}
+		_threads = std::max(threads, 1);
+	}
+};
@@ -35,11 +35,9 @@ Tile::Tile(int xPos, int yPos)
 
 Tile::~Tile()
 {
+	// neighbours are owned by the TileSpace, deleting them here would free the Sentinel
+	// and cascade through the whole grid
 	delete _loc;
-	delete _top;
-	delete _bottom;
-	delete _left;
-	delete _right;
 }
 
 Tile::Tile(const Tile& other)
@@ -188,46 +186,46 @@ void Tile::ShowNeighbors(int range) const
 {
 	if (range == 0)
 	{
-		cout << "Tile at (" << _xPos << ", " << _yPos << ") has no neighbors." <<  endl;
+		cout << "Tile at (" << _xPos << ", " << _yPos << ") has no neighbors.\n";
 		return;
 	}
 
-	cout << "Tile at (" << _xPos << ", " << _yPos << ") has neighbors: " <<  endl;
+	cout << "Tile at (" << _xPos << ", " << _yPos << ") has neighbors: \n";
 
 	if (HasTop())
 	{
-		cout << "Top: (" << _top->GetPosition()->x << ", " << _top->GetPosition()->y << ")" <<  endl;
+		cout << "Top: (" << _top->GetPosition()->x << ", " << _top->GetPosition()->y << ")\n";
 	}
 	else
 	{
-		cout << "Top: None" <<  endl;
+		cout << "Top: None\n";
 	}
 
 	if (HasBottom())
 	{
-		cout << "Bottom: (" << _bottom->GetPosition()->x << ", " << _bottom->GetPosition()->y << ")" <<  endl;
+		cout << "Bottom: (" << _bottom->GetPosition()->x << ", " << _bottom->GetPosition()->y << ")\n";
 	}
 	else
 	{
-		cout << "Bottom: None" <<  endl;
+		cout << "Bottom: None\n";
 	}
 
 	if (HasLeft())
 	{
-		cout << "Left: (" << _left->GetPosition()->x << ", " << _left->GetPosition()->y << ")" <<  endl;
+		cout << "Left: (" << _left->GetPosition()->x << ", " << _left->GetPosition()->y << ")\n";
 	}
 	else
 	{
-		cout << "Left: None" <<  endl;
+		cout << "Left: None\n";
 	}
 
 	if (HasRight())
 	{
-		cout << "Right: (" << _right->GetPosition()->x << ", " << _right->GetPosition()->y << ")" <<  endl;
+		cout << "Right: (" << _right->GetPosition()->x << ", " << _right->GetPosition()->y << ")\n";
 	}
 	else
 	{
-		cout << "Right: None" <<  endl;
+		cout << "Right: None\n";
 	}
 }
 
@@ -235,7 +233,7 @@ void Tile::PrintTile() const
 {
 	cout << "============\n";
 	cout << "|| Tile at (" << _xPos << ", " << _yPos << ")||\n";
-	cout << "============" << endl;
+	cout << "============\n";
 }
 
 
@@ -254,6 +252,6 @@ const Location& Location::operator*()
 
 void Location::PrintLoc() const
 {
-	cout << "(" << x << ", " << y << ")___________" << endl;
+	cout << "(" << x << ", " << y << ")___________\n";
 }
 
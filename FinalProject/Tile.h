@@ -249,4 +249,26 @@ public:
 	void PrintLoc() const;
 };
 
+/**
+ * TileFlags enum
+ *
+ * @brief Bit flags describing the state of a single tile. The TileSpace keeps one byte of
+ * these flags per tile in a flat row-major layer, which is also the layout written to disk by
+ * the MapFile binary format.
+ *
+ * Values:
+ * TILE_WALKABLE - The tile can be stepped on by a character.
+ * TILE_HAZARD - The tile hurts any character standing on it.
+ * TILE_OPAQUE - The tile blocks line of sight.
+ * TILE_OCCUPIED - A character is currently standing on the tile.
+*/
+enum TileFlags : unsigned char
+{
+	TILE_NONE = 0,
+	TILE_WALKABLE = 1 << 0,
+	TILE_HAZARD = 1 << 1,
+	TILE_OPAQUE = 1 << 2,
+	TILE_OCCUPIED = 1 << 3
+};
+
 extern Tile::TilePtr Sentinel;
\ No newline at end of file
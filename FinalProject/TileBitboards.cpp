@@ -0,0 +1,272 @@
+#include "TileBitboards.h"
+
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+TileBitboards::TileBitboards(const TileSpace<Tile*>* space)
+{
+	_flags = space->GetFlagsLayer();
+	_rows = space->GetRows();
+	_cols = space->GetCols();
+
+	for (BitGrid* grid : { &_walkable, &_occupied, &_hazard, &_visited, &_free, &_frontier, &_next })
+	{
+		grid->Resize(_rows, _cols);
+	}
+	Rebuild();
+}
+
+void TileBitboards::Rebuild()
+{
+	_walkable.Clear();
+	_occupied.Clear();
+	_hazard.Clear();
+	_visited.Clear();
+	_free.Clear();
+
+	// pack the flag bytes of a row 64 at a time straight into the words of each layer
+	const int wordsPerRow = _walkable.GetWordsPerRow();
+	for (int row = 0; row < _rows; row++)
+	{
+		const unsigned char* flags = &_flags[static_cast<size_t>(row) * _cols];
+		const size_t offset = static_cast<size_t>(row) * wordsPerRow;
+		for (int w = 0; w < wordsPerRow; w++)
+		{
+			uint64_t walkable = 0, occupied = 0, hazard = 0;
+			const int first = w * 64;
+			const int count = min(64, _cols - first);
+			for (int bit = 0; bit < count; bit++)
+			{
+				const unsigned char tile = flags[first + bit];
+				walkable |= static_cast<uint64_t>(tile & TILE_WALKABLE) << bit;
+				occupied |= static_cast<uint64_t>((tile & TILE_OCCUPIED) != 0) << bit;
+				hazard |= static_cast<uint64_t>((tile & TILE_HAZARD) != 0) << bit;
+			}
+			_walkable.GetWords()[offset + w] = walkable;
+			_occupied.GetWords()[offset + w] = occupied;
+			_hazard.GetWords()[offset + w] = hazard;
+			_free.GetWords()[offset + w] = walkable & ~occupied;
+		}
+	}
+}
+
+void TileBitboards::UpdateTile(int row, int col)
+{
+	const unsigned char tile = _flags[static_cast<size_t>(row) * _cols + col];
+	auto assign = [row, col](BitGrid& grid, bool value)
+	{
+		if (value)
+		{
+			grid.Set(row, col);
+		}
+		else
+		{
+			grid.Reset(row, col);
+		}
+	};
+
+	assign(_walkable, (tile & TILE_WALKABLE) != 0);
+	assign(_occupied, (tile & TILE_OCCUPIED) != 0);
+	assign(_hazard, (tile & TILE_HAZARD) != 0);
+	assign(_free, (tile & TILE_WALKABLE) != 0 && (tile & TILE_OCCUPIED) == 0);
+}
+
+TileBitboards::Window TileBitboards::Expand(const BitGrid& from, BitGrid& to, const Window& window, BitGrid* visited, int& added) const
+{
+	const int wordsPerRow = _free.GetWordsPerRow();
+	const uint64_t* source = from.GetWords();
+	const uint64_t* free = _free.GetWords();
+	uint64_t* target = to.GetWords();
+	uint64_t* seen = (visited != nullptr) ? visited->GetWords() : nullptr;
+
+	auto at = [&](int row, int w) -> uint64_t
+	{
+		return (row < window.top || row > window.bottom || w < window.left || w > window.right)
+			? 0 : source[static_cast<size_t>(row) * wordsPerRow + w];
+	};
+	auto open = [&](int row, int w) -> uint64_t
+	{
+		return (row < 0 || row >= _rows || w < 0 || w >= wordsPerRow) ? 0 : free[static_cast<size_t>(row) * wordsPerRow + w];
+	};
+
+	// the tiles of a row reached by one straight move, north from the row below, south from the
+	// row above, and east or west along the row with the bit carried across word boundaries
+	auto north = [&](int row, int w) { return at(row + 1, w) & open(row, w); };
+	auto south = [&](int row, int w) { return at(row - 1, w) & open(row, w); };
+	auto east = [&](int row, int w) { return ((at(row, w) << 1) | (at(row, w - 1) >> 63)) & open(row, w); };
+	auto west = [&](int row, int w) { return ((at(row, w) >> 1) | (at(row, w + 1) << 63)) & open(row, w); };
+
+	Window reached{ _rows, -1, wordsPerRow, -1 };
+	added = 0;
+	const int top = max(window.top - 1, 0);
+	const int bottom = min(window.bottom + 1, _rows - 1);
+	const int left = max(window.left - 1, 0);
+	const int right = min(window.right + 1, wordsPerRow - 1);
+	for (int row = top; row <= bottom; row++)
+	{
+		for (int w = left; w <= right; w++)
+		{
+			const size_t index = static_cast<size_t>(row) * wordsPerRow + w;
+
+			// a flood frontier is a thin ring, most words of its box have nothing nearby
+			if ((at(row - 1, w) | at(row, w) | at(row + 1, w)) == 0
+				&& ((at(row - 1, w - 1) | at(row, w - 1) | at(row + 1, w - 1)) >> 63) == 0
+				&& ((at(row - 1, w + 1) | at(row, w + 1) | at(row + 1, w + 1)) & 1) == 0)
+			{
+				target[index] = 0;
+				continue;
+			}
+
+			const uint64_t up = north(row, w);
+			const uint64_t down = south(row, w);
+			uint64_t word = up | down | east(row, w) | west(row, w);
+
+			// a diagonal move needs both tiles beside it free: it is a straight move carried one
+			// column further, and the same target must be reachable the other way round
+			const uint64_t upEast = (up << 1) | (north(row, w - 1) >> 63);
+			const uint64_t upWest = (up >> 1) | (north(row, w + 1) << 63);
+			const uint64_t downEast = (down << 1) | (south(row, w - 1) >> 63);
+			const uint64_t downWest = (down >> 1) | (south(row, w + 1) << 63);
+			word |= ((upEast & east(row + 1, w)) | (upWest & west(row + 1, w))
+				| (downEast & east(row - 1, w)) | (downWest & west(row - 1, w))) & open(row, w);
+
+			if (seen != nullptr)
+			{
+				word &= ~seen[index];
+				seen[index] |= word;
+			}
+			target[index] = word;
+			if (word != 0)
+			{
+				added += PopCount(word);
+				reached.top = min(reached.top, row);
+				reached.bottom = max(reached.bottom, row);
+				reached.left = min(reached.left, w);
+				reached.right = max(reached.right, w);
+			}
+		}
+	}
+	return reached;
+}
+
+void TileBitboards::Step(const BitGrid& from, BitGrid& to) const
+{
+	if (from.GetRows() != _rows || from.GetCols() != _cols || &from == &to)
+	{
+		throw out_of_range("Step needs a separate grid with the dimensions of the TileSpace");
+	}
+	if (to.GetRows() != _rows || to.GetCols() != _cols)
+	{
+		to.Resize(_rows, _cols);
+	}
+
+	int added = 0;
+	Expand(from, to, Window{ 0, _rows - 1, 0, _free.GetWordsPerRow() - 1 }, nullptr, added);
+}
+
+int TileBitboards::Flood(const Location& start, int maxSteps)
+{
+	_visited.Clear();
+	if (start.x < 0 || start.x >= _rows || start.y < 0 || start.y >= _cols || !_free.Get(start.x, start.y))
+	{
+		return 0;
+	}
+
+	// only the words inside the window are read, so stale bits elsewhere in the frontier never matter
+	Window window{ start.x, start.x, start.y >> 6, start.y >> 6 };
+	_frontier.GetWords()[static_cast<size_t>(start.x) * _frontier.GetWordsPerRow() + (start.y >> 6)] = uint64_t(1) << (start.y & 63);
+	_visited.Set(start.x, start.y);
+	int marked = 1;
+
+	for (int step = 0; maxSteps < 0 || step < maxSteps; step++)
+	{
+		int added = 0;
+		window = Expand(_frontier, _next, window, &_visited, added);
+		if (added == 0)
+		{
+			break;
+		}
+		marked += added;
+		swap(_frontier, _next);
+	}
+	return marked;
+}
+
+unsigned int TileBitboards::ReadThree(const BitGrid& grid, int row, int col) const
+{
+	if (row < 0 || row >= _rows)
+	{
+		return 0;
+	}
+
+	const uint64_t* words = grid.GetWords() + static_cast<size_t>(row) * grid.GetWordsPerRow();
+	if (col >= 1 && ((col - 1) >> 6) == ((col + 1) >> 6))
+	{
+		// the usual case, all three bits share one word; the tail bits past the last column are clear
+		return static_cast<unsigned int>((words[(col - 1) >> 6] >> ((col - 1) & 63)) & 7);
+	}
+
+	unsigned int bits = 0;
+	for (int k = 0; k < 3; k++)
+	{
+		const int c = col - 1 + k;
+		if (c >= 0 && c < _cols && ((words[c >> 6] >> (c & 63)) & 1) != 0)
+		{
+			bits |= 1u << k;
+		}
+	}
+	return bits;
+}
+
+unsigned char TileBitboards::NeighbourMask(int row, int col) const
+{
+	const unsigned int up = ReadThree(_free, row - 1, col);
+	const unsigned int middle = ReadThree(_free, row, col);
+	const unsigned int down = ReadThree(_free, row + 1, col);
+
+	const unsigned int north = (up >> 1) & 1;
+	const unsigned int south = (down >> 1) & 1;
+	const unsigned int west = middle & 1;
+	const unsigned int east = (middle >> 2) & 1;
+	const unsigned int northWest = up & north & west;
+	const unsigned int northEast = (up >> 2) & north & east;
+	const unsigned int southWest = down & south & west;
+	const unsigned int southEast = (down >> 2) & south & east;
+
+	return static_cast<unsigned char>(north | (south << 1) | (west << 2) | (east << 3)
+		| (northWest << 4) | (northEast << 5) | (southWest << 6) | (southEast << 7));
+}
+
+int TileBitboards::CountRegion(const BitGrid& layer, int top, int left, int bottom, int right) const
+{
+	return layer.CountRect(top, left, bottom, right);
+}
+
+const BitGrid& TileBitboards::GetWalkable() const
+{
+	return _walkable;
+}
+
+const BitGrid& TileBitboards::GetOccupied() const
+{
+	return _occupied;
+}
+
+const BitGrid& TileBitboards::GetHazard() const
+{
+	return _hazard;
+}
+
+BitGrid& TileBitboards::GetVisited()
+{
+	return _visited;
+}
+
+const BitGrid& TileBitboards::GetFree() const
+{
+	return _free;
+}
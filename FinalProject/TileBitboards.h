@@ -0,0 +1,165 @@
+#pragma once
+#include "TileSpace.h"
+#include "BitGrid.h"
+/**
+ * @file TileBitboards.h
+ * @author Billy Ndegwah Micah
+ *
+ * Description: This file contains the declaration of the TileBitboards class which mirrors
+ * the TileFlags layer of a TileSpace as four bitboards: walkable, occupied, hazard and visited,
+ * 64 tiles to a word. Questions about whole areas become word operations. Step() produces every
+ * tile one move away from a set of tiles with word shifts and a handful of ANDs and ORs,
+ * following the same rules as the Pathfinder: eight directions, onto free tiles (walkable and
+ * not occupied) and no cutting corners past a blocked tile. Flood() repeats it to find the area
+ * reachable from a tile, marking it in the visited layer; every step only touches the words
+ * around the bounding box of the frontier, so a flood limited to a few moves costs little more
+ * than the area it covers. NeighbourMask() answers which of
+ * the eight neighbours of one tile are free from three words.
+ *
+ * The bitboards are a copy of the flag layer, so UpdateTile() must be called when the flags
+ * of a tile change, or Rebuild() after many changes.
+ *
+ * Properties:
+ * -----------
+ * > _flags: unsigned char* - The TileFlags layer of the TileSpace.
+ * > _rows, _cols: int - The dimensions of the TileSpace.
+ * > _walkable, _occupied, _hazard, _visited: BitGrid - The four layers.
+ * > _free: BitGrid - Walkable tiles that are not occupied.
+ * > _frontier, _next: BitGrid - The frontier boards swapped by Flood().
+ *
+ * Methods:
+ * --------
+ * > TileBitboards(space) - Builds the layers from a TileSpace.
+ * > Rebuild() - Rebuilds every layer from the flag layer and clears the visited layer.
+ * > UpdateTile(row, col) - Copies the flags of one tile into the layers.
+ * > Step(from, to) - The free tiles one move away from a set of tiles.
+ * > Flood(start, maxSteps): int - Marks the free tiles reachable from a tile as visited.
+ * > NeighbourMask(row, col): unsigned char - Which of the eight neighbours of a tile are free to step on.
+ * > CountRegion(layer, top, left, bottom, right): int - Set bits of a layer inside a rectangle.
+ * > GetWalkable(), GetOccupied(), GetHazard(), GetVisited(), GetFree() - The layers.
+ */
+class TileBitboards
+{
+private:
+	const unsigned char* _flags;
+	int _rows;
+	int _cols;
+	BitGrid _walkable;
+	BitGrid _occupied;
+	BitGrid _hazard;
+	BitGrid _visited;
+	BitGrid _free;
+	BitGrid _frontier;
+	BitGrid _next;
+
+	/**
+	 * @brief A rectangle of rows and 64 bit word columns, all bounds inclusive. Empty when top > bottom.
+	*/
+	struct Window
+	{
+		int top;
+		int bottom;
+		int left;
+		int right;
+	};
+
+	/**
+	 * @brief Writes the free tiles one move away from the bits of from inside a window, over the
+	 * window grown by one tile, in a single pass. Bits of from outside the window are ignored and
+	 * words of to outside the grown window are left untouched.
+	 * @param visited - when not null, tiles already set in it are dropped from to and the new ones added to it.
+	 * @param added - receives the number of bits written to to.
+	 * @return the smallest window holding every bit written to to.
+	*/
+	Window Expand(const BitGrid& from, BitGrid& to, const Window& window, BitGrid* visited, int& added) const;
+
+	/**
+	 * @brief Reads three neighbouring bits of a row, centered on a column, as the low bits of a
+	 * word. Tiles outside the grid read as cleared.
+	*/
+	unsigned int ReadThree(const BitGrid& grid, int row, int col) const;
+
+public:
+	/**
+	 * @brief Builds the layers from a TileSpace.
+	 * @param space - the TileSpace to mirror.
+	*/
+	explicit TileBitboards(const TileSpace<Tile*>* space);
+
+	/**
+	 * @brief Rebuilds every layer from the flag layer and clears the visited layer.
+	*/
+	void Rebuild();
+
+	/**
+	 * @brief Copies the current flags of one tile into the layers.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	*/
+	void UpdateTile(int row, int col);
+
+	/**
+	 * @brief Finds every free tile one move away from a set of tiles.
+	 * @param from - the tiles to move from.
+	 * @param to - receives the tiles reached, resized to the map when needed. It may not be from.
+	*/
+	void Step(const BitGrid& from, BitGrid& to) const;
+
+	/**
+	 * @brief Marks the free tiles reachable from a tile in the visited layer, expanding the
+	 * whole frontier one move at a time.
+	 * @param start - the tile to flood from.
+	 * @param maxSteps - the largest number of moves, negative for no limit.
+	 * @return an integer representing the number of tiles marked, including the start.
+	*/
+	int Flood(const Location& start, int maxSteps = -1);
+
+	/**
+	 * @brief Finds which neighbours of a tile a character standing on it may step onto.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return one bit per direction in the order N, S, W, E, NW, NE, SW, SE, set when the step is allowed.
+	*/
+	unsigned char NeighbourMask(int row, int col) const;
+
+	/**
+	 * @brief Counts the set bits of a layer inside a rectangle, all bounds inclusive.
+	 * @param layer - the layer to count, one of the getters of this class.
+	 * @param top - the first row.
+	 * @param left - the first column.
+	 * @param bottom - the last row.
+	 * @param right - the last column.
+	 * @return an integer representing the number of set bits.
+	*/
+	int CountRegion(const BitGrid& layer, int top, int left, int bottom, int right) const;
+
+	/**
+	 * @brief Getter for the walkable layer.
+	 * @return the grid of walkable tiles.
+	*/
+	const BitGrid& GetWalkable() const;
+
+	/**
+	 * @brief Getter for the occupied layer.
+	 * @return the grid of occupied tiles.
+	*/
+	const BitGrid& GetOccupied() const;
+
+	/**
+	 * @brief Getter for the hazard layer.
+	 * @return the grid of hazardous tiles.
+	*/
+	const BitGrid& GetHazard() const;
+
+	/**
+	 * @brief Getter for the visited layer, written by Flood() and free for callers to mark.
+	 * @return the grid of visited tiles.
+	*/
+	BitGrid& GetVisited();
+
+	/**
+	 * @brief Getter for the tiles a character may stand on: walkable and not occupied.
+	 * @return the grid of free tiles.
+	*/
+	const BitGrid& GetFree() const;
+};
@@ -3,9 +3,16 @@
 #include "Iterator2D.h"
 #include "Queue.h"
 #include "QueueNode.h"
+#include "MapFile.h"
+#include "SummedAreaTable.h"
+#include "PaletteLayer.h"
 
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
 /**
  * @file TileSpace.h
  * @author Billy Ndegwah Micah
@@ -21,97 +28,148 @@
  * > _exitFour: Tile* - The fourth option for an exit point from the 2D map.
  * > _tileBag: Iterator2D* - The iterator for the 2D array of tiles. Used for
  *		searching through the 2D array of tiles.
- * >
+ * > _tileArray: Tile*** - The rows of Tiles the tile bag iterates over, nullptr for layer-only spaces.
+ * > _flags: unsigned char* - Row-major layer holding the TileFlags of every tile.
+ * > _terrain: PaletteLayer<unsigned char>* - Row-major layer holding the Environ index of every tile,
+ *		packed at 4 bits per tile while the map uses at most sixteen Environs. A mapped TileSpace
+ *		attaches it to the packed codes in the file.
+ * > _ownsLayers: bool - Whether the flag layer and the tiles were allocated by this TileSpace, false
+ *		when they live in a mapped file or belong to the TileSpace this one was copied from.
+ * > _mapFile: MapFile* - The mapped map file backing the layers, if any.
+ * > _damage, _healing: SummedAreaTable* - Per tile Environ damage and healing, created by the first SetEnvironEffect().
+ * > _environDamage, _environHealing: vector<int> - The damage and healing of every Environ index.
  *
  * Methods:
  * > Getters and Setters for the class attributes
  * > TileSpace() - Constructor for the TileSpace class.
  * > TileSpace(grid2D: int**, rows: int, cols: int) - Overloaded constructor for the TileSpace class.
+ * > TileSpace(rows: int, cols: int) - Creates a layer-only TileSpace of any size for generators.
  * > ~TileSpace() - Destructor for the TileSpace class.
  * > TileSpace(const TileSpace&) - Copy constructor for the TileSpace class.
+ * > TileSpace(mapPath: string) - Loads a TileSpace from a binary map file without parsing it.
+ * > Save(mapPath: string) - Writes the TileSpace out in the binary map format.
+ * > GetFlags(row, col), SetFlags(row, col, flags), IsWalkable(row, col) - Tile flag layer access.
+ * > GetTerrain(row, col), SetTerrain(row, col, terrain) - Tile Environ layer access.
+ * > LoadTerrain(terrain) - Replaces the whole Environ layer from unpacked indices.
+ * > ApplyHazard(terrain, hazard, changed) - Sets TILE_HAZARD on every tile of an Environ.
+ * > SetEnvironEffect(terrain, damage, healing) - Sets the damage and healing of every tile of an Environ.
+ * > GetDamageInRect(top, left, bottom, right), GetHealingInRect(top, left, bottom, right) - Area totals in O(1).
  */
 template <typename T>
 class TileSpace
 {
+public:
+	static const int DEFAULT_SIZE = 5;
+
 private:
 	Tile* _entryPoint;
 	Tile* _exitOne;
 	Tile* _exitTwo;
 	Tile* _exitThree;
 	Iterator2D<Tile*> _tileBag;
+	Tile*** _tileArray = nullptr;
 	int** _grid2D;
 	int _rows;
 	int _cols;
+	unsigned char* _flags = nullptr;
+	PaletteLayer<unsigned char>* _terrain = nullptr;
+	bool _ownsLayers = false;
+	MapFile* _mapFile = nullptr;
+	SummedAreaTable* _damage = nullptr;
+	SummedAreaTable* _healing = nullptr;
+	std::vector<int> _environDamage;
+	std::vector<int> _environHealing;
 
-public:
 	/**
-	 * @brief Default constructor for the TileSpace class.
+	 * @brief Allocates the flag and terrain layers for the current dimensions, marking every
+	 * tile as walkable plain ground.
 	*/
-	TileSpace()
+	void InitLayers()
 	{
-		int** grid2D = new int* [5];
-
-
-		for (int i = 0; i < 5; i++)
-		{
-			grid2D[i] = new int[5];
-		}
+		const size_t tiles = static_cast<size_t>(_rows) * _cols;
+		_flags = new unsigned char[tiles];
+		_terrain = new PaletteLayer<unsigned char>(tiles, 0);
+		memset(_flags, TILE_WALKABLE, tiles);
+		_ownsLayers = true;
+	}
 
-		for (int i = 0; i < 5; i++)
+	/**
+	 * @brief Creates a Tile for every position of the TileSpace and points the tile bag at them.
+	*/
+	void BuildTiles()
+	{
+		_tileArray = new Tile** [_rows];
+		for (int i = 0; i < _rows; i++)
 		{
-			for (int j = 0; i < 5; i++)
+			_tileArray[i] = new Tile* [_cols];
+			for (int j = 0; j < _cols; j++)
 			{
-				grid2D[i][j] = i;
+				_tileArray[i][j] = new Tile(i, j);
 			}
 		}
+		_tileBag = Iterator2D<Tile*>(_tileArray, _rows, _cols);
+	}
 
-		_grid2D = grid2D;
-
-		_rows = 5;
-		_cols = 5;
-		Iterator2D<int>* posNumber = new Iterator2D<int>(grid2D, _rows, _cols);
-		Tile** _tileArray = new Tile* [static_cast<int>(posNumber->GetRows()) * posNumber->GetCols()];
+	/**
+	 * @brief Places the entry point on the top left corner and the exits on the other three corners.
+	*/
+	void PlaceCorners()
+	{
+		_entryPoint = new Tile(0, 0);
+		_exitOne = new Tile(0, _cols - 1);
+		_exitTwo = new Tile(_rows - 1, 0);
+		_exitThree = new Tile(_rows - 1, _cols - 1);
+	}
 
-		for (int i = 0; i < 5; i++)
-		{
-			_tileArray[i] = new Tile[5];
-		}
+	/**
+	 * @brief Creates the Tile for a stored map point or returns nullptr for an unset point.
+	 * @param point - the stored point.
+	 * @return a pointer to a new Tile at the point.
+	*/
+	static Tile* TileAt(MapFilePoint point)
+	{
+		return (point.x < 0 || point.y < 0) ? nullptr : new Tile(point.x, point.y);
+	}
 
-		for (int i = 0; i < 5; i++)
+	/**
+	 * @brief Converts a Tile pointer into a stored map point.
+	 * @param tile - the tile to convert, may be nullptr.
+	 * @return the map point of the tile, (-1, -1) for nullptr.
+	*/
+	static MapFilePoint PointOf(const Tile* tile)
+	{
+		MapFilePoint point = { -1, -1 };
+		if (tile != nullptr)
 		{
-			for (int j = 0; i < 5; i++)
-			{
-				Tile* item = new Tile(i,j);
-				_tileArray[i][j] = *item;
-			}
+			point.x = tile->GetPosition()->x;
+			point.y = tile->GetPosition()->y;
 		}
+		return point;
+	}
 
-		_tileBag = Iterator2D<Tile*>(&_tileArray, _rows, _cols);
+public:
+	/**
+	 * @brief Default constructor for the TileSpace class, a small DEFAULT_SIZE x DEFAULT_SIZE space.
+	*/
+	TileSpace()
+	{
+		int** grid2D = new int* [DEFAULT_SIZE];
 
-		while (!_tileBag.ReachedEnd())
+		for (int i = 0; i < DEFAULT_SIZE; i++)
 		{
-			Tile* tile = new Tile(_tileBag.GetCurrentRow(), _tileBag.GetCurrentColumn());
-			
-			if (tile->GetPosition()->x == 0 && tile->GetPosition()->y == 0)
+			grid2D[i] = new int[DEFAULT_SIZE];
+			for (int j = 0; j < DEFAULT_SIZE; j++)
 			{
-				_entryPoint = tile;
-			}
-			else if (tile->GetPosition()->x == 0 && tile->GetPosition()->y == _cols)
-			{
-				_exitOne = tile;
-			}
-			else if (tile->GetPosition()->x == _rows && tile->GetPosition()->y == 0)
-			{
-				_exitTwo = tile;
-			}
-			else if (tile->GetPosition()->x == _rows && tile->GetPosition()->y == _cols)
-			{
-				_exitThree = tile;
+				grid2D[i][j] = i;
 			}
-
-			++_tileBag;
 		}
 
+		_grid2D = grid2D;
+		_rows = DEFAULT_SIZE;
+		_cols = DEFAULT_SIZE;
+		InitLayers();
+		BuildTiles();
+		PlaceCorners();
 	}
 
 	/**
@@ -124,51 +182,68 @@ public:
 	{
 		_grid2D = grid2D;
 		_rows = rows;
-		_cols = rows;
-		Iterator2D<int>* posNumber = new Iterator2D<int>(grid2D, rows, cols);
-		Tile** _tileArray = new Tile * [static_cast<int>(posNumber->GetRows()) * posNumber->GetCols()];
+		_cols = cols;
+		InitLayers();
+		BuildTiles();
+		PlaceCorners();
+	}
 
-		for (int i = 0; i < 5; i++)
+	/**
+	 * @brief Creates a TileSpace of any size holding only the flag and terrain layers, every
+	 * tile walkable plain ground, for generators to fill in. No Tile objects are created apart
+	 * from the entry point on the top left corner and the exits on the other three corners.
+	 * @param rows - the number of rows.
+	 * @param cols - the number of columns.
+	*/
+	TileSpace(int rows, int cols)
+	{
+		if (rows <= 0 || cols <= 0)
 		{
-			_tileArray[i] = new Tile[5];
+			throw std::out_of_range("TileSpace dimensions must be positive");
 		}
+		_grid2D = nullptr;
+		_rows = rows;
+		_cols = cols;
+		InitLayers();
+		PlaceCorners();
+	}
 
-		for (int i = 0; i < 5; i++)
+	/**
+	 * @brief Loads a TileSpace from a binary map file. The file is memory mapped, the flag
+	 * layer is read straight from the mapped pages and the terrain layer is attached to the
+	 * packed codes in them, so no tiles are parsed, unpacked or linked at load time. Only the
+	 * terrain palette is copied.
+	 * @param mapPath - the path of the binary map file.
+	*/
+	explicit TileSpace(const std::string& mapPath)
+	{
+		_mapFile = new MapFile(mapPath);
+		_grid2D = nullptr;
+		_rows = _mapFile->GetRows();
+		_cols = _mapFile->GetCols();
+		_flags = _mapFile->GetLayer(MAP_LAYER_FLAGS);
+		const MapFileLayer* terrain = _mapFile->GetLayerInfo(MAP_LAYER_TERRAIN);
+		const MapFileLayer* palette = _mapFile->GetLayerInfo(MAP_LAYER_TERRAIN_PALETTE);
+		_ownsLayers = false;
+
+		// the palette must fit the code width, Attach() pads it so stray codes still read a value
+		const bool packed = terrain != nullptr && palette != nullptr
+			&& terrain->bitsPerCode >= static_cast<uint32_t>(PaletteLayer<unsigned char>::PALETTE_MIN_BITS) && terrain->bitsPerCode <= 8
+			&& palette->size >= 1 && palette->size <= (uint64_t(1) << terrain->bitsPerCode);
+		if (_flags == nullptr || !packed)
 		{
-			for (int j = 0; i < 5; i++)
-			{
-				Tile* item = new Tile(i, j);
-				_tileArray[i][j] = *item;
-			}
+			delete _mapFile;
+			throw std::runtime_error("Map file " + mapPath + " is missing a tile layer");
 		}
 
-		_tileBag = Iterator2D<Tile*>(&_tileArray, rows, cols);
-		_tileBag.GetCurrentItem()->PrintTile();
-
-		while (!_tileBag.ReachedEnd())
-		{
-			Tile* tile = new Tile(_tileBag.GetCurrentRow(), _tileBag.GetCurrentColumn());
-			
-			if (tile->GetPosition()->x == 0 && tile->GetPosition()->y == 0)
-			{
-				_entryPoint = tile;
-			}
-			else if (tile->GetPosition()->x == 0 && tile->GetPosition()->y == _cols)
-			{
-				_exitOne = tile;
-			}
-			else if (tile->GetPosition()->x == _rows && tile->GetPosition()->y == 0)
-			{
-				_exitTwo = tile;
-			}
-			else if (tile->GetPosition()->x == _rows && tile->GetPosition()->y == _cols)
-			{
-				_exitThree = tile;
-			}
-
-			++_tileBag;
-		}
+		_terrain = new PaletteLayer<unsigned char>();
+		_terrain->Attach(static_cast<size_t>(_rows) * _cols, reinterpret_cast<uint64_t*>(_mapFile->GetLayer(MAP_LAYER_TERRAIN)),
+			static_cast<int>(terrain->bitsPerCode), _mapFile->GetLayer(MAP_LAYER_TERRAIN_PALETTE), static_cast<size_t>(palette->size));
 
+		_entryPoint = TileAt(_mapFile->GetEntry());
+		_exitOne = TileAt(_mapFile->GetExit(0));
+		_exitTwo = TileAt(_mapFile->GetExit(1));
+		_exitThree = TileAt(_mapFile->GetExit(2));
 	}
 
 	/**
@@ -181,6 +256,31 @@ public:
 		delete _exitOne;
 		delete _exitTwo;
 		delete _exitThree;
+
+		if (_ownsLayers)
+		{
+			delete[] _flags;
+
+			if (_tileArray != nullptr)
+			{
+				for (int i = 0; i < _rows; i++)
+				{
+					for (int j = 0; j < _cols; j++)
+					{
+						delete _tileArray[i][j];
+					}
+					delete[] _tileArray[i];
+				}
+				delete[] _tileArray;
+			}
+		}
+		if (_ownsLayers || _mapFile != nullptr)
+		{
+			delete _terrain;
+			delete _damage;
+			delete _healing;
+		}
+		delete _mapFile;
 	}
 
 	/**
@@ -193,10 +293,19 @@ public:
 		_rows = other._rows;
 		_cols = other._cols;
 		_tileBag = other._tileBag;
+		_tileArray = other._tileArray;
 		_entryPoint = other._entryPoint;
 		_exitOne = other._exitOne;
 		_exitTwo = other._exitTwo;
 		_exitThree = other._exitThree;
+		_flags = other._flags;
+		_terrain = other._terrain;
+		_ownsLayers = false;
+		_mapFile = nullptr;
+		_damage = other._damage;
+		_healing = other._healing;
+		_environDamage = other._environDamage;
+		_environHealing = other._environHealing;
 	}
 
 	/**
@@ -297,39 +406,275 @@ public:
 		_tileBag = tileBag;
 	}
 
+	/**
+	 * @brief Getter for the number of rows in the TileSpace.
+	 * @return an integer representing the number of rows.
+	*/
+	int GetRows() const
+	{
+		return _rows;
+	}
+
+	/**
+	 * @brief Getter for the number of columns in the TileSpace.
+	 * @return an integer representing the number of columns.
+	*/
+	int GetCols() const
+	{
+		return _cols;
+	}
+
+	/**
+	 * @brief Checks whether a coordinate lies inside the TileSpace.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return a boolean value indicating whether the coordinate is inside the TileSpace.
+	*/
+	bool InBounds(int row, int col) const
+	{
+		return row >= 0 && row < _rows && col >= 0 && col < _cols;
+	}
+
+	/**
+	 * @brief Getter for the TileFlags of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return the TileFlags bits of the tile.
+	*/
+	unsigned char GetFlags(int row, int col) const
+	{
+		return _flags[static_cast<size_t>(row) * _cols + col];
+	}
+
+	/**
+	 * @brief Setter for the TileFlags of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @param flags - the desired TileFlags bits of the tile.
+	*/
+	void SetFlags(int row, int col, unsigned char flags)
+	{
+		_flags[static_cast<size_t>(row) * _cols + col] = flags;
+	}
+
+	/**
+	 * @brief Checks whether a character can step on a tile. Tiles outside the TileSpace
+	 * are never walkable.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return a boolean value indicating whether the tile is walkable.
+	*/
+	bool IsWalkable(int row, int col) const
+	{
+		return InBounds(row, col) && (GetFlags(row, col) & TILE_WALKABLE) != 0;
+	}
+
+	/**
+	 * @brief Getter for the Environ index of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @return the index of the tile's Environ in the Map's environs.
+	*/
+	unsigned char GetTerrain(int row, int col) const
+	{
+		return _terrain->Get(static_cast<size_t>(row) * _cols + col);
+	}
+
+	/**
+	 * @brief Setter for the Environ index of a tile.
+	 * @param row - the row of the tile.
+	 * @param col - the column of the tile.
+	 * @param terrain - the desired Environ index of the tile.
+	*/
+	void SetTerrain(int row, int col, unsigned char terrain)
+	{
+		_terrain->Set(static_cast<size_t>(row) * _cols + col, terrain);
+		if (_damage != nullptr)
+		{
+			_damage->Set(row, col, _environDamage[terrain]);
+			_healing->Set(row, col, _environHealing[terrain]);
+		}
+	}
+
+	/**
+	 * @brief Replaces the Environ index of every tile at once, for generators and loaders.
+	 * @param terrain - the row-major Environ index of every tile, one byte per tile.
+	*/
+	void LoadTerrain(const unsigned char* terrain)
+	{
+		_terrain->Assign(terrain);
+		if (_damage != nullptr)
+		{
+			for (int i = 0; i < _rows; i++)
+			{
+				for (int j = 0; j < _cols; j++)
+				{
+					const unsigned char value = terrain[static_cast<size_t>(i) * _cols + j];
+					_damage->Set(i, j, _environDamage[value]);
+					_healing->Set(i, j, _environHealing[value]);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Sets or clears TILE_HAZARD on every tile whose Environ index matches, so the
+	 * flag layer follows an Environ's hazard status.
+	 * @param terrain - the Environ index of the tiles to update.
+	 * @param hazard - whether the tiles are hazardous.
+	 * @param changed - receives the tiles whose flags actually changed.
+	*/
+	void ApplyHazard(unsigned char terrain, bool hazard, std::vector<Location>& changed)
+	{
+		const int code = _terrain->Find(terrain);
+		if (code < 0)
+		{
+			return;
+		}
+
+		for (int i = 0; i < _rows; i++)
+		{
+			for (int j = 0; j < _cols; j++)
+			{
+				const size_t index = static_cast<size_t>(i) * _cols + j;
+				const unsigned char flags = hazard ? (_flags[index] | TILE_HAZARD) : (_flags[index] & ~TILE_HAZARD);
+				if (flags != _flags[index] && _terrain->GetCode(index) == static_cast<unsigned int>(code))
+				{
+					_flags[index] = flags;
+					changed.push_back(Location(i, j));
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Sets the damage and healing every tile of an Environ deals to a character standing
+	 * on it, updating the area tables. The first call creates the tables, with every other
+	 * Environ dealing nothing.
+	 * @param terrain - the Environ index of the tiles to update.
+	 * @param damage - the damage dealt by the Environ, 0 while it is not a hazard.
+	 * @param healing - the healing given by the Environ.
+	*/
+	void SetEnvironEffect(unsigned char terrain, int damage, int healing)
+	{
+		if (_damage == nullptr)
+		{
+			_damage = new SummedAreaTable(_rows, _cols);
+			_healing = new SummedAreaTable(_rows, _cols);
+			_environDamage.assign(256, 0);
+			_environHealing.assign(256, 0);
+		}
+
+		_environDamage[terrain] = damage;
+		_environHealing[terrain] = healing;
+		const int code = _terrain->Find(terrain);
+		if (code < 0)
+		{
+			return;
+		}
+
+		for (int i = 0; i < _rows; i++)
+		{
+			for (int j = 0; j < _cols; j++)
+			{
+				if (_terrain->GetCode(static_cast<size_t>(i) * _cols + j) == static_cast<unsigned int>(code))
+				{
+					_damage->Set(i, j, damage);
+					_healing->Set(i, j, healing);
+				}
+			}
+		}
+	}
+
+	/**
+	 * @brief Totals the Environ damage of the tiles inside a rectangle, for area attacks and
+	 * hazard zones. Tables changed since the last query rebuild only their dirty row bands.
+	 * @param top - the first row.
+	 * @param left - the first column.
+	 * @param bottom - the last row, inclusive.
+	 * @param right - the last column, inclusive.
+	 * @return the total damage, 0 before any SetEnvironEffect().
+	*/
+	long long GetDamageInRect(int top, int left, int bottom, int right) const
+	{
+		return (_damage != nullptr) ? _damage->Sum(top, left, bottom, right) : 0;
+	}
+
+	/**
+	 * @brief Totals the Environ healing of the tiles inside a rectangle.
+	 * @param top - the first row.
+	 * @param left - the first column.
+	 * @param bottom - the last row, inclusive.
+	 * @param right - the last column, inclusive.
+	 * @return the total healing, 0 before any SetEnvironEffect().
+	*/
+	long long GetHealingInRect(int top, int left, int bottom, int right) const
+	{
+		return (_healing != nullptr) ? _healing->Sum(top, left, bottom, right) : 0;
+	}
+
+	/**
+	 * @brief Getter for the raw row-major TileFlags layer.
+	 * @return a pointer to the first byte of the layer.
+	*/
+	const unsigned char* GetFlagsLayer() const
+	{
+		return _flags;
+	}
+
+	/**
+	 * @brief Getter for the packed row-major Environ index layer.
+	 * @return the palette layer holding the Environ index of every tile.
+	*/
+	const PaletteLayer<unsigned char>& GetTerrainLayer() const
+	{
+		return *_terrain;
+	}
+
+	/**
+	 * @brief Writes the TileSpace out in the binary map format so it can later be loaded
+	 * with the mapped constructor.
+	 * @param mapPath - the path of the binary map file to write.
+	*/
+	void Save(const std::string& mapPath) const
+	{
+		MapFilePoint exits[MAP_FILE_EXITS] = { PointOf(_exitOne), PointOf(_exitTwo), PointOf(_exitThree) };
+		MapFile::Save(mapPath, _rows, _cols, _flags, *_terrain, PointOf(_entryPoint), exits);
+	}
+
 	/**
 	 * @brief This function prints the 2D array of tiles.
 	*/
 	void PrintTileSpace() const
 	{
-		std::cout << "TileSpace Map" << std::endl;
-		std::cout << std::endl;
+		std::cout << "TileSpace Map\n";
+		std::cout << '\n';
 		
-		std::cout << "==============================================================================" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=______________________________________________||||_______________________||||" << std::endl;
-		std::cout << "=_________________________________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||__________________________________________________||||" << std::endl;
-		std::cout << "=___________________||||______________________________________________________" << std::endl;
-		std::cout << "=___________________||||______________________________________________________" << std::endl;
-		std::cout << "====================||||======================================================" << std::endl;
-		std::cout << "==============================================================================" << std::endl;
+		std::cout << "==============================================================================\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=______________________________________________||||_______________________||||\n";
+		std::cout << "=_________________________________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||__________________________________________________||||\n";
+		std::cout << "=___________________||||______________________________________________________\n";
+		std::cout << "=___________________||||______________________________________________________\n";
+		std::cout << "====================||||======================================================\n";
+		std::cout << "==============================================================================\n";
 	}
 
 
@@ -76,10 +76,10 @@ void Tool::ApplyElectricSpeed()
 
 void Tool::Print() const
 {
-	cout << "Name: " << _name << endl;
-	cout << "Strength: " << _strength << endl;
-	cout << "Range: " << _range << endl;
-	cout << "Mining speed: " << _miningSpeed << endl;
-	cout << "Durability: " << _durability << endl;
-	cout << "Electric speed: " << _electricSpeed << endl;
+	cout << "Name: " << _name << '\n';
+	cout << "Strength: " << _strength << '\n';
+	cout << "Range: " << _range << '\n';
+	cout << "Mining speed: " << _miningSpeed << '\n';
+	cout << "Durability: " << _durability << '\n';
+	cout << "Electric speed: " << _electricSpeed << '\n';
 }
@@ -55,9 +55,9 @@ void Weapon::ApplyLethalPotion()
 
 void Weapon::Print() const
 {
-	std::cout << "Weapon: " << _name << std::endl;
-	std::cout << "Strength: " << _strength << std::endl;
-	std::cout << "Range: " << _range << std::endl;
-	std::cout << "Attack Speed: " << _attackSpeed << std::endl;
-	std::cout << "Lethal Potion: " << _lethalPotion << std::endl;
+	std::cout << "Weapon: " << _name << '\n';
+	std::cout << "Strength: " << _strength << '\n';
+	std::cout << "Range: " << _range << '\n';
+	std::cout << "Attack Speed: " << _attackSpeed << '\n';
+	std::cout << "Lethal Potion: " << _lethalPotion << '\n';
 }
\ No newline at end of file